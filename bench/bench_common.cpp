@@ -0,0 +1,141 @@
+#include "bench_common.hpp"
+#include "telemetry/allocations.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+#ifndef NEBULA_MAPPER_ALLOC_TRACKING
+    std::atomic<uint64_t> allocations{0};
+#endif
+
+    parser::mapping::Property property(
+        const std::string& name, const std::string& path, const std::string& type,
+        std::optional<parser::mapping::Transform> transform = std::nullopt) {
+        parser::mapping::Property prop;
+        prop.name = name;
+        prop.json_path = path;
+        prop.nebula_type = type;
+        prop.transform = std::move(transform);
+        return prop;
+    }
+}
+
+#ifndef NEBULA_MAPPER_ALLOC_TRACKING
+// Counting replacements for the global allocator. Array and nothrow forms
+// forward to these in libstdc++, so they are counted as well. Builds with
+// allocation tracking already replace them in the library.
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+#endif
+
+namespace bench {
+
+uint64_t allocation_count() {
+#ifdef NEBULA_MAPPER_ALLOC_TRACKING
+    return telemetry::allocation_total().allocations;
+#else
+    return allocations.load(std::memory_order_relaxed);
+#endif
+}
+
+std::string read_test_file(const std::string& name) {
+    std::ifstream file(std::string(NEBULA_MAPPER_TEST_DATA_DIR) + "/" + name);
+    if (!file) {
+        throw std::runtime_error("Cannot open test data file: " + name);
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+const parser::json::JsonDocument& kakao_document() {
+    static const parser::json::JsonDocument document = [] {
+        auto result = parser::json::parse(read_test_file("input.json"));
+        if (std::holds_alternative<parser::json::Error>(result)) {
+            throw std::runtime_error(std::get<parser::json::Error>(result).message);
+        }
+        return std::get<parser::json::JsonDocument>(result);
+    }();
+    return document;
+}
+
+const parser::mapping::GraphMapping& kakao_mapping() {
+    static const parser::mapping::GraphMapping mapping = [] {
+        parser::mapping::GraphMapping m;
+
+        parser::mapping::VertexMapping place;
+        place.tag_name = "Place";
+        place.source_path = "basicInfo";
+        place.key_path = "cid";
+        place.properties = {
+            property("cid", "cid", "INT64"),
+            property("placenamefull", "placenamefull", "STRING"),
+            property("wpointx", "wpointx", "INT64"),
+            property("wpointy", "wpointy", "INT64"),
+            property("phonenum", "phonenum", "STRING"),
+            property("mainphotourl", "mainphotourl", "STRING"),
+        };
+        m.vertices.push_back(place);
+
+        parser::mapping::VertexMapping user;
+        user.tag_name = "User";
+        user.source_path = "comment/list";
+        user.key_path = "kakaoMapUserId";
+        user.properties = {
+            property("username", "username", "STRING"),
+            property("profileStatus", "profileStatus", "STRING"),
+            property("level_now", "level/nowLevel", "INT64"),
+            property("userCommentCount", "userCommentCount", "INT64"),
+            property("userCommentAverageScore", "userCommentAverageScore", "DOUBLE"),
+        };
+        m.vertices.push_back(user);
+
+        parser::mapping::VertexMapping review;
+        review.tag_name = "Review";
+        review.source_path = "comment/list";
+        review.key_path = "commentid";
+        review.properties = {
+            property("contents", "contents", "STRING",
+                     parser::mapping::Transform{"string_normalize", {}}),
+            property("point", "point", "INT64"),
+            property("date", "date", "STRING",
+                     parser::mapping::Transform{"time_format", {{"format", "%Y.%m.%d."}}}),
+        };
+        m.vertices.push_back(review);
+
+        parser::mapping::EdgeMapping wrote;
+        wrote.edge_name = "Wrote";
+        wrote.source_path = "comment/list";
+        wrote.from.tag = "User";
+        wrote.from.key_path = "kakaoMapUserId";
+        wrote.to.tag = "Review";
+        wrote.to.key_path = "commentid";
+        wrote.properties = {
+            property("likeCnt", "likeCnt", "INT64"),
+            property("photoCnt", "photoCnt", "INT64"),
+        };
+        m.edges.push_back(wrote);
+
+        return m;
+    }();
+    return mapping;
+}
+
+} // namespace bench
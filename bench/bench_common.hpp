@@ -0,0 +1,47 @@
+#ifndef NEBULA_MAPPER_BENCH_COMMON_HPP
+#define NEBULA_MAPPER_BENCH_COMMON_HPP
+
+#include "parser/json_parser.hpp"
+#include "parser/mapping_parser.hpp"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+
+namespace bench {
+
+// Heap allocations made by this process so far (operator new calls)
+uint64_t allocation_count();
+
+// Reports heap allocations per iteration as the "allocs/op" counter
+class AllocationCounter {
+public:
+    explicit AllocationCounter(benchmark::State& state)
+        : state_(state), start_(allocation_count()) {}
+
+    ~AllocationCounter() {
+        state_.counters["allocs/op"] = benchmark::Counter(
+            static_cast<double>(allocation_count() - start_),
+            benchmark::Counter::kAvgIterations);
+    }
+
+    AllocationCounter(const AllocationCounter&) = delete;
+    AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+private:
+    benchmark::State& state_;
+    uint64_t start_;
+};
+
+// Contents of a file under tests/test_data
+std::string read_test_file(const std::string& name);
+
+// Parsed tests/test_data/input.json
+const parser::json::JsonDocument& kakao_document();
+
+// Mapping of the Kakao place document (Place, User and Review tags plus
+// Wrote edges), built in code so it only uses paths the navigator supports
+const parser::mapping::GraphMapping& kakao_mapping();
+
+} // namespace bench
+
+#endif // NEBULA_MAPPER_BENCH_COMMON_HPP
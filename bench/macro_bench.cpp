@@ -0,0 +1,486 @@
+#include "corpus/corpus_generator.hpp"
+#include "graph/pipeline.hpp"
+#include "parser/mapping_parser.hpp"
+#include "parser/record_reader.hpp"
+#include "parser/yaml_parser.hpp"
+#include <nlohmann/json.hpp>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+
+// End-to-end benchmark: mapping compile, record parsing, statement
+// generation and output over the synthetic corpus, at several input sizes
+// and thread counts. Every run is a fresh process so peak RSS and CPU time
+// come straight from the kernel (wait4) and do not leak between runs.
+
+namespace fs = std::filesystem;
+using nlohmann::json;
+
+namespace {
+
+struct BenchOptions {
+    std::vector<uint64_t> sizes{4ULL << 20, 16ULL << 20};
+    std::vector<size_t> threads{1, 2, 4};
+    corpus::OutputFormat format{corpus::OutputFormat::NDJSON};
+    std::string format_name{"ndjson"};
+    std::string mapping{corpus::kakao_mapping_path()};
+    std::string output{"/dev/null"};
+    fs::path corpus_dir{fs::temp_directory_path() / "nebula_mapper_macro_bench"};
+    uint64_t seed{42};
+    size_t batch_size{500};
+    unsigned repetitions{1};
+    std::string report;
+    std::string baseline;
+    double tolerance{0.10};
+    bool fail_on_regression{false};
+};
+
+void print_usage(const char* program_name) {
+    std::cerr << "Usage: " << program_name << " [options]\n"
+              << "Options:\n"
+              << "  --sizes LIST          Corpus sizes, e.g. 4M,64M,1G (default: 4M,16M)\n"
+              << "  --threads LIST        Pipeline thread counts (default: 1,2,4)\n"
+              << "  --format F            Corpus format: ndjson, array or files\n"
+              << "                        (default: ndjson)\n"
+              << "  --mapping FILE        Mapping YAML (default: tools/corpus/kakao_mapping.yaml)\n"
+              << "  --output PATH         Where statements go (default: /dev/null)\n"
+              << "  --corpus-dir DIR      Cache for generated corpora\n"
+              << "  --seed N              Corpus seed (default: 42)\n"
+              << "  --batch-size N        Rows per INSERT statement (default: 500)\n"
+              << "  --repetitions N       Runs per configuration, fastest kept (default: 1)\n"
+              << "  --report FILE         Write the JSON report to FILE\n"
+              << "  --baseline FILE       Compare against a previous JSON report\n"
+              << "  --tolerance R         Allowed slowdown/growth vs baseline (default: 0.10)\n"
+              << "  --fail-on-regression  Exit with status 2 if a run regressed\n";
+}
+
+template<typename T, typename Parse>
+std::optional<std::vector<T>> parse_list(const std::string& text, Parse parse) {
+    std::vector<T> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        auto value = parse(item);
+        if (!value) return std::nullopt;
+        values.push_back(*value);
+    }
+    if (values.empty()) return std::nullopt;
+    return values;
+}
+
+std::string format_size(uint64_t bytes) {
+    static const char* UNITS[] = {"B", "K", "M", "G", "T"};
+    size_t unit = 0;
+    while (unit + 1 < std::size(UNITS) && bytes >= 1024 && bytes % 1024 == 0) {
+        bytes /= 1024;
+        ++unit;
+    }
+    return std::to_string(bytes) + UNITS[unit];
+}
+
+double since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Child process: compile, run and report one configuration on result_fd
+int run_child(const std::string& mapping_file, const std::string& input,
+              const std::string& format, const std::string& output,
+              size_t threads, size_t batch_size, int result_fd) {
+    auto start = std::chrono::steady_clock::now();
+
+    // The YAML layer logs while decoding; only show that if compiling fails
+    std::stringstream compile_log;
+    auto* saved = std::cerr.rdbuf(compile_log.rdbuf());
+    auto yaml = parser::yaml::parse_file(mapping_file);
+    auto mapping = parser::mapping::create_mapping(yaml);
+    std::cerr.rdbuf(saved);
+    if (std::holds_alternative<parser::yaml::Error>(yaml)) {
+        std::cerr << "YAML Error: " << std::get<parser::yaml::Error>(yaml).message << '\n';
+        return 1;
+    }
+    if (std::holds_alternative<parser::mapping::Error>(mapping)) {
+        std::cerr << compile_log.str() << "Mapping Error: "
+                  << std::get<parser::mapping::Error>(mapping).message << '\n';
+        return 1;
+    }
+    double compile_seconds = since(start);
+
+    auto input_format = parser::json::parse_input_format(format == "files" ? "directory"
+                                                                             : format);
+    auto reader = parser::json::open_records(
+        input, std::get<parser::json::InputFormat>(input_format));
+    if (std::holds_alternative<parser::json::Error>(reader)) {
+        std::cerr << "Error: " << std::get<parser::json::Error>(reader).message << '\n';
+        return 1;
+    }
+
+    std::ofstream out(output, std::ios::binary);
+    if (!out) {
+        std::cerr << "Error: Cannot open output: " << output << '\n';
+        return 1;
+    }
+    graph::OstreamSink sink(out);
+    graph::PipelineOptions options;
+    options.threads = threads;
+    options.batch_size = batch_size;
+
+    auto summary = graph::run_pipeline(
+        std::get<parser::mapping::GraphMapping>(mapping),
+        *std::get<std::unique_ptr<parser::json::RecordReader>>(reader), sink, options);
+    if (std::holds_alternative<graph::StatementError>(summary)) {
+        const auto& error = std::get<graph::StatementError>(summary);
+        std::cerr << "Error: " << error.message;
+        if (error.context) std::cerr << " (" << *error.context << ")";
+        std::cerr << '\n';
+        return 1;
+    }
+    out.flush();
+    double seconds = since(start);
+
+    const auto& s = std::get<graph::PipelineSummary>(summary);
+    std::string line = json{
+        {"records", s.records},
+        {"input_bytes", s.input_bytes},
+        {"statements", s.statements},
+        {"statement_bytes", s.statement_bytes},
+        {"compile_seconds", compile_seconds},
+        {"seconds", seconds},
+    }.dump() + "\n";
+    if (::write(result_fd, line.data(), line.size()) != static_cast<ssize_t>(line.size())) {
+        return 1;
+    }
+    return 0;
+}
+
+// Generate (or reuse) the corpus for one size
+std::optional<fs::path> ensure_corpus(const BenchOptions& options, uint64_t size) {
+    static const char* EXTENSIONS[] = {".ndjson", ".json", ""};
+    auto name = "corpus-" + format_size(size) + "-" + std::to_string(options.seed) +
+                EXTENSIONS[static_cast<int>(options.format)];
+    auto path = options.corpus_dir / name;
+    if (fs::exists(path)) {
+        return path;
+    }
+
+    std::error_code ec;
+    fs::create_directories(options.corpus_dir, ec);
+
+    corpus::CorpusOptions corpus_options;
+    corpus_options.seed = options.seed;
+    corpus_options.places = UINT64_MAX;
+    corpus_options.target_bytes = size;
+    corpus_options.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cerr << "Generating " << format_size(size) << " corpus: " << path << '\n';
+    auto partial = path;
+    partial += ".partial";
+    fs::remove_all(partial, ec);
+    auto result = corpus::write_corpus(corpus_options, options.format, partial.string());
+    if (std::holds_alternative<corpus::Error>(result)) {
+        std::cerr << "Error: " << std::get<corpus::Error>(result).message << '\n';
+        return std::nullopt;
+    }
+    fs::rename(partial, path, ec);
+    if (ec) {
+        std::cerr << "Error: Cannot move corpus into place: " << ec.message() << '\n';
+        return std::nullopt;
+    }
+    return path;
+}
+
+// Run one configuration in a fresh process
+std::optional<json> measure(const BenchOptions& options, const fs::path& corpus,
+                            uint64_t size, size_t threads) {
+    int fds[2];
+    if (::pipe(fds) != 0) {
+        std::perror("pipe");
+        return std::nullopt;
+    }
+
+    std::vector<std::string> args = {
+        "/proc/self/exe", "--child",
+        options.mapping, corpus.string(), options.format_name, options.output,
+        std::to_string(threads), std::to_string(options.batch_size), std::to_string(fds[1]),
+    };
+    std::vector<char*> argv;
+    for (auto& arg : args) argv.push_back(arg.data());
+    argv.push_back(nullptr);
+
+    pid_t pid = ::fork();
+    if (pid < 0) {
+        std::perror("fork");
+        return std::nullopt;
+    }
+    if (pid == 0) {
+        ::close(fds[0]);
+        ::execv(argv[0], argv.data());
+        std::perror("execv");
+        ::_exit(127);
+    }
+    ::close(fds[1]);
+
+    std::string line;
+    char buffer[512];
+    ssize_t n;
+    while ((n = ::read(fds[0], buffer, sizeof(buffer))) > 0) {
+        line.append(buffer, static_cast<size_t>(n));
+    }
+    ::close(fds[0]);
+
+    int status = 0;
+    struct rusage usage {};
+    if (::wait4(pid, &status, 0, &usage) < 0 || !WIFEXITED(status) ||
+        WEXITSTATUS(status) != 0 || line.empty()) {
+        std::cerr << "Error: run failed (size " << format_size(size) << ", "
+                  << threads << " threads)\n";
+        return std::nullopt;
+    }
+
+    auto child = json::parse(line);
+    double seconds = std::max(child["seconds"].get<double>(), 1e-9);
+    double cpu_seconds =
+        static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+        static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+    auto records = child["records"].get<uint64_t>();
+    auto input_bytes = child["input_bytes"].get<uint64_t>();
+
+    return json{
+        {"size_bytes", size},
+        {"threads", threads},
+        {"records", records},
+        {"input_bytes", input_bytes},
+        {"statements", child["statements"]},
+        {"statement_bytes", child["statement_bytes"]},
+        {"compile_seconds", child["compile_seconds"]},
+        {"seconds", seconds},
+        {"records_per_sec", static_cast<double>(records) / seconds},
+        {"mb_per_sec", static_cast<double>(input_bytes) / (1 << 20) / seconds},
+        {"peak_rss_kb", usage.ru_maxrss},
+        {"cpu_seconds", cpu_seconds},
+        {"cpu_utilization", cpu_seconds / seconds},
+    };
+}
+
+void print_table(const json& runs) {
+    std::cout << std::left << std::setw(8) << "size" << std::right
+              << std::setw(8) << "threads" << std::setw(11) << "records"
+              << std::setw(12) << "records/s" << std::setw(9) << "MB/s"
+              << std::setw(12) << "peak RSS" << std::setw(8) << "CPU" << '\n';
+    for (const auto& run : runs) {
+        std::cout << std::left << std::setw(8) << format_size(run["size_bytes"].get<uint64_t>())
+                  << std::right << std::fixed
+                  << std::setw(8) << run["threads"].get<size_t>()
+                  << std::setw(11) << run["records"].get<uint64_t>()
+                  << std::setw(12) << std::setprecision(0) << run["records_per_sec"].get<double>()
+                  << std::setw(9) << std::setprecision(1) << run["mb_per_sec"].get<double>()
+                  << std::setw(10) << run["peak_rss_kb"].get<long>() / 1024 << "MB"
+                  << std::setw(7) << std::setprecision(0)
+                  << run["cpu_utilization"].get<double>() * 100 << "%\n";
+    }
+}
+
+// Compare against a saved report; returns the number of regressions
+size_t compare_baseline(const json& runs, const json& baseline, double tolerance) {
+    std::cout << "\nComparison with baseline (tolerance " << tolerance * 100 << "%):\n";
+    size_t regressions = 0;
+    for (const auto& run : runs) {
+        auto match = std::find_if(baseline["runs"].begin(), baseline["runs"].end(),
+            [&](const json& old) {
+                return old["size_bytes"] == run["size_bytes"] && old["threads"] == run["threads"];
+            });
+        std::cout << "  " << std::left << std::setw(6)
+                  << format_size(run["size_bytes"].get<uint64_t>())
+                  << std::right << std::setw(3) << run["threads"].get<size_t>() << " threads: ";
+        if (match == baseline["runs"].end()) {
+            std::cout << "no baseline\n";
+            continue;
+        }
+
+        double throughput = run["records_per_sec"].get<double>() /
+                            std::max((*match)["records_per_sec"].get<double>(), 1e-9) - 1.0;
+        double rss = run["peak_rss_kb"].get<double>() /
+                     std::max((*match)["peak_rss_kb"].get<double>(), 1.0) - 1.0;
+        double cpu = run["cpu_utilization"].get<double>() -
+                     (*match)["cpu_utilization"].get<double>();
+        bool regressed = throughput < -tolerance || rss > tolerance;
+        regressions += regressed;
+
+        std::cout << std::showpos << std::fixed << std::setprecision(1)
+                  << "records/s " << throughput * 100 << "%, peak RSS " << rss * 100
+                  << "%, CPU " << cpu * 100 << " pts" << std::noshowpos
+                  << (regressed ? "  REGRESSION" : "") << '\n';
+    }
+    return regressions;
+}
+
+std::optional<BenchOptions> parse_arguments(int argc, char* argv[]) {
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--fail-on-regression") {
+            options.fail_on_regression = true;
+            continue;
+        }
+        if (arg == "--help" || i + 1 >= argc) {
+            print_usage(argv[0]);
+            return std::nullopt;
+        }
+        std::string value = argv[++i];
+
+        bool ok = true;
+        try {
+            if (arg == "--sizes") {
+                auto sizes = parse_list<uint64_t>(value, [](const std::string& item) {
+                    auto size = corpus::parse_size(item);
+                    return std::holds_alternative<uint64_t>(size)
+                        ? std::optional<uint64_t>(std::get<uint64_t>(size)) : std::nullopt;
+                });
+                ok = sizes.has_value();
+                if (ok) options.sizes = *sizes;
+            } else if (arg == "--threads") {
+                auto threads = parse_list<size_t>(value, [](const std::string& item) {
+                    auto count = std::stoul(item);
+                    return count > 0 ? std::optional<size_t>(count) : std::nullopt;
+                });
+                ok = threads.has_value();
+                if (ok) options.threads = *threads;
+            } else if (arg == "--format") {
+                auto format = corpus::parse_format(value);
+                ok = std::holds_alternative<corpus::OutputFormat>(format);
+                if (ok) {
+                    options.format = std::get<corpus::OutputFormat>(format);
+                    options.format_name = value;
+                }
+            } else if (arg == "--mapping") {
+                options.mapping = value;
+            } else if (arg == "--output") {
+                options.output = value;
+            } else if (arg == "--corpus-dir") {
+                options.corpus_dir = value;
+            } else if (arg == "--seed") {
+                options.seed = std::stoull(value);
+            } else if (arg == "--batch-size") {
+                options.batch_size = std::stoul(value);
+            } else if (arg == "--repetitions") {
+                options.repetitions = std::max(1u, static_cast<unsigned>(std::stoul(value)));
+            } else if (arg == "--report") {
+                options.report = value;
+            } else if (arg == "--baseline") {
+                options.baseline = value;
+            } else if (arg == "--tolerance") {
+                options.tolerance = std::stod(value);
+            } else {
+                std::cerr << "Error: Unknown option: " << arg << '\n';
+                print_usage(argv[0]);
+                return std::nullopt;
+            }
+        } catch (const std::exception&) {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << "Error: Invalid value for " << arg << ": " << value << '\n';
+            return std::nullopt;
+        }
+    }
+    return options;
+}
+
+std::string utc_timestamp() {
+    std::time_t now = std::time(nullptr);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return buffer;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc == 9 && std::string(argv[1]) == "--child") {
+        return run_child(argv[2], argv[3], argv[4], argv[5], std::stoul(argv[6]),
+                         std::stoul(argv[7]), std::stoi(argv[8]));
+    }
+
+    auto options = parse_arguments(argc, argv);
+    if (!options) {
+        return 1;
+    }
+
+    std::optional<json> baseline;
+    if (!options->baseline.empty()) {
+        std::ifstream in(options->baseline);
+        try {
+            baseline = json::parse(in);
+        } catch (const json::exception& e) {
+            std::cerr << "Error: Cannot read baseline " << options->baseline << ": "
+                      << e.what() << '\n';
+            return 1;
+        }
+    }
+
+    json runs = json::array();
+    for (auto size : options->sizes) {
+        auto corpus = ensure_corpus(*options, size);
+        if (!corpus) {
+            return 1;
+        }
+        for (auto threads : options->threads) {
+            std::optional<json> best;
+            for (unsigned rep = 0; rep < options->repetitions; ++rep) {
+                auto run = measure(*options, *corpus, size, threads);
+                if (!run) {
+                    return 1;
+                }
+                if (!best || (*run)["seconds"] < (*best)["seconds"]) {
+                    best = std::move(run);
+                }
+            }
+            runs.push_back(std::move(*best));
+        }
+    }
+
+    print_table(runs);
+
+    json report = {
+        {"meta", {
+            {"timestamp", utc_timestamp()},
+            {"hardware_concurrency", std::thread::hardware_concurrency()},
+            {"compiler", __VERSION__},
+            {"format", options->format_name},
+            {"seed", options->seed},
+            {"batch_size", options->batch_size},
+            {"repetitions", options->repetitions},
+            {"mapping", options->mapping},
+            {"output", options->output},
+        }},
+        {"runs", runs},
+    };
+
+    if (!options->report.empty()) {
+        std::ofstream out(options->report);
+        if (!out) {
+            std::cerr << "Error: Cannot write report: " << options->report << '\n';
+            return 1;
+        }
+        out << report.dump(2) << '\n';
+    }
+
+    if (baseline) {
+        size_t regressions = compare_baseline(runs, *baseline, options->tolerance);
+        if (regressions > 0 && options->fail_on_regression) {
+            std::cerr << regressions << " configuration(s) regressed\n";
+            return 2;
+        }
+    }
+    return 0;
+}
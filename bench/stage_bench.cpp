@@ -0,0 +1,370 @@
+#include "bench_common.hpp"
+#include "common/number_parser.hpp"
+#include "graph/column_dictionary.hpp"
+#include "graph/geo.hpp"
+#include "graph/json_literal.hpp"
+#include "graph/mapping_dsl.hpp"
+#include "graph/statement_generator.hpp"
+#include "transformer/transform_engine.hpp"
+
+// Micro-benchmarks for each pipeline stage. Every benchmark reports ns/op
+// (the default time column), bytes/s where an input size is meaningful, and
+// heap allocations per iteration ("allocs/op").
+
+namespace {
+
+using parser::json::JsonDocument;
+
+const JsonDocument& first_comment() {
+    static const JsonDocument comment = bench::kakao_document()["comment"]["list"][0];
+    return comment;
+}
+
+void BM_JsonParse(benchmark::State& state) {
+    const std::string input = bench::read_test_file("input.json");
+    bench::AllocationCounter allocs(state);
+    for (auto _ : state) {
+        auto result = parser::json::parse(input);
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.size()));
+}
+BENCHMARK(BM_JsonParse);
+
+void BM_SplitPath(benchmark::State& state) {
+    const std::string path = "comment/list/level/nowLevel";
+    bench::AllocationCounter allocs(state);
+    for (auto _ : state) {
+        auto segments = parser::json::detail::split_path(path);
+        benchmark::DoNotOptimize(segments);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * path.size()));
+}
+BENCHMARK(BM_SplitPath);
+
+void BM_NavigatePath(benchmark::State& state) {
+    const auto& document = bench::kakao_document();
+    const auto segments = parser::json::detail::split_path("basicInfo/placenamefull");
+    bench::AllocationCounter allocs(state);
+    for (auto _ : state) {
+        auto result = parser::json::detail::navigate_path(document, segments);
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK(BM_NavigatePath);
+
+// Arg 0: string, 1: integer, 2: double, 3: nested path, 4: with transform
+void BM_ExtractValue(benchmark::State& state) {
+    struct Case {
+        const char* path;
+        const char* type;
+        std::optional<parser::mapping::Transform> transform;
+    };
+    static const Case cases[] = {
+        {"username", "STRING", std::nullopt},
+        {"userCommentCount", "INT64", std::nullopt},
+        {"userCommentAverageScore", "DOUBLE", std::nullopt},
+        {"level/nowLevel", "INT64", std::nullopt},
+        {"contents", "STRING", parser::mapping::Transform{"string_normalize", {}}},
+    };
+    const auto& c = cases[state.range(0)];
+    graph::StatementGenerator generator;
+    const auto& comment = first_comment();
+
+    bench::AllocationCounter allocs(state);
+    for (auto _ : state) {
+        auto value = generator.extract_value(comment, c.path, c.type, c.transform);
+        benchmark::DoNotOptimize(value);
+    }
+    state.SetLabel(c.path);
+}
+BENCHMARK(BM_ExtractValue)->DenseRange(0, 4);
+
+// Arg 0: string, 1: integer, 2: double, 3: bool, 4: null
+void BM_FormatValue(benchmark::State& state) {
+    static const graph::Value values[] = {
+        {"STRING", std::string("Hanok cafe near Gyeongbokgung"), false},
+        {"INT64", int64_t{1081433159}, false},
+        {"DOUBLE", 2.9, false},
+        {"BOOL", true, false},
+        {"STRING", std::string(), true},
+    };
+    const auto& value = values[state.range(0)];
+    graph::StatementGenerator generator;
+
+    bench::AllocationCounter allocs(state);
+    for (auto _ : state) {
+        auto formatted = generator.format_value(value);
+        benchmark::DoNotOptimize(formatted);
+    }
+    state.SetLabel(value.is_null ? "NULL" : value.nebula_type);
+}
+BENCHMARK(BM_FormatValue)->DenseRange(0, 4);
+
+// One low-cardinality string column over many items.
+// Arg 0: extract_value + format_value, 1: ColumnDictionary
+void BM_RenderStringColumn(benchmark::State& state) {
+    static const char* badges[] = {"gold", "silver", "bronze", "new", "top reviewer"};
+    std::vector<JsonDocument> items;
+    for (int i = 0; i < 1024; ++i) {
+        items.push_back({{"user", {{"badge", badges[i % 5]}}}});
+    }
+    graph::StatementGenerator generator;
+    graph::ColumnDictionary dictionary("user/badge");
+
+    bench::AllocationCounter allocs(state);
+    for (auto _ : state) {
+        for (const auto& item : items) {
+            if (state.range(0) == 0) {
+                auto value = generator.extract_value(item, "user/badge", "STRING");
+                auto formatted = generator.format_value(std::get<graph::Value>(value));
+                benchmark::DoNotOptimize(formatted);
+            } else {
+                benchmark::DoNotOptimize(dictionary.render(item));
+            }
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * items.size()));
+    state.SetLabel(state.range(0) == 0 ? "extract+format" : "dictionary");
+}
+BENCHMARK(BM_RenderStringColumn)->DenseRange(0, 1);
+
+// Integer IDs stored as strings, e.g. comment IDs.
+// Arg 0: std::stod, 1: common::numbers::parse_int64
+void BM_ParseInt64String(benchmark::State& state) {
+    std::vector<std::string> ids;
+    for (int64_t i = 0; i < 1024; ++i) {
+        ids.push_back(std::to_string(9007199254740993 + i * 7919));
+    }
+
+    bench::AllocationCounter allocs(state);
+    for (auto _ : state) {
+        for (const auto& id : ids) {
+            if (state.range(0) == 0) {
+                benchmark::DoNotOptimize(static_cast<int64_t>(std::stod(id)));
+            } else {
+                benchmark::DoNotOptimize(common::numbers::parse_int64(id));
+            }
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * ids.size()));
+    state.SetLabel(state.range(0) == 0 ? "stod" : "parse_int64");
+}
+BENCHMARK(BM_ParseInt64String)->DenseRange(0, 1);
+
+// A JSON subtree stored as a string property.
+// Arg 0: to_string + escape_string + quotes, 1: append_json_literal
+void BM_SerializeJsonProperty(benchmark::State& state) {
+    const auto& subtree = bench::kakao_document()["basicInfo"];
+    parser::mapping::JsonFormat format;
+    std::string literal;
+
+    bench::AllocationCounter allocs(state);
+    for (auto _ : state) {
+        if (state.range(0) == 0) {
+            auto text = parser::json::to_string(subtree);
+            literal = "\"" + graph::StatementGenerator::escape_string(
+                std::get<std::string>(text)) + "\"";
+        } else {
+            literal.clear();
+            graph::append_json_literal(literal, subtree, format);
+        }
+        benchmark::DoNotOptimize(literal);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * literal.size()));
+    state.SetLabel(state.range(0) == 0 ? "dump+escape" : "fused");
+}
+BENCHMARK(BM_SerializeJsonProperty)->DenseRange(0, 1);
+
+// WCONGNAMUL place coordinates around Seoul to WGS84.
+// Arg 0: one point per call, as a per-row transform would, 1: one batch
+void BM_ConvertWcongnamul(benchmark::State& state) {
+    std::vector<double> source_x, source_y;
+    for (int i = 0; i < 1024; ++i) {
+        source_x.push_back(480000 + i * 37);
+        source_y.push_back(1110000 + i * 53);
+    }
+    std::vector<double> x, y;
+
+    bench::AllocationCounter allocs(state);
+    for (auto _ : state) {
+        x = source_x;
+        y = source_y;
+        if (state.range(0) == 0) {
+            for (size_t i = 0; i < x.size(); ++i) {
+                graph::to_wgs84(parser::mapping::Projection::WCONGNAMUL, &x[i], &y[i], 1);
+            }
+        } else {
+            graph::to_wgs84(parser::mapping::Projection::WCONGNAMUL, x.data(), y.data(),
+                            x.size());
+        }
+        benchmark::DoNotOptimize(x.data());
+        benchmark::DoNotOptimize(y.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * x.size()));
+    state.SetLabel(state.range(0) == 0 ? "per point" : "batch");
+}
+BENCHMARK(BM_ConvertWcongnamul)->DenseRange(0, 1);
+
+// Arg 0: string key, 1: integer key
+void BM_GetVertexId(benchmark::State& state) {
+    graph::StatementGenerator generator;
+    const auto& data = state.range(0) == 0 ? first_comment()
+                                           : bench::kakao_document()["basicInfo"];
+    const char* key = state.range(0) == 0 ? "kakaoMapUserId" : "cid";
+
+    bench::AllocationCounter allocs(state);
+    for (auto _ : state) {
+        auto id = generator.get_vertex_id(data, key);
+        benchmark::DoNotOptimize(id);
+    }
+    state.SetLabel(key);
+}
+BENCHMARK(BM_GetVertexId)->DenseRange(0, 1);
+
+// Arg 0: plain identifier, 1: needs backquotes
+void BM_QuoteIdentifier(benchmark::State& state) {
+    const std::string identifier = state.range(0) == 0 ? "userCommentAverageScore"
+                                                       : "1st-level name";
+    bench::AllocationCounter allocs(state);
+    for (auto _ : state) {
+        auto quoted = graph::StatementGenerator::quote_identifier(identifier);
+        benchmark::DoNotOptimize(quoted);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * identifier.size()));
+}
+BENCHMARK(BM_QuoteIdentifier)->DenseRange(0, 1);
+
+void run_transform(benchmark::State& state, const std::string& name,
+                   transformer::TransformValue input,
+                   const std::map<std::string, std::string>& params) {
+    auto& engine = transformer::TransformEngine::instance();
+    if (std::holds_alternative<transformer::TransformError>(
+            engine.apply_transform(name, input, params))) {
+        state.SkipWithError(("transform failed: " + name).c_str());
+        return;
+    }
+
+    bench::AllocationCounter allocs(state);
+    for (auto _ : state) {
+        auto result = engine.apply_transform(name, input, params);
+        benchmark::DoNotOptimize(result);
+    }
+}
+
+transformer::TransformValue string_input(const std::string& value) {
+    transformer::TransformValue input;
+    input.value = value;
+    input.source_type = "STRING";
+    input.target_type = "STRING";
+    return input;
+}
+
+void BM_TransformTimeFormat(benchmark::State& state) {
+    run_transform(state, "time_format", string_input("2024.10.19."),
+                  {{"format", "%Y.%m.%d."}});
+}
+BENCHMARK(BM_TransformTimeFormat);
+
+void BM_TransformPriceNormalize(benchmark::State& state) {
+    run_transform(state, "price_normalize", string_input("12,500원"), {});
+}
+BENCHMARK(BM_TransformPriceNormalize);
+
+void BM_TransformStringNormalize(benchmark::State& state) {
+    run_transform(state, "string_normalize",
+                  string_input("  Good coffee, friendly staff  "), {});
+}
+BENCHMARK(BM_TransformStringNormalize);
+
+void BM_TransformArrayJoin(benchmark::State& state) {
+    run_transform(state, "array_join", string_input("parking,wifi,pet,reservation"),
+                  {{"delimiter", ","}});
+}
+BENCHMARK(BM_TransformArrayJoin);
+
+void BM_TransformToBoolean(benchmark::State& state) {
+    run_transform(state, "to_boolean", string_input("Yes"), {});
+}
+BENCHMARK(BM_TransformToBoolean);
+
+// Whole document through the generator, bytes/s relative to the JSON input
+void BM_GenerateBatchStatements(benchmark::State& state) {
+    const auto& document = bench::kakao_document();
+    const auto& mapping = bench::kakao_mapping();
+    const size_t input_bytes = bench::read_test_file("input.json").size();
+    graph::StatementGenerator generator;
+
+    auto check = generator.generate_batch_statements(mapping, document, state.range(0));
+    if (std::holds_alternative<graph::StatementError>(check)) {
+        state.SkipWithError(std::get<graph::StatementError>(check).message.c_str());
+        return;
+    }
+
+    bench::AllocationCounter allocs(state);
+    for (auto _ : state) {
+        auto statements = generator.generate_batch_statements(mapping, document,
+                                                              state.range(0));
+        benchmark::DoNotOptimize(statements);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input_bytes));
+}
+BENCHMARK(BM_GenerateBatchStatements)->Arg(1)->Arg(500);
+
+// The kakao mapping without transforms, as DSL types
+constexpr char Place[] = "Place", User[] = "User", Review[] = "Review", Wrote[] = "Wrote";
+constexpr char basicInfo[] = "basicInfo", comment_list[] = "comment/list";
+constexpr char cid[] = "cid", placenamefull[] = "placenamefull", wpointx[] = "wpointx",
+               wpointy[] = "wpointy", phonenum[] = "phonenum", mainphotourl[] = "mainphotourl";
+constexpr char kakaoMapUserId[] = "kakaoMapUserId", username[] = "username",
+               profileStatus[] = "profileStatus", level_now[] = "level/nowLevel",
+               userCommentCount[] = "userCommentCount",
+               userCommentAverageScore[] = "userCommentAverageScore";
+constexpr char commentid[] = "commentid", contents[] = "contents", point[] = "point",
+               date[] = "date", likeCnt[] = "likeCnt", photoCnt[] = "photoCnt";
+
+namespace dsl = graph::dsl;
+
+constexpr auto kakao_dsl = dsl::mapping(
+    dsl::tag<Place, basicInfo>(dsl::key<cid>, dsl::prop<cid, int64_t>, dsl::prop<placenamefull>,
+                               dsl::prop<wpointx, int64_t>, dsl::prop<wpointy, int64_t>,
+                               dsl::prop<phonenum>, dsl::prop<mainphotourl>),
+    dsl::tag<User, comment_list>(dsl::key<kakaoMapUserId>, dsl::prop<username>,
+                                 dsl::prop<profileStatus>, dsl::prop<level_now, int64_t>,
+                                 dsl::prop<userCommentCount, int64_t>,
+                                 dsl::prop<userCommentAverageScore, double>),
+    dsl::tag<Review, comment_list>(dsl::key<commentid>, dsl::prop<contents>,
+                                   dsl::prop<point, int64_t>, dsl::prop<date>),
+    dsl::edge<Wrote, comment_list>(dsl::from_key<kakaoMapUserId>, dsl::to_key<commentid>,
+                                   dsl::prop<likeCnt, int64_t>, dsl::prop<photoCnt, int64_t>));
+
+// Same mapping interpreted (0) and as DSL types (1)
+void BM_MappingDsl(benchmark::State& state) {
+    const auto& document = bench::kakao_document();
+    const auto mapping = kakao_dsl.describe();
+    const size_t input_bytes = bench::read_test_file("input.json").size();
+    graph::StatementGenerator generator;
+
+    auto check = kakao_dsl.generate(document);
+    if (std::holds_alternative<graph::StatementError>(check)) {
+        state.SkipWithError(std::get<graph::StatementError>(check).message.c_str());
+        return;
+    }
+
+    bench::AllocationCounter allocs(state);
+    for (auto _ : state) {
+        if (state.range(0) == 0) {
+            auto statements = generator.generate_batch_statements(mapping, document);
+            benchmark::DoNotOptimize(statements);
+        } else {
+            auto statements = kakao_dsl.generate(document);
+            benchmark::DoNotOptimize(statements);
+        }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input_bytes));
+}
+BENCHMARK(BM_MappingDsl)->DenseRange(0, 1);
+
+} // namespace
+
+BENCHMARK_MAIN();
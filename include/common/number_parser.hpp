@@ -0,0 +1,202 @@
+// common/number_parser.hpp
+#ifndef NEBULA_MAPPER_NUMBER_PARSER_HPP
+#define NEBULA_MAPPER_NUMBER_PARSER_HPP
+
+#include "common/result.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace common::numbers {
+
+// How strings become numbers. STRICT takes exactly what JSON would write:
+// an optional '-' and digits with no leading zero, and for reals a fraction
+// and exponent that each carry digits. LENIENT also takes surrounding
+// whitespace, a leading '+', leading zeros, ".5" and "5.", ',' or '_'
+// between digits ("1,234,567") and, for integers, a zero fraction ("12.00").
+enum class CoercionMode : uint8_t {
+    STRICT,
+    LENIENT
+};
+
+inline std::optional<CoercionMode> parse_coercion_mode(const std::string& name) {
+    if (name == "strict") return CoercionMode::STRICT;
+    if (name == "lenient") return CoercionMode::LENIENT;
+    return std::nullopt;
+}
+
+namespace detail {
+
+    // Eight ASCII bytes as a little-endian word
+    inline uint64_t load_eight(const char* p) {
+        uint64_t chunk;
+        std::memcpy(&chunk, p, sizeof(chunk));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        chunk = __builtin_bswap64(chunk);
+#endif
+        return chunk;
+    }
+
+    // True if all eight bytes of `chunk` are '0'..'9'
+    inline bool is_eight_digits(uint64_t chunk) {
+        return ((chunk & 0xF0F0F0F0F0F0F0F0ull) |
+                (((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) ==
+               0x3333333333333333ull;
+    }
+
+    // Value of eight digit bytes, combined pairwise in three multiplies
+    inline uint32_t parse_eight_digits(uint64_t chunk) {
+        const uint64_t mask = 0x000000FF000000FFull;
+        const uint64_t mul1 = 0x000F424000000064ull;   // 100 + (1000000 << 32)
+        const uint64_t mul2 = 0x0000271000000001ull;   // 1 + (10000 << 32)
+        chunk -= 0x3030303030303030ull;
+        chunk = chunk * 10 + (chunk >> 8);
+        chunk = ((chunk & mask) * mul1 + ((chunk >> 16) & mask) * mul2) >> 32;
+        return static_cast<uint32_t>(chunk);
+    }
+
+    // First byte in [p, end) that is not a digit
+    inline const char* skip_digits(const char* p, const char* end) {
+        while (end - p >= 8 && is_eight_digits(load_eight(p))) p += 8;
+        while (p != end && *p >= '0' && *p <= '9') ++p;
+        return p;
+    }
+
+    // Value of at most 19 digits, which cannot overflow 64 bits
+    inline uint64_t digits_value(const char* p, const char* end) {
+        uint64_t value = 0;
+        while (end - p >= 8) {
+            value = value * 100000000 + parse_eight_digits(load_eight(p));
+            p += 8;
+        }
+        while (p != end) value = value * 10 + static_cast<uint64_t>(*p++ - '0');
+        return value;
+    }
+
+    inline bool is_space(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    // LENIENT input reduced to STRICT syntax, in `scratch` if anything but
+    // whitespace goes; nullopt if separators are misplaced
+    inline std::optional<std::string_view> relax(std::string_view text, std::string& scratch) {
+        while (!text.empty() && is_space(text.front())) text.remove_prefix(1);
+        while (!text.empty() && is_space(text.back())) text.remove_suffix(1);
+        if (!text.empty() && text.front() == '+') text.remove_prefix(1);
+        if (text.find_first_of(",_") == std::string_view::npos) return text;
+
+        // Separators only between two digits
+        scratch.clear();
+        for (size_t i = 0; i < text.size(); ++i) {
+            char c = text[i];
+            if (c != ',' && c != '_') {
+                scratch += c;
+                continue;
+            }
+            auto digit = [](char d) { return d >= '0' && d <= '9'; };
+            if (i == 0 || i + 1 == text.size() || !digit(text[i - 1]) || !digit(text[i + 1])) {
+                return std::nullopt;
+            }
+        }
+        return std::string_view(scratch);
+    }
+
+    // True if [p, end) is a JSON number: '0' or digits without a leading
+    // zero, then an optional fraction and exponent, each with digits
+    inline bool is_json_number(const char* p, const char* end) {
+        auto digit = [](char c) { return c >= '0' && c <= '9'; };
+        if (p == end || !digit(*p)) return false;
+        p = *p == '0' ? p + 1 : skip_digits(p, end);
+        if (p != end && *p == '.') {
+            if (++p == end || !digit(*p)) return false;
+            p = skip_digits(p, end);
+        }
+        if (p != end && (*p == 'e' || *p == 'E')) {
+            if (++p != end && (*p == '+' || *p == '-')) ++p;
+            if (p == end || !digit(*p)) return false;
+            p = skip_digits(p, end);
+        }
+        return p == end;
+    }
+
+    inline Error not_a(std::string_view text, const char* what) {
+        return Error{"'" + std::string(text) + "' is not " + what};
+    }
+
+    inline Error out_of_range(std::string_view text, const char* type) {
+        return Error{"'" + std::string(text) + "' is out of range for " + type};
+    }
+
+} // namespace detail
+
+// Exact 64-bit integer: every value in [-2^63, 2^63) round-trips, and
+// anything outside is a range error rather than a rounded double
+inline Result<int64_t> parse_int64(std::string_view text,
+                                   CoercionMode mode = CoercionMode::STRICT) {
+    std::string scratch;
+    std::string_view input = text;
+    if (mode == CoercionMode::LENIENT) {
+        auto relaxed = detail::relax(text, scratch);
+        if (!relaxed) return detail::not_a(text, "an integer");
+        input = *relaxed;
+    }
+
+    const char* p = input.data();
+    const char* end = p + input.size();
+    bool negative = p != end && *p == '-';
+    if (negative) ++p;
+
+    const char* digits_end = detail::skip_digits(p, end);
+    if (digits_end == p) return detail::not_a(text, "an integer");
+    if (digits_end != end) {
+        // "12.000" is 12 when lenient
+        bool zero_fraction = mode == CoercionMode::LENIENT && *digits_end == '.' &&
+            std::all_of(digits_end + 1, end, [](char c) { return c == '0'; });
+        if (!zero_fraction) return detail::not_a(text, "an integer");
+    }
+    if (mode == CoercionMode::STRICT && *p == '0' && digits_end - p > 1) {
+        return detail::not_a(text, "an integer");   // JSON has no leading zeros
+    }
+
+    while (p + 1 < digits_end && *p == '0') ++p;
+    if (digits_end - p > 19) return detail::out_of_range(text, "INT64");
+    uint64_t magnitude = detail::digits_value(p, digits_end);
+    uint64_t limit = static_cast<uint64_t>(INT64_MAX) + (negative ? 1 : 0);
+    if (magnitude > limit) return detail::out_of_range(text, "INT64");
+    return negative ? static_cast<int64_t>(0 - magnitude) : static_cast<int64_t>(magnitude);
+}
+
+// Finite double, correctly rounded by std::from_chars
+inline Result<double> parse_double(std::string_view text,
+                                   CoercionMode mode = CoercionMode::STRICT) {
+    std::string scratch;
+    std::string_view input = text;
+    if (mode == CoercionMode::LENIENT) {
+        auto relaxed = detail::relax(text, scratch);
+        if (!relaxed) return detail::not_a(text, "a number");
+        input = *relaxed;
+    }
+
+    // from_chars also reads "inf", "nan", ".5" and "5.", which JSON cannot hold
+    const char* p = input.data();
+    const char* end = p + input.size();
+    const char* first = p != end && *p == '-' ? p + 1 : p;
+    bool well_formed = mode == CoercionMode::STRICT
+        ? detail::is_json_number(first, end)
+        : first != end && ((*first >= '0' && *first <= '9') || *first == '.');
+    if (!well_formed) return detail::not_a(text, "a number");
+
+    double value = 0;
+    auto [parsed_end, ec] = std::from_chars(p, end, value);
+    if (ec == std::errc::result_out_of_range) return detail::out_of_range(text, "DOUBLE");
+    if (ec != std::errc() || parsed_end != end) return detail::not_a(text, "a number");
+    return value;
+}
+
+} // namespace common::numbers
+
+#endif // NEBULA_MAPPER_NUMBER_PARSER_HPP
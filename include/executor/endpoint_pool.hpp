@@ -0,0 +1,136 @@
+#ifndef NEBULA_MAPPER_ENDPOINT_POOL_HPP
+#define NEBULA_MAPPER_ENDPOINT_POOL_HPP
+
+#include "common/result.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace executor {
+
+// Error type for executor operations
+struct Error : common::Error {
+    Error(const std::string& msg,
+          const std::optional<std::string>& ctx = std::nullopt)
+        : common::Error(msg, ctx) {}
+};
+
+// Executor-specific result type
+template<typename T>
+using Result = common::Result<T, Error>;
+
+// A single gateway address
+struct Endpoint {
+    std::string host;
+    uint16_t port{0};
+
+    std::string to_string() const {
+        return host + ":" + std::to_string(port);
+    }
+};
+
+// Parse a comma separated "host:port" list; the port is required
+Result<std::vector<Endpoint>> parse_endpoints(const std::string& list);
+
+// Outcome of a single request against an endpoint
+enum class Outcome {
+    SUCCESS,
+    FAILURE,    // Endpoint answered, but rejected the statement
+    TIMEOUT     // Endpoint did not answer in time (or refused the connection)
+};
+
+// Health state of an endpoint
+enum class Health {
+    HEALTHY,
+    EJECTED,
+    PROBING
+};
+
+// Ejection and re-probe configuration
+struct HealthOptions {
+    // Consecutive timeouts before an endpoint is ejected
+    uint32_t max_consecutive_timeouts{1};
+    // Time an endpoint stays ejected before it is re-probed
+    std::chrono::milliseconds eject_duration{1000};
+    // Upper bound for the exponential ejection backoff
+    std::chrono::milliseconds max_eject_duration{30000};
+};
+
+// Point-in-time copy of the per-endpoint metrics
+struct EndpointSnapshot {
+    Endpoint endpoint;
+    Health health{Health::HEALTHY};
+    uint32_t outstanding{0};
+    uint64_t requests{0};
+    uint64_t failures{0};
+    uint64_t timeouts{0};
+    uint64_t ejections{0};
+    uint64_t statements{0};
+    uint64_t bytes{0};
+    double avg_latency_ms{0.0};
+    double max_latency_ms{0.0};
+    double statements_per_sec{0.0};
+};
+
+// Probe used to check whether an ejected endpoint is reachable again
+using ProbeFunction = std::function<bool(const Endpoint&)>;
+
+// Set of endpoints with least-outstanding-requests balancing
+class EndpointPool {
+public:
+    EndpointPool(std::vector<Endpoint> endpoints,
+                 HealthOptions options,
+                 ProbeFunction probe);
+
+    // Pick the healthy endpoint with the fewest outstanding requests.
+    // Returns nullopt when every endpoint is currently ejected.
+    std::optional<size_t> acquire();
+
+    // Report the result of a request started with acquire()
+    void release(size_t index,
+                 Outcome outcome,
+                 std::chrono::steady_clock::duration latency,
+                 size_t statements,
+                 size_t bytes);
+
+    size_t size() const { return slots_.size(); }
+    const Endpoint& endpoint(size_t index) const { return slots_[index]->endpoint; }
+
+    std::vector<EndpointSnapshot> snapshot() const;
+
+private:
+    struct Slot {
+        Endpoint endpoint;
+        std::atomic<uint32_t> outstanding{0};
+        std::atomic<Health> health{Health::HEALTHY};
+        std::atomic<uint32_t> consecutive_timeouts{0};
+        std::atomic<int64_t> retry_at_ns{0};
+        std::atomic<int64_t> eject_ns{0};
+
+        std::atomic<uint64_t> requests{0};
+        std::atomic<uint64_t> failures{0};
+        std::atomic<uint64_t> timeouts{0};
+        std::atomic<uint64_t> ejections{0};
+        std::atomic<uint64_t> statements{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> latency_ns_total{0};
+        std::atomic<uint64_t> latency_ns_max{0};
+    };
+
+    void eject(Slot& slot, int64_t now_ns);
+    bool try_probe(Slot& slot, int64_t now_ns);
+
+    std::vector<std::unique_ptr<Slot>> slots_;
+    HealthOptions options_;
+    ProbeFunction probe_;
+    std::chrono::steady_clock::time_point created_;
+};
+
+} // namespace executor
+
+#endif // NEBULA_MAPPER_ENDPOINT_POOL_HPP
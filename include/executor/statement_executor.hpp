@@ -0,0 +1,64 @@
+#ifndef NEBULA_MAPPER_STATEMENT_EXECUTOR_HPP
+#define NEBULA_MAPPER_STATEMENT_EXECUTOR_HPP
+
+#include "executor/endpoint_pool.hpp"
+#include "executor/transport.hpp"
+#include <string>
+#include <vector>
+
+namespace executor {
+
+// Executor configuration
+struct ExecutorOptions {
+    size_t concurrency{4};
+    std::chrono::milliseconds request_timeout{5000};
+    // Additional attempts on another endpoint for a statement that could
+    // not be sent. A statement the endpoint rejected is never retried.
+    size_t max_retries{2};
+    // Also retry statements that timed out after being sent. They may then
+    // run twice, so only for statements that are safe to repeat.
+    bool retry_timeouts{false};
+    // Space every request runs in, sent as "USE <space>; " in front of it
+    // since each request is its own session. Empty sends statements as is.
+    std::string space;
+    // How long to wait for an endpoint to come back when all are ejected
+    std::chrono::milliseconds unavailable_timeout{10000};
+    HealthOptions health;
+};
+
+// Outcome of an execute() call
+struct ExecutionSummary {
+    size_t executed{0};
+    size_t failed{0};
+    std::vector<std::string> errors;
+    std::vector<EndpointSnapshot> endpoints;
+};
+
+// Spreads statements across several statement gateway endpoints
+class StatementExecutor {
+public:
+    StatementExecutor(std::vector<Endpoint> endpoints,
+                      ExecutorOptions options = {},
+                      Transport transport = tcp_line_transport,
+                      ProbeFunction probe = {});
+
+    // Execute statements with up to `concurrency` requests in flight.
+    // Statements are independent; use ordered=true for DDL that must run in sequence.
+    ExecutionSummary execute(const std::vector<std::string>& statements,
+                             bool ordered = false);
+
+    const EndpointPool& pool() const { return pool_; }
+
+private:
+    // Send one statement, retrying unsent ones on other endpoints; returns
+    // error text on failure
+    std::optional<std::string> execute_one(const std::string& statement);
+
+    ExecutorOptions options_;
+    Transport transport_;
+    EndpointPool pool_;
+};
+
+} // namespace executor
+
+#endif // NEBULA_MAPPER_STATEMENT_EXECUTOR_HPP
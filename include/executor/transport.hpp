@@ -0,0 +1,41 @@
+#ifndef NEBULA_MAPPER_TRANSPORT_HPP
+#define NEBULA_MAPPER_TRANSPORT_HPP
+
+#include "executor/endpoint_pool.hpp"
+#include <chrono>
+#include <functional>
+#include <string>
+
+namespace executor {
+
+// Result of sending one statement to one endpoint
+struct SendResult {
+    Outcome outcome{Outcome::SUCCESS};
+    std::string message;
+    // False when no byte of the statement left, so another endpoint can
+    // take it without the statement running twice
+    bool sent{true};
+};
+
+// Sends a statement to an endpoint and waits for its answer.
+// The executor only balances and retries.
+using Transport = std::function<SendResult(
+    const Endpoint& endpoint,
+    const std::string& statement,
+    std::chrono::milliseconds timeout)>;
+
+// Line-oriented TCP transport for statement gateways: writes the statement
+// followed by '\n' and expects a single "OK" or "ERR <message>" line back.
+// graphd itself speaks fbthrift with authentication and sessions, so this
+// needs a gateway in front of it.
+SendResult tcp_line_transport(const Endpoint& endpoint,
+                              const std::string& statement,
+                              std::chrono::milliseconds timeout);
+
+// Probe that succeeds when a TCP connection can be established
+bool tcp_connect_probe(const Endpoint& endpoint,
+                       std::chrono::milliseconds timeout);
+
+} // namespace executor
+
+#endif // NEBULA_MAPPER_TRANSPORT_HPP
@@ -0,0 +1,118 @@
+#ifndef NEBULA_MAPPER_AGGREGATES_HPP
+#define NEBULA_MAPPER_AGGREGATES_HPP
+
+#include "common/result.hpp"
+#include "graph/memory_budget.hpp"
+#include "parser/json_parser.hpp"
+#include "parser/mapping_parser.hpp"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace graph {
+
+struct StatementError;
+
+// Distinct count of 64-bit hashes: exact while at most SPARSE_LIMIT were
+// seen, then a HyperLogLog of 2^PRECISION one-byte registers (about 1.6%
+// standard error), so a vertex with few values costs a few words
+class HyperLogLog {
+public:
+    static constexpr size_t SPARSE_LIMIT = 512;
+    static constexpr unsigned PRECISION = 12;
+
+    void add(uint64_t hash);
+    void merge(const HyperLogLog& other);
+    uint64_t estimate() const;
+
+    // Bytes held beyond the object itself
+    size_t heap_bytes() const;
+
+private:
+    void densify();
+    void add_dense(uint64_t hash);
+
+    std::vector<uint64_t> sparse_;      // Sorted and unique
+    std::vector<uint8_t> registers_;    // Empty while sparse
+};
+
+// Hash of a JSON value for distinct counting. Integral numbers hash alike
+// whatever their JSON type, and a string never hashes as the number it spells.
+uint64_t hash_value(const parser::json::JsonDocument& value);
+
+// Running state of one aggregate
+class Accumulator {
+public:
+    explicit Accumulator(parser::mapping::AggregateOp op) : op_(op) {}
+
+    // Fold in the value at `json_path` of one item, nullptr if missing.
+    // Nulls and missing values are skipped; SUM and AVG take numbers and
+    // numeric strings only.
+    common::Result<bool, StatementError> add(const parser::json::JsonDocument* value,
+                                             const std::string& json_path);
+
+    void merge(const Accumulator& other);
+
+    // nGQL literal of the result as the aggregate's type; NULL for the
+    // SUM, AVG, MIN or MAX of no values. A SUM or AVG that overflowed
+    // double is an error, as nGQL has no literal for it.
+    common::Result<std::string, StatementError> literal(
+        const parser::mapping::Aggregate& aggregate) const;
+
+    // Estimate of the memory the accumulator holds, itself included
+    size_t footprint() const;
+
+private:
+    parser::mapping::AggregateOp op_;
+    uint64_t count_{0};
+    int64_t int_sum_{0};        // Integers, exact until they overflow
+    double real_sum_{0};        // Everything else, and overflowed integers
+    bool integral_{true};
+    parser::json::JsonDocument extreme_;   // MIN or MAX so far, by JSON order
+    HyperLogLog distinct_;
+};
+
+// Update aggregates folded per tag and VID over a whole run. With a
+// budget, the state of every VID is charged to it until the UPDATE
+// statements are made.
+class AggregateTable {
+public:
+    AggregateTable() = default;
+    ~AggregateTable() { clear(); }
+
+    AggregateTable(const AggregateTable&) = delete;
+    AggregateTable& operator=(const AggregateTable&) = delete;
+
+    // Charge the table, and what it already holds, to `budget`
+    void set_budget(MemoryBudget* budget);
+
+    uint64_t bytes() const { return bytes_; }
+
+    // Fold the update aggregates among `accumulators`, one per aggregate of
+    // `vertex`, into the state of `vid`, a VID literal from get_vertex_id
+    void merge(const parser::mapping::VertexMapping& vertex, const std::string& vid,
+               const std::vector<const Accumulator*>& accumulators);
+
+    void merge(AggregateTable&& other);
+
+    bool empty() const { return states_.empty(); }
+
+    // One UPDATE VERTEX ON <tag> <vid> SET ... per vertex, in VID order,
+    // as Nebula has no multi-vertex UPDATE. Clears the table.
+    common::Result<std::vector<std::string>, StatementError> update_statements(
+        const parser::mapping::GraphMapping& mapping);
+
+private:
+    void charge(size_t before, size_t after);
+    void clear();
+
+    std::map<std::string, std::unordered_map<std::string, std::vector<Accumulator>>> states_;
+    MemoryBudget* budget_{nullptr};
+    uint64_t bytes_{0};
+};
+
+} // namespace graph
+
+#endif // NEBULA_MAPPER_AGGREGATES_HPP
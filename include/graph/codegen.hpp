@@ -0,0 +1,28 @@
+#ifndef NEBULA_MAPPER_CODEGEN_HPP
+#define NEBULA_MAPPER_CODEGEN_HPP
+
+#include "graph/statement_generator.hpp"
+#include "parser/mapping_parser.hpp"
+#include <string>
+
+namespace graph {
+
+// Version of the C interface between the CLI and a generated extractor
+constexpr unsigned EXTRACTOR_ABI_VERSION = 2;
+
+// FNV-1a of the mapping YAML text as 16 hex digits. An extractor is only
+// loaded for the exact text it was generated from.
+std::string mapping_hash(const std::string& yaml);
+
+// C++ source of an extractor specialized to `mapping`: paths unrolled into
+// fixed lookups, value types into fixed conversions and statement prefixes
+// into constants. It only needs nlohmann/json and is built as a shared
+// object for CompiledMapping. Mappings with transforms or aggregates are
+// refused.
+Result<std::string> generate_extractor_source(const parser::mapping::GraphMapping& mapping,
+                                              const std::string& yaml_hash,
+                                              const std::string& origin = "");
+
+} // namespace graph
+
+#endif // NEBULA_MAPPER_CODEGEN_HPP
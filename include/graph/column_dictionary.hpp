@@ -0,0 +1,68 @@
+#ifndef NEBULA_MAPPER_COLUMN_DICTIONARY_HPP
+#define NEBULA_MAPPER_COLUMN_DICTIONARY_HPP
+
+#include "parser/json_parser.hpp"
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace graph {
+
+// Adaptive dictionary for one string property. The column's path is split
+// once and values are read in place from the document. While the column
+// looks low-cardinality, each distinct value is interned under an ID
+// together with its rendered literal, so a repeat costs one hash lookup
+// instead of a copy, an escape pass and formatting. Columns that turn out
+// to be high-cardinality drop their dictionary and render directly.
+class ColumnDictionary {
+public:
+    struct Limits {
+        size_t max_entries{1024};      // Distinct values kept at most
+        size_t max_value_bytes{128};   // Longer values are never interned
+        size_t sample{256};            // Lookups before judging cardinality
+        double max_distinct_ratio{0.5};// Distinct/lookups that still pays off
+    };
+
+    explicit ColumnDictionary(std::string json_path);
+    ColumnDictionary(std::string json_path, Limits limits);
+
+    const std::string& json_path() const { return json_path_; }
+
+    // Rendered literal of the string at the column's path in `item`, valid
+    // until the next call. nullptr if the value is missing or not a
+    // string; the caller then takes the general path.
+    const std::string* render(const parser::json::JsonDocument& item);
+
+    // ID of an interned value, or nullopt
+    std::optional<uint32_t> find(std::string_view value) const;
+    const std::string& value(uint32_t id) const { return values_[id]; }
+    const std::string& literal(uint32_t id) const { return literals_[id]; }
+
+    bool interning() const { return interning_; }
+    size_t distinct() const { return values_.size(); }
+    uint64_t lookups() const { return lookups_; }
+    uint64_t hits() const { return hits_; }
+
+private:
+    static void render_literal(std::string& out, const std::string& value);
+    void stop_interning();
+
+    std::string json_path_;
+    std::vector<std::string> segments_;
+    Limits limits_;
+
+    bool interning_{true};
+    std::deque<std::string> values_;    // Stable storage behind ids_ keys
+    std::vector<std::string> literals_;
+    std::unordered_map<std::string_view, uint32_t> ids_;
+    std::string scratch_;               // Literal of a value not interned
+    uint64_t lookups_{0};
+    uint64_t hits_{0};
+};
+
+} // namespace graph
+
+#endif // NEBULA_MAPPER_COLUMN_DICTIONARY_HPP
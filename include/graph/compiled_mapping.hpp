@@ -0,0 +1,68 @@
+#ifndef NEBULA_MAPPER_COMPILED_MAPPING_HPP
+#define NEBULA_MAPPER_COMPILED_MAPPING_HPP
+
+#include "graph/statement_generator.hpp"
+#include "parser/json_parser.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace graph {
+
+// One statement an extractor rendered: the mapping that wrote it, counting
+// vertices first and then edges, and the size of each of its rows as
+// StatementGenerator counts them. Generated extractors mirror this layout.
+struct CompiledBatch {
+    uint32_t mapping{0};
+    std::vector<uint32_t> row_bytes;
+};
+
+// A shared object built from generate_extractor_source. It shares
+// nlohmann::json and std::string with the caller, so it must be built with
+// the same standard library and nlohmann/json release; load() checks the
+// release and that the mapping YAML is the one it was generated from.
+class CompiledMapping {
+public:
+    static Result<std::unique_ptr<CompiledMapping>> load(const std::string& library,
+                                                         const std::string& yaml);
+    ~CompiledMapping();
+
+    CompiledMapping(const CompiledMapping&) = delete;
+    CompiledMapping& operator=(const CompiledMapping&) = delete;
+
+    // Statements for `document`, the same ones StatementGenerator renders,
+    // or nullopt if it needs the interpreter. Errors and values the
+    // extractor cannot convert itself are always handed back, so messages
+    // come from the interpreter. Adds the rendered rows to `rows`, and with
+    // `batches` one CompiledBatch per statement.
+    std::optional<std::vector<std::string>> generate(
+        const parser::json::JsonDocument& document, size_t batch_size, uint64_t& rows,
+        std::vector<CompiledBatch>* batches = nullptr) const;
+
+    const std::string& hash() const { return hash_; }
+    uint64_t compiled_records() const { return compiled_.load(std::memory_order_relaxed); }
+    uint64_t interpreted_records() const { return interpreted_.load(std::memory_order_relaxed); }
+
+private:
+    using ExtractFn = int (*)(const void* document, size_t batch_size, void* statements,
+                              uint64_t* rows, void* batches);
+
+    CompiledMapping(void* handle, ExtractFn extract, std::string hash);
+
+    void* handle_;
+    ExtractFn extract_;
+    std::string hash_;
+    mutable std::atomic<uint64_t> compiled_{0};
+    mutable std::atomic<uint64_t> interpreted_{0};
+};
+
+// The nlohmann/json release this binary was built with, as an extractor
+// reports it
+uint64_t json_abi_stamp();
+
+} // namespace graph
+
+#endif // NEBULA_MAPPER_COMPILED_MAPPING_HPP
@@ -0,0 +1,24 @@
+#ifndef NEBULA_MAPPER_EXPLAIN_HPP
+#define NEBULA_MAPPER_EXPLAIN_HPP
+
+#include "parser/mapping_parser.hpp"
+#include "telemetry/profile.hpp"
+#include <cstdint>
+#include <string>
+
+namespace graph {
+
+// The plan the statement generator follows for a mapping: mappings grouped
+// by source path, the trie of paths read under each source, resolved
+// transforms, and the batching and dedup policy of every mapping
+std::string format_plan(const parser::mapping::GraphMapping& mapping, size_t batch_size);
+
+// Cost of every plan step from a profiled run over `records` records,
+// per mapping and then per step, most expensive first
+std::string format_analysis(const parser::mapping::GraphMapping& mapping,
+                            const telemetry::ProfileSnapshot& profile,
+                            uint64_t records, double wall_seconds);
+
+} // namespace graph
+
+#endif // NEBULA_MAPPER_EXPLAIN_HPP
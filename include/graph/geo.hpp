@@ -0,0 +1,24 @@
+#ifndef NEBULA_MAPPER_GEO_HPP
+#define NEBULA_MAPPER_GEO_HPP
+
+#include "parser/mapping_parser.hpp"
+#include <cstddef>
+#include <string>
+
+namespace graph {
+
+// Convert `count` points from `from` to WGS84 in place: x becomes the
+// longitude and y the latitude, in degrees. The arrays are walked once,
+// with the projection constants set up beforehand, so callers gather a
+// whole mapping's coordinates and convert them together. CONGNAMUL is
+// EPSG:5181, a transverse Mercator on GRS80, whose datum matches WGS84
+// to the centimetre, so only the projection is inverted.
+void to_wgs84(parser::mapping::Projection from, double* x, double* y, size_t count);
+
+// Append the nGQL point ST_Point(lon, lat), rounded to 1e-9 degrees and
+// written in shortest form: ST_Point(127, 38), not 127.00000000000001
+void append_point(std::string& out, double lon, double lat);
+
+} // namespace graph
+
+#endif // NEBULA_MAPPER_GEO_HPP
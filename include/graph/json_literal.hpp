@@ -0,0 +1,22 @@
+#ifndef NEBULA_MAPPER_JSON_LITERAL_HPP
+#define NEBULA_MAPPER_JSON_LITERAL_HPP
+
+#include "parser/json_parser.hpp"
+#include "parser/mapping_parser.hpp"
+#include <string>
+
+namespace graph {
+
+// Append `value` serialized as JSON text inside a quoted nGQL string
+// literal. The text is what value.dump() (or dump(2) when not minified)
+// produces, and the literal what format_value() makes of it, but it is
+// written in one pass: JSON and nGQL escaping are fused and nothing is
+// built in between. Numbers go through nlohmann's own formatter into a
+// per-thread scratch buffer, so they match dump() exactly. Only top-level
+// object keys in format.keys are kept when it is not empty.
+void append_json_literal(std::string& out, const parser::json::JsonDocument& value,
+                         const parser::mapping::JsonFormat& format);
+
+} // namespace graph
+
+#endif // NEBULA_MAPPER_JSON_LITERAL_HPP
@@ -0,0 +1,580 @@
+#ifndef NEBULA_MAPPER_MAPPING_DSL_HPP
+#define NEBULA_MAPPER_MAPPING_DSL_HPP
+
+#include "common/number_parser.hpp"
+#include "graph/pipeline.hpp"
+#include "graph/statement_generator.hpp"
+#include "graph/statement_sink.hpp"
+#include "parser/json_parser.hpp"
+#include "parser/record_reader.hpp"
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Mappings written as C++ types, for services that embed the library.
+// Names, paths and property types are template arguments, so paths are
+// split and statement prefixes rendered at compile time, and records are
+// mapped without a GraphMapping or YAML:
+//
+//     constexpr char Place[] = "Place", basicInfo[] = "basicInfo",
+//                    cid[] = "cid", wpointx[] = "wpointx";
+//     constexpr auto places = graph::dsl::mapping(
+//         graph::dsl::tag<Place, basicInfo>(graph::dsl::key<cid>,
+//                                           graph::dsl::prop<cid, int64_t>,
+//                                           graph::dsl::prop<wpointx, int64_t>));
+//     auto statements = places.generate(document);
+//
+// C++17 cannot take string literals as template arguments, so names and
+// paths are constexpr char arrays. Statements, errors and batching match
+// StatementGenerator for the same YAML mapping, with properties listed in
+// the same (alphabetical) order.
+namespace graph::dsl {
+
+namespace detail {
+
+    constexpr size_t length(const char* text) {
+        size_t size = 0;
+        while (text[size] != '\0') ++size;
+        return size;
+    }
+
+    constexpr bool is_alpha(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    }
+
+    constexpr bool is_alnum(char c) {
+        return is_alpha(c) || (c >= '0' && c <= '9');
+    }
+
+    // StatementGenerator::quote_identifier, at compile time
+    constexpr bool needs_quotes(const char* identifier) {
+        if (identifier[0] == '\0') return false;
+        if (!is_alpha(identifier[0]) && identifier[0] != '_') return true;
+        for (size_t i = 1; identifier[i] != '\0'; ++i) {
+            if (!is_alnum(identifier[i]) && identifier[i] != '_') return true;
+        }
+        return false;
+    }
+
+    constexpr size_t identifier_length(const char* identifier) {
+        return length(identifier) + (needs_quotes(identifier) ? 2 : 0);
+    }
+
+    template<size_t N>
+    struct Text {
+        char data[N + 1]{};
+
+        constexpr std::string_view view() const { return {data, N}; }
+    };
+
+    constexpr void put(char* out, size_t& at, const char* text) {
+        for (size_t i = 0; text[i] != '\0'; ++i) out[at++] = text[i];
+    }
+
+    constexpr void put_identifier(char* out, size_t& at, const char* identifier) {
+        bool quoted = needs_quotes(identifier);
+        if (quoted) out[at++] = '`';
+        put(out, at, identifier);
+        if (quoted) out[at++] = '`';
+    }
+
+    inline constexpr char INSERT_VERTEX[] = "INSERT VERTEX ";
+    inline constexpr char INSERT_EDGE[] = "INSERT EDGE ";
+
+    // "INSERT VERTEX Name (a, b) VALUES "
+    template<const char* Verb, const char* Name, const char*... Props>
+    constexpr size_t prefix_length() {
+        size_t size = length(Verb) + identifier_length(Name) + length(" (") +
+                      length(") VALUES ");
+        ((size += identifier_length(Props)), ...);
+        if constexpr (sizeof...(Props) > 1) size += 2 * (sizeof...(Props) - 1);
+        return size;
+    }
+
+    template<const char* Verb, const char* Name, const char*... Props>
+    constexpr auto build_prefix() {
+        Text<prefix_length<Verb, Name, Props...>()> text;
+        size_t at = 0;
+        put(text.data, at, Verb);
+        put_identifier(text.data, at, Name);
+        put(text.data, at, " (");
+        size_t index = 0;
+        ((put(text.data, at, index++ ? ", " : ""), put_identifier(text.data, at, Props)), ...);
+        put(text.data, at, ") VALUES ");
+        return text;
+    }
+
+    template<const char* Verb, const char* Name, const char*... Props>
+    inline constexpr auto prefix = build_prefix<Verb, Name, Props...>();
+
+    // One segment of a path split like parser::json::detail::split_path
+    struct Segment {
+        std::string_view text;
+        bool is_index{false};
+        bool valid_index{false};
+        size_t index{0};
+    };
+
+    constexpr size_t segment_count(const char* path) {
+        size_t count = 0;
+        bool in_segment = false;
+        for (size_t i = 0; path[i] != '\0'; ++i) {
+            if (path[i] == '/') {
+                in_segment = false;
+            } else if (!in_segment) {
+                in_segment = true;
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    constexpr Segment make_segment(std::string_view text) {
+        Segment segment{text};
+        if (text.size() >= 2 && text.front() == '[' && text.back() == ']') {
+            segment.is_index = true;
+            segment.valid_index = text.size() > 2;
+            for (size_t i = 1; i + 1 < text.size(); ++i) {
+                char c = text[i];
+                if (c < '0' || c > '9') {
+                    segment.valid_index = false;
+                    break;
+                }
+                segment.index = segment.index * 10 + static_cast<size_t>(c - '0');
+            }
+        }
+        return segment;
+    }
+
+    template<const char* Path>
+    constexpr auto split() {
+        std::array<Segment, segment_count(Path)> segments{};
+        size_t count = 0;
+        size_t start = 0;
+        size_t size = length(Path);
+        for (size_t i = 0; i <= size; ++i) {
+            if (i == size || Path[i] == '/') {
+                if (i > start) {
+                    segments[count++] = make_segment(std::string_view(Path + start, i - start));
+                }
+                start = i + 1;
+            }
+        }
+        return segments;
+    }
+
+    template<const char* Path>
+    inline constexpr auto segments = split<Path>();
+
+    // Node at Path under `node`, or nullptr with the reason in `error`,
+    // worded like parser::json::detail::navigate_path
+    template<const char* Path>
+    const parser::json::JsonDocument* find(const parser::json::JsonDocument& node,
+                                           std::string& error) {
+        const parser::json::JsonDocument* current = &node;
+        for (const auto& segment : segments<Path>) {
+            if (segment.is_index) {
+                if (!segment.valid_index) {
+                    error = "Invalid array index: " + std::string(segment.text);
+                    return nullptr;
+                }
+                if (!current->is_array()) {
+                    error = "Expected array at path segment: " + std::string(segment.text);
+                    return nullptr;
+                }
+                if (segment.index >= current->size()) {
+                    error = "Array index out of bounds: " + std::string(segment.text);
+                    return nullptr;
+                }
+                current = &(*current)[segment.index];
+                continue;
+            }
+            if (!current->is_object()) {
+                error = "Expected object at path segment: " + std::string(segment.text);
+                return nullptr;
+            }
+            auto it = current->find(segment.text);
+            if (it == current->end()) {
+                error = "Property not found: " + std::string(segment.text);
+                return nullptr;
+            }
+            current = &(*it);
+        }
+        return current;
+    }
+
+    template<typename T>
+    constexpr const char* nebula_type() {
+        if constexpr (std::is_same_v<T, bool>) {
+            return "BOOL";
+        } else if constexpr (std::is_integral_v<T>) {
+            static_assert(std::is_signed_v<T>, "integer properties are signed");
+            return sizeof(T) == 1 ? "INT8" : sizeof(T) == 2 ? "INT16"
+                 : sizeof(T) == 4 ? "INT32" : "INT64";
+        } else if constexpr (std::is_same_v<T, float>) {
+            return "FLOAT";
+        } else if constexpr (std::is_floating_point_v<T>) {
+            return "DOUBLE";
+        } else {
+            static_assert(std::is_same_v<T, std::string>,
+                          "properties are integers, float, double, bool or std::string");
+            return "STRING";
+        }
+    }
+
+    // A coerced numeric string, or the parse error thrown
+    template<typename T>
+    T number(const common::Result<T>& parsed) {
+        if (const auto* error = std::get_if<common::Error>(&parsed)) {
+            throw std::runtime_error(error->message);
+        }
+        return std::get<T>(parsed);
+    }
+
+    // Append the literal for `value` converted to T, as extract_value and
+    // format_value would render it
+    template<typename T>
+    void append_value(std::string& out, const parser::json::JsonDocument& value) {
+        if (value.is_null()) {
+            out += "NULL";
+        } else if constexpr (std::is_same_v<T, bool>) {
+            out += value.get<bool>() ? "true" : "false";
+        } else if constexpr (std::is_integral_v<T>) {
+            int64_t number_value = value.is_string()
+                ? number(common::numbers::parse_int64(value.get_ref<const std::string&>()))
+                : value.get<int64_t>();
+            if constexpr (sizeof(T) < sizeof(int64_t)) {
+                if (number_value < std::numeric_limits<T>::min() ||
+                    number_value > std::numeric_limits<T>::max()) {
+                    throw std::runtime_error(std::to_string(number_value) +
+                                             " is out of range for " + nebula_type<T>());
+                }
+            }
+            out += std::to_string(number_value);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            double number_value = value.is_string()
+                ? number(common::numbers::parse_double(value.get_ref<const std::string&>()))
+                : value.get<double>();
+            if (std::is_same_v<T, float> && std::isfinite(number_value) &&
+                std::fabs(number_value) > std::numeric_limits<float>::max()) {
+                throw std::runtime_error(value.dump() + " is out of range for FLOAT");
+            }
+            append_real(out, number_value, std::is_same_v<T, float>);
+        } else {
+            if (!value.is_string()) {
+                (void)value.get<std::string>();  // Throws the error extract_value reports
+            }
+            out += '"';
+            out += StatementGenerator::escape_string(value.get_ref<const std::string&>());
+            out += '"';
+        }
+    }
+
+    // Quoted vertex ID as StatementGenerator::get_vertex_id renders it
+    template<const char* Path>
+    bool append_id(std::string& out, const parser::json::JsonDocument& item,
+                   StatementError& error) {
+        std::string reason;
+        const parser::json::JsonDocument* id = find<Path>(item, reason);
+        if (!id) {
+            error = StatementError{"Failed to extract vertex ID: " + reason, std::nullopt, Path};
+            return false;
+        }
+        if (id->is_string()) {
+            out += '"';
+            out += StatementGenerator::escape_string(id->get_ref<const std::string&>());
+            out += '"';
+        } else if (id->is_number()) {
+            out += '"';
+            out += std::to_string(id->get<int64_t>());
+            out += '"';
+        } else {
+            error = StatementError{id->is_null() ? "Vertex ID cannot be null"
+                                                 : "Invalid vertex ID type",
+                                   Path};
+            return false;
+        }
+        return true;
+    }
+
+    // Items under Path: the elements of an array, or the node itself
+    template<const char* Path, typename F>
+    bool for_each_item(const parser::json::JsonDocument& document, StatementError& error,
+                       F&& f) {
+        std::string reason;
+        const parser::json::JsonDocument* source = find<Path>(document, reason);
+        if (!source) {
+            error = StatementError{"Failed to extract data: " + reason, Path};
+            return false;
+        }
+        if (!source->is_array()) return f(*source);
+        for (const auto& item : *source) {
+            if (!f(item)) return false;
+        }
+        return true;
+    }
+
+    // Rows collected into INSERT statements of at most batch_size rows
+    class Batch {
+    public:
+        Batch(std::string_view prefix, size_t batch_size, std::vector<std::string>& out)
+            : prefix_(prefix), batch_size_(batch_size), out_(out) {}
+
+        // Start a row; its text is appended to the returned string
+        std::string& row() {
+            if (rows_ > 0) values_ += ", ";
+            return values_;
+        }
+
+        void close_row() {
+            if (++rows_ >= batch_size_) flush();
+        }
+
+        void flush() {
+            if (rows_ == 0) return;
+            std::string statement;
+            statement.reserve(prefix_.size() + values_.size() + 1);
+            statement.append(prefix_).append(values_) += ';';
+            out_.push_back(std::move(statement));
+            values_.clear();
+            rows_ = 0;
+        }
+
+    private:
+        std::string_view prefix_;
+        size_t batch_size_;
+        std::vector<std::string>& out_;
+        std::string values_;
+        size_t rows_{0};
+    };
+
+} // namespace detail
+
+template<const char* Path>
+struct Key {};
+
+template<const char* Path, typename T, const char* Name>
+struct Prop {
+    using type = T;
+    static constexpr const char* NAME = Name;
+
+    // Append ", " (unless first) and the value, or fail like extract_value
+    static bool append(std::string& out, const parser::json::JsonDocument& item, bool first,
+                       StatementError& error) {
+        std::string reason;
+        const parser::json::JsonDocument* value = detail::find<Path>(item, reason);
+        if (!value) {
+            error = StatementError{"Failed to extract value: " + reason, std::nullopt, Path};
+            return false;
+        }
+        if (!first) out += ", ";
+        try {
+            detail::append_value<T>(out, *value);
+        } catch (const std::exception& e) {
+            error = StatementError{"Value conversion error: " + std::string(e.what()), Path};
+            return false;
+        }
+        return true;
+    }
+
+    static parser::mapping::Property describe() {
+        parser::mapping::Property property;
+        property.name = Name;
+        property.json_path = Path;
+        property.nebula_type = detail::nebula_type<T>();
+        return property;
+    }
+};
+
+// Vertex key, and edge source/destination keys
+template<const char* Path>
+inline constexpr Key<Path> key{};
+
+template<const char* Path>
+inline constexpr Key<Path> from_key{};
+
+template<const char* Path>
+inline constexpr Key<Path> to_key{};
+
+// Property read from Path as T, named like its path unless Name is given.
+// int8_t, int16_t, int32_t and int64_t are INT8 to INT64 with the same range
+// checks as the YAML types, float is FLOAT and double DOUBLE, then bool and
+// std::string.
+template<const char* Path, typename T = std::string, const char* Name = Path>
+inline constexpr Prop<Path, T, Name> prop{};
+
+namespace detail {
+    template<typename... Props>
+    bool append_props(std::string& out, const parser::json::JsonDocument& item,
+                      StatementError& error) {
+        bool first = true;
+        return ((Props::append(out, item, std::exchange(first, false), error)) && ...);
+    }
+}
+
+template<const char* Name, const char* Source, const char* KeyPath, typename... Props>
+struct Tag {
+    static constexpr std::string_view prefix =
+        detail::prefix<detail::INSERT_VERTEX, Name, Props::NAME...>.view();
+
+    static bool generate(const parser::json::JsonDocument& document, size_t batch_size,
+                         std::vector<std::string>& out, uint64_t& rows,
+                         StatementError& error) {
+        detail::Batch batch(prefix, batch_size, out);
+        bool ok = detail::for_each_item<Source>(document, error, [&](const auto& item) {
+            auto& row = batch.row();
+            if (!detail::append_id<KeyPath>(row, item, error)) return false;
+            row += ":(";
+            if (!detail::append_props<Props...>(row, item, error)) return false;
+            row += ')';
+            ++rows;
+            batch.close_row();
+            return true;
+        });
+        if (!ok) return false;
+        batch.flush();
+        return true;
+    }
+
+    static void describe(parser::mapping::GraphMapping& mapping) {
+        parser::mapping::VertexMapping vertex;
+        vertex.tag_name = Name;
+        vertex.source_path = Source;
+        vertex.key_path = KeyPath;
+        (vertex.properties.push_back(Props::describe()), ...);
+        mapping.vertices.push_back(std::move(vertex));
+    }
+};
+
+template<const char* Name, const char* Source, const char* FromKey, const char* ToKey,
+         typename... Props>
+struct Edge {
+    static constexpr std::string_view prefix =
+        detail::prefix<detail::INSERT_EDGE, Name, Props::NAME...>.view();
+
+    static bool generate(const parser::json::JsonDocument& document, size_t batch_size,
+                         std::vector<std::string>& out, uint64_t& rows,
+                         StatementError& error) {
+        detail::Batch batch(prefix, batch_size, out);
+        bool ok = detail::for_each_item<Source>(document, error, [&](const auto& item) {
+            auto& row = batch.row();
+            if (!detail::append_id<FromKey>(row, item, error)) return false;
+            row += " -> ";
+            if (!detail::append_id<ToKey>(row, item, error)) return false;
+            row += ":(";
+            if (!detail::append_props<Props...>(row, item, error)) return false;
+            row += ')';
+            ++rows;
+            batch.close_row();
+            return true;
+        });
+        if (!ok) return false;
+        batch.flush();
+        return true;
+    }
+
+    static void describe(parser::mapping::GraphMapping& mapping) {
+        parser::mapping::EdgeMapping edge;
+        edge.edge_name = Name;
+        edge.source_path = Source;
+        edge.from.key_path = FromKey;
+        edge.to.key_path = ToKey;
+        (edge.properties.push_back(Props::describe()), ...);
+        mapping.edges.push_back(std::move(edge));
+    }
+};
+
+// Tag Name for every item under Source, keyed by Key
+template<const char* Name, const char* Source, const char* KeyPath,
+         const char*... Paths, typename... Types, const char*... Names>
+constexpr Tag<Name, Source, KeyPath, Prop<Paths, Types, Names>...> tag(
+    Key<KeyPath>, Prop<Paths, Types, Names>...) {
+    return {};
+}
+
+// Edge Name for every item under Source, from one key to the other
+template<const char* Name, const char* Source, const char* FromKey, const char* ToKey,
+         const char*... Paths, typename... Types, const char*... Names>
+constexpr Edge<Name, Source, FromKey, ToKey, Prop<Paths, Types, Names>...> edge(
+    Key<FromKey>, Key<ToKey>, Prop<Paths, Types, Names>...) {
+    return {};
+}
+
+// Tags and edges mapped in the order given; like GraphMapping, list the
+// tags before the edges to match the interpreter's statement order
+template<typename... Parts>
+class Mapping {
+public:
+    // Statements for one document, as StatementGenerator::generate_batch_statements
+    Result<std::vector<std::string>> generate(const parser::json::JsonDocument& document,
+                                              size_t batch_size = 500) const {
+        std::vector<std::string> statements;
+        uint64_t rows = 0;
+        StatementError error{""};
+        bool ok = (Parts::generate(document, batch_size, statements, rows, error) && ...);
+        if (!ok) return error;
+        return statements;
+    }
+
+    // Map every record of `reader` in order and hand the statements to `sink`
+    Result<PipelineSummary> run(parser::json::RecordReader& reader, StatementSink& sink,
+                                size_t batch_size = 500) const {
+        PipelineSummary summary;
+        for (;;) {
+            auto next = reader.next();
+            if (std::holds_alternative<parser::json::Error>(next)) {
+                return StatementError{"Input error: " +
+                                      std::get<parser::json::Error>(next).message};
+            }
+            auto& record = std::get<std::optional<parser::json::Record>>(next);
+            if (!record) break;
+
+            auto document = parser::json::parse(record->text);
+            if (std::holds_alternative<parser::json::Error>(document)) {
+                return StatementError{
+                    "JSON error: " + std::get<parser::json::Error>(document).message,
+                    record->source};
+            }
+            auto statements = generate(std::get<parser::json::JsonDocument>(document),
+                                       batch_size);
+            if (std::holds_alternative<StatementError>(statements)) {
+                auto& error = std::get<StatementError>(statements);
+                error.context = error.context ? record->source + ": " + *error.context
+                                              : record->source;
+                return error;
+            }
+            auto& produced = std::get<std::vector<std::string>>(statements);
+            ++summary.records;
+            summary.statements += produced.size();
+            for (const auto& statement : produced) {
+                summary.statement_bytes += statement.size();
+            }
+            sink.consume(std::move(produced));
+        }
+        summary.input_bytes = reader.bytes_read();
+        return summary;
+    }
+
+    // The same mapping as a GraphMapping, e.g. for SchemaManager
+    parser::mapping::GraphMapping describe() const {
+        parser::mapping::GraphMapping mapping;
+        (Parts::describe(mapping), ...);
+        return mapping;
+    }
+};
+
+template<typename... Parts>
+constexpr Mapping<Parts...> mapping(Parts...) {
+    return {};
+}
+
+} // namespace graph::dsl
+
+#endif // NEBULA_MAPPER_MAPPING_DSL_HPP
@@ -0,0 +1,81 @@
+#ifndef NEBULA_MAPPER_MAPPING_PREFLIGHT_HPP
+#define NEBULA_MAPPER_MAPPING_PREFLIGHT_HPP
+
+#include "graph/statement_generator.hpp"
+#include "parser/mapping_parser.hpp"
+#include "parser/record_reader.hpp"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace graph {
+
+// How one mapped path fared on the sampled records of a preflight
+struct PathReport {
+    std::string owner;          // Tag or edge
+    std::string name;           // Property, aggregate or key
+    std::string json_path;
+    std::string nebula_type;    // Empty for keys
+    bool key{false};            // A VID path: null and missing values fail a run
+    bool required{true};        // A missing value fails a run
+    uint64_t items{0};          // Items the path was read on
+    uint64_t resolved{0};       // Non-null values
+    uint64_t nulls{0};
+    uint64_t missing{0};
+    uint64_t conflicts{0};      // Values the declared type does not take
+    std::string first_missing;  // Record of the first missing value
+    std::string first_conflict; // "record: message" of the first conflict
+
+    double resolution_rate() const {
+        return items ? static_cast<double>(resolved) / static_cast<double>(items) : 0;
+    }
+};
+
+// How a tag or edge source path fared on the sampled records
+struct SourceReport {
+    std::string owner;
+    std::string source_path;
+    uint64_t records{0};
+    uint64_t missing{0};        // Records without the path, which fail a run
+    uint64_t items{0};
+    std::string first_missing;
+};
+
+struct ValidationReport {
+    uint64_t records_read{0};   // Records streamed past
+    uint64_t records{0};        // Records checked
+    std::vector<SourceReport> sources;
+    std::vector<PathReport> paths;
+    std::vector<std::string> errors;    // Findings that would stop a run
+    std::vector<std::string> warnings;  // Paths that never yield a value
+
+    bool ok() const { return errors.empty(); }
+};
+
+// Records a preflight checks: the first `head`, then a uniform reservoir of
+// `reservoir` among the rest. Only checked records are parsed.
+struct SampleOptions {
+    size_t head{100};
+    size_t reservoir{100};
+    uint64_t seed{0x5eed};
+    uint64_t max_records{0};    // Stop reading after this many, 0 reads all
+};
+
+// Preflight of `mapping` on one document: walks every source, key and
+// property path through the plans of a StatementGenerator, without
+// rendering statements
+Result<ValidationReport> validate_mapping(const parser::mapping::GraphMapping& mapping,
+                                          const parser::json::JsonDocument& document);
+
+// Preflight on a sample of the records of `reader`. Records that are not
+// valid JSON are findings; only errors reading the input are returned.
+Result<ValidationReport> validate_mapping(const parser::mapping::GraphMapping& mapping,
+                                          parser::json::RecordReader& reader,
+                                          const SampleOptions& options = {});
+
+// Per-path resolution rates, then errors and warnings, as text
+std::string format_validation(const ValidationReport& report);
+
+} // namespace graph
+
+#endif // NEBULA_MAPPER_MAPPING_PREFLIGHT_HPP
@@ -0,0 +1,114 @@
+#ifndef NEBULA_MAPPER_MEMORY_BUDGET_HPP
+#define NEBULA_MAPPER_MEMORY_BUDGET_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace graph {
+
+// Components that hold memory on behalf of a run
+enum class MemoryConsumer {
+    READ_AHEAD,   // Records queued for workers
+    DOCUMENTS,    // Records being parsed and mapped
+    REORDER,      // Statements waiting for earlier records
+    COLLECTED,    // Statements held by a sink
+    AGGREGATES,   // Per-vertex state of update aggregates
+    COUNT
+};
+
+constexpr size_t MEMORY_CONSUMER_COUNT = static_cast<size_t>(MemoryConsumer::COUNT);
+
+const char* memory_consumer_name(MemoryConsumer consumer);
+
+struct MemoryUsage {
+    uint64_t current{0};
+    uint64_t peak{0};
+};
+
+struct MemorySnapshot {
+    uint64_t limit{0};
+    uint64_t used{0};
+    uint64_t peak{0};
+    std::array<MemoryUsage, MEMORY_CONSUMER_COUNT> consumers{};
+    uint64_t throttles{0};        // Times the reader waited for room
+    uint64_t spills{0};
+    uint64_t spilled_bytes{0};
+};
+
+// Central account of the memory held by the pipeline and its sinks.
+// Consumers charge what they hold and release it when done; figures are
+// estimates from payload sizes, not allocator truth. Above the soft limit
+// consumers should shed memory (spill, flush); at the limit the reader
+// stops taking records until work in flight drains.
+class MemoryBudget {
+public:
+    explicit MemoryBudget(uint64_t limit);
+
+    MemoryBudget(const MemoryBudget&) = delete;
+    MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+    void charge(MemoryConsumer consumer, uint64_t bytes);
+    void release(MemoryConsumer consumer, uint64_t bytes);
+
+    uint64_t limit() const { return limit_; }
+    uint64_t used() const { return used_.load(std::memory_order_relaxed); }
+
+    // At or above three quarters of the limit
+    bool under_pressure() const { return used() >= soft_limit_; }
+
+    bool exhausted() const { return used() >= limit_; }
+
+    void count_throttle() { throttles_.fetch_add(1, std::memory_order_relaxed); }
+    void count_spill(uint64_t bytes);
+
+    MemorySnapshot snapshot() const;
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> current{0};
+        std::atomic<uint64_t> peak{0};
+    };
+
+    const uint64_t limit_;
+    const uint64_t soft_limit_;
+    std::atomic<uint64_t> used_{0};
+    std::atomic<uint64_t> peak_{0};
+    std::array<Slot, MEMORY_CONSUMER_COUNT> slots_{};
+    std::atomic<uint64_t> throttles_{0};
+    std::atomic<uint64_t> spills_{0};
+    std::atomic<uint64_t> spilled_bytes_{0};
+};
+
+// Holds a charge for its lifetime; a null budget makes it a no-op
+class MemoryCharge {
+public:
+    MemoryCharge() = default;
+    MemoryCharge(MemoryBudget* budget, MemoryConsumer consumer, uint64_t bytes)
+        : budget_(budget), consumer_(consumer), bytes_(budget ? bytes : 0) {
+        if (budget_) budget_->charge(consumer_, bytes_);
+    }
+
+    ~MemoryCharge() {
+        if (budget_) budget_->release(consumer_, bytes_);
+    }
+
+    MemoryCharge(const MemoryCharge&) = delete;
+    MemoryCharge& operator=(const MemoryCharge&) = delete;
+
+private:
+    MemoryBudget* budget_{nullptr};
+    MemoryConsumer consumer_{MemoryConsumer::DOCUMENTS};
+    uint64_t bytes_{0};
+};
+
+// "512M", "2G", "65536"; nullopt if malformed
+std::optional<uint64_t> parse_memory_size(const std::string& text);
+
+std::string format_memory(const MemorySnapshot& memory);
+
+} // namespace graph
+
+#endif // NEBULA_MAPPER_MEMORY_BUDGET_HPP
@@ -0,0 +1,165 @@
+#ifndef NEBULA_MAPPER_NEBULA_VALUE_HPP
+#define NEBULA_MAPPER_NEBULA_VALUE_HPP
+
+#include "common/number_parser.hpp"
+#include "common/result.hpp"
+#include "parser/json_parser.hpp"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace graph {
+
+struct StatementError;
+
+// Nebula scalar property types
+enum class NebulaType : uint8_t {
+    BOOL,
+    INT8,
+    INT16,
+    INT32,
+    INT64,
+    FLOAT,
+    DOUBLE,
+    STRING,
+    FIXED_STRING,
+    DATE,
+    TIME,
+    DATETIME,
+    TIMESTAMP
+};
+
+const char* nebula_type_name(NebulaType type);
+
+// A property's declared type, e.g. "int32", "FIXED_STRING(16)" or
+// "STRING(256)"; INT and INTEGER are INT64, VARCHAR is STRING
+struct TypeSpec {
+    NebulaType type{NebulaType::STRING};
+    uint32_t length{0};     // FIXED_STRING bytes, 0 otherwise
+};
+
+std::optional<TypeSpec> parse_type(const std::string& declared);
+
+// Smallest integer type holding every value in [min, max]
+NebulaType narrowest_integer_type(int64_t min, int64_t max);
+
+// Narrowest type that holds every value observed in a column: the smallest
+// integer type, FLOAT when no value needs a double, DATE or DATETIME when
+// every string parses as one. Nulls are ignored.
+class TypeInference {
+public:
+    void observe(const parser::json::JsonDocument& value);
+
+    // nullopt until a non-null value was observed
+    std::optional<TypeSpec> type() const;
+
+    size_t max_length() const { return max_length_; }
+
+private:
+    enum Kind : uint8_t { BOOLEAN = 1, INTEGER = 2, REAL = 4, TEXT = 8, OTHER = 16 };
+
+    uint8_t kinds_{0};
+    uint64_t observed_{0};
+    int64_t min_{INT64_MAX};
+    int64_t max_{INT64_MIN};
+    bool needs_double_{false};
+    bool not_date_{false};
+    bool not_datetime_{false};
+    size_t max_length_{0};
+};
+
+// A typed scalar in 16 bytes: an 8-byte payload, a length, the type and a
+// null flag. Integers are range-checked against their declared width,
+// FLOAT is held as a 4-byte float, and DATE, TIME and DATETIME as packed
+// integers (year*512 + month*32 + day, microseconds of the day, and
+// date*86400000000 + time). Strings of up to 8 bytes
+// are held inline; longer ones point at text the value does not own,
+// normally a string in the JSON document being mapped.
+class NebulaValue {
+public:
+    struct Date {
+        int32_t year;
+        uint8_t month;
+        uint8_t day;
+    };
+
+    struct Time {
+        uint8_t hour;
+        uint8_t minute;
+        uint8_t second;
+        uint32_t microsecond;
+    };
+
+    static NebulaValue null(NebulaType type);
+    static NebulaValue boolean(bool value);
+    static NebulaValue integer(NebulaType type, int64_t value);   // INT8..INT64, TIMESTAMP
+    static NebulaValue real(NebulaType type, double value);       // FLOAT, DOUBLE
+    static NebulaValue text(NebulaType type, std::string_view value);
+    static NebulaValue date(Date date);
+    static NebulaValue time(Time time);
+    static NebulaValue datetime(Date date, Time time);
+
+    NebulaType type() const { return type_; }
+    bool is_null() const { return null_; }
+
+    bool as_bool() const { return payload_.integer != 0; }
+    int64_t as_int() const;
+    double as_double() const;
+    std::string_view as_string() const;
+    Date as_date() const;
+    Time as_time() const;
+
+    // Raw packed payload, e.g. to compare or hash temporal values
+    int64_t packed() const { return payload_.integer; }
+
+private:
+    NebulaValue(NebulaType type, bool null) : type_(type), null_(null) {}
+
+    union {
+        int64_t integer;
+        double real;
+        float single;
+        const char* text;
+        char inline_text[8];
+    } payload_{0};
+    uint32_t size_{0};
+    NebulaType type_;
+    bool null_;
+    bool inline_{false};
+};
+
+static_assert(sizeof(NebulaValue) == 16, "NebulaValue is meant to stay 16 bytes");
+
+// Convert a JSON value to `spec`, checking ranges and formats. Strings
+// convert to numeric types exactly, as `coerce` allows. Errors read
+// "Value conversion error: ..." with `json_path` as context, as
+// StatementGenerator::extract_value reports them. A returned string value
+// points into `json`.
+common::Result<NebulaValue, StatementError> to_nebula_value(
+    const parser::json::JsonDocument& json, const TypeSpec& spec, const std::string& json_path,
+    common::numbers::CoercionMode coerce = common::numbers::CoercionMode::STRICT);
+
+// Append the shortest digits that read back as `value`, or as the float
+// nearest to it when `single` (FLOAT properties)
+void append_real(std::string& out, double value, bool single = false);
+
+// Append the text of `value` without quotes: strings as they are, numbers
+// as in literals, temporal values in ISO 8601 form; nothing for NULL
+void append_text(std::string& out, const NebulaValue& value);
+
+// Append the nGQL literal for `value`: NULL, numbers, true/false, quoted
+// strings, date("..."), time("..."), datetime("...") and TIMESTAMP as
+// seconds since the epoch
+void append_literal(std::string& out, const NebulaValue& value);
+
+// "2024-01-31", "12:30:45[.ffffff]" and "2024-01-31T12:30:45[.ffffff]" (a
+// space also separates date and time; a trailing Z is ignored)
+std::optional<NebulaValue::Date> parse_date(std::string_view text);
+std::optional<NebulaValue::Time> parse_time(std::string_view text);
+std::optional<std::pair<NebulaValue::Date, NebulaValue::Time>> parse_datetime(
+    std::string_view text);
+
+} // namespace graph
+
+#endif // NEBULA_MAPPER_NEBULA_VALUE_HPP
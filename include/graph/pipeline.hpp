@@ -0,0 +1,49 @@
+#ifndef NEBULA_MAPPER_PIPELINE_HPP
+#define NEBULA_MAPPER_PIPELINE_HPP
+
+#include "graph/memory_budget.hpp"
+#include "graph/statement_generator.hpp"
+#include "graph/statement_sink.hpp"
+#include "parser/record_reader.hpp"
+#include "telemetry/progress.hpp"
+#include "telemetry/slow_records.hpp"
+#include <cstdint>
+
+namespace graph {
+
+class CompiledMapping;
+
+struct PipelineOptions {
+    size_t threads{1};          // Parse/generate workers
+    size_t batch_size{500};     // Rows per INSERT statement
+    size_t queue_capacity{0};   // Records read ahead (0 = 4 per worker)
+    bool ordered{true};         // Emit statements in input order
+    telemetry::SlowRecordLog* slow_records{nullptr};   // Per-record timing, if set
+    telemetry::ProgressCounters* progress{nullptr};    // Live run totals, if set
+    MemoryBudget* memory{nullptr};     // Charged for records and statements in flight
+    const CompiledMapping* compiled{nullptr};   // Extractor tried before the interpreter
+    StatementSink* update_sink{nullptr};   // UPDATE statements, if not the main sink
+};
+
+struct PipelineSummary {
+    uint64_t records{0};
+    uint64_t input_bytes{0};
+    uint64_t statements{0};
+    uint64_t statement_bytes{0};
+};
+
+// Read records, parse and map each one, and pass the statements to `sink`.
+// Records are independent: each one gets its own INSERT batches, so
+// duplicate vertices are only folded within a record. Update aggregates
+// are folded over all records and their UPDATE statements passed last, to
+// `options.update_sink` when set so they can run after every INSERT.
+// Stops at the first error, which carries the record's source as context.
+Result<PipelineSummary> run_pipeline(
+    const parser::mapping::GraphMapping& mapping,
+    parser::json::RecordReader& reader,
+    StatementSink& sink,
+    const PipelineOptions& options = {});
+
+} // namespace graph
+
+#endif // NEBULA_MAPPER_PIPELINE_HPP
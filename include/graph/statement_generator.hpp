@@ -2,8 +2,12 @@
 #define NEBULA_MAPPER_STATEMENT_GENERATOR_HPP
 
 #include "common/result.hpp"
+#include "graph/aggregates.hpp"
+#include "graph/column_dictionary.hpp"
+#include "graph/nebula_value.hpp"
 #include "parser/mapping_parser.hpp"
 #include "parser/json_parser.hpp"
+#include <unordered_set>
 
 namespace graph {
 
@@ -38,8 +42,17 @@ struct StatementError : common::Error {
 template<typename T>
 using Result = common::Result<T, StatementError>;
 
+struct GeneratorOptions {
+    // Column dictionaries, native value rendering and batched point
+    // projection. Off, every value goes through extract_value() and
+    // format_value(), as a reference for checking those paths.
+    bool fast_paths{true};
+};
+
 class StatementGenerator {
 public:
+    explicit StatementGenerator(GeneratorOptions options = {}) : options_(options) {}
+
     // Generate statements from JSON data using mapping
     Result<std::vector<std::string>> generate_statements(
         const parser::mapping::GraphMapping& mapping,
@@ -51,6 +64,30 @@ public:
         const parser::json::JsonDocument& data,
         size_t batch_size = 500);
 
+    // Per-value building blocks, public so they can be benchmarked and reused
+    Result<Value> extract_value(
+        const parser::json::JsonDocument& data,
+        const std::string& json_path,
+        const std::string& nebula_type,
+        const std::optional<parser::mapping::Transform>& transform = std::nullopt,
+        common::numbers::CoercionMode coerce = common::numbers::CoercionMode::STRICT);
+
+    Result<std::string> format_value(const Value& value);
+
+    Result<std::string> get_vertex_id(
+        const parser::json::JsonDocument& data,
+        const std::string& key_path);
+
+    static std::string quote_identifier(const std::string& identifier);
+    static std::string escape_string(const std::string& str);
+
+    // Rows rendered by this generator so far, all calls together
+    uint64_t rows_generated() const { return rows_generated_; }
+
+    // Update aggregates of every document mapped so far, for the caller to
+    // turn into UPDATE statements once the input is done
+    AggregateTable& aggregates() { return aggregates_; }
+
 private:
     // Fixed method declarations without class qualification
     std::string infer_type(const parser::json::JsonDocument& value);
@@ -79,22 +116,91 @@ private:
         const parser::json::JsonDocument& data,
         const std::string& path);
 
-    Result<Value> extract_value(
-        const parser::json::JsonDocument& data,
-        const std::string& json_path,
-        const std::string& nebula_type,
-        const std::optional<parser::mapping::Transform>& transform = std::nullopt);
-
-    Result<std::string> format_value(const Value& value);
-
-    Result<std::string> get_vertex_id(
+    friend class ColumnDictionary;
+    // Checks sampled records through the same plans (mapping_preflight.cpp)
+    friend class MappingPreflight;
+
+    // Dictionary of a property whose values are rendered as plain string
+    // literals, or nullptr if it converts or transforms them
+    ColumnDictionary* dictionary_for(const parser::mapping::Property& prop);
+
+    // A property's split path and parsed type, worked out once
+    struct ValuePlan {
+        std::string json_path;
+        std::string nebula_type;
+        std::vector<std::string> segments;
+        TypeSpec spec;
+        common::numbers::CoercionMode coerce;
+    };
+
+    const ValuePlan& plan_for(const parser::mapping::Property& prop);
+
+    // Append the literal of an untransformed property to `prop_values`,
+    // converted through NebulaValue or serialized as JSON text. false if
+    // the path is missing, which the general path then reports.
+    Result<bool> render_native(
+        const parser::mapping::Property& prop,
+        const parser::json::JsonDocument& item,
+        std::vector<std::string>& prop_values);
+
+    // Coordinates of a point property for each item of the mapping being
+    // rendered, converted to WGS84 in one batch before its rows
+    struct PointColumn {
+        std::vector<double> lon;
+        std::vector<double> lat;
+        std::vector<uint8_t> state;   // PointState of each item
+    };
+
+    void convert_points(
+        const std::vector<parser::mapping::Property>& properties,
+        const std::vector<parser::json::JsonDocument>& items);
+
+    // Append ST_Point() of item `row` of the last convert_points() call to
+    // `prop_values`, or NULL. false if `prop` is not a point property.
+    Result<bool> render_point(
+        const parser::mapping::Property& prop,
+        const parser::json::JsonDocument& item,
+        size_t row,
+        std::vector<std::string>& prop_values);
+
+    // Aggregates of one vertex mapping over one document: one accumulator
+    // per aggregate shared by every vertex, and per VID for keyed ones
+    struct AggregateGroups {
+        std::vector<Accumulator> shared;
+        std::unordered_map<std::string, std::vector<Accumulator>> keyed;
+        std::vector<Accumulator> none;      // VIDs no item is keyed to
+        std::unordered_set<std::string> merged;     // VIDs folded into aggregates_
+    };
+
+    struct AggregatePlan {
+        std::string over_path;
+        std::string json_path;
+        std::vector<std::string> over;
+        std::vector<std::string> value;
+    };
+
+    const AggregatePlan& aggregate_plan_for(const parser::mapping::Aggregate& aggregate);
+
+    Result<bool> accumulate(
+        const parser::mapping::VertexMapping& vertex_mapping,
         const parser::json::JsonDocument& data,
-        const std::string& key_path);
-
-
+        AggregateGroups& groups);
 
-    static std::string escape_string(const std::string& str);
-    static std::string quote_identifier(const std::string& identifier);
+    // Append the row aggregates of vertex `vid` to `prop_values`, and fold
+    // its update aggregates into aggregates_ the first time it is seen
+    Result<bool> render_aggregates(
+        const parser::mapping::VertexMapping& vertex_mapping,
+        AggregateGroups& groups,
+        const std::string& vid,
+        std::vector<std::string>& prop_values);
+
+    uint64_t rows_generated_{0};
+    GeneratorOptions options_;
+    std::unordered_map<const parser::mapping::Property*, ColumnDictionary> dictionaries_;
+    std::unordered_map<const parser::mapping::Property*, ValuePlan> plans_;
+    std::unordered_map<const parser::mapping::Property*, PointColumn> points_;
+    std::unordered_map<const parser::mapping::Aggregate*, AggregatePlan> aggregate_plans_;
+    AggregateTable aggregates_;
 };
 
 namespace detail {
@@ -108,6 +214,9 @@ namespace detail {
     Result<std::string> format_timestamp(const std::string& value);
     Result<std::string> format_date(const std::string& value);
     Result<std::string> format_datetime(const std::string& value);
+
+    // Report one emitted statement covering `rows` rows to probes and metrics
+    void publish_statement(const std::string& mapping, size_t rows, size_t bytes);
 }
 
 } // namespace graph
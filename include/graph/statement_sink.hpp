@@ -0,0 +1,85 @@
+#ifndef NEBULA_MAPPER_STATEMENT_SINK_HPP
+#define NEBULA_MAPPER_STATEMENT_SINK_HPP
+
+#include "graph/memory_budget.hpp"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace graph {
+
+// Destination for generated statements. The pipeline hands over one
+// record's statements at a time, from one thread at a time.
+class StatementSink {
+public:
+    virtual ~StatementSink() = default;
+
+    virtual void consume(std::vector<std::string>&& statements) = 0;
+};
+
+// Writes one statement per line
+class OstreamSink : public StatementSink {
+public:
+    explicit OstreamSink(std::ostream& out) : out_(out) {}
+
+    void consume(std::vector<std::string>&& statements) override;
+
+    uint64_t bytes_written() const { return bytes_; }
+
+private:
+    std::ostream& out_;
+    uint64_t bytes_{0};
+};
+
+// Keeps every statement, e.g. to hand them to the executor afterwards
+class VectorSink : public StatementSink {
+public:
+    void consume(std::vector<std::string>&& statements) override;
+
+    std::vector<std::string>& statements() { return statements_; }
+
+private:
+    std::vector<std::string> statements_;
+};
+
+// Keeps every statement like VectorSink, but within a memory budget: once
+// the budget is under pressure, everything held so far is appended to a
+// spill file under `spill_dir`. drain() replays the file, then what is
+// still in memory, so statements come back in the order they arrived.
+class SpillingSink : public StatementSink {
+public:
+    SpillingSink(MemoryBudget* budget, std::filesystem::path spill_dir);
+    ~SpillingSink() override;
+
+    SpillingSink(const SpillingSink&) = delete;
+    SpillingSink& operator=(const SpillingSink&) = delete;
+
+    void consume(std::vector<std::string>&& statements) override;
+
+    // Hand every statement to `handle` in chunks of about `chunk_bytes`.
+    // Returns false if the spill file could not be read back.
+    bool drain(uint64_t chunk_bytes,
+               const std::function<void(std::vector<std::string>&&)>& handle);
+
+    uint64_t spilled_statements() const { return spilled_; }
+
+private:
+    void spill();
+
+    MemoryBudget* budget_;
+    std::filesystem::path spill_dir_;
+    std::filesystem::path spill_path_;
+    std::ofstream spill_file_;
+    bool spill_failed_{false};
+    uint64_t spilled_{0};
+    std::vector<std::string> statements_;
+    uint64_t held_bytes_{0};
+};
+
+} // namespace graph
+
+#endif // NEBULA_MAPPER_STATEMENT_SINK_HPP
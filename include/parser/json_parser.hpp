@@ -41,6 +41,10 @@ namespace parser::json {
         std::vector<std::string> split_path(const std::string& path);
         Result<JsonDocument> navigate_path(const JsonDocument& j,
                                          const std::vector<std::string>& segments);
+
+        // Node at `segments` without copying it; nullptr if there is none
+        const JsonDocument* find_path(const JsonDocument& j,
+                                      const std::vector<std::string>& segments);
     }
 
 } // namespace parser::json
@@ -1,6 +1,7 @@
 #ifndef NEBULA_MAPPER_MAPPING_PARSER_HPP
 #define NEBULA_MAPPER_MAPPING_PARSER_HPP
 
+#include "common/number_parser.hpp"
 #include "common/result.hpp"
 #include "json_parser.hpp"
 #include "yaml_parser.hpp"
@@ -24,6 +25,26 @@ struct Transform {
     std::map<std::string, std::string> params;
 };
 
+// A property that stores its JSON subtree as text
+struct JsonFormat {
+    std::vector<std::string> keys;  // Top-level object keys kept; empty keeps all
+    bool minify{true};              // false indents by two spaces, like dump(2)
+};
+
+// Coordinate systems a point property can read
+enum class Projection : uint8_t {
+    WGS84,       // x is longitude and y latitude, in degrees
+    CONGNAMUL,   // Korea Central Belt TM on GRS80 (EPSG:5181), in metres
+    WCONGNAMUL   // CONGNAMUL scaled by 2.5, as in Kakao place data
+};
+
+// A GEOGRAPHY(POINT) property built from two coordinate paths
+struct GeoPoint {
+    std::string x_path;
+    std::string y_path;
+    Projection from{Projection::WCONGNAMUL};
+};
+
 // Property in the final mapping
     struct Property {
         std::string name;
@@ -33,16 +54,45 @@ struct Transform {
         bool indexable{false};  // Add this line
         std::optional<std::string> default_value;
         std::optional<Transform> transform;
+        // How numeric strings convert to numeric types
+        common::numbers::CoercionMode coerce{common::numbers::CoercionMode::STRICT};
+        std::optional<JsonFormat> json_format;
+        std::optional<GeoPoint> geo;  // json_path is then geo->x_path
     };
 
     using DynamicFieldsConfig = yaml::DynamicFieldsConfig;
 
+// Functions of an aggregate property
+enum class AggregateOp : uint8_t {
+    COUNT,
+    SUM,
+    AVG,
+    MIN,
+    MAX,
+    DISTINCT    // Distinct values, estimated by HyperLogLog past 512
+};
+
+// A property computed over the items at `over` while a document is mapped:
+// over all of them, or with a key path only over those whose key is the
+// vertex's own. Rendered in the vertex's row, or with `update` folded over
+// the whole run and set by one UPDATE per vertex once the input is done.
+struct Aggregate {
+    std::string name;
+    AggregateOp op{AggregateOp::COUNT};
+    std::string over;
+    std::string json_path;      // Value aggregated; empty counts the items
+    std::string key_path;       // VID of the item's vertex; empty = every vertex
+    std::string nebula_type;
+    bool update{false};
+};
+
     struct VertexMapping {
         std::string tag_name;
         std::string source_path;
         std::string key_path;
         std::vector<Property> properties;
         DynamicFieldsConfig dynamic_fields;  // Changed from bool to DynamicFieldsConfig
+        std::vector<Aggregate> aggregates;
     };
 
 // Edge mapping
@@ -76,10 +126,6 @@ struct GraphMapping {
 // Main mapping creation function
 Result<parser::mapping::GraphMapping> create_mapping(const parser::yaml::Result<YAML::Node>& config);
 
-// Validation function
-Result<void> validate_mapping(const parser::mapping::GraphMapping& mapping,
-                            const parser::json::JsonDocument& document);
-
 namespace detail {
     Result<VertexMapping> create_vertex_mapping(
         const parser::yaml::TagMapping& tag_def,
@@ -92,6 +138,11 @@ namespace detail {
     Result<Property> create_property_mapping(
         const parser::yaml::PropertyMapping& prop_def,
         const std::string& prop_name);
+
+    // Checks `aggregate_def` against the properties and aggregates of `vertex`
+    Result<Aggregate> create_aggregate(
+        const parser::yaml::AggregateMapping& aggregate_def,
+        const VertexMapping& vertex);
 }
 
 } // namespace parser::mapping
@@ -0,0 +1,54 @@
+#ifndef NEBULA_MAPPER_RECORD_READER_HPP
+#define NEBULA_MAPPER_RECORD_READER_HPP
+
+#include "parser/json_parser.hpp"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace parser::json {
+
+    // How an input path is split into records
+    enum class InputFormat {
+        AUTO,       // Directory, .ndjson/.jsonl, top-level array or document
+        DOCUMENT,   // The whole file is one record
+        NDJSON,     // One record per non-blank line
+        ARRAY,      // Each element of a top-level array is a record
+        DIRECTORY   // Every regular file below a directory, in path order
+    };
+
+    // Raw text of one input record, parsed later by whoever consumes it
+    struct Record {
+        std::string text;
+        std::string source;   // "file", "file:line" or "file[index]"
+        uint64_t index{0};    // Position in the input, starting at 0
+        uint64_t offset{0};   // Byte offset of the record in its file
+    };
+
+    // Streams records out of a file or directory without loading the whole
+    // input; a record is only held in memory until it is handed out.
+    class RecordReader {
+    public:
+        virtual ~RecordReader() = default;
+
+        // Next record, or std::nullopt once the input is exhausted
+        virtual Result<std::optional<Record>> next() = 0;
+
+        // Input bytes consumed so far
+        virtual uint64_t bytes_read() const = 0;
+    };
+
+    Result<std::unique_ptr<RecordReader>> open_records(
+        const std::string& path,
+        InputFormat format = InputFormat::AUTO);
+
+    Result<InputFormat> parse_input_format(const std::string& name);
+
+    // Bytes a reader over `path` consumes in total: the file size, or the
+    // sum over a directory. 0 if unknown.
+    uint64_t input_size(const std::string& path);
+
+} // namespace parser::json
+
+#endif // NEBULA_MAPPER_RECORD_READER_HPP
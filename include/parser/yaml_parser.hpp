@@ -7,6 +7,7 @@
 #include <string>
 #include <map>
 #include <optional>
+#include <vector>
 
 namespace parser::yaml {
 
@@ -49,6 +50,13 @@ namespace parser::yaml {
         }
     };
 
+    // Coordinate paths of a point property
+    struct GeoSource {
+        std::string x;
+        std::string y;
+        std::string from{"wcongnamul"};
+    };
+
     struct PropertyMapping {
         std::string json_path;
         std::string name;
@@ -57,14 +65,31 @@ namespace parser::yaml {
         bool indexable{false};
         size_t max_length{256};
         std::optional<std::string> default_value;
+        std::optional<std::string> coerce;  // "strict" or "lenient"
+        std::optional<std::string> serialize;  // "json" stores the subtree as text
+        std::vector<std::string> serialize_keys;
+        bool serialize_minify{true};
+        std::optional<GeoSource> geo;
         std::optional<Transform> transform;
     };
 
+    // A property aggregated over the items at `over`
+    struct AggregateMapping {
+        std::string name;
+        std::string op;
+        std::string over;
+        std::string json_path;
+        std::string key_field;
+        std::optional<std::string> nebula_type;
+        std::string emit{"row"};    // "row" or "update"
+    };
+
     struct TagMapping {
         std::string json_path;
         std::string key_field;
         std::map<std::string, PropertyMapping> properties;
         DynamicFieldsConfig dynamic_fields;
+        std::vector<AggregateMapping> aggregates;
     };
 
     // YAML-specific error type
@@ -244,12 +269,28 @@ template<>
                 }
                 std::cerr << std::endl;
 
-                // Required field: json
-                if (!node["json"]) {
+                // geo: {x, y, from} reads a point from two coordinate paths
+                if (node["geo"]) {
+                    const auto& geo = node["geo"];
+                    if (!geo.IsMap() || !geo["x"] || !geo["y"]) {
+                        std::cerr << "Property 'geo' needs x and y paths" << std::endl;
+                        return false;
+                    }
+                    parser::yaml::GeoSource source;
+                    source.x = geo["x"].as<std::string>();
+                    source.y = geo["y"].as<std::string>();
+                    if (geo["from"]) {
+                        source.from = geo["from"].as<std::string>();
+                    }
+                    rhs.geo = source;
+                }
+
+                // Required field: json, which a point reads from geo.x
+                if (!node["json"] && !rhs.geo) {
                     std::cerr << "Missing 'json' field in property" << std::endl;
                     return false;
                 }
-                rhs.json_path = node["json"].as<std::string>();
+                rhs.json_path = node["json"] ? node["json"].as<std::string>() : rhs.geo->x;
 
                 // Name field (optional)
                 if (node["name"]) {
@@ -320,6 +361,26 @@ template<>
                 if (node["default"]) {
                     rhs.default_value = node["default"].as<std::string>();
                 }
+                if (node["coerce"]) {
+                    rhs.coerce = node["coerce"].as<std::string>();
+                }
+                // serialize: json, or a map with format, keys and minify
+                if (node["serialize"]) {
+                    const auto& serialize = node["serialize"];
+                    if (serialize.IsMap()) {
+                        rhs.serialize = serialize["format"] ?
+                            serialize["format"].as<std::string>() : "json";
+                        if (serialize["keys"]) {
+                            rhs.serialize_keys =
+                                serialize["keys"].as<std::vector<std::string>>();
+                        }
+                        if (serialize["minify"]) {
+                            rhs.serialize_minify = serialize["minify"].as<bool>();
+                        }
+                    } else {
+                        rhs.serialize = serialize.as<std::string>();
+                    }
+                }
 
                 std::cerr << "Successfully parsed property: " << rhs.name
                          << " of type " << rhs.nebula_type
@@ -410,6 +471,22 @@ template<>
                 }
             }
 
+            // Parse aggregates; create_vertex_mapping checks the fields
+            if (node["aggregates"] && node["aggregates"].IsSequence()) {
+                for (const auto& item : node["aggregates"]) {
+                    if (!item.IsMap()) continue;
+                    parser::yaml::AggregateMapping aggregate;
+                    if (item["name"]) aggregate.name = item["name"].as<std::string>();
+                    if (item["op"]) aggregate.op = item["op"].as<std::string>();
+                    if (item["over"]) aggregate.over = item["over"].as<std::string>();
+                    if (item["json"]) aggregate.json_path = item["json"].as<std::string>();
+                    if (item["key"]) aggregate.key_field = item["key"].as<std::string>();
+                    if (item["type"]) aggregate.nebula_type = item["type"].as<std::string>();
+                    if (item["emit"]) aggregate.emit = item["emit"].as<std::string>();
+                    rhs.aggregates.push_back(aggregate);
+                }
+            }
+
             return true;
         }
     };
@@ -448,9 +525,11 @@ template<>
 
                 // Set up endpoints
                 rhs.from.tag = node["source_tag"].as<std::string>();
-                rhs.from.key_field = "id";  // Default key field
+                rhs.from.key_field = node["source_key"] ?
+                    node["source_key"].as<std::string>() : "id";  // Default key field
                 rhs.to.tag = node["target_tag"].as<std::string>();
-                rhs.to.key_field = "id";  // Default key field
+                rhs.to.key_field = node["target_key"] ?
+                    node["target_key"].as<std::string>() : "id";  // Default key field
 
                 // Handle properties
                 if (node["properties"] && node["properties"].IsSequence()) {
@@ -0,0 +1,37 @@
+#ifndef NEBULA_MAPPER_ALLOCATIONS_HPP
+#define NEBULA_MAPPER_ALLOCATIONS_HPP
+
+#include "telemetry/stats.hpp"
+#include <array>
+#include <cstdint>
+
+// Heap allocation accounting, only available in builds configured with
+// ENABLE_ALLOC_TRACKING. Those builds replace the global operator new and
+// charge every allocation to the innermost running StageTimer of the
+// calling thread, so per-stage figures need stats to be enabled.
+
+namespace telemetry {
+
+// One slot per stage, plus a last slot for allocations outside any stage
+constexpr size_t ALLOCATION_SLOTS = STAGE_COUNT + 1;
+
+#ifdef NEBULA_MAPPER_ALLOC_TRACKING
+
+// Counters since the last reset
+std::array<AllocationCounters, ALLOCATION_SLOTS> allocation_counters();
+
+// All allocations since the last reset
+AllocationCounters allocation_total();
+
+void reset_allocation_counters();
+
+namespace detail {
+    // Slot of the calling thread's innermost StageTimer; must not allocate
+    size_t current_allocation_slot() noexcept;
+}
+
+#endif // NEBULA_MAPPER_ALLOC_TRACKING
+
+} // namespace telemetry
+
+#endif // NEBULA_MAPPER_ALLOCATIONS_HPP
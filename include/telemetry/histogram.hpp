@@ -0,0 +1,82 @@
+#ifndef NEBULA_MAPPER_HISTOGRAM_HPP
+#define NEBULA_MAPPER_HISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace telemetry {
+
+// Log-linear (HDR-style) histogram of unsigned integer samples.
+// Values below 16 get exact buckets; above that every power of two is
+// split into 8 linear sub-buckets, bounding the relative error at 12.5%.
+// Recording is a few relaxed atomic increments and never blocks.
+class Histogram {
+public:
+    static constexpr size_t LINEAR_BUCKETS = 16;
+    static constexpr size_t SUB_BUCKETS = 8;
+    static constexpr size_t BUCKET_COUNT = LINEAR_BUCKETS + (64 - 4) * SUB_BUCKETS;
+
+    Histogram() = default;
+
+    // Copies take a snapshot; not atomic against concurrent recording
+    Histogram(const Histogram& other) { merge(other); }
+
+    Histogram& operator=(const Histogram& other) {
+        if (this != &other) {
+            reset();
+            merge(other);
+        }
+        return *this;
+    }
+
+    static size_t bucket_index(uint64_t value) {
+        if (value < LINEAR_BUCKETS) return static_cast<size_t>(value);
+        auto exponent = static_cast<size_t>(63 - __builtin_clzll(value));
+        auto sub = static_cast<size_t>((value >> (exponent - 3)) & (SUB_BUCKETS - 1));
+        return LINEAR_BUCKETS + (exponent - 4) * SUB_BUCKETS + sub;
+    }
+
+    // Smallest value that falls into the bucket
+    static uint64_t bucket_lower_bound(size_t index);
+
+    // Largest value that falls into the bucket
+    static uint64_t bucket_upper_bound(size_t index);
+
+    void record(uint64_t value) {
+        buckets_[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+        uint64_t current = max_.load(std::memory_order_relaxed);
+        while (value > current &&
+               !max_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+
+    // Upper bound of the bucket holding the q-th quantile (0 < q <= 1)
+    uint64_t percentile(double q) const;
+
+    // Copy of the bucket counts
+    std::vector<uint64_t> buckets() const;
+
+    // Add all samples of another histogram
+    void merge(const Histogram& other);
+
+    void reset();
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+} // namespace telemetry
+
+#endif // NEBULA_MAPPER_HISTOGRAM_HPP
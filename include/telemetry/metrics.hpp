@@ -0,0 +1,160 @@
+#ifndef NEBULA_MAPPER_METRICS_HPP
+#define NEBULA_MAPPER_METRICS_HPP
+
+#include "telemetry/histogram.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace telemetry {
+
+// Ordered label set, e.g. {{"mapping", "Place"}}
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+// Monotonic counter
+class Counter {
+public:
+    void add(uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+// Value that can go up and down
+class Gauge {
+public:
+    void set(int64_t v) { value_.store(v, std::memory_order_relaxed); }
+    void add(int64_t n) { value_.fetch_add(n, std::memory_order_relaxed); }
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> value_{0};
+};
+
+// Text exposition flavours
+enum class ExpositionFormat {
+    OPENMETRICS,   // For the HTTP endpoint
+    PROMETHEUS     // For node-exporter textfiles
+};
+
+// Process-wide metric registry. Lookups take a lock; the returned
+// references stay valid for the life of the process, so hot paths should
+// look a metric up once and then only touch its atomics.
+class MetricsRegistry {
+public:
+    static MetricsRegistry& instance() {
+        static MetricsRegistry registry;
+        return registry;
+    }
+
+    Counter& counter(const std::string& name, const std::string& help,
+                     const Labels& labels = {});
+
+    Gauge& gauge(const std::string& name, const std::string& help,
+                 const Labels& labels = {});
+
+    // `scale` divides recorded samples on export, e.g. 1e9 for ns -> seconds
+    Histogram& histogram(const std::string& name, const std::string& help,
+                         const Labels& labels = {}, double scale = 1.0);
+
+    std::string render(ExpositionFormat format = ExpositionFormat::OPENMETRICS) const;
+
+private:
+    MetricsRegistry() = default;
+
+    enum class Type { COUNTER, GAUGE, HISTOGRAM };
+
+    struct Family {
+        Type type{Type::COUNTER};
+        std::string help;
+        double scale{1.0};
+        std::map<std::string, std::unique_ptr<Counter>> counters;
+        std::map<std::string, std::unique_ptr<Gauge>> gauges;
+        std::map<std::string, std::unique_ptr<Histogram>> histograms;
+    };
+
+    Family& family(const std::string& name, Type type, const std::string& help);
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Family> families_;
+};
+
+namespace detail {
+    extern std::atomic<bool> metrics_enabled;
+}
+
+// Pipeline components only publish metrics once this is on
+inline bool metrics_enabled() {
+    return detail::metrics_enabled.load(std::memory_order_relaxed);
+}
+
+void enable_metrics(bool enabled = true);
+
+// Metrics published by the generator and executor, registered on first use
+struct PipelineMetrics {
+    Counter& rows;
+    Counter& statements;
+    Counter& statement_bytes;
+    Counter& dedup_hits;
+    Counter& dedup_misses;
+    Counter& generate_errors;
+    Counter& execute_errors;
+    Gauge& queue_depth;
+    Gauge& in_flight;
+    Histogram& request_latency_ns;
+};
+
+PipelineMetrics& pipeline_metrics();
+
+// Minimal HTTP server answering GET /metrics on a local port
+class MetricsServer {
+public:
+    ~MetricsServer();
+
+    // Bind to `address:port` (port 0 picks a free port) and start serving
+    bool start(uint16_t port, const std::string& address = "127.0.0.1");
+    void stop();
+
+    uint16_t port() const { return port_; }
+
+private:
+    void serve();
+
+    int fd_{-1};
+    uint16_t port_{0};
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+// Periodically rewrites a node-exporter textfile (atomically via rename)
+class TextfileExporter {
+public:
+    ~TextfileExporter();
+
+    bool start(const std::string& path, std::chrono::milliseconds interval);
+    void stop();
+
+    // Write the current metrics now
+    bool write_now() const;
+
+private:
+    std::string path_;
+    std::chrono::milliseconds interval_{0};
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_{false};
+    std::thread thread_;
+};
+
+} // namespace telemetry
+
+#endif // NEBULA_MAPPER_METRICS_HPP
@@ -0,0 +1,70 @@
+#ifndef NEBULA_MAPPER_PROBES_HPP
+#define NEBULA_MAPPER_PROBES_HPP
+
+// USDT (user statically-defined tracing) probes for perf and bpftrace.
+// An unattached probe is a single nop. Each probe also has a semaphore,
+// which is non-zero only while a tracer is attached. Argument work that
+// costs more than a register load, such as reading the clock, should be
+// guarded with NEBULA_MAPPER_PROBE_ENABLED.
+//
+// Provider: nebula_mapper
+//   document_parsed   (bytes, duration_ns, ok)
+//   row_extracted     (mapping, bytes)
+//   transform_applied (name, duration_ns, failed)
+//   batch_flushed     (mapping, rows, bytes)
+//   statement_written (host, port, bytes, latency_ns, outcome)
+//       also fires per line written to a stream, with host "" and port 0
+//
+// Example:
+//   bpftrace -e 'usdt:./nebula_mapper:nebula_mapper:statement_written
+//                { @latency_us = hist(arg3 / 1000); }'
+
+#include <chrono>
+#include <cstdint>
+
+#ifdef NEBULA_MAPPER_USDT
+
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+
+// Defined in src/telemetry/probes.cpp; the tracer increments them on attach
+extern "C" {
+    extern unsigned short nebula_mapper_document_parsed_semaphore;
+    extern unsigned short nebula_mapper_row_extracted_semaphore;
+    extern unsigned short nebula_mapper_transform_applied_semaphore;
+    extern unsigned short nebula_mapper_batch_flushed_semaphore;
+    extern unsigned short nebula_mapper_statement_written_semaphore;
+}
+
+#define NEBULA_MAPPER_PROBE_ENABLED(name) \
+    __builtin_expect(nebula_mapper_##name##_semaphore != 0, 0)
+
+#define NEBULA_MAPPER_PROBE2(name, a1, a2) \
+    DTRACE_PROBE2(nebula_mapper, name, a1, a2)
+#define NEBULA_MAPPER_PROBE3(name, a1, a2, a3) \
+    DTRACE_PROBE3(nebula_mapper, name, a1, a2, a3)
+#define NEBULA_MAPPER_PROBE5(name, a1, a2, a3, a4, a5) \
+    DTRACE_PROBE5(nebula_mapper, name, a1, a2, a3, a4, a5)
+
+#else
+
+// Arguments stay unevaluated but count as used
+#define NEBULA_MAPPER_PROBE_ENABLED(name) false
+#define NEBULA_MAPPER_PROBE2(name, a1, a2) \
+    ((void)sizeof(a1), (void)sizeof(a2))
+#define NEBULA_MAPPER_PROBE3(name, a1, a2, a3) \
+    ((void)sizeof(a1), (void)sizeof(a2), (void)sizeof(a3))
+#define NEBULA_MAPPER_PROBE5(name, a1, a2, a3, a4, a5) \
+    ((void)sizeof(a1), (void)sizeof(a2), (void)sizeof(a3), (void)sizeof(a4), (void)sizeof(a5))
+
+#endif // NEBULA_MAPPER_USDT
+
+namespace telemetry {
+    // Clock for probe durations; only read while a probe is attached
+    inline int64_t probe_clock_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+#endif // NEBULA_MAPPER_PROBES_HPP
@@ -0,0 +1,77 @@
+#ifndef NEBULA_MAPPER_PROFILE_HPP
+#define NEBULA_MAPPER_PROFILE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+
+namespace telemetry {
+
+// Cost of one step of a mapping plan: a source navigation, a key lookup
+// or a property extraction
+struct StepCost {
+    uint64_t calls{0};
+    uint64_t ns{0};
+    uint64_t transform_ns{0};      // Needs stats enabled
+    uint64_t output_bytes{0};
+    uint64_t allocations{0};       // ENABLE_ALLOC_TRACKING builds only
+    uint64_t allocation_bytes{0};
+
+    void merge(const StepCost& other);
+};
+
+// Steps are keyed by the address of the mapping field they evaluate, so
+// the mapping must outlive the profile
+using ProfileSnapshot = std::unordered_map<const void*, StepCost>;
+
+namespace detail {
+    extern std::atomic<bool> profile_enabled;
+}
+
+// Step profiling is off until enabled; disabled scopes cost one relaxed load
+inline bool profile_enabled() {
+    return detail::profile_enabled.load(std::memory_order_relaxed);
+}
+
+void enable_profile(bool enabled = true);
+
+// Times one evaluation of a plan step on the calling thread. Allocation
+// counts come from the process-wide counters, so they are only exact when
+// a single thread is mapping.
+class StepScope {
+public:
+    explicit StepScope(const void* step)
+        : step_(profile_enabled() ? step : nullptr) {
+        if (step_) begin();
+    }
+
+    ~StepScope() {
+        if (step_) end();
+    }
+
+    StepScope(const StepScope&) = delete;
+    StepScope& operator=(const StepScope&) = delete;
+
+    void add_output(size_t bytes) { output_bytes_ += bytes; }
+
+private:
+    void begin();
+    void end();
+
+    const void* step_;
+    uint64_t output_bytes_{0};
+    uint64_t transform_ns_{0};
+    uint64_t allocations_{0};
+    uint64_t allocation_bytes_{0};
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Merge all thread accumulators. Call once worker threads are done.
+ProfileSnapshot collect_profile();
+
+void reset_profile();
+
+} // namespace telemetry
+
+#endif // NEBULA_MAPPER_PROFILE_HPP
@@ -0,0 +1,93 @@
+#ifndef NEBULA_MAPPER_PROGRESS_HPP
+#define NEBULA_MAPPER_PROGRESS_HPP
+
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <thread>
+
+namespace telemetry {
+
+// Run totals bumped by the pipeline with relaxed atomics: one add per
+// record, never per row, so keeping them costs nothing measurable
+struct ProgressCounters {
+    std::atomic<uint64_t> records{0};
+    std::atomic<uint64_t> input_bytes{0};    // Consumed by the reader
+    std::atomic<uint64_t> rows{0};
+    std::atomic<uint64_t> statements{0};
+    std::atomic<uint64_t> statement_bytes{0};
+};
+
+struct ProgressSnapshot {
+    double elapsed_seconds{0.0};
+    uint64_t records{0};
+    uint64_t input_bytes{0};
+    uint64_t total_bytes{0};                  // 0 if unknown
+    uint64_t rows{0};
+    uint64_t statements{0};
+    uint64_t statement_bytes{0};
+    double bytes_per_second{0.0};             // Smoothed over recent intervals
+    double records_per_second{0.0};
+    std::optional<double> eta_seconds;        // Needs a known total
+    bool final{false};
+};
+
+enum class ProgressFormat {
+    TEXT,   // One status line per interval
+    JSON    // One JSON object per line
+};
+
+std::string format_progress(const ProgressSnapshot& progress);
+nlohmann::json progress_to_json(const ProgressSnapshot& progress);
+
+// Background thread that samples the counters every `interval` and writes
+// a status line with throughput and ETA. The hot path never waits on it.
+class ProgressReporter {
+public:
+    ProgressReporter(const ProgressCounters& counters, uint64_t total_bytes,
+                     std::ostream& out, ProgressFormat format = ProgressFormat::TEXT);
+    ~ProgressReporter();
+
+    ProgressReporter(const ProgressReporter&) = delete;
+    ProgressReporter& operator=(const ProgressReporter&) = delete;
+
+    void start(std::chrono::milliseconds interval);
+
+    // Stop the thread and write a final line
+    void stop();
+
+    // Sample the counters now; updates the smoothed rates
+    ProgressSnapshot sample();
+
+private:
+    void write(const ProgressSnapshot& progress);
+
+    const ProgressCounters& counters_;
+    uint64_t total_bytes_;
+    std::ostream& out_;
+    ProgressFormat format_;
+
+    std::chrono::steady_clock::time_point started_;
+    std::chrono::steady_clock::time_point last_time_;
+    uint64_t last_bytes_{0};
+    uint64_t last_records_{0};
+    double bytes_rate_{0.0};
+    double records_rate_{0.0};
+    bool rated_{false};
+
+    std::chrono::milliseconds interval_{0};
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_{false};
+    std::thread thread_;
+};
+
+} // namespace telemetry
+
+#endif // NEBULA_MAPPER_PROGRESS_HPP
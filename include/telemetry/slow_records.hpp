@@ -0,0 +1,88 @@
+#ifndef NEBULA_MAPPER_SLOW_RECORDS_HPP
+#define NEBULA_MAPPER_SLOW_RECORDS_HPP
+
+#include "telemetry/stats.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Per-record timing. Records slower than a threshold are logged as they
+// finish, and the K slowest are kept for a summary at the end of the run.
+// Stage times and row counts come from the calling thread's stats
+// accumulator, so they are only filled in while stats are enabled.
+
+namespace telemetry {
+
+struct RecordTiming {
+    std::string source;     // "file", "file:line" or "file[index]"
+    uint64_t index{0};      // Position in the input
+    uint64_t offset{0};     // Byte offset in its file
+    uint64_t bytes{0};
+    uint64_t total_ns{0};
+    std::array<uint64_t, STAGE_COUNT> stage_ns{};
+    std::map<std::string, uint64_t> rows;   // Per mapping, non-zero only
+};
+
+// Measures one record on the calling thread, from construction to finish()
+class RecordTimer {
+public:
+    RecordTimer();
+
+    RecordTimer(const RecordTimer&) = delete;
+    RecordTimer& operator=(const RecordTimer&) = delete;
+
+    RecordTiming finish(std::string source, uint64_t index,
+                        uint64_t offset, uint64_t bytes) const;
+
+private:
+    std::chrono::steady_clock::time_point start_;
+    std::array<uint64_t, STAGE_COUNT> stage_ns_{};
+    std::vector<std::pair<std::string, uint64_t>> rows_;
+};
+
+class SlowRecordLog {
+public:
+    // Records taking at least `threshold` are written to `log` (if any);
+    // the `top_k` slowest of all records are kept
+    SlowRecordLog(std::chrono::nanoseconds threshold, size_t top_k,
+                  std::ostream* log = nullptr);
+
+    // Thread-safe
+    void observe(RecordTiming&& timing);
+
+    // Slowest first
+    std::vector<RecordTiming> slowest() const;
+
+    uint64_t records() const { return records_.load(std::memory_order_relaxed); }
+    uint64_t slow_records() const { return slow_.load(std::memory_order_relaxed); }
+    uint64_t threshold_ns() const { return threshold_ns_; }
+
+private:
+    uint64_t threshold_ns_;
+    size_t top_k_;
+    std::ostream* log_;
+    std::atomic<uint64_t> records_{0};
+    std::atomic<uint64_t> slow_{0};
+    // Fastest time still in the top K once it is full; lets most records
+    // skip the lock
+    std::atomic<uint64_t> cutoff_ns_{0};
+    mutable std::mutex mutex_;
+    std::vector<RecordTiming> heap_;   // Min-heap on total_ns
+};
+
+// One line: source, offset, size, time, stage breakdown and rows
+std::string format_record_timing(const RecordTiming& timing);
+
+// Summary of the slowest records
+std::string format_slow_records(const SlowRecordLog& log);
+
+} // namespace telemetry
+
+#endif // NEBULA_MAPPER_SLOW_RECORDS_HPP
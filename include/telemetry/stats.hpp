@@ -0,0 +1,170 @@
+#ifndef NEBULA_MAPPER_STATS_HPP
+#define NEBULA_MAPPER_STATS_HPP
+
+#include "telemetry/histogram.hpp"
+#include <nlohmann/json.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+namespace telemetry {
+
+// Pipeline stages with their own timers
+enum class Stage {
+    YAML_LOAD,
+    JSON_PARSE,
+    EXTRACTION,
+    TRANSFORM,
+    RENDER,
+    OUTPUT,
+    COUNT
+};
+
+constexpr size_t STAGE_COUNT = static_cast<size_t>(Stage::COUNT);
+
+const char* stage_name(Stage stage);
+
+// Why a statement stopped taking rows
+enum class BatchClose {
+    FULL,        // Reached the batch size
+    FLUSH,       // The record had no more rows for the mapping
+    SINGLE_ROW,  // One-row UPSERT
+    COUNT
+};
+
+constexpr size_t BATCH_CLOSE_COUNT = static_cast<size_t>(BatchClose::COUNT);
+
+const char* batch_close_name(BatchClose close);
+
+// Counters kept per tag/edge mapping
+struct MappingCounters {
+    uint64_t rows{0};
+    uint64_t bytes{0};
+    uint64_t statements{0};
+    uint64_t statement_bytes{0};
+
+    // Shapes, for tuning batching
+    Histogram row_sizes;         // Bytes per row
+    Histogram statement_sizes;   // Bytes per statement
+    Histogram batch_rows;        // Rows per statement
+    std::array<uint64_t, BATCH_CLOSE_COUNT> batch_closes{};
+};
+
+// Counters kept per transform name
+struct TransformCounters {
+    uint64_t calls{0};
+    uint64_t errors{0};
+};
+
+// Heap allocations (ENABLE_ALLOC_TRACKING builds)
+struct AllocationCounters {
+    uint64_t allocations{0};
+    uint64_t bytes{0};
+};
+
+// Per-thread accumulator; only ever written by its owning thread
+struct ThreadStats {
+    std::array<uint64_t, STAGE_COUNT> stage_ns{};
+    std::array<uint64_t, STAGE_COUNT> stage_calls{};
+    std::unordered_map<std::string, MappingCounters> mappings;
+    std::unordered_map<std::string, TransformCounters> transforms;
+
+    void merge(const ThreadStats& other);
+};
+
+// Merged view over all threads
+struct StatsSnapshot {
+    std::array<uint64_t, STAGE_COUNT> stage_ns{};
+    std::array<uint64_t, STAGE_COUNT> stage_calls{};
+    std::map<std::string, MappingCounters> mappings;
+    std::map<std::string, TransformCounters> transforms;
+    double wall_seconds{0.0};
+
+    // Per stage, then allocations outside any stage; only filled in when
+    // allocation tracking is compiled in
+    bool allocations_tracked{false};
+    std::array<AllocationCounters, STAGE_COUNT + 1> allocations{};
+};
+
+namespace detail {
+    extern std::atomic<bool> stats_enabled;
+
+    // Accumulator of the calling thread, registered on first use
+    ThreadStats& local_stats();
+}
+
+// Stats collection is off until enabled; disabled probes cost one relaxed load
+inline bool stats_enabled() {
+    return detail::stats_enabled.load(std::memory_order_relaxed);
+}
+
+void enable_stats(bool enabled = true);
+
+// Scoped monotonic timer for a pipeline stage. Nested timers are
+// exclusive: time spent in an inner stage is not charged to the outer one.
+class StageTimer {
+public:
+    explicit StageTimer(Stage stage);
+    ~StageTimer();
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+    Stage stage() const { return stage_; }
+
+private:
+    Stage stage_;
+    bool active_;
+    StageTimer* parent_{nullptr};
+    uint64_t child_ns_{0};
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Record one rendered row of `bytes` for a mapping
+inline void count_row(const std::string& mapping, size_t bytes) {
+    if (!stats_enabled()) return;
+    auto& counters = detail::local_stats().mappings[mapping];
+    ++counters.rows;
+    counters.bytes += bytes;
+    counters.row_sizes.record(bytes);
+}
+
+// Record one emitted statement of `bytes` holding `rows` rows for a mapping
+inline void count_statement(const std::string& mapping, size_t bytes, size_t rows,
+                            BatchClose close) {
+    if (!stats_enabled()) return;
+    auto& counters = detail::local_stats().mappings[mapping];
+    ++counters.statements;
+    counters.statement_bytes += bytes;
+    counters.statement_sizes.record(bytes);
+    counters.batch_rows.record(rows);
+    ++counters.batch_closes[static_cast<size_t>(close)];
+}
+
+// Record a transform invocation and whether it failed
+inline void count_transform(const std::string& name, bool failed) {
+    if (!stats_enabled()) return;
+    auto& counters = detail::local_stats().transforms[name];
+    ++counters.calls;
+    if (failed) ++counters.errors;
+}
+
+// Merge all thread accumulators. Call once worker threads are done.
+StatsSnapshot collect_stats();
+
+// Drop everything collected so far
+void reset_stats();
+
+// Human-readable report
+std::string format_stats(const StatsSnapshot& stats);
+
+// Machine-readable report
+nlohmann::json stats_to_json(const StatsSnapshot& stats);
+
+} // namespace telemetry
+
+#endif // NEBULA_MAPPER_STATS_HPP
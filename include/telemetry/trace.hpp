@@ -0,0 +1,84 @@
+#ifndef NEBULA_MAPPER_TRACE_HPP
+#define NEBULA_MAPPER_TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace telemetry {
+
+// One completed span, sized to a cache line
+struct TraceEvent {
+    const char* name{nullptr};   // Must point to a string literal
+    char detail[40]{};           // Optional label, e.g. the mapping name
+    int64_t start_ns{0};
+    int64_t duration_ns{0};
+};
+
+namespace detail {
+    extern std::atomic<bool> tracing_enabled;
+
+    // Append to the calling thread's ring buffer (single writer, lock-free)
+    void record_span(const char* name, const char* detail, size_t detail_len,
+                     int64_t start_ns, int64_t end_ns);
+
+    int64_t trace_clock_ns();
+}
+
+inline bool tracing_enabled() {
+    return detail::tracing_enabled.load(std::memory_order_relaxed);
+}
+
+// Start recording spans; each thread keeps the newest `events_per_thread`
+void enable_tracing(size_t events_per_thread = 1 << 16);
+
+// Write all recorded spans as Chrome trace-event JSON (Perfetto compatible).
+// Call after worker threads have finished.
+bool write_chrome_trace(const std::string& path);
+
+// Scoped span; does nothing unless tracing was enabled.
+// A detail string must outlive the span.
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name)
+        : name_(tracing_enabled() ? name : nullptr) {
+        if (name_) start_ns_ = detail::trace_clock_ns();
+    }
+
+    TraceSpan(const char* name, const std::string& detail)
+        : TraceSpan(name) {
+        detail_ = &detail;
+    }
+
+    ~TraceSpan() {
+        if (!name_) return;
+        detail::record_span(name_,
+                            detail_ ? detail_->data() : nullptr,
+                            detail_ ? detail_->size() : 0,
+                            start_ns_, detail::trace_clock_ns());
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name_;
+    const std::string* detail_{nullptr};
+    int64_t start_ns_{0};
+};
+
+} // namespace telemetry
+
+// Spans compile away entirely when tracing is disabled at build time
+#define NEBULA_MAPPER_TRACE_CONCAT_(a, b) a##b
+#define NEBULA_MAPPER_TRACE_CONCAT(a, b) NEBULA_MAPPER_TRACE_CONCAT_(a, b)
+
+#ifdef NEBULA_MAPPER_TRACING
+#define NEBULA_MAPPER_TRACE_SPAN(...) \
+    ::telemetry::TraceSpan NEBULA_MAPPER_TRACE_CONCAT(nm_trace_span_, __LINE__)(__VA_ARGS__)
+#else
+#define NEBULA_MAPPER_TRACE_SPAN(...) ((void)0)
+#endif
+
+#endif // NEBULA_MAPPER_TRACE_HPP
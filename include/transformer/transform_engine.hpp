@@ -1,6 +1,7 @@
 #ifndef NEBULA_MAPPER_TRANSFORM_ENGINE_HPP
 #define NEBULA_MAPPER_TRANSFORM_ENGINE_HPP
 
+#include "common/number_parser.hpp"
 #include "parser/mapping_parser.hpp"
 #include <string>
 #include <variant>
@@ -16,6 +17,8 @@ struct TransformValue {
     std::variant<std::string, int64_t, double, bool> value;
     std::string source_type;  // Original JSON type
     std::string target_type;  // Target Nebula type
+    // How numeric strings convert, from the property's `coerce`
+    common::numbers::CoercionMode coerce{common::numbers::CoercionMode::STRICT};
 };
 
 // Transform error type
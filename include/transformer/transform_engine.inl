@@ -1,6 +1,8 @@
 #ifndef NEBULA_MAPPER_TRANSFORM_ENGINE_INL
 #define NEBULA_MAPPER_TRANSFORM_ENGINE_INL
 
+#include "common/number_parser.hpp"
+#include <limits>
 #include <string>
 #include <stdexcept>
 #include <type_traits>
@@ -27,13 +29,37 @@ namespace transformer {
                     }, value.value);
                 }
                 else if constexpr (std::is_arithmetic_v<T>) {
-                    return std::visit([](const auto& v) -> T {
+                    return std::visit([&value](const auto& v) -> T {
                         using V = std::decay_t<decltype(v)>;
                         if constexpr (std::is_arithmetic_v<V>) {
                             return static_cast<T>(v);
                         }
                         else if constexpr (std::is_same_v<V, std::string>) {
-                            return static_cast<T>(std::stod(v));
+                            // Integers are read exactly; a double would round
+                            // IDs above 2^53
+                            if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool>) {
+                                auto parsed = common::numbers::parse_int64(v, value.coerce);
+                                if (const auto* error = std::get_if<common::Error>(&parsed)) {
+                                    throw std::runtime_error(error->message);
+                                }
+                                int64_t number = std::get<int64_t>(parsed);
+                                using Limits = std::numeric_limits<T>;
+                                bool fits = std::is_signed_v<T>
+                                    ? number >= static_cast<int64_t>(Limits::min()) &&
+                                      number <= static_cast<int64_t>(Limits::max())
+                                    : number >= 0 && static_cast<uint64_t>(number) <=
+                                                     static_cast<uint64_t>(Limits::max());
+                                if (!fits) {
+                                    throw std::runtime_error("'" + v + "' is out of range");
+                                }
+                                return static_cast<T>(number);
+                            } else {
+                                auto parsed = common::numbers::parse_double(v, value.coerce);
+                                if (const auto* error = std::get_if<common::Error>(&parsed)) {
+                                    throw std::runtime_error(error->message);
+                                }
+                                return static_cast<T>(std::get<double>(parsed));
+                            }
                         }
                         throw std::runtime_error("Invalid type conversion");
                     }, value.value);
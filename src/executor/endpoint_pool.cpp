@@ -0,0 +1,225 @@
+#include "executor/endpoint_pool.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace executor {
+
+namespace {
+    int64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void update_max(std::atomic<uint64_t>& target, uint64_t value) {
+        uint64_t current = target.load(std::memory_order_relaxed);
+        while (value > current &&
+               !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+}
+
+Result<std::vector<Endpoint>> parse_endpoints(const std::string& list) {
+    std::vector<Endpoint> endpoints;
+    size_t start = 0;
+
+    while (start <= list.size()) {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos) end = list.size();
+        std::string item = list.substr(start, end - start);
+        start = end + 1;
+
+        if (item.empty()) continue;
+
+        Endpoint endpoint;
+        auto colon = item.rfind(':');
+        if (colon == std::string::npos) {
+            return Error{"Missing port", item};
+        }
+        endpoint.host = item.substr(0, colon);
+        try {
+            unsigned long port = std::stoul(item.substr(colon + 1));
+            if (port == 0 || port > std::numeric_limits<uint16_t>::max()) {
+                return Error{"Invalid port", item};
+            }
+            endpoint.port = static_cast<uint16_t>(port);
+        } catch (const std::exception&) {
+            return Error{"Invalid port", item};
+        }
+
+        if (endpoint.host.empty()) {
+            return Error{"Missing host", item};
+        }
+        endpoints.push_back(std::move(endpoint));
+    }
+
+    if (endpoints.empty()) {
+        return Error{"No endpoints given"};
+    }
+    return endpoints;
+}
+
+EndpointPool::EndpointPool(std::vector<Endpoint> endpoints,
+                           HealthOptions options,
+                           ProbeFunction probe)
+    : options_(options),
+      probe_(std::move(probe)),
+      created_(std::chrono::steady_clock::now()) {
+    for (auto& endpoint : endpoints) {
+        auto slot = std::make_unique<Slot>();
+        slot->endpoint = std::move(endpoint);
+        slot->eject_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            options_.eject_duration).count();
+        slots_.push_back(std::move(slot));
+    }
+}
+
+std::optional<size_t> EndpointPool::acquire() {
+    const int64_t now = now_ns();
+
+    for (;;) {
+        std::optional<size_t> best;
+        uint32_t best_outstanding = std::numeric_limits<uint32_t>::max();
+
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            auto& slot = *slots_[i];
+            auto health = slot.health.load(std::memory_order_acquire);
+
+            // Re-admit ejected endpoints once their ejection window is over
+            if (health == Health::EJECTED &&
+                now >= slot.retry_at_ns.load(std::memory_order_relaxed)) {
+                if (try_probe(slot, now)) {
+                    health = Health::HEALTHY;
+                }
+            }
+            if (health != Health::HEALTHY) continue;
+
+            uint32_t outstanding = slot.outstanding.load(std::memory_order_relaxed);
+            if (outstanding < best_outstanding) {
+                best = i;
+                best_outstanding = outstanding;
+            }
+        }
+
+        if (!best) return std::nullopt;
+
+        // Another thread may have raced us to the same slot; retry if so
+        auto& slot = *slots_[*best];
+        if (slot.outstanding.compare_exchange_strong(
+                best_outstanding, best_outstanding + 1, std::memory_order_acq_rel)) {
+            return best;
+        }
+    }
+}
+
+void EndpointPool::release(size_t index,
+                           Outcome outcome,
+                           std::chrono::steady_clock::duration latency,
+                           size_t statements,
+                           size_t bytes) {
+    auto& slot = *slots_[index];
+    slot.outstanding.fetch_sub(1, std::memory_order_acq_rel);
+
+    auto latency_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count());
+    slot.requests.fetch_add(1, std::memory_order_relaxed);
+    slot.latency_ns_total.fetch_add(latency_ns, std::memory_order_relaxed);
+    update_max(slot.latency_ns_max, latency_ns);
+
+    switch (outcome) {
+        case Outcome::SUCCESS:
+            slot.consecutive_timeouts.store(0, std::memory_order_relaxed);
+            slot.statements.fetch_add(statements, std::memory_order_relaxed);
+            slot.bytes.fetch_add(bytes, std::memory_order_relaxed);
+            // A successful answer resets the ejection backoff
+            slot.eject_ns.store(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                options_.eject_duration).count(), std::memory_order_relaxed);
+            break;
+        case Outcome::FAILURE:
+            slot.consecutive_timeouts.store(0, std::memory_order_relaxed);
+            slot.failures.fetch_add(1, std::memory_order_relaxed);
+            break;
+        case Outcome::TIMEOUT:
+            slot.timeouts.fetch_add(1, std::memory_order_relaxed);
+            if (slot.consecutive_timeouts.fetch_add(1, std::memory_order_relaxed) + 1 >=
+                options_.max_consecutive_timeouts) {
+                eject(slot, now_ns());
+            }
+            break;
+    }
+}
+
+void EndpointPool::eject(Slot& slot, int64_t now) {
+    auto expected = Health::HEALTHY;
+    if (!slot.health.compare_exchange_strong(expected, Health::EJECTED,
+                                             std::memory_order_acq_rel)) {
+        return;
+    }
+
+    int64_t window = slot.eject_ns.load(std::memory_order_relaxed);
+    slot.retry_at_ns.store(now + window, std::memory_order_relaxed);
+    slot.ejections.fetch_add(1, std::memory_order_relaxed);
+
+    // Double the window for the next ejection, up to the configured maximum
+    int64_t max_window = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        options_.max_eject_duration).count();
+    slot.eject_ns.store(std::min(window * 2, max_window), std::memory_order_relaxed);
+}
+
+bool EndpointPool::try_probe(Slot& slot, int64_t now) {
+    // Only one thread probes a given endpoint at a time
+    auto expected = Health::EJECTED;
+    if (!slot.health.compare_exchange_strong(expected, Health::PROBING,
+                                             std::memory_order_acq_rel)) {
+        return false;
+    }
+
+    bool reachable = probe_ ? probe_(slot.endpoint) : true;
+    if (reachable) {
+        slot.consecutive_timeouts.store(0, std::memory_order_relaxed);
+        slot.health.store(Health::HEALTHY, std::memory_order_release);
+        return true;
+    }
+
+    int64_t window = slot.eject_ns.load(std::memory_order_relaxed);
+    slot.retry_at_ns.store(now + window, std::memory_order_relaxed);
+    int64_t max_window = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        options_.max_eject_duration).count();
+    slot.eject_ns.store(std::min(window * 2, max_window), std::memory_order_relaxed);
+    slot.health.store(Health::EJECTED, std::memory_order_release);
+    return false;
+}
+
+std::vector<EndpointSnapshot> EndpointPool::snapshot() const {
+    std::vector<EndpointSnapshot> result;
+    double elapsed_sec = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - created_).count();
+
+    for (const auto& slot_ptr : slots_) {
+        const auto& slot = *slot_ptr;
+        EndpointSnapshot snap;
+        snap.endpoint = slot.endpoint;
+        snap.health = slot.health.load(std::memory_order_relaxed);
+        snap.outstanding = slot.outstanding.load(std::memory_order_relaxed);
+        snap.requests = slot.requests.load(std::memory_order_relaxed);
+        snap.failures = slot.failures.load(std::memory_order_relaxed);
+        snap.timeouts = slot.timeouts.load(std::memory_order_relaxed);
+        snap.ejections = slot.ejections.load(std::memory_order_relaxed);
+        snap.statements = slot.statements.load(std::memory_order_relaxed);
+        snap.bytes = slot.bytes.load(std::memory_order_relaxed);
+
+        if (snap.requests > 0) {
+            snap.avg_latency_ms = static_cast<double>(
+                slot.latency_ns_total.load(std::memory_order_relaxed)) /
+                static_cast<double>(snap.requests) / 1e6;
+        }
+        snap.max_latency_ms = static_cast<double>(
+            slot.latency_ns_max.load(std::memory_order_relaxed)) / 1e6;
+        if (elapsed_sec > 0) {
+            snap.statements_per_sec = static_cast<double>(snap.statements) / elapsed_sec;
+        }
+        result.push_back(snap);
+    }
+    return result;
+}
+
+} // namespace executor
@@ -0,0 +1,132 @@
+#include "executor/statement_executor.hpp"
+#include "telemetry/metrics.hpp"
+#include "telemetry/probes.hpp"
+#include "telemetry/trace.hpp"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace executor {
+
+StatementExecutor::StatementExecutor(std::vector<Endpoint> endpoints,
+                                     ExecutorOptions options,
+                                     Transport transport,
+                                     ProbeFunction probe)
+    : options_(options),
+      transport_(std::move(transport)),
+      pool_(std::move(endpoints),
+            options.health,
+            probe ? std::move(probe) : ProbeFunction{[timeout = options.request_timeout](
+                                                         const Endpoint& endpoint) {
+                return tcp_connect_probe(endpoint, timeout);
+            }}) {
+    if (options_.concurrency == 0) {
+        options_.concurrency = 1;
+    }
+}
+
+std::optional<std::string> StatementExecutor::execute_one(const std::string& statement) {
+    const std::string request = options_.space.empty()
+        ? statement
+        : "USE `" + options_.space + "`; " + statement;
+    std::string last_error = "No attempt made";
+    size_t attempts = 0;
+    auto unavailable_since = std::chrono::steady_clock::now();
+
+    while (attempts <= options_.max_retries) {
+        auto index = pool_.acquire();
+        if (!index) {
+            // Every endpoint is ejected; wait for a re-probe window to open
+            if (std::chrono::steady_clock::now() - unavailable_since >
+                options_.unavailable_timeout) {
+                return "All endpoints are unavailable (" + last_error + ")";
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+
+        ++attempts;
+        NEBULA_MAPPER_TRACE_SPAN("write", pool_.endpoint(*index).host);
+        bool metrics = telemetry::metrics_enabled();
+        if (metrics) telemetry::pipeline_metrics().in_flight.add(1);
+        auto start = std::chrono::steady_clock::now();
+        auto result = transport_(pool_.endpoint(*index), request, options_.request_timeout);
+        auto latency = std::chrono::steady_clock::now() - start;
+        pool_.release(*index, result.outcome, latency, 1, request.size());
+        NEBULA_MAPPER_PROBE5(statement_written, pool_.endpoint(*index).host.c_str(),
+                             pool_.endpoint(*index).port, request.size(),
+                             std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count(),
+                             static_cast<int>(result.outcome));
+        if (metrics) {
+            auto& pipeline = telemetry::pipeline_metrics();
+            pipeline.in_flight.add(-1);
+            pipeline.request_latency_ns.record(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count()));
+        }
+
+        if (result.outcome == Outcome::SUCCESS) {
+            return std::nullopt;
+        }
+        last_error = pool_.endpoint(*index).to_string() + ": " + result.message;
+        // A rejection is deterministic, and a sent statement may have run
+        if (result.outcome == Outcome::FAILURE ||
+            (result.sent && !options_.retry_timeouts)) {
+            return last_error;
+        }
+        unavailable_since = std::chrono::steady_clock::now();
+    }
+
+    return last_error;
+}
+
+ExecutionSummary StatementExecutor::execute(const std::vector<std::string>& statements,
+                                            bool ordered) {
+    ExecutionSummary summary;
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> executed{0};
+    std::mutex errors_mutex;
+
+    bool metrics = telemetry::metrics_enabled();
+    if (metrics) {
+        telemetry::pipeline_metrics().queue_depth.add(static_cast<int64_t>(statements.size()));
+    }
+
+    auto worker = [&]() {
+        for (;;) {
+            size_t i = next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= statements.size()) return;
+            if (metrics) telemetry::pipeline_metrics().queue_depth.add(-1);
+
+            auto error = execute_one(statements[i]);
+            if (error) {
+                if (metrics) telemetry::pipeline_metrics().execute_errors.add();
+                std::lock_guard<std::mutex> lock(errors_mutex);
+                summary.errors.push_back(*error);
+            } else {
+                executed.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    size_t threads = ordered ? 1 : std::min(options_.concurrency, statements.size());
+    if (threads <= 1) {
+        worker();
+    } else {
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (size_t i = 0; i < threads; ++i) {
+            workers.emplace_back(worker);
+        }
+        for (auto& t : workers) {
+            t.join();
+        }
+    }
+
+    summary.executed = executed.load();
+    summary.failed = summary.errors.size();
+    summary.endpoints = pool_.snapshot();
+    return summary;
+}
+
+} // namespace executor
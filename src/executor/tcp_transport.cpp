@@ -0,0 +1,137 @@
+#include "executor/transport.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace executor {
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // Closes the socket when leaving scope
+    struct SocketGuard {
+        int fd{-1};
+        ~SocketGuard() {
+            if (fd >= 0) ::close(fd);
+        }
+    };
+
+    int remaining_ms(Clock::time_point deadline) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - Clock::now()).count();
+        return left > 0 ? static_cast<int>(left) : 0;
+    }
+
+    bool wait_for(int fd, short events, Clock::time_point deadline) {
+        pollfd pfd{fd, events, 0};
+        for (;;) {
+            int rc = ::poll(&pfd, 1, remaining_ms(deadline));
+            if (rc > 0) return true;
+            if (rc == 0) return false;
+            if (errno != EINTR) return false;
+        }
+    }
+
+    // Non-blocking connect bounded by the deadline; returns -1 on failure
+    int connect_with_deadline(const Endpoint& endpoint, Clock::time_point deadline) {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        addrinfo* addresses = nullptr;
+        auto port = std::to_string(endpoint.port);
+        if (::getaddrinfo(endpoint.host.c_str(), port.c_str(), &hints, &addresses) != 0) {
+            return -1;
+        }
+
+        int connected = -1;
+        for (auto* ai = addresses; ai != nullptr && connected < 0; ai = ai->ai_next) {
+            int fd = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd < 0) continue;
+
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+            int rc = ::connect(fd, ai->ai_addr, ai->ai_addrlen);
+            if (rc != 0 && errno == EINPROGRESS && wait_for(fd, POLLOUT, deadline)) {
+                int error = 0;
+                socklen_t len = sizeof(error);
+                ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len);
+                rc = error == 0 ? 0 : -1;
+            }
+
+            if (rc == 0) {
+                connected = fd;
+            } else {
+                ::close(fd);
+            }
+        }
+
+        ::freeaddrinfo(addresses);
+        return connected;
+    }
+}
+
+SendResult tcp_line_transport(const Endpoint& endpoint,
+                              const std::string& statement,
+                              std::chrono::milliseconds timeout) {
+    auto deadline = Clock::now() + timeout;
+
+    SocketGuard socket;
+    socket.fd = connect_with_deadline(endpoint, deadline);
+    if (socket.fd < 0) {
+        return {Outcome::TIMEOUT, "Cannot connect to " + endpoint.to_string(), false};
+    }
+
+    std::string request = statement;
+    request.push_back('\n');
+
+    size_t sent = 0;
+    while (sent < request.size()) {
+        if (!wait_for(socket.fd, POLLOUT, deadline)) {
+            return {Outcome::TIMEOUT, "Send timed out", sent > 0};
+        }
+        ssize_t n = ::send(socket.fd, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EINTR) continue;
+            return {Outcome::TIMEOUT, "Send failed: " + std::string(std::strerror(errno)),
+                    sent > 0};
+        }
+        sent += static_cast<size_t>(n);
+    }
+
+    std::string response;
+    char buffer[256];
+    while (response.find('\n') == std::string::npos) {
+        if (!wait_for(socket.fd, POLLIN, deadline)) {
+            return {Outcome::TIMEOUT, "Response timed out"};
+        }
+        ssize_t n = ::recv(socket.fd, buffer, sizeof(buffer), 0);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EINTR) continue;
+            return {Outcome::TIMEOUT, "Receive failed: " + std::string(std::strerror(errno))};
+        }
+        if (n == 0) {
+            return {Outcome::TIMEOUT, "Connection closed by " + endpoint.to_string()};
+        }
+        response.append(buffer, static_cast<size_t>(n));
+    }
+
+    response.erase(response.find('\n'));
+    if (!response.empty() && response.back() == '\r') response.pop_back();
+
+    if (response.rfind("OK", 0) == 0) {
+        return {Outcome::SUCCESS, response};
+    }
+    return {Outcome::FAILURE, response};
+}
+
+bool tcp_connect_probe(const Endpoint& endpoint, std::chrono::milliseconds timeout) {
+    SocketGuard socket;
+    socket.fd = connect_with_deadline(endpoint, Clock::now() + timeout);
+    return socket.fd >= 0;
+}
+
+} // namespace executor
@@ -0,0 +1,349 @@
+#include "graph/aggregates.hpp"
+#include "graph/nebula_value.hpp"
+#include "graph/statement_generator.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+namespace graph {
+
+namespace {
+    // splitmix64's finalizer, so nearby inputs spread over all 64 bits
+    uint64_t mix(uint64_t hash) {
+        hash ^= hash >> 30;
+        hash *= 0xbf58476d1ce4e5b9ull;
+        hash ^= hash >> 27;
+        hash *= 0x94d049bb133111ebull;
+        return hash ^ (hash >> 31);
+    }
+
+    uint64_t fnv1a(char kind, const char* data, size_t size) {
+        uint64_t hash = 14695981039346656037ull;
+        hash = (hash ^ static_cast<unsigned char>(kind)) * 1099511628211ull;
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ull;
+        }
+        return mix(hash);
+    }
+
+    // Add with the overflow going to the real part
+    void add_integer(int64_t& int_sum, double& real_sum, bool& integral, int64_t value) {
+        int64_t sum = 0;
+        if (__builtin_add_overflow(int_sum, value, &sum)) {
+            real_sum += static_cast<double>(value);
+            integral = false;
+        } else {
+            int_sum = sum;
+        }
+    }
+
+    std::string value_path(const parser::mapping::Aggregate& aggregate) {
+        return aggregate.json_path.empty() ? aggregate.over
+                                           : aggregate.over + "/" + aggregate.json_path;
+    }
+
+    // Map node, key and vector of one VID's state; the estimate of a hash
+    // node and its bucket
+    constexpr size_t STATE_OVERHEAD = sizeof(std::string) + sizeof(std::vector<Accumulator>) + 32;
+
+    size_t state_bytes(const std::string& vid, const std::vector<Accumulator>& state) {
+        size_t bytes = STATE_OVERHEAD + vid.size();
+        for (const auto& accumulator : state) {
+            bytes += accumulator.footprint();
+        }
+        return bytes;
+    }
+}
+
+void HyperLogLog::add(uint64_t hash) {
+    if (!registers_.empty()) {
+        add_dense(hash);
+        return;
+    }
+    auto it = std::lower_bound(sparse_.begin(), sparse_.end(), hash);
+    if (it != sparse_.end() && *it == hash) return;
+    sparse_.insert(it, hash);
+    if (sparse_.size() > SPARSE_LIMIT) densify();
+}
+
+void HyperLogLog::merge(const HyperLogLog& other) {
+    if (other.registers_.empty()) {
+        for (uint64_t hash : other.sparse_) add(hash);
+        return;
+    }
+    if (registers_.empty()) densify();
+    for (size_t i = 0; i < registers_.size(); ++i) {
+        registers_[i] = std::max(registers_[i], other.registers_[i]);
+    }
+}
+
+uint64_t HyperLogLog::estimate() const {
+    if (registers_.empty()) return sparse_.size();
+
+    const double m = static_cast<double>(registers_.size());
+    double sum = 0;
+    size_t zeros = 0;
+    for (uint8_t rank : registers_) {
+        sum += std::ldexp(1.0, -rank);
+        zeros += rank == 0;
+    }
+    double estimate = 0.7213 / (1 + 1.079 / m) * m * m / sum;
+    // Linear counting while many registers are still empty
+    if (estimate <= 2.5 * m && zeros > 0) {
+        estimate = m * std::log(m / static_cast<double>(zeros));
+    }
+    return static_cast<uint64_t>(std::llround(estimate));
+}
+
+size_t HyperLogLog::heap_bytes() const {
+    return sparse_.capacity() * sizeof(uint64_t) + registers_.capacity();
+}
+
+void HyperLogLog::densify() {
+    registers_.assign(size_t{1} << PRECISION, 0);
+    for (uint64_t hash : sparse_) add_dense(hash);
+    sparse_.clear();
+    sparse_.shrink_to_fit();
+}
+
+void HyperLogLog::add_dense(uint64_t hash) {
+    uint64_t rest = hash << PRECISION;
+    auto rank = static_cast<uint8_t>(rest ? __builtin_clzll(rest) + 1 : 64 - PRECISION + 1);
+    auto& slot = registers_[hash >> (64 - PRECISION)];
+    slot = std::max(slot, rank);
+}
+
+uint64_t hash_value(const parser::json::JsonDocument& value) {
+    if (value.is_string()) {
+        const auto& text = value.get_ref<const std::string&>();
+        return fnv1a('s', text.data(), text.size());
+    }
+
+    std::optional<int64_t> integer;
+    if (value.is_number_integer()) {
+        integer = value.get<int64_t>();
+    } else if (value.is_number_unsigned() && value.get<uint64_t>() <= INT64_MAX) {
+        integer = static_cast<int64_t>(value.get<uint64_t>());
+    } else if (value.is_number_float()) {
+        double real = value.get<double>();
+        if (std::trunc(real) == real && std::fabs(real) < 9.2e18) {
+            integer = static_cast<int64_t>(real);
+        }
+    }
+    if (integer) {
+        char buffer[24];
+        auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), *integer);
+        return fnv1a('i', buffer, static_cast<size_t>(end - buffer));
+    }
+
+    auto text = value.dump();
+    return fnv1a('j', text.data(), text.size());
+}
+
+common::Result<bool, StatementError> Accumulator::add(const parser::json::JsonDocument* value,
+                                                      const std::string& json_path) {
+    using parser::mapping::AggregateOp;
+    if (!value || value->is_null()) return true;
+
+    switch (op_) {
+        case AggregateOp::COUNT:
+            break;
+        case AggregateOp::SUM:
+        case AggregateOp::AVG:
+            if (value->is_number_integer() ||
+                (value->is_number_unsigned() && value->get<uint64_t>() <= INT64_MAX)) {
+                add_integer(int_sum_, real_sum_, integral_, value->get<int64_t>());
+            } else {
+                auto real = to_nebula_value(*value, TypeSpec{NebulaType::DOUBLE}, json_path);
+                if (std::holds_alternative<StatementError>(real)) {
+                    return std::get<StatementError>(real);
+                }
+                real_sum_ += std::get<NebulaValue>(real).as_double();
+                integral_ = false;
+            }
+            break;
+        case AggregateOp::MIN:
+            if (count_ == 0 || *value < extreme_) extreme_ = *value;
+            break;
+        case AggregateOp::MAX:
+            if (count_ == 0 || extreme_ < *value) extreme_ = *value;
+            break;
+        case AggregateOp::DISTINCT:
+            distinct_.add(hash_value(*value));
+            break;
+    }
+    ++count_;
+    return true;
+}
+
+void Accumulator::merge(const Accumulator& other) {
+    using parser::mapping::AggregateOp;
+    if (other.count_ == 0) return;
+
+    add_integer(int_sum_, real_sum_, integral_, other.int_sum_);
+    real_sum_ += other.real_sum_;
+    integral_ = integral_ && other.integral_;
+    if (count_ == 0 ||
+        (op_ == AggregateOp::MIN && other.extreme_ < extreme_) ||
+        (op_ == AggregateOp::MAX && extreme_ < other.extreme_)) {
+        extreme_ = other.extreme_;
+    }
+    distinct_.merge(other.distinct_);
+    count_ += other.count_;
+}
+
+common::Result<std::string, StatementError> Accumulator::literal(
+    const parser::mapping::Aggregate& aggregate) const {
+    using parser::mapping::AggregateOp;
+
+    auto spec = parse_type(aggregate.nebula_type);
+    if (!spec) {
+        return StatementError{"Unsupported aggregate type: " + aggregate.nebula_type,
+                              aggregate.name};
+    }
+
+    parser::json::JsonDocument result;
+    switch (op_) {
+        case AggregateOp::COUNT:
+            result = count_;
+            break;
+        case AggregateOp::DISTINCT:
+            result = distinct_.estimate();
+            break;
+        case AggregateOp::SUM:
+            if (count_ == 0) break;
+            if (integral_) {
+                result = int_sum_;
+            } else {
+                result = static_cast<double>(int_sum_) + real_sum_;
+            }
+            break;
+        case AggregateOp::AVG:
+            if (count_ == 0) break;
+            result = (static_cast<double>(int_sum_) + real_sum_) / static_cast<double>(count_);
+            break;
+        case AggregateOp::MIN:
+        case AggregateOp::MAX:
+            if (count_ > 0) result = extreme_;
+            break;
+    }
+
+    if (result.is_number_float() && !std::isfinite(result.get<double>())) {
+        return StatementError{"Aggregate result overflows DOUBLE", aggregate.name,
+                              value_path(aggregate)};
+    }
+
+    auto value = to_nebula_value(result, *spec, value_path(aggregate));
+    if (std::holds_alternative<StatementError>(value)) {
+        return std::get<StatementError>(value);
+    }
+    std::string out;
+    append_literal(out, std::get<NebulaValue>(value));
+    return out;
+}
+
+size_t Accumulator::footprint() const {
+    size_t bytes = sizeof(Accumulator) + distinct_.heap_bytes();
+    if (extreme_.is_string()) bytes += extreme_.get_ref<const std::string&>().capacity();
+    return bytes;
+}
+
+void AggregateTable::set_budget(MemoryBudget* budget) {
+    if (budget_) budget_->release(MemoryConsumer::AGGREGATES, bytes_);
+    budget_ = budget;
+    if (budget_) budget_->charge(MemoryConsumer::AGGREGATES, bytes_);
+}
+
+void AggregateTable::charge(size_t before, size_t after) {
+    if (after >= before) {
+        bytes_ += after - before;
+        if (budget_) budget_->charge(MemoryConsumer::AGGREGATES, after - before);
+    } else {
+        bytes_ -= before - after;
+        if (budget_) budget_->release(MemoryConsumer::AGGREGATES, before - after);
+    }
+}
+
+void AggregateTable::clear() {
+    if (budget_) budget_->release(MemoryConsumer::AGGREGATES, bytes_);
+    bytes_ = 0;
+    states_.clear();
+}
+
+void AggregateTable::merge(const parser::mapping::VertexMapping& vertex, const std::string& vid,
+                           const std::vector<const Accumulator*>& accumulators) {
+    auto [it, fresh] = states_[vertex.tag_name].try_emplace(vid);
+    auto& state = it->second;
+    if (fresh) {
+        for (const auto& aggregate : vertex.aggregates) {
+            if (aggregate.update) state.emplace_back(aggregate.op);
+        }
+    }
+    const size_t before = fresh ? 0 : state_bytes(vid, state);
+
+    size_t next = 0;
+    for (size_t i = 0; i < vertex.aggregates.size(); ++i) {
+        if (vertex.aggregates[i].update) state[next++].merge(*accumulators[i]);
+    }
+    charge(before, state_bytes(vid, state));
+}
+
+void AggregateTable::merge(AggregateTable&& other) {
+    for (auto& [tag, vertices] : other.states_) {
+        auto& mine = states_[tag];
+        for (auto& [vid, state] : vertices) {
+            auto [it, fresh] = mine.try_emplace(vid);
+            const size_t before = fresh ? 0 : state_bytes(vid, it->second);
+            if (fresh) {
+                it->second = std::move(state);
+            } else {
+                for (size_t i = 0; i < state.size(); ++i) {
+                    it->second[i].merge(state[i]);
+                }
+            }
+            charge(before, state_bytes(vid, it->second));
+        }
+    }
+    other.clear();
+}
+
+common::Result<std::vector<std::string>, StatementError> AggregateTable::update_statements(
+    const parser::mapping::GraphMapping& mapping) {
+
+    std::vector<std::string> statements;
+    for (const auto& vertex : mapping.vertices) {
+        auto tag = states_.find(vertex.tag_name);
+        if (tag == states_.end()) continue;
+
+        std::vector<const std::string*> vids;
+        vids.reserve(tag->second.size());
+        for (const auto& entry : tag->second) {
+            vids.push_back(&entry.first);
+        }
+        std::sort(vids.begin(), vids.end(),
+                  [](const std::string* a, const std::string* b) { return *a < *b; });
+
+        const auto prefix = "UPDATE VERTEX ON " +
+                            StatementGenerator::quote_identifier(vertex.tag_name) + " ";
+        for (const auto* vid : vids) {
+            const auto& state = tag->second.at(*vid);
+            std::string statement = prefix + *vid + " SET ";
+            size_t next = 0;
+            for (const auto& aggregate : vertex.aggregates) {
+                if (!aggregate.update) continue;
+                auto literal = state[next].literal(aggregate);
+                if (std::holds_alternative<StatementError>(literal)) {
+                    return std::get<StatementError>(literal);
+                }
+                if (next++ > 0) statement += ", ";
+                statement += StatementGenerator::quote_identifier(aggregate.name) + " = " +
+                             std::get<std::string>(literal);
+            }
+            statements.push_back(statement + ";");
+        }
+    }
+    clear();
+    return statements;
+}
+
+} // namespace graph
@@ -0,0 +1,466 @@
+#include "graph/codegen.hpp"
+#include <cstdio>
+#include <map>
+#include <sstream>
+
+namespace graph {
+
+namespace {
+    // Helpers and the C entry points every extractor shares. Anything a
+    // helper cannot render exactly like StatementGenerator throws Fallback
+    // and the whole document goes to the interpreter.
+    constexpr const char* PRELUDE = R"cpp(#include <nlohmann/json.hpp>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+using json = nlohmann::json;
+
+struct Fallback {};
+
+// Same layout as graph::CompiledBatch
+struct Batch {
+    std::uint32_t mapping{0};
+    std::vector<std::uint32_t> row_bytes;
+};
+
+[[maybe_unused]] const json& key(const json& node, const char* name) {
+    if (!node.is_object()) throw Fallback{};
+    auto it = node.find(name);
+    if (it == node.end()) throw Fallback{};
+    return *it;
+}
+
+[[maybe_unused]] const json& index(const json& node, std::size_t i) {
+    if (!node.is_array() || i >= node.size()) throw Fallback{};
+    return node[i];
+}
+
+[[maybe_unused]] const json& invalid(const json&) {
+    throw Fallback{};
+}
+
+[[maybe_unused]] void append_escaped(std::string& out, const std::string& s) {
+    for (char c : s) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            default: {
+                auto byte = static_cast<unsigned char>(c);
+                if (byte >= 0x20 && byte != 0x7F) {
+                    out += c;
+                    break;
+                }
+                out += '\\';
+                out += static_cast<char>('0' + (byte >> 6));
+                out += static_cast<char>('0' + ((byte >> 3) & 7));
+                out += static_cast<char>('0' + (byte & 7));
+            }
+        }
+    }
+}
+
+[[maybe_unused]] void append_id(std::string& out, const json& v) {
+    out += '"';
+    if (v.is_string()) {
+        append_escaped(out, v.get_ref<const std::string&>());
+    } else if (v.is_number()) {
+        out += std::to_string(v.get<std::int64_t>());
+    } else {
+        throw Fallback{};
+    }
+    out += '"';
+}
+
+[[maybe_unused]] void append_string(std::string& out, const json& v) {
+    if (v.is_null()) { out += "NULL"; return; }
+    if (!v.is_string()) throw Fallback{};
+    out += '"';
+    append_escaped(out, v.get_ref<const std::string&>());
+    out += '"';
+}
+
+[[maybe_unused]] void append_int(std::string& out, const json& v) {
+    if (v.is_null()) { out += "NULL"; return; }
+    if (!v.is_number() && !v.is_boolean()) throw Fallback{};
+    out += std::to_string(v.get<std::int64_t>());
+}
+
+[[maybe_unused]] void append_double(std::string& out, const json& v) {
+    if (v.is_null()) { out += "NULL"; return; }
+    if (!v.is_number() && !v.is_boolean()) throw Fallback{};
+    char buffer[32];
+    auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), v.get<double>());
+    out.append(buffer, end);
+}
+
+[[maybe_unused]] void append_bool(std::string& out, const json& v) {
+    if (v.is_null()) { out += "NULL"; return; }
+    if (!v.is_boolean()) throw Fallback{};
+    out += v.get<bool>() ? "true" : "false";
+}
+
+template<typename F>
+void for_each_item(const json& source, F&& f) {
+    if (source.is_array()) {
+        for (const auto& item : source) f(item);
+    } else {
+        f(source);
+    }
+}
+
+void generate(const json& doc, std::size_t batch_size,
+              std::vector<std::string>& out, std::uint64_t& rows,
+              std::vector<Batch>* batches);
+
+} // namespace
+
+extern "C" {
+
+unsigned nebula_mapper_extractor_abi() {
+    return %ABI%;
+}
+
+std::uint64_t nebula_mapper_extractor_json() {
+    return (NLOHMANN_JSON_VERSION_MAJOR * 10000 + NLOHMANN_JSON_VERSION_MINOR * 100 +
+            NLOHMANN_JSON_VERSION_PATCH) * 2 + (JSON_DIAGNOSTICS ? 1 : 0);
+}
+
+const char* nebula_mapper_extractor_hash() {
+    return "%HASH%";
+}
+
+// 0 with the statements, and their batches if asked for, appended; or 1
+// if the document needs the interpreter
+int nebula_mapper_extract(const void* document, std::size_t batch_size,
+                          void* statements, std::uint64_t* rows, void* batches) {
+    std::vector<std::string> out;
+    std::vector<Batch> out_batches;
+    std::uint64_t generated = 0;
+    try {
+        generate(*static_cast<const json*>(document), batch_size, out, generated,
+                 batches ? &out_batches : nullptr);
+    } catch (...) {
+        return 1;
+    }
+    auto& target = *static_cast<std::vector<std::string>*>(statements);
+    for (auto& statement : out) {
+        target.push_back(std::move(statement));
+    }
+    if (batches) {
+        auto& target_batches = *static_cast<std::vector<Batch>*>(batches);
+        for (auto& batch : out_batches) {
+            target_batches.push_back(std::move(batch));
+        }
+    }
+    *rows += generated;
+    return 0;
+}
+
+} // extern "C"
+)cpp";
+
+    std::string replace_all(std::string text, const std::string& from, const std::string& to) {
+        for (size_t at = text.find(from); at != std::string::npos;
+             at = text.find(from, at + to.size())) {
+            text.replace(at, from.size(), to);
+        }
+        return text;
+    }
+
+    // `value` as a C++ string literal
+    std::string literal(const std::string& value) {
+        std::string result = "\"";
+        for (unsigned char c : value) {
+            if (c == '"' || c == '\\') {
+                result += '\\';
+                result += static_cast<char>(c);
+            } else if (c < 0x20 || c >= 0x7f || c == '?') {
+                // Three octal digits, so a following digit never joins in;
+                // '?' too, so no trigraphs
+                char buffer[8];
+                std::snprintf(buffer, sizeof(buffer), "\\%03o", c);
+                result += buffer;
+            } else {
+                result += static_cast<char>(c);
+            }
+        }
+        return result + "\"";
+    }
+
+    // Expression for the node at `path` under `base`, following
+    // parser::json::detail::navigate_path
+    std::string path_expression(const std::string& base, const std::string& path) {
+        std::string expression = base;
+        for (const auto& segment : parser::json::detail::split_path(path)) {
+            if (segment.front() == '[' && segment.back() == ']') {
+                try {
+                    size_t index = std::stoul(segment.substr(1, segment.length() - 2));
+                    expression = "index(" + expression + ", " + std::to_string(index) + "u)";
+                } catch (const std::exception&) {
+                    expression = "invalid(" + expression + ")";
+                }
+            } else {
+                expression = "key(" + expression + ", " + literal(segment) + ")";
+            }
+        }
+        return expression;
+    }
+
+    // Renderer matching the conversion extract_value applies for `type`
+    std::string value_renderer(const std::string& type) {
+        switch (parse_type(type).value_or(TypeSpec{}).type) {
+            case NebulaType::INT64: return "append_int";
+            case NebulaType::DOUBLE: return "append_double";
+            case NebulaType::BOOL: return "append_bool";
+            default: return "append_string";
+        }
+    }
+
+    // Types the generated helpers render exactly as the interpreter does
+    bool compilable_type(const std::string& type) {
+        auto spec = parse_type(type);
+        return spec && (spec->type == NebulaType::INT64 || spec->type == NebulaType::DOUBLE ||
+                        spec->type == NebulaType::BOOL || spec->type == NebulaType::STRING);
+    }
+
+    std::string property_names(const std::vector<parser::mapping::Property>& properties) {
+        std::vector<std::string> names;
+        for (const auto& prop : properties) {
+            names.push_back(StatementGenerator::quote_identifier(prop.name));
+        }
+        return detail::join_values(names);
+    }
+
+    // Statements appending each property of `item` to `target`
+    void write_properties(std::ostream& out, const std::vector<parser::mapping::Property>& properties,
+                          const std::string& target, const std::string& indent) {
+        for (size_t i = 0; i < properties.size(); ++i) {
+            const auto& prop = properties[i];
+            if (i > 0) {
+                out << indent << target << " += \", \";\n";
+            }
+            out << indent << value_renderer(prop.nebula_type) << "(" << target << ", "
+                << path_expression("item", prop.json_path) << ");\n";
+        }
+    }
+
+    // Flush of a full or final INSERT batch
+    void write_flush(std::ostream& out, const std::string& prefix, const std::string& indent) {
+        out << indent << "out.push_back(" << prefix << " + values + \";\");\n"
+            << indent << "if (batches) {\n"
+            << indent << "    batches->push_back(batch);\n"
+            << indent << "    batch.row_bytes.clear();\n"
+            << indent << "}\n"
+            << indent << "values.clear();\n"
+            << indent << "batched = 0;\n";
+    }
+
+    // Size of the row just appended to `values`, for the batch's telemetry
+    void write_row_bytes(std::ostream& out) {
+        out << "            if (batches) {\n"
+            << "                batch.row_bytes.push_back(\n"
+            << "                    static_cast<std::uint32_t>(values.size() - row_start));\n"
+            << "            }\n";
+    }
+
+    Result<bool> check_properties(const std::vector<parser::mapping::Property>& properties,
+                                  const std::string& mapping_name) {
+        for (const auto& prop : properties) {
+            if (prop.transform) {
+                return StatementError{
+                    "Transform '" + prop.transform->type + "' on property '" + prop.name +
+                    "' cannot be compiled",
+                    mapping_name};
+            }
+            if (prop.json_format) {
+                return StatementError{
+                    "JSON-serialized property '" + prop.name + "' cannot be compiled",
+                    mapping_name};
+            }
+            if (prop.geo) {
+                return StatementError{
+                    "Point property '" + prop.name + "' cannot be compiled", mapping_name};
+            }
+            if (!compilable_type(prop.nebula_type)) {
+                return StatementError{
+                    "Type '" + prop.nebula_type + "' of property '" + prop.name +
+                    "' cannot be compiled",
+                    mapping_name};
+            }
+        }
+        return true;
+    }
+}
+
+std::string mapping_hash(const std::string& yaml) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : yaml) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    char buffer[17];
+    std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(hash));
+    return buffer;
+}
+
+Result<std::string> generate_extractor_source(const parser::mapping::GraphMapping& mapping,
+                                              const std::string& yaml_hash,
+                                              const std::string& origin) {
+    for (const auto& vertex : mapping.vertices) {
+        if (!vertex.aggregates.empty()) {
+            return StatementError{"Aggregates of tag '" + vertex.tag_name +
+                                  "' cannot be compiled", vertex.tag_name};
+        }
+        auto checked = check_properties(vertex.properties, vertex.tag_name);
+        if (std::holds_alternative<StatementError>(checked)) {
+            return std::get<StatementError>(checked);
+        }
+    }
+    for (const auto& edge : mapping.edges) {
+        auto checked = check_properties(edge.properties, edge.edge_name);
+        if (std::holds_alternative<StatementError>(checked)) {
+            return std::get<StatementError>(checked);
+        }
+    }
+
+    std::ostringstream out;
+    out << "// Generated by nebula_mapper --codegen"
+        << (origin.empty() ? "" : " from " + origin) << ". Do not edit.\n"
+        << "// Mapping hash " << yaml_hash << "\n";
+    out << replace_all(replace_all(PRELUDE, "%ABI%", std::to_string(EXTRACTOR_ABI_VERSION)),
+                       "%HASH%", yaml_hash);
+
+    // Statement prefixes
+    out << "\nnamespace {\n\n";
+    for (size_t i = 0; i < mapping.vertices.size(); ++i) {
+        const auto& vertex = mapping.vertices[i];
+        const auto tag = StatementGenerator::quote_identifier(vertex.tag_name);
+        const auto names = property_names(vertex.properties);
+        if (vertex.dynamic_fields.enabled) {
+            out << "const std::string UPSERT_" << i << " = "
+                << literal("UPSERT VERTEX " + tag + " ") << ";\n"
+                << "const std::string UPSERT_VALUES_" << i << " = "
+                << literal(" (" + names + ") VALUES (") << ";\n";
+        } else {
+            out << "const std::string VERTEX_" << i << " = "
+                << literal("INSERT VERTEX " + tag + " (" + names + ") VALUES ") << ";\n";
+        }
+    }
+    for (size_t i = 0; i < mapping.edges.size(); ++i) {
+        const auto& edge = mapping.edges[i];
+        out << "const std::string EDGE_" << i << " = "
+            << literal("INSERT EDGE " + StatementGenerator::quote_identifier(edge.edge_name) +
+                       " (" + property_names(edge.properties) + ") VALUES ")
+            << ";\n";
+    }
+
+    out << "\nvoid generate(const json& doc, std::size_t batch_size,\n"
+        << "              std::vector<std::string>& out, std::uint64_t& rows,\n"
+        << "              std::vector<Batch>* batches) {\n";
+
+    // Deduplicated vertex ids, shared by every mapping of a tag
+    std::map<std::string, size_t> seen_sets;
+    for (const auto& vertex : mapping.vertices) {
+        if (vertex.dynamic_fields.enabled && !seen_sets.count(vertex.tag_name)) {
+            size_t id = seen_sets.size();
+            seen_sets.emplace(vertex.tag_name, id);
+            out << "    std::unordered_set<std::string> seen_" << id << "; // "
+                << vertex.tag_name << "\n";
+        }
+    }
+
+    for (size_t i = 0; i < mapping.vertices.size(); ++i) {
+        const auto& vertex = mapping.vertices[i];
+        out << "\n    // tag " << vertex.tag_name << "\n"
+            << "    {\n";
+        if (vertex.dynamic_fields.enabled) {
+            out << "        for_each_item(" << path_expression("doc", vertex.source_path)
+                << ", [&](const json& item) {\n"
+                << "            std::string id;\n"
+                << "            append_id(id, " << path_expression("item", vertex.key_path) << ");\n"
+                << "            if (!seen_" << seen_sets.at(vertex.tag_name)
+                << ".insert(id).second) return;\n"
+                << "            std::string row;\n";
+            write_properties(out, vertex.properties, "row", "            ");
+            out << "            out.push_back(UPSERT_" << i << " + id + UPSERT_VALUES_" << i
+                << " + row + \");\");\n"
+                << "            ++rows;\n"
+                << "            if (batches) {\n"
+                << "                batches->push_back(Batch{" << i
+                << ", {static_cast<std::uint32_t>(out.back().size())}});\n"
+                << "            }\n"
+                << "        });\n";
+        } else {
+            out << "        std::string values;\n"
+                << "        std::size_t batched = 0;\n"
+                << "        Batch batch{" << i << ", {}};\n"
+                << "        for_each_item(" << path_expression("doc", vertex.source_path)
+                << ", [&](const json& item) {\n"
+                << "            if (batched > 0) values += \", \";\n"
+                << "            const std::size_t row_start = values.size();\n"
+                << "            append_id(values, " << path_expression("item", vertex.key_path)
+                << ");\n"
+                << "            values += \":(\";\n";
+            write_properties(out, vertex.properties, "values", "            ");
+            out << "            values += ')';\n"
+                << "            ++rows;\n";
+            write_row_bytes(out);
+            out << "            if (++batched >= batch_size) {\n";
+            write_flush(out, "VERTEX_" + std::to_string(i), "                ");
+            out << "            }\n"
+                << "        });\n"
+                << "        if (batched > 0) {\n";
+            write_flush(out, "VERTEX_" + std::to_string(i), "            ");
+            out << "        }\n";
+        }
+        out << "    }\n";
+    }
+
+    for (size_t i = 0; i < mapping.edges.size(); ++i) {
+        const auto& edge = mapping.edges[i];
+        out << "\n    // edge " << edge.edge_name << "\n"
+            << "    {\n"
+            << "        std::string values;\n"
+            << "        std::size_t batched = 0;\n"
+            << "        Batch batch{" << mapping.vertices.size() + i << ", {}};\n"
+            << "        for_each_item(" << path_expression("doc", edge.source_path)
+            << ", [&](const json& item) {\n"
+            << "            if (batched > 0) values += \", \";\n"
+            << "            const std::size_t row_start = values.size();\n"
+            << "            append_id(values, " << path_expression("item", edge.from.key_path)
+            << ");\n"
+            << "            values += \" -> \";\n"
+            << "            append_id(values, " << path_expression("item", edge.to.key_path)
+            << ");\n"
+            << "            values += \":(\";\n";
+        write_properties(out, edge.properties, "values", "            ");
+        out << "            values += ')';\n"
+            << "            ++rows;\n";
+        write_row_bytes(out);
+        out << "            if (++batched >= batch_size) {\n";
+        write_flush(out, "EDGE_" + std::to_string(i), "                ");
+        out << "            }\n"
+            << "        });\n"
+            << "        if (batched > 0) {\n";
+        write_flush(out, "EDGE_" + std::to_string(i), "            ");
+        out << "        }\n"
+            << "    }\n";
+    }
+
+    out << "}\n\n} // namespace\n";
+    return out.str();
+}
+
+} // namespace graph
@@ -0,0 +1,74 @@
+#include "graph/column_dictionary.hpp"
+#include "graph/statement_generator.hpp"
+
+namespace graph {
+
+ColumnDictionary::ColumnDictionary(std::string json_path)
+    : ColumnDictionary(std::move(json_path), Limits{}) {}
+
+ColumnDictionary::ColumnDictionary(std::string json_path, Limits limits)
+    : json_path_(std::move(json_path)),
+      segments_(parser::json::detail::split_path(json_path_)),
+      limits_(limits) {}
+
+const std::string* ColumnDictionary::render(const parser::json::JsonDocument& item) {
+    const auto* node = parser::json::detail::find_path(item, segments_);
+    if (!node || !node->is_string()) return nullptr;
+    const auto& text = node->get_ref<const std::string&>();
+
+    if (!interning_ || text.size() > limits_.max_value_bytes) {
+        render_literal(scratch_, text);
+        return &scratch_;
+    }
+
+    ++lookups_;
+    auto found = ids_.find(text);
+    if (found != ids_.end()) {
+        ++hits_;
+        return &literals_[found->second];
+    }
+
+    // A new value: check the column still pays for its dictionary
+    bool too_many = values_.size() >= limits_.max_entries;
+    bool too_distinct = lookups_ >= limits_.sample &&
+        static_cast<double>(values_.size() + 1) >
+            limits_.max_distinct_ratio * static_cast<double>(lookups_);
+    if (too_many || too_distinct) {
+        stop_interning();
+        render_literal(scratch_, text);
+        return &scratch_;
+    }
+
+    auto id = static_cast<uint32_t>(values_.size());
+    values_.push_back(text);
+    literals_.emplace_back();
+    render_literal(literals_.back(), text);
+    ids_.emplace(values_.back(), id);
+    return &literals_.back();
+}
+
+std::optional<uint32_t> ColumnDictionary::find(std::string_view value) const {
+    auto found = ids_.find(value);
+    if (found == ids_.end()) return std::nullopt;
+    return found->second;
+}
+
+// Same text as format_value() gives a string Value
+void ColumnDictionary::render_literal(std::string& out, const std::string& value) {
+    out.clear();
+    out.reserve(value.size() + 2);
+    out += '"';
+    out += StatementGenerator::escape_string(value);
+    out += '"';
+}
+
+void ColumnDictionary::stop_interning() {
+    interning_ = false;
+    ids_.clear();
+    literals_.clear();
+    literals_.shrink_to_fit();
+    values_.clear();
+    values_.shrink_to_fit();
+}
+
+} // namespace graph
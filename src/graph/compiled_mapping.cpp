@@ -0,0 +1,83 @@
+#include "graph/compiled_mapping.hpp"
+#include "graph/codegen.hpp"
+#include <dlfcn.h>
+
+namespace graph {
+
+namespace {
+    template<typename Fn>
+    Fn find_symbol(void* handle, const char* name) {
+        return reinterpret_cast<Fn>(dlsym(handle, name));
+    }
+
+    StatementError load_error(void* handle, const std::string& message,
+                              const std::string& library) {
+        dlclose(handle);
+        return StatementError{message, library};
+    }
+}
+
+uint64_t json_abi_stamp() {
+    return (NLOHMANN_JSON_VERSION_MAJOR * 10000 + NLOHMANN_JSON_VERSION_MINOR * 100 +
+            NLOHMANN_JSON_VERSION_PATCH) * 2 + (JSON_DIAGNOSTICS ? 1 : 0);
+}
+
+CompiledMapping::CompiledMapping(void* handle, ExtractFn extract, std::string hash)
+    : handle_(handle), extract_(extract), hash_(std::move(hash)) {}
+
+CompiledMapping::~CompiledMapping() {
+    dlclose(handle_);
+}
+
+Result<std::unique_ptr<CompiledMapping>> CompiledMapping::load(const std::string& library,
+                                                               const std::string& yaml) {
+    void* handle = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        const char* error = dlerror();
+        return StatementError{
+            "Cannot load extractor: " + std::string(error ? error : "unknown error"), library};
+    }
+
+    auto abi = find_symbol<unsigned (*)()>(handle, "nebula_mapper_extractor_abi");
+    auto json = find_symbol<uint64_t (*)()>(handle, "nebula_mapper_extractor_json");
+    auto hash = find_symbol<const char* (*)()>(handle, "nebula_mapper_extractor_hash");
+    auto extract = find_symbol<ExtractFn>(handle, "nebula_mapper_extract");
+    if (!abi || !json || !hash || !extract) {
+        return load_error(handle, "Not an extractor built from --codegen output", library);
+    }
+    if (abi() != EXTRACTOR_ABI_VERSION) {
+        return load_error(handle,
+                          "Extractor interface version " + std::to_string(abi()) +
+                          ", expected " + std::to_string(EXTRACTOR_ABI_VERSION) +
+                          "; run --codegen again",
+                          library);
+    }
+    if (json() != json_abi_stamp()) {
+        return load_error(handle, "Extractor was built against a different nlohmann/json",
+                          library);
+    }
+
+    std::string expected = mapping_hash(yaml);
+    if (expected != hash()) {
+        return load_error(handle,
+                          "Extractor was generated from a different mapping (hash " +
+                          std::string(hash()) + ", mapping " + expected +
+                          "); run --codegen again",
+                          library);
+    }
+    return std::unique_ptr<CompiledMapping>(new CompiledMapping(handle, extract, expected));
+}
+
+std::optional<std::vector<std::string>> CompiledMapping::generate(
+    const parser::json::JsonDocument& document, size_t batch_size, uint64_t& rows,
+    std::vector<CompiledBatch>* batches) const {
+    std::vector<std::string> statements;
+    if (extract_(&document, batch_size, &statements, &rows, batches) != 0) {
+        interpreted_.fetch_add(1, std::memory_order_relaxed);
+        return std::nullopt;
+    }
+    compiled_.fetch_add(1, std::memory_order_relaxed);
+    return statements;
+}
+
+} // namespace graph
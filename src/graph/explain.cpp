@@ -0,0 +1,299 @@
+#include "graph/explain.hpp"
+#include "transformer/transform_engine.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <vector>
+
+namespace graph {
+
+namespace {
+    // One evaluation the generator performs per record or per item
+    struct PlanStep {
+        std::string label;
+        const void* key;
+    };
+
+    // A tag or edge mapping in plan order
+    struct PlanMapping {
+        std::string kind;
+        std::string name;
+        std::string source_path;
+        std::vector<PlanStep> steps;
+    };
+
+    // Paths read under one source, split into segments
+    struct PathNode {
+        std::string segment;
+        std::vector<std::string> uses;
+        std::vector<PathNode> children;
+
+        PathNode& child(const std::string& name) {
+            for (auto& node : children) {
+                if (node.segment == name) return node;
+            }
+            children.push_back(PathNode{name, {}, {}});
+            return children.back();
+        }
+    };
+
+    std::vector<PlanMapping> plan_mappings(const parser::mapping::GraphMapping& mapping) {
+        std::vector<PlanMapping> result;
+        for (const auto& vertex : mapping.vertices) {
+            PlanMapping plan{"tag", vertex.tag_name, vertex.source_path, {}};
+            plan.steps.push_back({"source " + vertex.source_path, &vertex.source_path});
+            plan.steps.push_back({"key " + vertex.key_path, &vertex.key_path});
+            for (const auto& prop : vertex.properties) {
+                plan.steps.push_back({"prop " + prop.name, &prop});
+            }
+            result.push_back(std::move(plan));
+        }
+        for (const auto& edge : mapping.edges) {
+            PlanMapping plan{"edge", edge.edge_name, edge.source_path, {}};
+            plan.steps.push_back({"source " + edge.source_path, &edge.source_path});
+            plan.steps.push_back({"from key " + edge.from.key_path, &edge.from.key_path});
+            plan.steps.push_back({"to key " + edge.to.key_path, &edge.to.key_path});
+            for (const auto& prop : edge.properties) {
+                plan.steps.push_back({"prop " + prop.name, &prop});
+            }
+            result.push_back(std::move(plan));
+        }
+        return result;
+    }
+
+    void add_path(PathNode& root, const std::string& path, const std::string& use) {
+        PathNode* node = &root;
+        for (const auto& segment : parser::json::detail::split_path(path)) {
+            node = &node->child(segment);
+        }
+        node->uses.push_back(use);
+    }
+
+    void write_trie(std::ostream& out, const PathNode& node, size_t depth) {
+        for (const auto& child : node.children) {
+            std::string label = std::string(2 * depth, ' ') + child.segment;
+            out << "    ";
+            if (child.uses.empty()) {
+                out << label << '\n';
+            } else {
+                out << std::left << std::setw(28) << label;
+                for (size_t i = 0; i < child.uses.size(); ++i) {
+                    out << (i ? ", " : "") << child.uses[i];
+                }
+                out << '\n';
+            }
+            write_trie(out, child, depth + 1);
+        }
+    }
+
+    std::string property_use(const std::string& owner, const parser::mapping::Property& prop) {
+        std::string use = owner + "." + prop.name + " " + prop.nebula_type;
+        if (prop.transform) use += " via " + prop.transform->type;
+        if (prop.geo) use += " point";
+        return use;
+    }
+
+    std::string describe_transform(const parser::mapping::Transform& transform) {
+        std::string result = transform.type + "(";
+        bool first = true;
+        for (const auto& [name, value] : transform.params) {
+            result += (first ? "" : ", ") + name + "=" + value;
+            first = false;
+        }
+        result += ")";
+        bool registered = transformer::TransformEngine::instance().has_transform(transform.type);
+        return result + (registered ? " resolved" : " UNRESOLVED");
+    }
+
+    void write_transforms(std::ostream& out,
+                          const std::vector<parser::mapping::Property>& properties) {
+        bool any = false;
+        for (const auto& prop : properties) {
+            if (!prop.transform) continue;
+            out << "    transform " << prop.name << ": " << describe_transform(*prop.transform) << '\n';
+            any = true;
+        }
+        if (!any) out << "    transforms: none\n";
+    }
+
+    const char* aggregate_op_name(parser::mapping::AggregateOp op) {
+        switch (op) {
+            case parser::mapping::AggregateOp::COUNT: return "count";
+            case parser::mapping::AggregateOp::SUM: return "sum";
+            case parser::mapping::AggregateOp::AVG: return "avg";
+            case parser::mapping::AggregateOp::MIN: return "min";
+            case parser::mapping::AggregateOp::MAX: return "max";
+            case parser::mapping::AggregateOp::DISTINCT: return "distinct";
+        }
+        return "?";
+    }
+
+    void write_aggregates(std::ostream& out, const parser::mapping::VertexMapping& vertex) {
+        for (const auto& aggregate : vertex.aggregates) {
+            out << "    aggregate " << aggregate.name << ": "
+                << aggregate_op_name(aggregate.op) << " over " << aggregate.over;
+            if (!aggregate.json_path.empty()) out << " of " << aggregate.json_path;
+            if (!aggregate.key_path.empty()) out << " by " << aggregate.key_path;
+            out << (aggregate.update ? ", UPDATE after the last record\n" : ", in the row\n");
+        }
+    }
+
+    double ms(uint64_t ns) {
+        return static_cast<double>(ns) / 1e6;
+    }
+}
+
+std::string format_plan(const parser::mapping::GraphMapping& mapping, size_t batch_size) {
+    // Sources in first-use order
+    std::vector<std::string> sources;
+    for (const auto& plan : plan_mappings(mapping)) {
+        if (std::find(sources.begin(), sources.end(), plan.source_path) == sources.end()) {
+            sources.push_back(plan.source_path);
+        }
+    }
+
+    std::ostringstream out;
+    out << "Plan: " << mapping.vertices.size() << " tags, " << mapping.edges.size()
+        << " edges, " << sources.size() << " source paths, batch size " << batch_size << '\n';
+    out << "Scans are not fused: each mapping navigates its source path once per record.\n";
+
+    for (const auto& source : sources) {
+        PathNode root;
+        std::vector<std::string> readers;
+        for (const auto& vertex : mapping.vertices) {
+            if (vertex.source_path != source) continue;
+            readers.push_back(vertex.tag_name);
+            add_path(root, vertex.key_path, vertex.tag_name + " key");
+            for (const auto& prop : vertex.properties) {
+                add_path(root, prop.json_path, property_use(vertex.tag_name, prop));
+                if (prop.geo) add_path(root, prop.geo->y_path, property_use(vertex.tag_name, prop));
+            }
+        }
+        for (const auto& edge : mapping.edges) {
+            if (edge.source_path != source) continue;
+            readers.push_back(edge.edge_name);
+            add_path(root, edge.from.key_path, edge.edge_name + " source key");
+            add_path(root, edge.to.key_path, edge.edge_name + " target key");
+            for (const auto& prop : edge.properties) {
+                add_path(root, prop.json_path, property_use(edge.edge_name, prop));
+                if (prop.geo) add_path(root, prop.geo->y_path, property_use(edge.edge_name, prop));
+            }
+        }
+
+        out << "\nsource " << source << " (navigated " << readers.size() << "x per record:";
+        for (const auto& reader : readers) out << ' ' << reader;
+        out << ")\n";
+        out << "  paths read per item:\n";
+        write_trie(out, root, 0);
+
+        for (const auto& vertex : mapping.vertices) {
+            if (vertex.source_path != source) continue;
+            out << "  tag " << vertex.tag_name << '\n';
+            out << "    key: " << vertex.key_path << '\n';
+            if (vertex.dynamic_fields.enabled) {
+                out << "    write: UPSERT VERTEX, one row per statement\n";
+                out << "    dedup: by vertex id within a record\n";
+            } else {
+                out << "    write: INSERT VERTEX, up to " << batch_size << " rows per statement\n";
+                out << "    dedup: none\n";
+            }
+            write_transforms(out, vertex.properties);
+            write_aggregates(out, vertex);
+        }
+        for (const auto& edge : mapping.edges) {
+            if (edge.source_path != source) continue;
+            out << "  edge " << edge.edge_name << " (" << edge.from.tag << " -> "
+                << edge.to.tag << ")\n";
+            out << "    keys: " << edge.from.key_path << " -> " << edge.to.key_path << '\n';
+            out << "    write: INSERT EDGE, up to " << batch_size << " rows per statement\n";
+            out << "    dedup: none\n";
+            write_transforms(out, edge.properties);
+        }
+    }
+    return out.str();
+}
+
+std::string format_analysis(const parser::mapping::GraphMapping& mapping,
+                            const telemetry::ProfileSnapshot& profile,
+                            uint64_t records, double wall_seconds) {
+#ifdef NEBULA_MAPPER_ALLOC_TRACKING
+    constexpr bool allocations_tracked = true;
+#else
+    constexpr bool allocations_tracked = false;
+#endif
+
+    struct Row {
+        const PlanStep* step;
+        telemetry::StepCost cost;
+    };
+    struct Group {
+        const PlanMapping* plan;
+        uint64_t ns{0};
+        std::vector<Row> rows;
+    };
+
+    auto plans = plan_mappings(mapping);
+    std::vector<Group> groups;
+    uint64_t total_ns = 0;
+    for (const auto& plan : plans) {
+        Group group{&plan, 0, {}};
+        for (const auto& step : plan.steps) {
+            auto found = profile.find(step.key);
+            Row row{&step, found != profile.end() ? found->second : telemetry::StepCost{}};
+            group.ns += row.cost.ns;
+            group.rows.push_back(row);
+        }
+        std::stable_sort(group.rows.begin(), group.rows.end(),
+                         [](const Row& a, const Row& b) { return a.cost.ns > b.cost.ns; });
+        total_ns += group.ns;
+        groups.push_back(std::move(group));
+    }
+    std::stable_sort(groups.begin(), groups.end(),
+                     [](const Group& a, const Group& b) { return a.ns > b.ns; });
+
+    auto share = [&](uint64_t ns) {
+        return total_ns ? 100.0 * static_cast<double>(ns) / static_cast<double>(total_ns) : 0.0;
+    };
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "Analysis: " << records << " records in " << wall_seconds << " s, plan steps took "
+        << ms(total_ns) / 1e3 << " s";
+    if (wall_seconds > 0.0) {
+        out << " (" << std::setprecision(1) << 100.0 * ms(total_ns) / 1e3 / wall_seconds
+            << "% of the run)" << std::setprecision(3);
+    }
+    out << '\n';
+
+    out << "  " << std::left << std::setw(32) << "step" << std::right
+        << std::setw(10) << "calls" << std::setw(12) << "total ms" << std::setw(10) << "ns/call"
+        << std::setw(14) << "transform ms" << std::setw(12) << "out bytes";
+    if (allocations_tracked) out << std::setw(13) << "allocs/call";
+    out << std::setw(8) << "share" << '\n';
+
+    for (const auto& group : groups) {
+        out << group.plan->kind << ' ' << group.plan->name << ": " << ms(group.ns) << " ms, "
+            << std::setprecision(1) << share(group.ns) << "%" << std::setprecision(3) << '\n';
+        for (const auto& row : group.rows) {
+            const auto& cost = row.cost;
+            out << "  " << std::left << std::setw(32) << row.step->label << std::right
+                << std::setw(10) << cost.calls
+                << std::setw(12) << ms(cost.ns)
+                << std::setw(10) << (cost.calls ? cost.ns / cost.calls : 0)
+                << std::setw(14) << ms(cost.transform_ns)
+                << std::setw(12) << cost.output_bytes;
+            if (allocations_tracked) {
+                out << std::setw(13) << std::setprecision(1)
+                    << (cost.calls ? static_cast<double>(cost.allocations) /
+                                         static_cast<double>(cost.calls) : 0.0)
+                    << std::setprecision(3);
+            }
+            out << std::setw(7) << std::setprecision(1) << share(cost.ns) << '%'
+                << std::setprecision(3) << '\n';
+        }
+    }
+    return out.str();
+}
+
+} // namespace graph
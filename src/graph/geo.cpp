@@ -0,0 +1,143 @@
+#include "graph/geo.hpp"
+#include <charconv>
+#include <cmath>
+
+namespace graph {
+
+namespace {
+    constexpr double PI = 3.14159265358979323846;
+    constexpr double DEGREE = PI / 180;
+
+    // Inverse transverse Mercator by Krueger's series to fourth order in the
+    // third flattening n (Karney 2011), well under a millimetre over Korea
+    class TransverseMercator {
+    public:
+        TransverseMercator(double a, double f, double lat0, double lon0, double k0,
+                           double false_easting, double false_northing)
+            : lon0_(lon0 * DEGREE), false_easting_(false_easting),
+              false_northing_(false_northing) {
+
+            double n = f / (2 - f);
+            double n2 = n * n, n3 = n2 * n, n4 = n3 * n;
+            radius_ = k0 * a / (1 + n) * (1 + n2 / 4 + n4 / 64);
+
+            beta_[0] = n / 2 - 2 * n2 / 3 + 37 * n3 / 96 - n4 / 360;
+            beta_[1] = n2 / 48 + n3 / 15 - 437 * n4 / 1440;
+            beta_[2] = 17 * n3 / 480 - 37 * n4 / 840;
+            beta_[3] = 4397 * n4 / 161280;
+
+            delta_[0] = 2 * n - 2 * n2 / 3 - 2 * n3 + 116 * n4 / 45;
+            delta_[1] = 7 * n2 / 3 - 8 * n3 / 5 - 227 * n4 / 45;
+            delta_[2] = 56 * n3 / 15 - 136 * n4 / 35;
+            delta_[3] = 4279 * n4 / 630;
+
+            // Northing of the origin latitude on the central meridian
+            const double alpha[4] = {
+                n / 2 - 2 * n2 / 3 + 5 * n3 / 16 + 41 * n4 / 180,
+                13 * n2 / 48 - 3 * n3 / 5 + 557 * n4 / 1440,
+                61 * n3 / 240 - 103 * n4 / 140,
+                49561 * n4 / 161280
+            };
+            double e = std::sqrt(f * (2 - f));
+            double sin_lat0 = std::sin(lat0 * DEGREE);
+            double chi0 = std::asin(std::tanh(std::atanh(sin_lat0) -
+                                              e * std::atanh(e * sin_lat0)));
+            xi0_ = chi0;
+            for (int j = 0; j < 4; ++j) xi0_ += alpha[j] * std::sin(2 * (j + 1) * chi0);
+        }
+
+        // Easting x and northing y in metres to degrees, in place. Both
+        // series go through Clenshaw's recurrence, so a point costs eight
+        // transcendental calls whatever the order, not two per term.
+        void inverse(double* x, double* y, size_t count) const {
+            for (size_t i = 0; i < count; ++i) {
+                double xi = (y[i] - false_northing_) / radius_ + xi0_;
+                double eta = (x[i] - false_easting_) / radius_;
+
+                // zeta' = zeta - sum beta_j sin(2j zeta), with zeta = xi + i eta
+                double s2 = std::sin(2 * xi), c2 = std::cos(2 * xi);
+                double exp2 = std::exp(2 * eta);
+                double sh2 = (exp2 - 1 / exp2) / 2, ch2 = (exp2 + 1 / exp2) / 2;
+                double ar = 2 * c2 * ch2, ai = -2 * s2 * sh2;   // 2 cos(2 zeta)
+                double b1r = 0, b1i = 0, b2r = 0, b2i = 0;
+                for (int j = 3; j >= 0; --j) {
+                    double br = beta_[j] + ar * b1r - ai * b1i - b2r;
+                    double bi = ar * b1i + ai * b1r - b2i;
+                    b2r = b1r; b2i = b1i;
+                    b1r = br; b1i = bi;
+                }
+                double xi1 = xi - (b1r * s2 * ch2 - b1i * c2 * sh2);
+                double eta1 = eta - (b1r * c2 * sh2 + b1i * s2 * ch2);
+
+                double exp1 = std::exp(eta1);
+                double sh1 = (exp1 - 1 / exp1) / 2, ch1 = (exp1 + 1 / exp1) / 2;
+                double sin_chi = std::sin(xi1) / ch1;
+                double lon = lon0_ + std::atan2(sh1, std::cos(xi1));
+
+                // Latitude from the conformal latitude chi: chi + sum delta_j sin(2j chi)
+                double cos_chi = std::sqrt(1 - sin_chi * sin_chi);
+                double s = 2 * sin_chi * cos_chi, a = 2 * (1 - 2 * sin_chi * sin_chi);
+                double b1 = 0, b2 = 0;
+                for (int j = 3; j >= 0; --j) {
+                    double b = delta_[j] + a * b1 - b2;
+                    b2 = b1;
+                    b1 = b;
+                }
+                double lat = std::asin(sin_chi) + b1 * s;
+
+                x[i] = lon / DEGREE;
+                y[i] = lat / DEGREE;
+            }
+        }
+
+    private:
+        double lon0_;
+        double false_easting_;
+        double false_northing_;
+        double radius_;       // k0 times the rectifying radius
+        double xi0_;          // Origin latitude as the series' xi
+        double beta_[4];
+        double delta_[4];
+    };
+
+    // EPSG:5181, Korea 2000 / Central Belt
+    const TransverseMercator& central_belt() {
+        static const TransverseMercator projection(
+            6378137.0, 1 / 298.257222101, 38.0, 127.0, 1.0, 200000.0, 500000.0);
+        return projection;
+    }
+
+    // Nanodegrees are about 0.1 mm, past what any source coordinate holds
+    void append_degrees(std::string& out, double value) {
+        char buffer[32];
+        double rounded = std::round(value * 1e9) / 1e9;
+        auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), rounded);
+        out.append(buffer, end);
+    }
+}
+
+void to_wgs84(parser::mapping::Projection from, double* x, double* y, size_t count) {
+    switch (from) {
+        case parser::mapping::Projection::WGS84:
+            return;
+        case parser::mapping::Projection::WCONGNAMUL:
+            for (size_t i = 0; i < count; ++i) {
+                x[i] /= 2.5;
+                y[i] /= 2.5;
+            }
+            [[fallthrough]];
+        case parser::mapping::Projection::CONGNAMUL:
+            central_belt().inverse(x, y, count);
+            return;
+    }
+}
+
+void append_point(std::string& out, double lon, double lat) {
+    out += "ST_Point(";
+    append_degrees(out, lon);
+    out += ", ";
+    append_degrees(out, lat);
+    out += ')';
+}
+
+} // namespace graph
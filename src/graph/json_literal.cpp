@@ -0,0 +1,137 @@
+#include "graph/json_literal.hpp"
+#include <algorithm>
+#include <charconv>
+
+namespace graph {
+
+namespace {
+    using Serializer = nlohmann::detail::serializer<parser::json::JsonDocument>;
+
+    // Escape sequence for a byte inside a JSON string, as it reads once the
+    // JSON text is escaped again for the nGQL literal; nullptr if the byte
+    // is copied as it is
+    const char* fused_escape(unsigned char c) {
+        switch (c) {
+            case '"': return "\\\\\\\"";
+            case '\\': return "\\\\\\\\";
+            case '\b': return "\\\\b";
+            case '\f': return "\\\\f";
+            case '\n': return "\\\\n";
+            case '\r': return "\\\\r";
+            case '\t': return "\\\\t";
+            default: return nullptr;
+        }
+    }
+
+    // A JSON string, quotes included
+    void append_string(std::string& out, const std::string& text) {
+        out += "\\\"";
+        const char* run = text.data();
+        const char* end = run + text.size();
+        for (const char* p = run; p != end; ++p) {
+            auto c = static_cast<unsigned char>(*p);
+            if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+            out.append(run, p);
+            run = p + 1;
+            if (const char* escape = fused_escape(c)) {
+                out += escape;
+            } else {
+                // Other control bytes are \u00xx in dump()
+                static const char HEX[] = "0123456789abcdef";
+                out += "\\\\u00";
+                out += HEX[c >> 4];
+                out += HEX[c & 0xF];
+            }
+        }
+        out.append(run, end);
+        out += "\\\"";
+    }
+
+    void append_indent(std::string& out, unsigned depth) {
+        out += "\\n";
+        out.append(depth * 2, ' ');
+    }
+
+    void append_value(std::string& out, const parser::json::JsonDocument& value,
+                      const parser::mapping::JsonFormat& format, unsigned depth);
+
+    template<typename Items>
+    void append_container(std::string& out, const Items& items, char open, char close,
+                          const parser::mapping::JsonFormat& format, unsigned depth,
+                          bool is_object) {
+        out += open;
+        bool first = true;
+        for (auto it = items.begin(); it != items.end(); ++it) {
+            if (is_object && depth == 0 && !format.keys.empty() &&
+                std::find(format.keys.begin(), format.keys.end(), it.key()) ==
+                    format.keys.end()) {
+                continue;
+            }
+            if (!first) out += ',';
+            first = false;
+            if (!format.minify) append_indent(out, depth + 1);
+            if (is_object) {
+                append_string(out, it.key());
+                out += format.minify ? ":" : ": ";
+            }
+            append_value(out, it.value(), format, depth + 1);
+        }
+        if (!first && !format.minify) append_indent(out, depth);
+        out += close;
+    }
+
+    void append_value(std::string& out, const parser::json::JsonDocument& value,
+                      const parser::mapping::JsonFormat& format, unsigned depth) {
+        using Type = parser::json::JsonDocument::value_t;
+        char buffer[24];
+        switch (value.type()) {
+            case Type::object:
+                append_container(out, value, '{', '}', format, depth, true);
+                return;
+            case Type::array:
+                append_container(out, value, '[', ']', format, depth, false);
+                return;
+            case Type::string:
+                append_string(out, value.get_ref<const std::string&>());
+                return;
+            case Type::boolean:
+                out += value.get<bool>() ? "true" : "false";
+                return;
+            case Type::null:
+                out += "null";
+                return;
+            case Type::number_integer: {
+                auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer),
+                                               value.get<int64_t>());
+                out.append(buffer, end);
+                return;
+            }
+            case Type::number_unsigned: {
+                auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer),
+                                               value.get<uint64_t>());
+                out.append(buffer, end);
+                return;
+            }
+            default: {
+                // Floats (and binary values) in nlohmann's exact format
+                thread_local std::string scratch;
+                thread_local Serializer serializer(
+                    nlohmann::detail::output_adapter<char>(scratch), ' ');
+                scratch.clear();
+                serializer.dump(value, false, false, 0);
+                out += scratch;
+                return;
+            }
+        }
+    }
+}
+
+void append_json_literal(std::string& out, const parser::json::JsonDocument& value,
+                         const parser::mapping::JsonFormat& format) {
+    out += '"';
+    append_value(out, value, format, 0);
+    out += '"';
+}
+
+} // namespace graph
@@ -0,0 +1,404 @@
+#include "graph/mapping_preflight.hpp"
+#include <iomanip>
+#include <random>
+#include <sstream>
+
+namespace graph {
+
+namespace json = parser::json;
+using json::JsonDocument;
+using parser::mapping::Aggregate;
+using parser::mapping::GraphMapping;
+using parser::mapping::Property;
+
+namespace {
+    std::string percent(uint64_t part, uint64_t whole) {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(1)
+            << (whole ? 100.0 * static_cast<double>(part) / static_cast<double>(whole) : 0.0)
+            << '%';
+        return out.str();
+    }
+
+    // Dotted and [*] paths come from older mappings; they never resolve
+    std::string path_hint(const std::string& path) {
+        bool legacy = path.find("[*]") != std::string::npos ||
+                      (path.find('.') != std::string::npos && path.find('/') == std::string::npos);
+        return legacy ? "; paths use '/' separators, and arrays are expanded without [*]" : "";
+    }
+}
+
+// Walks every document through the paths of a mapping, in the order the
+// generator reads them, and counts what each path finds. Properties and
+// aggregates are read through the generator's own plans and converted by
+// the calls it renders them with; each tag and edge owns a fixed run of
+// report slots.
+class MappingPreflight {
+public:
+    MappingPreflight(const GraphMapping& mapping, ValidationReport& report)
+        : mapping_(mapping), report_(report) {
+        for (const auto& vertex : mapping.vertices) {
+            add_source(vertex.tag_name, vertex.source_path);
+            add_path(vertex.tag_name, "key", vertex.key_path, "").key = true;
+            add_properties(vertex.tag_name, vertex.properties);
+            for (const auto& aggregate : vertex.aggregates) {
+                if (!aggregate.key_path.empty()) {
+                    add_path(vertex.tag_name, aggregate.name + " key",
+                             aggregate.key_path, "").key = true;
+                }
+                add_path(vertex.tag_name, aggregate.name, aggregate.json_path,
+                         aggregate.nebula_type, false).required = false;
+            }
+        }
+        for (const auto& edge : mapping.edges) {
+            add_source(edge.edge_name, edge.source_path);
+            add_path(edge.edge_name, "source key", edge.from.key_path, "").key = true;
+            add_path(edge.edge_name, "target key", edge.to.key_path, "").key = true;
+            add_properties(edge.edge_name, edge.properties);
+        }
+    }
+
+    void check(const JsonDocument& document, const std::string& record) {
+        ++report_.records;
+        size_t source = 0;
+        size_t slot = 0;
+
+        for (const auto& vertex : mapping_.vertices) {
+            auto items = items_at(document, source++, record);
+            size_t first = slot;
+            for (const auto* item : items) {
+                slot = first;
+                check_key(slot++, *item, record);
+                for (const auto& prop : vertex.properties) {
+                    slot = check_property(slot, prop, *item, record);
+                }
+            }
+            slot = first + 1 + property_slots(vertex.properties);
+            for (const auto& aggregate : vertex.aggregates) {
+                slot = check_aggregate(slot, aggregate, document, record);
+            }
+        }
+
+        for (const auto& edge : mapping_.edges) {
+            auto items = items_at(document, source++, record);
+            size_t first = slot;
+            for (const auto* item : items) {
+                slot = first;
+                check_key(slot++, *item, record);
+                check_key(slot++, *item, record);
+                for (const auto& prop : edge.properties) {
+                    slot = check_property(slot, prop, *item, record);
+                }
+            }
+            slot = first + 2 + property_slots(edge.properties);
+        }
+    }
+
+    void finish() {
+        for (const auto& source : report_.sources) {
+            if (source.missing > 0) {
+                report_.errors.push_back(
+                    source.owner + ": source '" + source.source_path + "' missing in " +
+                    std::to_string(source.missing) + " of " +
+                    std::to_string(source.records) + " records (first " +
+                    source.first_missing + ")" + path_hint(source.source_path));
+            } else if (source.records > 0 && source.items == 0) {
+                report_.warnings.push_back(source.owner + ": source '" +
+                                           source.source_path + "' has no items");
+            }
+        }
+
+        for (const auto& path : report_.paths) {
+            const std::string label = path.owner + "." + path.name;
+            const std::string of_items = " of " + std::to_string(path.items) + " items";
+            bool failed = false;
+            if (path.missing > 0 && path.required) {
+                report_.errors.push_back(
+                    label + ": '" + path.json_path + "' missing in " +
+                    std::to_string(path.missing) + of_items + " (first " +
+                    path.first_missing + ")" + path_hint(path.json_path));
+                failed = true;
+            }
+            if (path.key && path.nulls > 0) {
+                report_.errors.push_back(label + ": '" + path.json_path + "' null in " +
+                                         std::to_string(path.nulls) + of_items);
+                failed = true;
+            }
+            if (path.conflicts > 0) {
+                report_.errors.push_back(
+                    label + ": " + std::to_string(path.conflicts) + of_items +
+                    " do not convert (first " + path.first_conflict + ")");
+                failed = true;
+            }
+            if (!failed && path.items > 0 && path.resolved == 0) {
+                report_.warnings.push_back(label + ": '" + path.json_path +
+                                           "' never has a value");
+            }
+        }
+    }
+
+private:
+    void add_source(const std::string& owner, const std::string& path) {
+        SourceReport source;
+        source.owner = owner;
+        source.source_path = path;
+        report_.sources.push_back(source);
+        source_segments_.push_back(json::detail::split_path(path));
+    }
+
+    // `split` is false for paths the generator reads through its own plans
+    PathReport& add_path(const std::string& owner, const std::string& name,
+                         const std::string& json_path, const std::string& type,
+                         bool split = true) {
+        PathReport path;
+        path.owner = owner;
+        path.name = name;
+        path.json_path = json_path;
+        path.nebula_type = type;
+        report_.paths.push_back(path);
+        segments_.push_back(split ? json::detail::split_path(json_path)
+                                  : std::vector<std::string>{});
+        return report_.paths.back();
+    }
+
+    void add_properties(const std::string& owner, const std::vector<Property>& properties) {
+        for (const auto& prop : properties) {
+            if (prop.geo) {
+                add_path(owner, prop.name + " x", prop.geo->x_path, "DOUBLE");
+                add_path(owner, prop.name + " y", prop.geo->y_path, "DOUBLE");
+            } else {
+                add_path(owner, prop.name, prop.json_path, prop.nebula_type, false);
+            }
+        }
+    }
+
+    static size_t property_slots(const std::vector<Property>& properties) {
+        size_t slots = 0;
+        for (const auto& prop : properties) {
+            slots += prop.geo ? 2 : 1;
+        }
+        return slots;
+    }
+
+    // Items as get_array_or_single yields them; none if the path is missing
+    std::vector<const JsonDocument*> items_at(const JsonDocument& document, size_t index,
+                                              const std::string& record) {
+        auto& source = report_.sources[index];
+        ++source.records;
+        std::vector<const JsonDocument*> items;
+        const auto* value = json::detail::find_path(document, source_segments_[index]);
+        if (!value) {
+            if (source.missing++ == 0) source.first_missing = record;
+            return items;
+        }
+        if (value->is_array()) {
+            for (const auto& item : *value) items.push_back(&item);
+        } else {
+            items.push_back(value);
+        }
+        source.items += items.size();
+        return items;
+    }
+
+    // Find `segments` in `item` and count what is there in the slot; the
+    // value if there is one to convert
+    const JsonDocument* resolve(size_t slot, const JsonDocument& item,
+                                const std::vector<std::string>& segments,
+                                const std::string& record) {
+        auto& path = report_.paths[slot];
+        ++path.items;
+        const auto* value = json::detail::find_path(item, segments);
+        if (!value) {
+            if (path.missing++ == 0) path.first_missing = record;
+            return nullptr;
+        }
+        if (value->is_null()) {
+            ++path.nulls;
+            return nullptr;
+        }
+        ++path.resolved;
+        return value;
+    }
+
+    void conflict(size_t slot, const std::string& record, const std::string& message) {
+        auto& path = report_.paths[slot];
+        if (path.conflicts++ == 0) path.first_conflict = record + ": " + message;
+    }
+
+    // Keys convert through get_vertex_id, as every row's VID does
+    void check_key(size_t slot, const JsonDocument& item, const std::string& record) {
+        if (!resolve(slot, item, segments_[slot], record)) return;
+        auto vid = generator_.get_vertex_id(item, report_.paths[slot].json_path);
+        if (auto* error = std::get_if<StatementError>(&vid)) {
+            conflict(slot, record, error->message);
+        }
+    }
+
+    // Values take the generator's own rendering steps: render_native on
+    // the property's plan, then extract_value and format_value
+    size_t check_property(size_t slot, const Property& prop, const JsonDocument& item,
+                          const std::string& record) {
+        if (prop.geo) {
+            // Coordinates as render_point reports them
+            for (int axis = 0; axis < 2; ++axis, ++slot) {
+                if (!resolve(slot, item, segments_[slot], record)) continue;
+                auto coordinate = generator_.extract_value(
+                    item, report_.paths[slot].json_path, "DOUBLE", std::nullopt, prop.coerce);
+                if (auto* error = std::get_if<StatementError>(&coordinate)) {
+                    conflict(slot, record, error->message);
+                }
+            }
+            return slot;
+        }
+
+        if (!resolve(slot, item, generator_.plan_for(prop).segments, record)) {
+            return slot + 1;
+        }
+        std::vector<std::string> rendered;
+        auto native = generator_.render_native(prop, item, rendered);
+        if (auto* error = std::get_if<StatementError>(&native)) {
+            conflict(slot, record, error->message);
+            return slot + 1;
+        }
+        if (std::get<bool>(native)) return slot + 1;
+
+        auto extracted = generator_.extract_value(item, prop.json_path, prop.nebula_type,
+                                                  prop.transform, prop.coerce);
+        if (auto* error = std::get_if<StatementError>(&extracted)) {
+            conflict(slot, record, error->message);
+            return slot + 1;
+        }
+        auto formatted = generator_.format_value(std::get<Value>(extracted));
+        if (auto* error = std::get_if<StatementError>(&formatted)) {
+            conflict(slot, record, error->message);
+        }
+        return slot + 1;
+    }
+
+    // Items of the aggregate plan's source are folded into a scratch
+    // accumulator, which reports the values SUM and AVG cannot take
+    size_t check_aggregate(size_t slot, const Aggregate& aggregate,
+                           const JsonDocument& document, const std::string& record) {
+        const size_t key_slot = slot;
+        const size_t value_slot = aggregate.key_path.empty() ? slot : slot + 1;
+        const auto& plan = generator_.aggregate_plan_for(aggregate);
+        const auto* source = json::detail::find_path(document, plan.over);
+        if (source && !source->is_null()) {
+            const size_t count = source->is_array() ? source->size() : 1;
+            Accumulator scratch(aggregate.op);
+            for (size_t i = 0; i < count; ++i) {
+                const auto& item = source->is_array() ? (*source)[i] : *source;
+                if (!aggregate.key_path.empty()) check_key(key_slot, item, record);
+                const auto* value = resolve(value_slot, item, plan.value, record);
+                auto added = scratch.add(value, aggregate.json_path);
+                if (auto* error = std::get_if<StatementError>(&added)) {
+                    conflict(value_slot, record, error->message);
+                }
+            }
+        }
+        return value_slot + 1;
+    }
+
+    const GraphMapping& mapping_;
+    ValidationReport& report_;
+    std::vector<std::vector<std::string>> source_segments_;
+    std::vector<std::vector<std::string>> segments_;   // One per report path
+    StatementGenerator generator_;
+};
+
+namespace {
+    void check_record(MappingPreflight& preflight, ValidationReport& report,
+                      const json::Record& record) {
+        auto document = json::parse(record.text);
+        if (auto* error = std::get_if<json::Error>(&document)) {
+            report.errors.push_back(record.source + ": JSON error: " + error->message);
+            return;
+        }
+        preflight.check(std::get<JsonDocument>(document), record.source);
+    }
+}
+
+Result<ValidationReport> validate_mapping(const GraphMapping& mapping,
+                                          const JsonDocument& document) {
+    ValidationReport report;
+    MappingPreflight preflight(mapping, report);
+    report.records_read = 1;
+    preflight.check(document, "document");
+    preflight.finish();
+    return report;
+}
+
+Result<ValidationReport> validate_mapping(const GraphMapping& mapping,
+                                          json::RecordReader& reader,
+                                          const SampleOptions& options) {
+    ValidationReport report;
+    MappingPreflight preflight(mapping, report);
+    std::mt19937_64 random(options.seed);
+    std::vector<json::Record> reservoir;
+    reservoir.reserve(options.reservoir);
+
+    // The head is checked as it streams past; the rest is sampled by
+    // Algorithm R and only parsed once the reservoir is final
+    while (options.max_records == 0 || report.records_read < options.max_records) {
+        auto next = reader.next();
+        if (auto* error = std::get_if<json::Error>(&next)) {
+            return StatementError{"Input error: " + error->message};
+        }
+        auto& record = std::get<std::optional<json::Record>>(next);
+        if (!record) break;
+
+        uint64_t index = report.records_read++;
+        if (index < options.head) {
+            check_record(preflight, report, *record);
+            continue;
+        }
+        uint64_t seen = index - options.head;
+        if (seen < options.reservoir) {
+            reservoir.push_back(std::move(*record));
+            continue;
+        }
+        uint64_t pick = std::uniform_int_distribution<uint64_t>(0, seen)(random);
+        if (pick < options.reservoir) {
+            reservoir[pick] = std::move(*record);
+        }
+    }
+
+    for (const auto& record : reservoir) {
+        check_record(preflight, report, record);
+    }
+    preflight.finish();
+    return report;
+}
+
+std::string format_validation(const ValidationReport& report) {
+    std::ostringstream out;
+    out << "Preflight: " << report.records << " records checked of "
+        << report.records_read << " read\n";
+
+    for (const auto& source : report.sources) {
+        out << '\n' << source.owner << ": source " << source.source_path << " in "
+            << source.records - source.missing << "/" << source.records << " records, "
+            << source.items << " items\n";
+        for (const auto& path : report.paths) {
+            if (path.owner != source.owner) continue;
+            std::string label = path.name + " " +
+                                (path.nebula_type.empty() ? path.json_path : path.nebula_type);
+            out << "  " << std::left << std::setw(36) << label << std::right
+                << std::setw(7) << percent(path.resolved, path.items) << " resolved, "
+                << path.nulls << " null, " << path.missing << " missing, "
+                << path.conflicts << " conflicts\n";
+        }
+    }
+
+    if (!report.errors.empty()) {
+        out << "\nErrors:\n";
+        for (const auto& error : report.errors) out << "  " << error << '\n';
+    }
+    if (!report.warnings.empty()) {
+        out << "\nWarnings:\n";
+        for (const auto& warning : report.warnings) out << "  " << warning << '\n';
+    }
+    return out.str();
+}
+
+} // namespace graph
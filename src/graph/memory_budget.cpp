@@ -0,0 +1,113 @@
+#include "graph/memory_budget.hpp"
+#include <cctype>
+#include <charconv>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <sstream>
+
+namespace graph {
+
+namespace {
+    constexpr const char* CONSUMER_NAMES[MEMORY_CONSUMER_COUNT] = {
+        "read_ahead", "documents", "reorder", "collected", "aggregates"
+    };
+
+    void raise_peak(std::atomic<uint64_t>& peak, uint64_t value) {
+        uint64_t current = peak.load(std::memory_order_relaxed);
+        while (value > current &&
+               !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    std::string format_bytes(uint64_t bytes) {
+        static const char* UNITS[] = {"B", "KiB", "MiB", "GiB"};
+        auto value = static_cast<double>(bytes);
+        size_t unit = 0;
+        while (value >= 1024.0 && unit + 1 < std::size(UNITS)) {
+            value /= 1024.0;
+            ++unit;
+        }
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(unit ? 1 : 0) << value << ' ' << UNITS[unit];
+        return out.str();
+    }
+}
+
+const char* memory_consumer_name(MemoryConsumer consumer) {
+    return CONSUMER_NAMES[static_cast<size_t>(consumer)];
+}
+
+MemoryBudget::MemoryBudget(uint64_t limit)
+    : limit_(limit), soft_limit_(limit - limit / 4) {}
+
+void MemoryBudget::charge(MemoryConsumer consumer, uint64_t bytes) {
+    auto& slot = slots_[static_cast<size_t>(consumer)];
+    raise_peak(slot.peak, slot.current.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+    raise_peak(peak_, used_.fetch_add(bytes, std::memory_order_relaxed) + bytes);
+}
+
+void MemoryBudget::release(MemoryConsumer consumer, uint64_t bytes) {
+    slots_[static_cast<size_t>(consumer)].current.fetch_sub(bytes, std::memory_order_relaxed);
+    used_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void MemoryBudget::count_spill(uint64_t bytes) {
+    spills_.fetch_add(1, std::memory_order_relaxed);
+    spilled_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+MemorySnapshot MemoryBudget::snapshot() const {
+    MemorySnapshot result;
+    result.limit = limit_;
+    result.used = used();
+    result.peak = peak_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < MEMORY_CONSUMER_COUNT; ++i) {
+        result.consumers[i].current = slots_[i].current.load(std::memory_order_relaxed);
+        result.consumers[i].peak = slots_[i].peak.load(std::memory_order_relaxed);
+    }
+    result.throttles = throttles_.load(std::memory_order_relaxed);
+    result.spills = spills_.load(std::memory_order_relaxed);
+    result.spilled_bytes = spilled_bytes_.load(std::memory_order_relaxed);
+    return result;
+}
+
+std::optional<uint64_t> parse_memory_size(const std::string& text) {
+    // from_chars takes no sign, so "-1" cannot wrap around
+    uint64_t value = 0;
+    auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (ec != std::errc()) return std::nullopt;
+
+    std::string suffix;
+    for (size_t i = static_cast<size_t>(end - text.data()); i < text.size(); ++i) {
+        suffix += static_cast<char>(std::toupper(static_cast<unsigned char>(text[i])));
+    }
+    if (suffix.size() == 2 && suffix[1] == 'B') suffix.pop_back();
+
+    unsigned shift = 0;
+    if (suffix == "K") {
+        shift = 10;
+    } else if (suffix == "M") {
+        shift = 20;
+    } else if (suffix == "G") {
+        shift = 30;
+    } else if (!suffix.empty() && suffix != "B") {
+        return std::nullopt;
+    }
+    if (value > (std::numeric_limits<uint64_t>::max() >> shift)) return std::nullopt;
+    return value << shift;
+}
+
+std::string format_memory(const MemorySnapshot& memory) {
+    std::ostringstream out;
+    out << "Memory (limit " << format_bytes(memory.limit) << ", peak "
+        << format_bytes(memory.peak) << ", " << memory.throttles << " reader throttles, "
+        << memory.spills << " spills of " << format_bytes(memory.spilled_bytes) << "):\n";
+    for (size_t i = 0; i < MEMORY_CONSUMER_COUNT; ++i) {
+        out << "  " << std::left << std::setw(12) << CONSUMER_NAMES[i] << std::right
+            << std::setw(12) << format_bytes(memory.consumers[i].peak) << " peak\n";
+    }
+    return out.str();
+}
+
+} // namespace graph
@@ -0,0 +1,593 @@
+#include "graph/nebula_value.hpp"
+#include "graph/statement_generator.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cfloat>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+namespace graph {
+
+namespace {
+    constexpr int64_t MICROS_PER_DAY = 86400000000LL;
+
+    bool is_text(NebulaType type) {
+        return type == NebulaType::STRING || type == NebulaType::FIXED_STRING;
+    }
+
+    std::pair<int64_t, int64_t> integer_range(NebulaType type) {
+        switch (type) {
+            case NebulaType::INT8: return {INT8_MIN, INT8_MAX};
+            case NebulaType::INT16: return {INT16_MIN, INT16_MAX};
+            case NebulaType::INT32: return {INT32_MIN, INT32_MAX};
+            default: return {INT64_MIN, INT64_MAX};
+        }
+    }
+
+    bool leap_year(int32_t year) {
+        return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    }
+
+    int days_in_month(int32_t year, int month) {
+        static const int DAYS[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        return month == 2 && leap_year(year) ? 29 : DAYS[month - 1];
+    }
+
+    // Days from 1970-01-01 to `date` in the proleptic Gregorian calendar
+    int64_t days_from_epoch(const NebulaValue::Date& date) {
+        int64_t year = date.year - (date.month <= 2 ? 1 : 0);
+        int64_t era = (year >= 0 ? year : year - 399) / 400;
+        int64_t year_of_era = year - era * 400;
+        int64_t month = date.month;
+        int64_t day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + date.day - 1;
+        int64_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+        return era * 146097 + day_of_era - 719468;
+    }
+
+    // Exactly `width` digits at text[pos]
+    std::optional<uint32_t> digits(std::string_view text, size_t pos, size_t width) {
+        if (pos + width > text.size()) return std::nullopt;
+        uint32_t value = 0;
+        for (size_t i = pos; i < pos + width; ++i) {
+            if (text[i] < '0' || text[i] > '9') return std::nullopt;
+            value = value * 10 + static_cast<uint32_t>(text[i] - '0');
+        }
+        return value;
+    }
+
+    std::string_view strip_zone(std::string_view text) {
+        if (!text.empty() && (text.back() == 'Z' || text.back() == 'z')) {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+
+    StatementError conversion_error(const std::string& what, const std::string& json_path) {
+        return StatementError{"Value conversion error: " + what, json_path};
+    }
+
+    StatementError format_error(std::string_view text, NebulaType type,
+                                const char* expected, const std::string& json_path) {
+        return conversion_error("'" + std::string(text) + "' is not a " +
+                                nebula_type_name(type) + " (expected " + expected + ")",
+                                json_path);
+    }
+
+    // Longest prefix of `text` no longer than `limit` bytes that does not
+    // split a UTF-8 sequence
+    std::string_view truncate_utf8(std::string_view text, size_t limit) {
+        if (text.size() <= limit) return text;
+        size_t end = limit;
+        while (end > 0 && (static_cast<unsigned char>(text[end]) & 0xC0) == 0x80) {
+            --end;
+        }
+        return text.substr(0, end);
+    }
+
+    // Same escapes as StatementGenerator::escape_string
+    void append_quoted(std::string& out, std::string_view text) {
+        out += '"';
+        for (char c : text) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                case '\b': out += "\\b"; break;
+                case '\f': out += "\\f"; break;
+                default: {
+                    auto byte = static_cast<unsigned char>(c);
+                    if (byte >= 0x20 && byte != 0x7F) {
+                        out += c;
+                        break;
+                    }
+                    out += '\\';
+                    out += static_cast<char>('0' + (byte >> 6));
+                    out += static_cast<char>('0' + ((byte >> 3) & 7));
+                    out += static_cast<char>('0' + (byte & 7));
+                }
+            }
+        }
+        out += '"';
+    }
+
+    void append_date(std::string& out, const NebulaValue::Date& date) {
+        char buffer[16];
+        int size = std::snprintf(buffer, sizeof(buffer), "%04d-%02u-%02u", date.year,
+                                 static_cast<unsigned>(date.month),
+                                 static_cast<unsigned>(date.day));
+        out.append(buffer, static_cast<size_t>(size));
+    }
+
+    void append_time(std::string& out, const NebulaValue::Time& time) {
+        char buffer[24];
+        int size = std::snprintf(buffer, sizeof(buffer), "%02u:%02u:%02u",
+                                 static_cast<unsigned>(time.hour),
+                                 static_cast<unsigned>(time.minute),
+                                 static_cast<unsigned>(time.second));
+        if (time.microsecond != 0) {
+            size += std::snprintf(buffer + size, sizeof(buffer) - static_cast<size_t>(size),
+                                  ".%06u", static_cast<unsigned>(time.microsecond));
+        }
+        out.append(buffer, static_cast<size_t>(size));
+    }
+
+    int64_t pack_date(const NebulaValue::Date& date) {
+        return (static_cast<int64_t>(date.year) * 16 + date.month) * 32 + date.day;
+    }
+
+    NebulaValue::Date unpack_date(int64_t packed) {
+        return {static_cast<int32_t>(packed / 512), static_cast<uint8_t>(packed / 32 % 16),
+                static_cast<uint8_t>(packed % 32)};
+    }
+
+    int64_t pack_time(const NebulaValue::Time& time) {
+        return ((time.hour * 60LL + time.minute) * 60 + time.second) * 1000000 +
+               time.microsecond;
+    }
+
+    NebulaValue::Time unpack_time(int64_t packed) {
+        int64_t seconds = packed / 1000000;
+        return {static_cast<uint8_t>(seconds / 3600), static_cast<uint8_t>(seconds / 60 % 60),
+                static_cast<uint8_t>(seconds % 60), static_cast<uint32_t>(packed % 1000000)};
+    }
+}
+
+const char* nebula_type_name(NebulaType type) {
+    switch (type) {
+        case NebulaType::BOOL: return "BOOL";
+        case NebulaType::INT8: return "INT8";
+        case NebulaType::INT16: return "INT16";
+        case NebulaType::INT32: return "INT32";
+        case NebulaType::INT64: return "INT64";
+        case NebulaType::FLOAT: return "FLOAT";
+        case NebulaType::DOUBLE: return "DOUBLE";
+        case NebulaType::STRING: return "STRING";
+        case NebulaType::FIXED_STRING: return "FIXED_STRING";
+        case NebulaType::DATE: return "DATE";
+        case NebulaType::TIME: return "TIME";
+        case NebulaType::DATETIME: return "DATETIME";
+        case NebulaType::TIMESTAMP: return "TIMESTAMP";
+    }
+    return "STRING";
+}
+
+std::optional<TypeSpec> parse_type(const std::string& declared) {
+    std::string upper;
+    for (char c : declared) {
+        if (!std::isspace(static_cast<unsigned char>(c))) {
+            upper += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+    }
+
+    std::optional<uint32_t> length;
+    auto paren = upper.find('(');
+    if (paren != std::string::npos) {
+        if (upper.back() != ')') return std::nullopt;
+        std::string_view inside(upper.data() + paren + 1, upper.size() - paren - 2);
+        uint32_t parsed = 0;
+        auto [end, ec] = std::from_chars(inside.data(), inside.data() + inside.size(), parsed);
+        if (ec != std::errc() || end != inside.data() + inside.size() || parsed == 0) {
+            return std::nullopt;
+        }
+        length = parsed;
+        upper.erase(paren);
+    }
+
+    static const std::pair<const char*, NebulaType> NAMES[] = {
+        {"BOOL", NebulaType::BOOL}, {"BOOLEAN", NebulaType::BOOL},
+        {"INT8", NebulaType::INT8}, {"INT16", NebulaType::INT16},
+        {"INT32", NebulaType::INT32}, {"INT64", NebulaType::INT64},
+        {"INT", NebulaType::INT64}, {"INTEGER", NebulaType::INT64},
+        {"FLOAT", NebulaType::FLOAT}, {"DOUBLE", NebulaType::DOUBLE},
+        {"STRING", NebulaType::STRING}, {"VARCHAR", NebulaType::STRING},
+        {"FIXED_STRING", NebulaType::FIXED_STRING},
+        {"DATE", NebulaType::DATE}, {"TIME", NebulaType::TIME},
+        {"DATETIME", NebulaType::DATETIME}, {"TIMESTAMP", NebulaType::TIMESTAMP},
+    };
+    for (const auto& [name, type] : NAMES) {
+        if (upper != name) continue;
+        if (type == NebulaType::FIXED_STRING) return TypeSpec{type, length.value_or(32)};
+        // Only string types take a length
+        if (length && type != NebulaType::STRING) return std::nullopt;
+        return TypeSpec{type, 0};
+    }
+    return std::nullopt;
+}
+
+NebulaType narrowest_integer_type(int64_t min, int64_t max) {
+    for (auto type : {NebulaType::INT8, NebulaType::INT16, NebulaType::INT32}) {
+        auto [low, high] = integer_range(type);
+        if (min >= low && max <= high) return type;
+    }
+    return NebulaType::INT64;
+}
+
+void TypeInference::observe(const parser::json::JsonDocument& value) {
+    if (value.is_null()) return;
+    ++observed_;
+    if (value.is_boolean()) {
+        kinds_ |= BOOLEAN;
+    } else if (value.is_number_integer()) {
+        kinds_ |= INTEGER;
+        int64_t number = value.is_number_unsigned() &&
+                         value.get<uint64_t>() > static_cast<uint64_t>(INT64_MAX)
+            ? INT64_MAX : value.get<int64_t>();
+        min_ = std::min(min_, number);
+        max_ = std::max(max_, number);
+    } else if (value.is_number_float()) {
+        kinds_ |= REAL;
+        double number = value.get<double>();
+        if (static_cast<double>(static_cast<float>(number)) != number) {
+            needs_double_ = true;
+        }
+    } else if (value.is_string()) {
+        kinds_ |= TEXT;
+        const auto& text = value.get_ref<const std::string&>();
+        max_length_ = std::max(max_length_, text.size());
+        if (!parse_date(text)) not_date_ = true;
+        if (!parse_datetime(text)) not_datetime_ = true;
+    } else {
+        kinds_ |= OTHER;
+    }
+}
+
+std::optional<TypeSpec> TypeInference::type() const {
+    if (observed_ == 0) return std::nullopt;
+    switch (kinds_) {
+        case BOOLEAN:
+            return TypeSpec{NebulaType::BOOL, 0};
+        case INTEGER:
+            return TypeSpec{narrowest_integer_type(min_, max_), 0};
+        case REAL:
+        case INTEGER | REAL: {
+            // Integers up to 2^24 are exact in a float
+            bool small = min_ >= -(1 << 24) && max_ <= (1 << 24);
+            bool narrow = !needs_double_ && (!(kinds_ & INTEGER) || small);
+            return TypeSpec{narrow ? NebulaType::FLOAT : NebulaType::DOUBLE, 0};
+        }
+        case TEXT:
+            if (!not_date_) return TypeSpec{NebulaType::DATE, 0};
+            if (!not_datetime_) return TypeSpec{NebulaType::DATETIME, 0};
+            return TypeSpec{NebulaType::STRING, 0};
+        default:
+            return TypeSpec{NebulaType::STRING, 0};
+    }
+}
+
+NebulaValue NebulaValue::null(NebulaType type) {
+    return NebulaValue(type, true);
+}
+
+NebulaValue NebulaValue::boolean(bool value) {
+    NebulaValue result(NebulaType::BOOL, false);
+    result.payload_.integer = value ? 1 : 0;
+    return result;
+}
+
+NebulaValue NebulaValue::integer(NebulaType type, int64_t value) {
+    NebulaValue result(type, false);
+    result.payload_.integer = value;
+    return result;
+}
+
+NebulaValue NebulaValue::real(NebulaType type, double value) {
+    NebulaValue result(type, false);
+    if (type == NebulaType::FLOAT) {
+        result.payload_.single = static_cast<float>(value);
+    } else {
+        result.payload_.real = value;
+    }
+    return result;
+}
+
+NebulaValue NebulaValue::text(NebulaType type, std::string_view value) {
+    NebulaValue result(type, false);
+    result.size_ = static_cast<uint32_t>(value.size());
+    if (value.size() <= sizeof(result.payload_.inline_text)) {
+        result.inline_ = true;
+        std::memcpy(result.payload_.inline_text, value.data(), value.size());
+    } else {
+        result.payload_.text = value.data();
+    }
+    return result;
+}
+
+NebulaValue NebulaValue::date(Date date) {
+    return integer(NebulaType::DATE, pack_date(date));
+}
+
+NebulaValue NebulaValue::time(Time time) {
+    return integer(NebulaType::TIME, pack_time(time));
+}
+
+NebulaValue NebulaValue::datetime(Date date, Time time) {
+    return integer(NebulaType::DATETIME, pack_date(date) * MICROS_PER_DAY + pack_time(time));
+}
+
+int64_t NebulaValue::as_int() const {
+    if (type_ == NebulaType::FLOAT) return static_cast<int64_t>(payload_.single);
+    if (type_ == NebulaType::DOUBLE) return static_cast<int64_t>(payload_.real);
+    return payload_.integer;
+}
+
+double NebulaValue::as_double() const {
+    if (type_ == NebulaType::FLOAT) return payload_.single;
+    if (type_ == NebulaType::DOUBLE) return payload_.real;
+    return static_cast<double>(payload_.integer);
+}
+
+std::string_view NebulaValue::as_string() const {
+    if (!is_text(type_) || null_) return {};
+    return inline_ ? std::string_view(payload_.inline_text, size_)
+                   : std::string_view(payload_.text, size_);
+}
+
+NebulaValue::Date NebulaValue::as_date() const {
+    if (type_ == NebulaType::DATETIME) return unpack_date(payload_.integer / MICROS_PER_DAY);
+    return unpack_date(payload_.integer);
+}
+
+NebulaValue::Time NebulaValue::as_time() const {
+    if (type_ == NebulaType::DATETIME) return unpack_time(payload_.integer % MICROS_PER_DAY);
+    return unpack_time(payload_.integer);
+}
+
+std::optional<NebulaValue::Date> parse_date(std::string_view text) {
+    if (text.size() != 10 || text[4] != '-' || text[7] != '-') return std::nullopt;
+    auto year = digits(text, 0, 4);
+    auto month = digits(text, 5, 2);
+    auto day = digits(text, 8, 2);
+    if (!year || !month || !day || *month < 1 || *month > 12 || *day < 1) return std::nullopt;
+    auto date = NebulaValue::Date{static_cast<int32_t>(*year), static_cast<uint8_t>(*month),
+                                  static_cast<uint8_t>(*day)};
+    if (*day > static_cast<uint32_t>(days_in_month(date.year, date.month))) return std::nullopt;
+    return date;
+}
+
+std::optional<NebulaValue::Time> parse_time(std::string_view text) {
+    text = strip_zone(text);
+    if (text.size() < 8 || text[2] != ':' || text[5] != ':') return std::nullopt;
+    auto hour = digits(text, 0, 2);
+    auto minute = digits(text, 3, 2);
+    auto second = digits(text, 6, 2);
+    if (!hour || !minute || !second || *hour > 23 || *minute > 59 || *second > 59) {
+        return std::nullopt;
+    }
+
+    uint32_t microsecond = 0;
+    if (text.size() > 8) {
+        // Up to six fraction digits
+        size_t width = text.size() - 9;
+        if (text[8] != '.' || width == 0 || width > 6) return std::nullopt;
+        auto fraction = digits(text, 9, width);
+        if (!fraction) return std::nullopt;
+        microsecond = *fraction;
+        for (size_t i = width; i < 6; ++i) microsecond *= 10;
+    }
+    return NebulaValue::Time{static_cast<uint8_t>(*hour), static_cast<uint8_t>(*minute),
+                             static_cast<uint8_t>(*second), microsecond};
+}
+
+std::optional<std::pair<NebulaValue::Date, NebulaValue::Time>> parse_datetime(
+    std::string_view text) {
+    if (text.size() < 11 || (text[10] != 'T' && text[10] != 't' && text[10] != ' ')) {
+        return std::nullopt;
+    }
+    auto date = parse_date(text.substr(0, 10));
+    auto time = parse_time(text.substr(11));
+    if (!date || !time) return std::nullopt;
+    return std::make_pair(*date, *time);
+}
+
+common::Result<NebulaValue, StatementError> to_nebula_value(
+    const parser::json::JsonDocument& json, const TypeSpec& spec, const std::string& json_path,
+    common::numbers::CoercionMode coerce) {
+
+    if (json.is_null()) return NebulaValue::null(spec.type);
+
+    try {
+        switch (spec.type) {
+            case NebulaType::BOOL:
+                return NebulaValue::boolean(json.get<bool>());
+
+            case NebulaType::INT8:
+            case NebulaType::INT16:
+            case NebulaType::INT32:
+            case NebulaType::INT64: {
+                int64_t value = 0;
+                if (json.is_string()) {
+                    auto parsed = common::numbers::parse_int64(
+                        json.get_ref<const std::string&>(), coerce);
+                    if (auto* error = std::get_if<common::Error>(&parsed)) {
+                        return conversion_error(error->message, json_path);
+                    }
+                    value = std::get<int64_t>(parsed);
+                } else {
+                    value = json.get<int64_t>();
+                }
+                auto [low, high] = integer_range(spec.type);
+                if (value < low || value > high) {
+                    return conversion_error(std::to_string(value) + " is out of range for " +
+                                            nebula_type_name(spec.type), json_path);
+                }
+                return NebulaValue::integer(spec.type, value);
+            }
+
+            case NebulaType::FLOAT:
+            case NebulaType::DOUBLE: {
+                double value = 0;
+                if (json.is_string()) {
+                    auto parsed = common::numbers::parse_double(
+                        json.get_ref<const std::string&>(), coerce);
+                    if (auto* error = std::get_if<common::Error>(&parsed)) {
+                        return conversion_error(error->message, json_path);
+                    }
+                    value = std::get<double>(parsed);
+                } else {
+                    value = json.get<double>();
+                }
+                if (spec.type == NebulaType::DOUBLE) return NebulaValue::real(spec.type, value);
+                if (std::isfinite(value) && std::fabs(value) > FLT_MAX) {
+                    return conversion_error(json.dump() + " is out of range for FLOAT",
+                                            json_path);
+                }
+                return NebulaValue::real(spec.type, value);
+            }
+
+            case NebulaType::TIMESTAMP: {
+                if (!json.is_string()) {
+                    int64_t seconds = json.get<int64_t>();
+                    if (seconds < 0) {
+                        return conversion_error(std::to_string(seconds) +
+                                                " is out of range for TIMESTAMP", json_path);
+                    }
+                    return NebulaValue::integer(spec.type, seconds);
+                }
+                const auto& text = json.get_ref<const std::string&>();
+                auto parsed = parse_datetime(text);
+                if (!parsed) {
+                    // Seconds written as a string
+                    auto seconds = common::numbers::parse_int64(text, coerce);
+                    const auto* value = std::get_if<int64_t>(&seconds);
+                    if (value && *value >= 0) return NebulaValue::integer(spec.type, *value);
+                }
+                if (!parsed || parsed->first.year < 1970) {
+                    return format_error(text, spec.type, "seconds or YYYY-MM-DDTHH:MM:SS",
+                                        json_path);
+                }
+                auto& [date, time] = *parsed;
+                int64_t seconds = days_from_epoch(date) * 86400 +
+                                  (time.hour * 60LL + time.minute) * 60 + time.second;
+                return NebulaValue::integer(spec.type, seconds);
+            }
+
+            default:
+                break;
+        }
+
+        // The remaining types are read from strings; get<std::string>()
+        // reports any other JSON type
+        if (!json.is_string()) json.get<std::string>();
+        const auto& text = json.get_ref<const std::string&>();
+
+        switch (spec.type) {
+            case NebulaType::FIXED_STRING:
+                return NebulaValue::text(spec.type, truncate_utf8(text, spec.length));
+
+            case NebulaType::DATE:
+                if (auto date = parse_date(text)) return NebulaValue::date(*date);
+                return format_error(text, spec.type, "YYYY-MM-DD", json_path);
+
+            case NebulaType::TIME:
+                if (auto time = parse_time(text)) return NebulaValue::time(*time);
+                return format_error(text, spec.type, "HH:MM:SS", json_path);
+
+            case NebulaType::DATETIME:
+                if (auto parsed = parse_datetime(text)) {
+                    return NebulaValue::datetime(parsed->first, parsed->second);
+                }
+                return format_error(text, spec.type, "YYYY-MM-DDTHH:MM:SS", json_path);
+
+            default:
+                return NebulaValue::text(NebulaType::STRING, text);
+        }
+    } catch (const std::exception& e) {
+        return conversion_error(e.what(), json_path);
+    }
+}
+
+void append_real(std::string& out, double value, bool single) {
+    char buffer[32];
+    auto [end, ec] = single
+        ? std::to_chars(buffer, buffer + sizeof(buffer), static_cast<float>(value))
+        : std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, end);
+}
+
+void append_text(std::string& out, const NebulaValue& value) {
+    if (value.is_null()) return;
+
+    char buffer[32];
+    switch (value.type()) {
+        case NebulaType::BOOL:
+            out += value.as_bool() ? "true" : "false";
+            return;
+        case NebulaType::FLOAT:
+        case NebulaType::DOUBLE: {
+            append_real(out, value.as_double(), value.type() == NebulaType::FLOAT);
+            return;
+        }
+        case NebulaType::STRING:
+        case NebulaType::FIXED_STRING:
+            out += value.as_string();
+            return;
+        case NebulaType::DATE:
+            append_date(out, value.as_date());
+            return;
+        case NebulaType::TIME:
+            append_time(out, value.as_time());
+            return;
+        case NebulaType::DATETIME:
+            append_date(out, value.as_date());
+            out += 'T';
+            append_time(out, value.as_time());
+            return;
+        default: {
+            auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value.as_int());
+            out.append(buffer, end);
+            return;
+        }
+    }
+}
+
+void append_literal(std::string& out, const NebulaValue& value) {
+    if (value.is_null()) {
+        out += "NULL";
+        return;
+    }
+
+    const char* function = nullptr;
+    switch (value.type()) {
+        case NebulaType::STRING:
+        case NebulaType::FIXED_STRING:
+            append_quoted(out, value.as_string());
+            return;
+        case NebulaType::DATE: function = "date"; break;
+        case NebulaType::TIME: function = "time"; break;
+        case NebulaType::DATETIME: function = "datetime"; break;
+        default:
+            append_text(out, value);
+            return;
+    }
+    out += function;
+    out += "(\"";
+    append_text(out, value);
+    out += "\")";
+}
+
+} // namespace graph
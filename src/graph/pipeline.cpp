@@ -0,0 +1,438 @@
+#include "graph/pipeline.hpp"
+#include "graph/compiled_mapping.hpp"
+#include "telemetry/metrics.hpp"
+#include "telemetry/probes.hpp"
+#include "telemetry/stats.hpp"
+#include "telemetry/trace.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace graph {
+
+namespace {
+
+    using parser::json::Record;
+
+    // Rough size of a parsed DOM relative to its text
+    constexpr uint64_t DOCUMENT_EXPANSION = 4;
+
+    // Whether anything reads the per-mapping rows and statements
+    bool accounting_enabled() {
+        return telemetry::stats_enabled() || telemetry::metrics_enabled() ||
+               NEBULA_MAPPER_PROBE_ENABLED(row_extracted) ||
+               NEBULA_MAPPER_PROBE_ENABLED(batch_flushed);
+    }
+
+    // Counters, metrics and probes for an extractor's statements, the ones
+    // StatementGenerator reports for its own
+    void account_compiled(const parser::mapping::GraphMapping& mapping,
+                          const std::vector<std::string>& statements,
+                          const std::vector<CompiledBatch>& batches, size_t batch_size) {
+        const size_t vertices = mapping.vertices.size();
+        for (size_t i = 0; i < batches.size() && i < statements.size(); ++i) {
+            const auto& batch = batches[i];
+            if (batch.mapping >= vertices + mapping.edges.size()) continue;
+            const auto* vertex = batch.mapping < vertices ? &mapping.vertices[batch.mapping]
+                                                          : nullptr;
+            const std::string& name = vertex ? vertex->tag_name
+                                             : mapping.edges[batch.mapping - vertices].edge_name;
+
+            for (uint32_t bytes : batch.row_bytes) {
+                telemetry::count_row(name, bytes);
+                NEBULA_MAPPER_PROBE2(row_extracted, name.c_str(), bytes);
+            }
+            const size_t rows = batch.row_bytes.size();
+            auto close = vertex && vertex->dynamic_fields.enabled
+                ? telemetry::BatchClose::SINGLE_ROW
+                : rows >= batch_size ? telemetry::BatchClose::FULL : telemetry::BatchClose::FLUSH;
+            telemetry::count_statement(name, statements[i].size(), rows, close);
+            detail::publish_statement(name, rows, statements[i].size());
+        }
+    }
+
+    Result<std::vector<std::string>> map_record(
+        StatementGenerator& generator,
+        const parser::mapping::GraphMapping& mapping,
+        const Record& record,
+        const PipelineOptions& options,
+        uint64_t& compiled_rows) {
+        parser::json::Result<parser::json::JsonDocument> document =
+            parser::json::JsonDocument{};
+        {
+            NEBULA_MAPPER_TRACE_SPAN("document_parse");
+            telemetry::StageTimer timer(telemetry::Stage::JSON_PARSE);
+            document = parser::json::parse(record.text);
+        }
+        if (std::holds_alternative<parser::json::Error>(document)) {
+            return StatementError{
+                "JSON error: " + std::get<parser::json::Error>(document).message,
+                record.source};
+        }
+
+        const auto& json = std::get<parser::json::JsonDocument>(document);
+        if (options.compiled) {
+            telemetry::StageTimer timer(telemetry::Stage::EXTRACTION);
+            std::vector<CompiledBatch> batches;
+            const bool accounting = accounting_enabled();
+            if (auto statements = options.compiled->generate(
+                    json, options.batch_size, compiled_rows, accounting ? &batches : nullptr)) {
+                if (accounting) {
+                    account_compiled(mapping, *statements, batches, options.batch_size);
+                }
+                return std::move(*statements);
+            }
+        }
+
+        auto result = generator.generate_batch_statements(mapping, json, options.batch_size);
+        if (std::holds_alternative<StatementError>(result)) {
+            auto& error = std::get<StatementError>(result);
+            error.context = error.context ? record.source + ": " + *error.context
+                                          : record.source;
+        }
+        return result;
+    }
+
+    // One relaxed add per counter and record
+    void track_progress(telemetry::ProgressCounters& progress, uint64_t rows,
+                        const std::vector<std::string>& statements) {
+        uint64_t bytes = 0;
+        for (const auto& stmt : statements) {
+            bytes += stmt.size();
+        }
+        progress.records.fetch_add(1, std::memory_order_relaxed);
+        progress.rows.fetch_add(rows, std::memory_order_relaxed);
+        progress.statements.fetch_add(statements.size(), std::memory_order_relaxed);
+        progress.statement_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    // Parse and map one record, timing and counting it if asked to
+    Result<std::vector<std::string>> process_record(
+        StatementGenerator& generator,
+        const parser::mapping::GraphMapping& mapping,
+        const Record& record,
+        const PipelineOptions& options) {
+        MemoryCharge document(options.memory, MemoryConsumer::DOCUMENTS,
+                              record.text.size() * DOCUMENT_EXPANSION);
+        uint64_t rows_before = generator.rows_generated();
+        uint64_t compiled_rows = 0;
+        std::optional<telemetry::RecordTimer> timer;
+        if (options.slow_records) {
+            timer.emplace();
+        }
+
+        auto result = map_record(generator, mapping, record, options, compiled_rows);
+
+        if (timer) {
+            options.slow_records->observe(
+                timer->finish(record.source, record.index, record.offset, record.text.size()));
+        }
+        if (options.progress && std::holds_alternative<std::vector<std::string>>(result)) {
+            track_progress(*options.progress,
+                           generator.rows_generated() - rows_before + compiled_rows,
+                           std::get<std::vector<std::string>>(result));
+        }
+        return result;
+    }
+
+    StatementError input_error(const parser::json::Error& error) {
+        std::string message = "Input error: " + error.message;
+        if (error.line_number) {
+            message += " at line " + std::to_string(*error.line_number);
+        }
+        return StatementError{message};
+    }
+
+    uint64_t total_bytes(const std::vector<std::string>& statements) {
+        uint64_t bytes = 0;
+        for (const auto& stmt : statements) {
+            bytes += stmt.size();
+        }
+        return bytes;
+    }
+
+    void count_statements(PipelineSummary& summary,
+                          const std::vector<std::string>& statements) {
+        summary.statements += statements.size();
+        summary.statement_bytes += total_bytes(statements);
+    }
+
+    // UPDATE statements of the run's update aggregates, after every record
+    Result<bool> flush_aggregates(AggregateTable& aggregates,
+                                  const parser::mapping::GraphMapping& mapping,
+                                  PipelineSummary& summary,
+                                  StatementSink& sink) {
+        if (aggregates.empty()) return true;
+        auto updates = aggregates.update_statements(mapping);
+        if (std::holds_alternative<StatementError>(updates)) {
+            return std::get<StatementError>(updates);
+        }
+        auto& statements = std::get<std::vector<std::string>>(updates);
+        count_statements(summary, statements);
+        sink.consume(std::move(statements));
+        return true;
+    }
+
+    Result<PipelineSummary> run_serial(
+        const parser::mapping::GraphMapping& mapping,
+        parser::json::RecordReader& reader,
+        StatementSink& sink,
+        const PipelineOptions& options) {
+        StatementGenerator generator;
+        generator.aggregates().set_budget(options.memory);
+        PipelineSummary summary;
+
+        for (;;) {
+            auto next = reader.next();
+            if (options.progress) {
+                options.progress->input_bytes.store(reader.bytes_read(),
+                                                    std::memory_order_relaxed);
+            }
+            if (std::holds_alternative<parser::json::Error>(next)) {
+                return input_error(std::get<parser::json::Error>(next));
+            }
+            auto& record = std::get<std::optional<Record>>(next);
+            if (!record) break;
+
+            auto statements = process_record(generator, mapping, *record, options);
+            if (std::holds_alternative<StatementError>(statements)) {
+                return std::get<StatementError>(statements);
+            }
+            ++summary.records;
+            auto& produced = std::get<std::vector<std::string>>(statements);
+            count_statements(summary, produced);
+            sink.consume(std::move(produced));
+        }
+
+        auto flushed = flush_aggregates(generator.aggregates(), mapping, summary,
+                                        options.update_sink ? *options.update_sink : sink);
+        if (std::holds_alternative<StatementError>(flushed)) {
+            return std::get<StatementError>(flushed);
+        }
+        summary.input_bytes = reader.bytes_read();
+        return summary;
+    }
+
+    // The reading thread feeds a bounded queue; workers parse and map
+    // records and deliver them through a reorder buffer, so the sink sees
+    // input order and at most `window` records are in memory at once.
+    // With a memory budget, the reader also stops while the budget is
+    // exhausted and records are still in flight.
+    class ParallelPipeline {
+    public:
+        ParallelPipeline(const parser::mapping::GraphMapping& mapping,
+                         StatementSink& sink,
+                         const PipelineOptions& options)
+            : mapping_(mapping), sink_(sink), options_(options),
+              window_(options.queue_capacity ? options.queue_capacity
+                                             : options.threads * 4) {
+            aggregates_.set_budget(options.memory);
+        }
+
+        Result<PipelineSummary> run(parser::json::RecordReader& reader) {
+            std::vector<std::thread> workers;
+            workers.reserve(options_.threads);
+            for (size_t i = 0; i < options_.threads; ++i) {
+                workers.emplace_back([this] { work(); });
+            }
+
+            read(reader);
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            release_leftovers();
+
+            if (error_) {
+                return *error_;
+            }
+            auto flushed = flush_aggregates(aggregates_, mapping_, summary_,
+                                            options_.update_sink ? *options_.update_sink
+                                                                 : sink_);
+            if (std::holds_alternative<StatementError>(flushed)) {
+                return std::get<StatementError>(flushed);
+            }
+            summary_.input_bytes = reader.bytes_read();
+            return summary_;
+        }
+
+    private:
+        void read(parser::json::RecordReader& reader) {
+            uint64_t count = 0;
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    if (!stopped_ && throttled(count)) {
+                        options_.memory->count_throttle();
+                    }
+                    not_full_.wait(lock, [&] {
+                        return stopped_ || (count - delivered_ < window_ && !throttled(count));
+                    });
+                    if (stopped_) break;
+                }
+
+                auto next = reader.next();
+                if (options_.progress) {
+                    options_.progress->input_bytes.store(reader.bytes_read(),
+                                                         std::memory_order_relaxed);
+                }
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (std::holds_alternative<parser::json::Error>(next)) {
+                    fail(count, input_error(std::get<parser::json::Error>(next)));
+                    break;
+                }
+                auto& record = std::get<std::optional<Record>>(next);
+                if (!record) break;
+
+                record->index = count++;
+                if (options_.memory) {
+                    options_.memory->charge(MemoryConsumer::READ_AHEAD, record->text.size());
+                }
+                queue_.push_back(std::move(*record));
+                not_empty_.notify_one();
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+            not_empty_.notify_all();
+        }
+
+        void work() {
+            StatementGenerator generator;
+            generator.aggregates().set_budget(options_.memory);
+            process(generator);
+            std::lock_guard<std::mutex> lock(output_mutex_);
+            aggregates_.merge(std::move(generator.aggregates()));
+        }
+
+        void process(StatementGenerator& generator) {
+            for (;;) {
+                Record record;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    not_empty_.wait(lock, [&] {
+                        return stopped_ || closed_ || !queue_.empty();
+                    });
+                    if (stopped_ || queue_.empty()) return;
+                    record = std::move(queue_.front());
+                    queue_.pop_front();
+                }
+                if (options_.memory) {
+                    options_.memory->release(MemoryConsumer::READ_AHEAD, record.text.size());
+                }
+
+                auto statements = process_record(generator, mapping_, record, options_);
+                if (std::holds_alternative<StatementError>(statements)) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    fail(record.index, std::move(std::get<StatementError>(statements)));
+                    return;
+                }
+                deliver(record.index, std::move(std::get<std::vector<std::string>>(statements)));
+            }
+        }
+
+        void deliver(uint64_t index, std::vector<std::string>&& statements) {
+            uint64_t delivered = 0;
+            {
+                std::lock_guard<std::mutex> lock(output_mutex_);
+                if (!options_.ordered) {
+                    emit(std::move(statements));
+                    delivered = 1;
+                } else {
+                    if (options_.memory) {
+                        options_.memory->charge(MemoryConsumer::REORDER, total_bytes(statements));
+                    }
+                    pending_.emplace(index, std::move(statements));
+                    while (!pending_.empty() && pending_.begin()->first == next_output_) {
+                        if (options_.memory) {
+                            options_.memory->release(MemoryConsumer::REORDER,
+                                                     total_bytes(pending_.begin()->second));
+                        }
+                        emit(std::move(pending_.begin()->second));
+                        pending_.erase(pending_.begin());
+                        ++next_output_;
+                        ++delivered;
+                    }
+                }
+            }
+
+            if (delivered > 0) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                delivered_ += delivered;
+                not_full_.notify_one();
+            }
+        }
+
+        // Called with output_mutex_ held
+        void emit(std::vector<std::string>&& statements) {
+            ++summary_.records;
+            count_statements(summary_, statements);
+            sink_.consume(std::move(statements));
+        }
+
+        // Records and statements a failed run never got to
+        void release_leftovers() {
+            if (!options_.memory) return;
+            for (const auto& record : queue_) {
+                options_.memory->release(MemoryConsumer::READ_AHEAD, record.text.size());
+            }
+            for (const auto& [index, statements] : pending_) {
+                options_.memory->release(MemoryConsumer::REORDER, total_bytes(statements));
+            }
+        }
+
+        // Out of memory with work in flight that will free some; called
+        // with mutex_ held
+        bool throttled(uint64_t count) const {
+            return options_.memory && options_.memory->exhausted() && count > delivered_;
+        }
+
+        // Keep the error of the earliest record; called with mutex_ held
+        void fail(uint64_t index, StatementError error) {
+            if (!error_ || index < error_index_) {
+                error_ = std::move(error);
+                error_index_ = index;
+            }
+            stopped_ = true;
+            not_empty_.notify_all();
+            not_full_.notify_all();
+        }
+
+        const parser::mapping::GraphMapping& mapping_;
+        StatementSink& sink_;
+        const PipelineOptions& options_;
+        const uint64_t window_;
+
+        std::mutex mutex_;
+        std::condition_variable not_empty_;
+        std::condition_variable not_full_;
+        std::deque<Record> queue_;
+        uint64_t delivered_{0};
+        bool closed_{false};
+        bool stopped_{false};
+        std::optional<StatementError> error_;
+        uint64_t error_index_{0};
+
+        std::mutex output_mutex_;
+        std::map<uint64_t, std::vector<std::string>> pending_;
+        uint64_t next_output_{0};
+        PipelineSummary summary_;
+        AggregateTable aggregates_;     // Each worker's, merged as it finishes
+    };
+
+} // namespace
+
+Result<PipelineSummary> run_pipeline(
+    const parser::mapping::GraphMapping& mapping,
+    parser::json::RecordReader& reader,
+    StatementSink& sink,
+    const PipelineOptions& options) {
+    if (options.threads <= 1) {
+        return run_serial(mapping, reader, sink, options);
+    }
+    return ParallelPipeline(mapping, sink, options).run(reader);
+}
+
+} // namespace graph
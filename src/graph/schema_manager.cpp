@@ -10,7 +10,12 @@ namespace graph {
         const std::unordered_set<std::string> VALID_TYPES = {
             "BOOL", "INT", "INT8", "INT16", "INT32", "INT64",
             "FLOAT", "DOUBLE", "STRING", "FIXED_STRING",
-            "TIMESTAMP", "DATE", "TIME", "DATETIME"
+            "TIMESTAMP", "DATE", "TIME", "DATETIME", "GEOGRAPHY"
+        };
+
+        // GEOGRAPHY, unconstrained or limited to one shape
+        const std::unordered_set<std::string> GEOGRAPHY_TYPES = {
+            "GEOGRAPHY", "GEOGRAPHY(POINT)", "GEOGRAPHY(LINESTRING)", "GEOGRAPHY(POLYGON)"
         };
 
         // Default lengths for string types
@@ -77,6 +82,21 @@ SchemaResult<std::vector<std::string>> SchemaManager::generate_schema_statements
             element.properties.push_back(schema_prop);
         }
 
+        // Aggregate columns are NULL where there is nothing to aggregate
+        for (const auto& aggregate : vertex.aggregates) {
+            SchemaProperty schema_prop;
+            schema_prop.name = aggregate.name;
+
+            auto type_result = convert_to_nebula_type(aggregate.nebula_type);
+            if (std::holds_alternative<SchemaError>(type_result)) {
+                return std::get<SchemaError>(type_result);
+            }
+            schema_prop.type = std::get<std::string>(type_result);
+            schema_prop.nullable = true;
+
+            element.properties.push_back(schema_prop);
+        }
+
         // Validate schema element
         auto validation = validate_schema_element(element);
         if (std::holds_alternative<SchemaError>(validation)) {
@@ -398,11 +418,21 @@ SchemaResult<std::vector<std::string>> SchemaManager::generate_schema_statements
             return upper_type + "(" + std::to_string(length) + ")";
         }
 
+        // GEOGRAPHY without spaces: "Geography (Point)" is GEOGRAPHY(POINT)
+        if (upper_type.rfind("GEOGRAPHY", 0) == 0) {
+            upper_type.erase(std::remove_if(upper_type.begin(), upper_type.end(), ::isspace),
+                             upper_type.end());
+            if (GEOGRAPHY_TYPES.find(upper_type) != GEOGRAPHY_TYPES.end()) {
+                return upper_type;
+            }
+            return SchemaError{"Unsupported type: " + type};
+        }
+
         // Handle numeric and other types
         static const std::unordered_map<std::string, std::string> TYPE_MAP = {
             {"INT", "INT64"},
             {"INTEGER", "INT64"},
-            {"FLOAT", "DOUBLE"},
+            {"FLOAT", "FLOAT"},
             {"DOUBLE", "DOUBLE"},
             {"BOOL", "BOOL"},
             {"BOOLEAN", "BOOL"},
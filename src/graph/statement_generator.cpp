@@ -1,11 +1,29 @@
 #include "graph/statement_generator.hpp"
+#include "graph/geo.hpp"
+#include "graph/json_literal.hpp"
 #include "transformer/transform_engine.hpp"
+#include "telemetry/metrics.hpp"
+#include "telemetry/probes.hpp"
+#include "telemetry/profile.hpp"
+#include "telemetry/stats.hpp"
+#include "telemetry/trace.hpp"
 #include <unordered_set>
 #include <sstream>
 #include <regex>
 
 namespace graph {
 
+namespace {
+    using detail::publish_statement;
+
+    // What convert_points() found for one item
+    enum PointState : uint8_t {
+        POINT,
+        NULL_POINT,     // A coordinate is null
+        BAD_POINT       // A coordinate is missing or not a number
+    };
+}
+
     void StatementGenerator::generate_insert_vertex_statement(
     std::vector<std::string>& statements,
     const std::string& tag_name,
@@ -76,12 +94,25 @@ Result<std::vector<std::string>> StatementGenerator::generate_batch_statements(
 
     // Process vertices first
     for (const auto& vertex_mapping : mapping.vertices) {
-        auto vertex_data = get_array_or_single(data, vertex_mapping.source_path);
+        NEBULA_MAPPER_TRACE_SPAN("mapping_chunk", vertex_mapping.tag_name);
+        telemetry::StageTimer extraction_timer(telemetry::Stage::EXTRACTION);
+        auto vertex_data = [&] {
+            telemetry::StepScope step(&vertex_mapping.source_path);
+            return get_array_or_single(data, vertex_mapping.source_path);
+        }();
         if (std::holds_alternative<StatementError>(vertex_data)) {
             return std::get<StatementError>(vertex_data);
         }
 
         const auto& vertices = std::get<std::vector<parser::json::JsonDocument>>(vertex_data);
+        convert_points(vertex_mapping.properties, vertices);
+        AggregateGroups groups;
+        if (!vertex_mapping.aggregates.empty()) {
+            auto accumulated = accumulate(vertex_mapping, data, groups);
+            if (std::holds_alternative<StatementError>(accumulated)) {
+                return std::get<StatementError>(accumulated);
+            }
+        }
         std::vector<std::string> batch_values;
         std::vector<std::string> prop_names;  // Moved inside the loop
 
@@ -89,10 +120,19 @@ Result<std::vector<std::string>> StatementGenerator::generate_batch_statements(
         for (const auto& prop : vertex_mapping.properties) {
             prop_names.push_back(quote_identifier(prop.name));
         }
+        for (const auto& aggregate : vertex_mapping.aggregates) {
+            if (!aggregate.update) prop_names.push_back(quote_identifier(aggregate.name));
+        }
+
+        uint64_t dedup_hits = 0;
+        uint64_t dedup_misses = 0;
 
         // Process each vertex
         for (const auto& vertex : vertices) {
-            auto vertex_id = get_vertex_id(vertex, vertex_mapping.key_path);
+            auto vertex_id = [&] {
+                telemetry::StepScope step(&vertex_mapping.key_path);
+                return get_vertex_id(vertex, vertex_mapping.key_path);
+            }();
             if (std::holds_alternative<StatementError>(vertex_id)) {
                 return std::get<StatementError>(vertex_id);
             }
@@ -103,34 +143,75 @@ Result<std::vector<std::string>> StatementGenerator::generate_batch_statements(
             if (vertex_mapping.dynamic_fields.enabled) {  // Changed from allow_dynamic_fields
                 auto& processed = processed_vertices[vertex_mapping.tag_name];
                 if (processed.find(id_str) != processed.end()) {
+                    ++dedup_hits;
                     continue;
                 }
                 processed.insert(id_str);
+                ++dedup_misses;
             }
 
             std::vector<std::string> prop_values;
 
             // Extract and format properties
             for (const auto& prop : vertex_mapping.properties) {
+                telemetry::StepScope step(&prop);
+                auto point = render_point(prop, vertex, &vertex - vertices.data(), prop_values);
+                if (std::holds_alternative<StatementError>(point)) {
+                    return std::get<StatementError>(point);
+                }
+                if (std::get<bool>(point)) {
+                    step.add_output(prop_values.back().size());
+                    continue;
+                }
+
+                if (auto* dictionary = dictionary_for(prop)) {
+                    if (const auto* literal = dictionary->render(vertex)) {
+                        prop_values.push_back(*literal);
+                        step.add_output(literal->size());
+                        continue;
+                    }
+                }
+
+                auto native = render_native(prop, vertex, prop_values);
+                if (std::holds_alternative<StatementError>(native)) {
+                    return std::get<StatementError>(native);
+                }
+                if (std::get<bool>(native)) {
+                    step.add_output(prop_values.back().size());
+                    continue;
+                }
+
                 auto value = extract_value(
                     vertex,
                     prop.json_path,
                     prop.nebula_type,
-                    prop.transform
+                    prop.transform,
+                    prop.coerce
                 );
 
                 if (std::holds_alternative<StatementError>(value)) {
                     return std::get<StatementError>(value);
                 }
 
+                telemetry::StageTimer render_timer(telemetry::Stage::RENDER);
                 auto formatted = format_value(std::get<Value>(value));
                 if (std::holds_alternative<StatementError>(formatted)) {
                     return std::get<StatementError>(formatted);
                 }
 
                 prop_values.push_back(std::get<std::string>(formatted));
+                step.add_output(prop_values.back().size());
+            }
+
+            if (!vertex_mapping.aggregates.empty()) {
+                auto rendered = render_aggregates(vertex_mapping, groups, id_str, prop_values);
+                if (std::holds_alternative<StatementError>(rendered)) {
+                    return std::get<StatementError>(rendered);
+                }
             }
 
+            telemetry::StageTimer render_timer(telemetry::Stage::RENDER);
+
             // Generate UPSERT statement for vertices with dynamic fields
             if (vertex_mapping.dynamic_fields.enabled) {  // Changed from allow_dynamic_fields
                 std::stringstream ss;
@@ -140,18 +221,34 @@ Result<std::vector<std::string>> StatementGenerator::generate_batch_statements(
                    << "VALUES ("
                    << detail::join_values(prop_values) << ");";
                 statements.push_back(ss.str());
+                ++rows_generated_;
+                telemetry::count_row(vertex_mapping.tag_name, statements.back().size());
+                NEBULA_MAPPER_PROBE2(row_extracted, vertex_mapping.tag_name.c_str(),
+                                     statements.back().size());
+                telemetry::count_statement(vertex_mapping.tag_name, statements.back().size(), 1,
+                                           telemetry::BatchClose::SINGLE_ROW);
+                publish_statement(vertex_mapping.tag_name, 1, statements.back().size());
             } else {
                 batch_values.push_back(
                     id_str + ":(" +
                     detail::join_values(prop_values) + ")"
                 );
+                ++rows_generated_;
+                telemetry::count_row(vertex_mapping.tag_name, batch_values.back().size());
+                NEBULA_MAPPER_PROBE2(row_extracted, vertex_mapping.tag_name.c_str(),
+                                     batch_values.back().size());
 
                 if (batch_values.size() >= batch_size) {
+                    NEBULA_MAPPER_TRACE_SPAN("batch_render", vertex_mapping.tag_name);
                     std::stringstream ss;
                     ss << "INSERT VERTEX " << quote_identifier(vertex_mapping.tag_name)
                        << " (" << detail::join_values(prop_names) << ") "
                        << "VALUES " << detail::join_values(batch_values) << ";";
                     statements.push_back(ss.str());
+                    telemetry::count_statement(vertex_mapping.tag_name, statements.back().size(),
+                                               batch_values.size(), telemetry::BatchClose::FULL);
+                    publish_statement(vertex_mapping.tag_name, batch_values.size(),
+                                      statements.back().size());
                     batch_values.clear();
                 }
             }
@@ -159,22 +256,39 @@ Result<std::vector<std::string>> StatementGenerator::generate_batch_statements(
 
         // Handle remaining vertices
         if (!batch_values.empty()) {
+            NEBULA_MAPPER_TRACE_SPAN("batch_render", vertex_mapping.tag_name);
+            telemetry::StageTimer render_timer(telemetry::Stage::RENDER);
             std::stringstream ss;
             ss << "INSERT VERTEX " << quote_identifier(vertex_mapping.tag_name)
                << " (" << detail::join_values(prop_names) << ") "
                << "VALUES " << detail::join_values(batch_values) << ";";
             statements.push_back(ss.str());
+            telemetry::count_statement(vertex_mapping.tag_name, statements.back().size(),
+                                       batch_values.size(), telemetry::BatchClose::FLUSH);
+            publish_statement(vertex_mapping.tag_name, batch_values.size(),
+                              statements.back().size());
+        }
+
+        if (telemetry::metrics_enabled()) {
+            telemetry::pipeline_metrics().dedup_hits.add(dedup_hits);
+            telemetry::pipeline_metrics().dedup_misses.add(dedup_misses);
         }
     }
 
     // Process edges
     for (const auto& edge_mapping : mapping.edges) {
-        auto edge_data = get_array_or_single(data, edge_mapping.source_path);
+        NEBULA_MAPPER_TRACE_SPAN("mapping_chunk", edge_mapping.edge_name);
+        telemetry::StageTimer extraction_timer(telemetry::Stage::EXTRACTION);
+        auto edge_data = [&] {
+            telemetry::StepScope step(&edge_mapping.source_path);
+            return get_array_or_single(data, edge_mapping.source_path);
+        }();
         if (std::holds_alternative<StatementError>(edge_data)) {
             return std::get<StatementError>(edge_data);
         }
 
         const auto& edges = std::get<std::vector<parser::json::JsonDocument>>(edge_data);
+        convert_points(edge_mapping.properties, edges);
         std::vector<std::string> batch_values;
         std::vector<std::string> prop_names;
 
@@ -185,60 +299,112 @@ Result<std::vector<std::string>> StatementGenerator::generate_batch_statements(
 
         // Process each edge
         for (const auto& edge : edges) {
-            auto src_id = get_vertex_id(edge, edge_mapping.from.key_path);
+            auto src_id = [&] {
+                telemetry::StepScope step(&edge_mapping.from.key_path);
+                return get_vertex_id(edge, edge_mapping.from.key_path);
+            }();
             if (std::holds_alternative<StatementError>(src_id)) {
                 return std::get<StatementError>(src_id);
             }
 
-            auto dst_id = get_vertex_id(edge, edge_mapping.to.key_path);
+            auto dst_id = [&] {
+                telemetry::StepScope step(&edge_mapping.to.key_path);
+                return get_vertex_id(edge, edge_mapping.to.key_path);
+            }();
             if (std::holds_alternative<StatementError>(dst_id)) {
                 return std::get<StatementError>(dst_id);
             }
 
             std::vector<std::string> prop_values;
             for (const auto& prop : edge_mapping.properties) {
+                telemetry::StepScope step(&prop);
+                auto point = render_point(prop, edge, &edge - edges.data(), prop_values);
+                if (std::holds_alternative<StatementError>(point)) {
+                    return std::get<StatementError>(point);
+                }
+                if (std::get<bool>(point)) {
+                    step.add_output(prop_values.back().size());
+                    continue;
+                }
+
+                if (auto* dictionary = dictionary_for(prop)) {
+                    if (const auto* literal = dictionary->render(edge)) {
+                        prop_values.push_back(*literal);
+                        step.add_output(literal->size());
+                        continue;
+                    }
+                }
+
+                auto native = render_native(prop, edge, prop_values);
+                if (std::holds_alternative<StatementError>(native)) {
+                    return std::get<StatementError>(native);
+                }
+                if (std::get<bool>(native)) {
+                    step.add_output(prop_values.back().size());
+                    continue;
+                }
+
                 auto value = extract_value(
                     edge,
                     prop.json_path,
                     prop.nebula_type,
-                    prop.transform
+                    prop.transform,
+                    prop.coerce
                 );
 
                 if (std::holds_alternative<StatementError>(value)) {
                     return std::get<StatementError>(value);
                 }
 
+                telemetry::StageTimer render_timer(telemetry::Stage::RENDER);
                 auto formatted = format_value(std::get<Value>(value));
                 if (std::holds_alternative<StatementError>(formatted)) {
                     return std::get<StatementError>(formatted);
                 }
 
                 prop_values.push_back(std::get<std::string>(formatted));
+                step.add_output(prop_values.back().size());
             }
 
+            telemetry::StageTimer render_timer(telemetry::Stage::RENDER);
             batch_values.push_back(
                 std::get<std::string>(src_id) + " -> " +
                 std::get<std::string>(dst_id) + ":(" +
                 detail::join_values(prop_values) + ")"
             );
+            ++rows_generated_;
+            telemetry::count_row(edge_mapping.edge_name, batch_values.back().size());
+            NEBULA_MAPPER_PROBE2(row_extracted, edge_mapping.edge_name.c_str(),
+                                 batch_values.back().size());
 
             if (batch_values.size() >= batch_size) {
+                NEBULA_MAPPER_TRACE_SPAN("batch_render", edge_mapping.edge_name);
                 std::stringstream ss;
                 ss << "INSERT EDGE " << quote_identifier(edge_mapping.edge_name)
                    << " (" << detail::join_values(prop_names) << ") "
                    << "VALUES " << detail::join_values(batch_values) << ";";
                 statements.push_back(ss.str());
+                telemetry::count_statement(edge_mapping.edge_name, statements.back().size(),
+                                           batch_values.size(), telemetry::BatchClose::FULL);
+                publish_statement(edge_mapping.edge_name, batch_values.size(),
+                                  statements.back().size());
                 batch_values.clear();
             }
         }
 
         // Handle remaining edges
         if (!batch_values.empty()) {
+            NEBULA_MAPPER_TRACE_SPAN("batch_render", edge_mapping.edge_name);
+            telemetry::StageTimer render_timer(telemetry::Stage::RENDER);
             std::stringstream ss;
             ss << "INSERT EDGE " << quote_identifier(edge_mapping.edge_name)
                << " (" << detail::join_values(prop_names) << ") "
                << "VALUES " << detail::join_values(batch_values) << ";";
             statements.push_back(ss.str());
+            telemetry::count_statement(edge_mapping.edge_name, statements.back().size(),
+                                       batch_values.size(), telemetry::BatchClose::FLUSH);
+            publish_statement(edge_mapping.edge_name, batch_values.size(),
+                              statements.back().size());
         }
     }
 
@@ -309,7 +475,8 @@ Result<Value> StatementGenerator::extract_value(
     const parser::json::JsonDocument& data,
     const std::string& json_path,
     const std::string& nebula_type,
-    const std::optional<parser::mapping::Transform>& transform) {
+    const std::optional<parser::mapping::Transform>& transform,
+    common::numbers::CoercionMode coerce) {
 
     try {
         auto json_value = parser::json::get_value<parser::json::JsonDocument>(data, json_path);
@@ -355,6 +522,7 @@ Result<Value> StatementGenerator::extract_value(
                 };
             }
             transform_input.target_type = nebula_type;
+            transform_input.coerce = coerce;
 
             // Apply transformation
             auto transform_result = transformer::TransformEngine::instance()
@@ -374,25 +542,33 @@ Result<Value> StatementGenerator::extract_value(
         }
 
         // If no transformation, convert value based on Nebula type
-        try {
-            if (nebula_type == "INT" || nebula_type == "INT64") {
-                value.value = extracted.get<int64_t>();
-            }
-            else if (nebula_type == "DOUBLE") {
-                value.value = extracted.get<double>();
-            }
-            else if (nebula_type == "BOOL") {
-                value.value = extracted.get<bool>();
-            }
-            else {
-                value.value = extracted.get<std::string>();
-            }
+        auto spec = parse_type(nebula_type).value_or(TypeSpec{});
+        auto converted = to_nebula_value(extracted, spec, json_path, coerce);
+        if (std::holds_alternative<StatementError>(converted)) {
+            return std::get<StatementError>(converted);
         }
-        catch (const std::exception& e) {
-            return StatementError{
-                "Value conversion error: " + std::string(e.what()),
-                json_path
-            };
+
+        const auto& native = std::get<NebulaValue>(converted);
+        switch (native.type()) {
+            case NebulaType::BOOL:
+                value.value = native.as_bool();
+                break;
+            case NebulaType::FLOAT:
+            case NebulaType::DOUBLE:
+                value.value = native.as_double();
+                break;
+            case NebulaType::INT8:
+            case NebulaType::INT16:
+            case NebulaType::INT32:
+            case NebulaType::INT64:
+            case NebulaType::TIMESTAMP:
+                value.value = native.as_int();
+                break;
+            default: {
+                std::string text;
+                append_text(text, native);
+                value.value = std::move(text);
+            }
         }
 
         return value;
@@ -405,6 +581,265 @@ Result<Value> StatementGenerator::extract_value(
     }
 }
 
+ColumnDictionary* StatementGenerator::dictionary_for(const parser::mapping::Property& prop) {
+    if (!options_.fast_paths) return nullptr;
+    const auto& spec = plan_for(prop).spec;
+    if (prop.transform || prop.json_format || spec.type != NebulaType::STRING) {
+        return nullptr;
+    }
+
+    auto found = dictionaries_.find(&prop);
+    if (found == dictionaries_.end()) {
+        found = dictionaries_.emplace(&prop, ColumnDictionary(prop.json_path)).first;
+    } else if (found->second.json_path() != prop.json_path) {
+        // A different mapping now lives at this address
+        found->second = ColumnDictionary(prop.json_path);
+    }
+    return &found->second;
+}
+
+const StatementGenerator::ValuePlan& StatementGenerator::plan_for(
+    const parser::mapping::Property& prop) {
+
+    auto found = plans_.find(&prop);
+    if (found != plans_.end() && found->second.json_path == prop.json_path &&
+        found->second.nebula_type == prop.nebula_type && found->second.coerce == prop.coerce) {
+        return found->second;
+    }
+
+    // New, or a different mapping now lives at this address. Types this
+    // build does not know are read as strings.
+    ValuePlan plan{prop.json_path, prop.nebula_type,
+                   parser::json::detail::split_path(prop.json_path),
+                   parse_type(prop.nebula_type).value_or(TypeSpec{}), prop.coerce};
+    return plans_.insert_or_assign(&prop, std::move(plan)).first->second;
+}
+
+Result<bool> StatementGenerator::render_native(
+    const parser::mapping::Property& prop,
+    const parser::json::JsonDocument& item,
+    std::vector<std::string>& prop_values) {
+
+    if (prop.transform) return false;
+    const auto& plan = plan_for(prop);
+    const auto* node = parser::json::detail::find_path(item, plan.segments);
+    if (!node) return false;
+
+    if (prop.json_format) {
+        prop_values.emplace_back(node->is_null() ? "NULL" : "");
+        if (!node->is_null()) append_json_literal(prop_values.back(), *node, *prop.json_format);
+        return true;
+    }
+    if (!options_.fast_paths) return false;
+
+    auto value = to_nebula_value(*node, plan.spec, prop.json_path, plan.coerce);
+    if (std::holds_alternative<StatementError>(value)) {
+        return std::get<StatementError>(value);
+    }
+    prop_values.emplace_back();
+    append_literal(prop_values.back(), std::get<NebulaValue>(value));
+    return true;
+}
+
+const StatementGenerator::AggregatePlan& StatementGenerator::aggregate_plan_for(
+    const parser::mapping::Aggregate& aggregate) {
+
+    auto found = aggregate_plans_.find(&aggregate);
+    if (found != aggregate_plans_.end() && found->second.over_path == aggregate.over &&
+        found->second.json_path == aggregate.json_path) {
+        return found->second;
+    }
+
+    // New, or a different mapping now lives at this address
+    AggregatePlan plan{aggregate.over, aggregate.json_path,
+                       parser::json::detail::split_path(aggregate.over),
+                       parser::json::detail::split_path(aggregate.json_path)};
+    return aggregate_plans_.insert_or_assign(&aggregate, std::move(plan)).first->second;
+}
+
+Result<bool> StatementGenerator::accumulate(
+    const parser::mapping::VertexMapping& vertex_mapping,
+    const parser::json::JsonDocument& data,
+    AggregateGroups& groups) {
+
+    const auto& aggregates = vertex_mapping.aggregates;
+    auto fresh = [&] {
+        std::vector<Accumulator> accumulators;
+        accumulators.reserve(aggregates.size());
+        for (const auto& aggregate : aggregates) {
+            accumulators.emplace_back(aggregate.op);
+        }
+        return accumulators;
+    };
+    groups.shared = fresh();
+    groups.none = fresh();
+
+    for (size_t i = 0; i < aggregates.size(); ++i) {
+        const auto& aggregate = aggregates[i];
+        const auto& plan = aggregate_plan_for(aggregate);
+
+        // A missing or null source has no items, an object is one item
+        const auto* source = parser::json::detail::find_path(data, plan.over);
+        if (!source || source->is_null()) continue;
+        const size_t count = source->is_array() ? source->size() : 1;
+
+        for (size_t k = 0; k < count; ++k) {
+            const auto& item = source->is_array() ? (*source)[k] : *source;
+            auto* accumulators = &groups.shared;
+            if (!aggregate.key_path.empty()) {
+                auto vid = get_vertex_id(item, aggregate.key_path);
+                if (std::holds_alternative<StatementError>(vid)) {
+                    return std::get<StatementError>(vid);
+                }
+                auto [group, created] = groups.keyed.try_emplace(
+                    std::move(std::get<std::string>(vid)));
+                if (created) group->second = fresh();
+                accumulators = &group->second;
+            }
+
+            auto folded = (*accumulators)[i].add(
+                parser::json::detail::find_path(item, plan.value), aggregate.json_path);
+            if (std::holds_alternative<StatementError>(folded)) {
+                return std::get<StatementError>(folded);
+            }
+        }
+    }
+    return true;
+}
+
+Result<bool> StatementGenerator::render_aggregates(
+    const parser::mapping::VertexMapping& vertex_mapping,
+    AggregateGroups& groups,
+    const std::string& vid,
+    std::vector<std::string>& prop_values) {
+
+    const auto& aggregates = vertex_mapping.aggregates;
+    auto keyed = groups.keyed.find(vid);
+    std::vector<const Accumulator*> accumulators(aggregates.size());
+    bool updates = false;
+
+    for (size_t i = 0; i < aggregates.size(); ++i) {
+        if (aggregates[i].key_path.empty()) {
+            accumulators[i] = &groups.shared[i];
+        } else {
+            accumulators[i] = keyed != groups.keyed.end() ? &keyed->second[i] : &groups.none[i];
+        }
+        if (aggregates[i].update) {
+            updates = true;
+            continue;
+        }
+
+        auto literal = accumulators[i]->literal(aggregates[i]);
+        if (std::holds_alternative<StatementError>(literal)) {
+            return std::get<StatementError>(literal);
+        }
+        prop_values.push_back(std::move(std::get<std::string>(literal)));
+    }
+
+    if (updates && groups.merged.insert(vid).second) {
+        aggregates_.merge(vertex_mapping, vid, accumulators);
+    }
+    return true;
+}
+
+void StatementGenerator::convert_points(
+    const std::vector<parser::mapping::Property>& properties,
+    const std::vector<parser::json::JsonDocument>& items) {
+
+    if (!options_.fast_paths) return;
+    const TypeSpec coordinate{NebulaType::DOUBLE};
+    for (const auto& prop : properties) {
+        if (!prop.geo) continue;
+
+        auto& column = points_[&prop];
+        column.lon.assign(items.size(), 0);
+        column.lat.assign(items.size(), 0);
+        column.state.assign(items.size(), POINT);
+        auto x_segments = parser::json::detail::split_path(prop.geo->x_path);
+        auto y_segments = parser::json::detail::split_path(prop.geo->y_path);
+
+        for (size_t i = 0; i < items.size(); ++i) {
+            const auto* x = parser::json::detail::find_path(items[i], x_segments);
+            const auto* y = parser::json::detail::find_path(items[i], y_segments);
+            if (!x || !y) {
+                column.state[i] = BAD_POINT;
+                continue;
+            }
+            if (x->is_null() || y->is_null()) {
+                column.state[i] = NULL_POINT;
+                continue;
+            }
+
+            auto lon = to_nebula_value(*x, coordinate, prop.geo->x_path, prop.coerce);
+            auto lat = to_nebula_value(*y, coordinate, prop.geo->y_path, prop.coerce);
+            if (!std::holds_alternative<NebulaValue>(lon) ||
+                !std::holds_alternative<NebulaValue>(lat)) {
+                column.state[i] = BAD_POINT;
+                continue;
+            }
+            column.lon[i] = std::get<NebulaValue>(lon).as_double();
+            column.lat[i] = std::get<NebulaValue>(lat).as_double();
+        }
+
+        to_wgs84(prop.geo->from, column.lon.data(), column.lat.data(), items.size());
+    }
+}
+
+Result<bool> StatementGenerator::render_point(
+    const parser::mapping::Property& prop,
+    const parser::json::JsonDocument& item,
+    size_t row,
+    std::vector<std::string>& prop_values) {
+
+    if (!prop.geo) return false;
+    if (!options_.fast_paths) {
+        // One point at a time, from the coordinates extract_value() reads
+        double coordinates[2] = {0, 0};
+        bool null = false;
+        for (int i = 0; i < 2; ++i) {
+            const auto& path = i == 0 ? prop.geo->x_path : prop.geo->y_path;
+            auto value = extract_value(item, path, "DOUBLE", std::nullopt, prop.coerce);
+            if (std::holds_alternative<StatementError>(value)) {
+                return std::get<StatementError>(value);
+            }
+            const auto& coordinate = std::get<Value>(value);
+            if (coordinate.is_null) {
+                null = true;
+            } else {
+                coordinates[i] = std::get<double>(coordinate.value);
+            }
+        }
+        if (null) {
+            prop_values.emplace_back("NULL");
+            return true;
+        }
+        to_wgs84(prop.geo->from, &coordinates[0], &coordinates[1], 1);
+        prop_values.emplace_back();
+        append_point(prop_values.back(), coordinates[0], coordinates[1]);
+        return true;
+    }
+
+    const auto& column = points_.at(&prop);
+    if (column.state[row] == POINT) {
+        prop_values.emplace_back();
+        append_point(prop_values.back(), column.lon[row], column.lat[row]);
+        return true;
+    }
+    if (column.state[row] == NULL_POINT) {
+        prop_values.emplace_back("NULL");
+        return true;
+    }
+
+    // Report the bad coordinate as any DOUBLE property would
+    for (const auto* path : {&prop.geo->x_path, &prop.geo->y_path}) {
+        auto value = extract_value(item, *path, "DOUBLE", std::nullopt, prop.coerce);
+        if (std::holds_alternative<StatementError>(value)) {
+            return std::get<StatementError>(value);
+        }
+    }
+    return StatementError{"Invalid point coordinates", prop.name};
+}
+
 Result<std::string> StatementGenerator::get_vertex_id(
     const parser::json::JsonDocument& data,
     const std::string& key_path) {
@@ -449,7 +884,7 @@ Result<std::string> StatementGenerator::get_vertex_id(
         };
     }
 
-    return "\"" + id_str + "\"";
+    return "\"" + escape_string(id_str) + "\"";
 }
 
 Result<std::string> StatementGenerator::format_value(const Value& value) {
@@ -458,15 +893,30 @@ Result<std::string> StatementGenerator::format_value(const Value& value) {
     }
 
     try {
+        // Temporal text goes into date(), time() or datetime()
+        const auto* text = std::get_if<std::string>(&value.value);
+        auto spec = parse_type(value.nebula_type);
+        if (text && spec && (spec->type == NebulaType::DATE || spec->type == NebulaType::TIME ||
+                             spec->type == NebulaType::DATETIME)) {
+            std::string function = spec->type == NebulaType::DATE ? "date"
+                                 : spec->type == NebulaType::TIME ? "time" : "datetime";
+            return function + "(\"" + escape_string(*text) + "\")";
+        }
+
         std::stringstream ss;
         std::visit([&](const auto& v) {
             using T = std::decay_t<decltype(v)>;
             if constexpr (std::is_same_v<T, std::string>) {
-                ss << "\"" << v << "\"";
+                ss << "\"" << escape_string(v) << "\"";
             }
             else if constexpr (std::is_same_v<T, bool>) {
                 ss << (v ? "true" : "false");
             }
+            else if constexpr (std::is_same_v<T, double>) {
+                std::string digits;
+                append_real(digits, v, spec && spec->type == NebulaType::FLOAT);
+                ss << digits;
+            }
             else {
                 ss << v;
             }
@@ -481,6 +931,42 @@ Result<std::string> StatementGenerator::format_value(const Value& value) {
     }
 }
 
+std::string StatementGenerator::escape_string(const std::string& str) {
+    auto special = [](char c) {
+        auto byte = static_cast<unsigned char>(c);
+        return c == '"' || c == '\\' || byte < 0x20 || byte == 0x7F;
+    };
+    if (std::none_of(str.begin(), str.end(), special)) {
+        return str;
+    }
+
+    std::string escaped;
+    escaped.reserve(str.size() + 8);
+    for (char c : str) {
+        switch (c) {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\b': escaped += "\\b"; break;
+            case '\f': escaped += "\\f"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\r': escaped += "\\r"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if (special(c)) {
+                    // Other control bytes as three-digit octal escapes
+                    auto byte = static_cast<unsigned char>(c);
+                    escaped += '\\';
+                    escaped += static_cast<char>('0' + (byte >> 6));
+                    escaped += static_cast<char>('0' + ((byte >> 3) & 7));
+                    escaped += static_cast<char>('0' + (byte & 7));
+                } else {
+                    escaped += c;
+                }
+        }
+    }
+    return escaped;
+}
+
 std::string StatementGenerator::quote_identifier(const std::string& identifier) {
     // Check if identifier needs quoting
     bool needs_quotes = false;
@@ -499,6 +985,15 @@ std::string StatementGenerator::quote_identifier(const std::string& identifier)
 }
 
 namespace detail {
+    void publish_statement(const std::string& mapping, size_t rows, size_t bytes) {
+        NEBULA_MAPPER_PROBE3(batch_flushed, mapping.c_str(), rows, bytes);
+        if (!telemetry::metrics_enabled()) return;
+        auto& metrics = telemetry::pipeline_metrics();
+        metrics.rows.add(rows);
+        metrics.statements.add();
+        metrics.statement_bytes.add(bytes);
+    }
+
     std::string join_values(
         const std::vector<std::string>& values,
         const std::string& delimiter) {
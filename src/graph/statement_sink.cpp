@@ -0,0 +1,143 @@
+#include "graph/statement_sink.hpp"
+#include "telemetry/probes.hpp"
+#include "telemetry/stats.hpp"
+#include "telemetry/trace.hpp"
+#include <atomic>
+#include <iterator>
+#include <unistd.h>
+
+namespace graph {
+
+void OstreamSink::consume(std::vector<std::string>&& statements) {
+    NEBULA_MAPPER_TRACE_SPAN("write");
+    telemetry::StageTimer timer(telemetry::Stage::OUTPUT);
+    bool probed = NEBULA_MAPPER_PROBE_ENABLED(statement_written);
+    for (const auto& stmt : statements) {
+        int64_t start_ns = probed ? telemetry::probe_clock_ns() : 0;
+        out_ << stmt << '\n';
+        bytes_ += stmt.size() + 1;
+        if (probed) {
+            // No endpoint: host "" and port 0; outcome 1 if the stream failed
+            const char* host = "";
+            NEBULA_MAPPER_PROBE5(statement_written, host, 0, stmt.size() + 1,
+                                 telemetry::probe_clock_ns() - start_ns, out_ ? 0 : 1);
+        }
+    }
+}
+
+void VectorSink::consume(std::vector<std::string>&& statements) {
+    if (statements_.empty()) {
+        statements_ = std::move(statements);
+        return;
+    }
+    statements_.insert(statements_.end(),
+                       std::make_move_iterator(statements.begin()),
+                       std::make_move_iterator(statements.end()));
+}
+
+namespace {
+    // Distinguishes spill files of sinks in the same process
+    std::atomic<uint64_t> spill_sequence{0};
+}
+
+SpillingSink::SpillingSink(MemoryBudget* budget, std::filesystem::path spill_dir)
+    : budget_(budget), spill_dir_(std::move(spill_dir)) {}
+
+SpillingSink::~SpillingSink() {
+    if (budget_) budget_->release(MemoryConsumer::COLLECTED, held_bytes_);
+    if (!spill_path_.empty()) {
+        spill_file_.close();
+        std::error_code ignored;
+        std::filesystem::remove(spill_path_, ignored);
+    }
+}
+
+void SpillingSink::consume(std::vector<std::string>&& statements) {
+    uint64_t bytes = 0;
+    for (const auto& stmt : statements) {
+        bytes += stmt.size();
+    }
+    held_bytes_ += bytes;
+    if (budget_) budget_->charge(MemoryConsumer::COLLECTED, bytes);
+
+    if (statements_.empty()) {
+        statements_ = std::move(statements);
+    } else {
+        statements_.insert(statements_.end(),
+                           std::make_move_iterator(statements.begin()),
+                           std::make_move_iterator(statements.end()));
+    }
+
+    if (budget_ && budget_->under_pressure() && !spill_failed_) {
+        spill();
+    }
+}
+
+// Statements are written as "<length>\n<bytes>", so they may contain
+// anything, newlines included
+void SpillingSink::spill() {
+    NEBULA_MAPPER_TRACE_SPAN("spill");
+    telemetry::StageTimer timer(telemetry::Stage::OUTPUT);
+    if (spill_path_.empty()) {
+        spill_path_ = spill_dir_ / ("nebula_mapper_spill_" + std::to_string(::getpid()) + "_" +
+                                    std::to_string(spill_sequence.fetch_add(1)) + ".bin");
+        spill_file_.open(spill_path_, std::ios::binary | std::ios::trunc);
+    }
+    for (const auto& stmt : statements_) {
+        spill_file_ << stmt.size() << '\n';
+        spill_file_.write(stmt.data(), static_cast<std::streamsize>(stmt.size()));
+    }
+    spill_file_.flush();
+    if (!spill_file_) {
+        // Keep going in memory; the statements are all still here
+        spill_failed_ = true;
+        return;
+    }
+
+    spilled_ += statements_.size();
+    budget_->count_spill(held_bytes_);
+    budget_->release(MemoryConsumer::COLLECTED, held_bytes_);
+    held_bytes_ = 0;
+    statements_.clear();
+    statements_.shrink_to_fit();
+}
+
+bool SpillingSink::drain(uint64_t chunk_bytes,
+                         const std::function<void(std::vector<std::string>&&)>& handle) {
+    std::vector<std::string> chunk;
+    uint64_t bytes = 0;
+    auto add = [&](std::string&& stmt) {
+        bytes += stmt.size();
+        chunk.push_back(std::move(stmt));
+        if (bytes >= chunk_bytes) {
+            handle(std::move(chunk));
+            chunk.clear();
+            bytes = 0;
+        }
+    };
+
+    if (spilled_ > 0) {
+        spill_file_.close();
+        std::ifstream in(spill_path_, std::ios::binary);
+        for (uint64_t i = 0; i < spilled_; ++i) {
+            size_t size = 0;
+            if (!(in >> size) || in.get() != '\n') return false;
+            std::string stmt(size, '\0');
+            if (!in.read(stmt.data(), static_cast<std::streamsize>(size))) return false;
+            add(std::move(stmt));
+        }
+    }
+    for (auto& stmt : statements_) {
+        add(std::move(stmt));
+    }
+    if (!chunk.empty()) {
+        handle(std::move(chunk));
+    }
+
+    statements_.clear();
+    if (budget_) budget_->release(MemoryConsumer::COLLECTED, held_bytes_);
+    held_bytes_ = 0;
+    return true;
+}
+
+} // namespace graph
@@ -1,21 +1,89 @@
+#include <algorithm>
 #include <iostream>
 #include <filesystem>
 #include <fstream>
+#include <limits>
+#include <memory>
 #include <sstream>
 #include "parser/json_parser.hpp"
+#include "parser/record_reader.hpp"
 #include "parser/yaml_parser.hpp"
 #include "parser/mapping_parser.hpp"
+#include "graph/codegen.hpp"
+#include "graph/compiled_mapping.hpp"
+#include "graph/explain.hpp"
+#include "graph/mapping_preflight.hpp"
+#include "graph/pipeline.hpp"
 #include "graph/schema_manager.hpp"
 #include "graph/statement_generator.hpp"
+#include "executor/statement_executor.hpp"
+#include "telemetry/metrics.hpp"
+#include "telemetry/profile.hpp"
+#include "telemetry/progress.hpp"
+#include "telemetry/stats.hpp"
+#include "telemetry/trace.hpp"
 
 namespace fs = std::filesystem;
 
 void print_usage(const char* program_name) {
     std::cerr << "Usage: " << program_name
-              << " <mapping.yaml> <input.json> [--schema-only] [--batch-size N]\n"
+              << " <mapping.yaml> <input> [--schema-only] [--batch-size N]"
+              << " [--gateway host:port[,host:port...]]\n"
+              << "       " << program_name << " <mapping.yaml> --explain\n"
+              << "       " << program_name << " --codegen <mapping.yaml> [--codegen-out FILE]\n"
+              << "Input is a JSON document, an NDJSON file, a top-level JSON array or a\n"
+              << "directory of JSON documents.\n"
               << "Options:\n"
-              << "  --schema-only  Only generate schema statements\n"
-              << "  --batch-size N Batch size for INSERT statements (default: 500)\n";
+              << "  --schema-only     Only generate schema statements\n"
+              << "  --batch-size N    Batch size for INSERT statements (default: 500)\n"
+              << "  --input-format F  auto, document, ndjson, array or directory\n"
+              << "                    (default: auto)\n"
+              << "  --threads N       Parse and generate records on N threads (default: 1)\n"
+              << "  --gateway LIST    Send statements to these statement gateways (one\n"
+              << "                    statement per line, OK or ERR back) instead of\n"
+              << "                    printing them\n"
+              << "  --space NAME      Run every gateway request in this graph space\n"
+              << "  --retry-timeouts  Retry statements that timed out after being sent on\n"
+              << "                    another endpoint; they may run twice\n"
+              << "  --concurrency N   Requests in flight across endpoints (default: 4)\n"
+              << "  --timeout-ms N    Per-request timeout before an endpoint is ejected\n"
+              << "                    (default: 5000)\n"
+              << "  --validate        Check the mapping on a sample of the input and print\n"
+              << "                    per-path resolution rates and type conflicts\n"
+              << "  --preflight       Run the --validate checks first; stop on an error\n"
+              << "  --sample N        Records checked: the first N and N sampled from the\n"
+              << "                    rest (default: 100)\n"
+              << "  --explain         Print the mapping plan instead of statements\n"
+              << "  --explain-analyze Print the plan, then map the input on one thread without\n"
+              << "                    output and report the cost of every plan step\n"
+              << "  --codegen         Print C++ source of an extractor specialized to the\n"
+              << "                    mapping, to build as a shared object for --extractor\n"
+              << "  --codegen-out FILE\n"
+              << "                    Write the --codegen source to FILE\n"
+              << "  --extractor LIB   Map records with an extractor built from --codegen;\n"
+              << "                    it must come from this exact mapping YAML\n"
+              << "  --memory-limit SIZE\n"
+              << "                    Budget for records and statements held in memory,\n"
+              << "                    e.g. 512M; spill and throttle the reader under it\n"
+              << "  --spill-dir DIR   Where to spill statements (default: system temp)\n"
+              << "  --stats           Print stage timings and counters to stderr\n"
+              << "  --stats-json FILE Write stage timings and counters as JSON\n"
+              << "  --progress        Print a status line with throughput and ETA to stderr\n"
+              << "  --progress-json   Same, as one JSON object per line\n"
+              << "  --progress-interval-ms N\n"
+              << "                    Status interval (default: 5000)\n"
+              << "  --slow-record-ms MS\n"
+              << "                    Log records that take at least MS milliseconds, with\n"
+              << "                    stage times and rows, and list the slowest at the end\n"
+              << "  --slow-top K      Slowest records to list (default: 10)\n"
+              << "  --trace FILE      Write a Chrome trace-event timeline of pipeline stages\n"
+              << "  --metrics-port N  Serve OpenMetrics on http://127.0.0.1:N/metrics\n"
+              << "                    (0 picks a free port)\n"
+              << "  --metrics-textfile FILE\n"
+              << "                    Periodically rewrite FILE for the node-exporter\n"
+              << "                    textfile collector\n"
+              << "  --metrics-interval-ms N\n"
+              << "                    Textfile rewrite interval (default: 10000)\n";
 }
 
 std::optional<std::string> read_file(const fs::path& path) {
@@ -39,7 +107,31 @@ struct ProgramOptions {
     fs::path mapping_file;
     fs::path input_file;
     bool schema_only{false};
+    bool explain{false};
+    bool explain_analyze{false};
+    bool validate{false};
+    bool preflight{false};
+    size_t sample{100};
+    bool codegen{false};
+    fs::path codegen_out;
+    fs::path extractor;
     size_t batch_size{500};
+    parser::json::InputFormat input_format{parser::json::InputFormat::AUTO};
+    size_t threads{1};
+    std::optional<uint64_t> memory_limit;
+    fs::path spill_dir;
+    std::vector<executor::Endpoint> gateways;
+    executor::ExecutorOptions executor_options;
+    bool stats{false};
+    fs::path stats_json_file;
+    std::optional<telemetry::ProgressFormat> progress;
+    std::chrono::milliseconds progress_interval{5000};
+    std::optional<double> slow_record_ms;
+    size_t slow_top{10};
+    fs::path trace_file;
+    std::optional<uint16_t> metrics_port;
+    fs::path metrics_textfile;
+    std::chrono::milliseconds metrics_interval{10000};
 };
 
 std::optional<ProgramOptions> parse_arguments(int argc, char* argv[]) {
@@ -50,12 +142,43 @@ std::optional<ProgramOptions> parse_arguments(int argc, char* argv[]) {
 
     ProgramOptions options;
     options.mapping_file = argv[1];
-    options.input_file = argv[2];
 
-    for (int i = 3; i < argc; ++i) {
+    // The input may be left out when only the plan or the extractor is wanted
+    int first_option = 2;
+    if (std::string(argv[1]) == "--codegen") {
+        options.codegen = true;
+        options.mapping_file = argv[2];
+        first_option = 3;
+    } else if (std::string(argv[2]).rfind("--", 0) != 0) {
+        options.input_file = argv[2];
+        first_option = 3;
+    }
+
+    for (int i = first_option; i < argc; ++i) {
         std::string arg = argv[i];
         if (arg == "--schema-only") {
             options.schema_only = true;
+        } else if (arg == "--explain") {
+            options.explain = true;
+        } else if (arg == "--explain-analyze") {
+            options.explain_analyze = true;
+        } else if (arg == "--validate") {
+            options.validate = true;
+        } else if (arg == "--preflight") {
+            options.preflight = true;
+        } else if (arg == "--sample" && i + 1 < argc) {
+            try {
+                options.sample = std::stoul(argv[++i]);
+            } catch (const std::exception&) {
+                std::cerr << "Error: Invalid sample size\n";
+                return std::nullopt;
+            }
+        } else if (arg == "--codegen") {
+            options.codegen = true;
+        } else if (arg == "--codegen-out" && i + 1 < argc) {
+            options.codegen_out = argv[++i];
+        } else if (arg == "--extractor" && i + 1 < argc) {
+            options.extractor = argv[++i];
         } else if (arg == "--batch-size" && i + 1 < argc) {
             try {
                 options.batch_size = std::stoul(argv[++i]);
@@ -63,6 +186,110 @@ std::optional<ProgramOptions> parse_arguments(int argc, char* argv[]) {
                 std::cerr << "Error: Invalid batch size\n";
                 return std::nullopt;
             }
+        } else if (arg == "--input-format" && i + 1 < argc) {
+            auto format = parser::json::parse_input_format(argv[++i]);
+            if (std::holds_alternative<parser::json::Error>(format)) {
+                std::cerr << "Error: " << std::get<parser::json::Error>(format).message << '\n';
+                return std::nullopt;
+            }
+            options.input_format = std::get<parser::json::InputFormat>(format);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            try {
+                options.threads = std::stoul(argv[++i]);
+                if (options.threads == 0) throw std::out_of_range("threads");
+            } catch (const std::exception&) {
+                std::cerr << "Error: Invalid thread count\n";
+                return std::nullopt;
+            }
+        } else if (arg == "--memory-limit" && i + 1 < argc) {
+            options.memory_limit = graph::parse_memory_size(argv[++i]);
+            if (!options.memory_limit || *options.memory_limit == 0) {
+                std::cerr << "Error: Invalid memory limit\n";
+                return std::nullopt;
+            }
+        } else if (arg == "--spill-dir" && i + 1 < argc) {
+            options.spill_dir = argv[++i];
+        } else if (arg == "--stats") {
+            options.stats = true;
+        } else if (arg == "--stats-json" && i + 1 < argc) {
+            options.stats_json_file = argv[++i];
+        } else if (arg == "--progress") {
+            options.progress = telemetry::ProgressFormat::TEXT;
+        } else if (arg == "--progress-json") {
+            options.progress = telemetry::ProgressFormat::JSON;
+        } else if (arg == "--progress-interval-ms" && i + 1 < argc) {
+            try {
+                options.progress_interval = std::chrono::milliseconds(std::stoul(argv[++i]));
+                if (options.progress_interval.count() == 0) throw std::out_of_range("interval");
+            } catch (const std::exception&) {
+                std::cerr << "Error: Invalid progress interval\n";
+                return std::nullopt;
+            }
+        } else if (arg == "--slow-record-ms" && i + 1 < argc) {
+            try {
+                options.slow_record_ms = std::stod(argv[++i]);
+                if (*options.slow_record_ms < 0) throw std::out_of_range("slow-record-ms");
+            } catch (const std::exception&) {
+                std::cerr << "Error: Invalid slow record threshold\n";
+                return std::nullopt;
+            }
+        } else if (arg == "--slow-top" && i + 1 < argc) {
+            try {
+                options.slow_top = std::stoul(argv[++i]);
+            } catch (const std::exception&) {
+                std::cerr << "Error: Invalid slow record count\n";
+                return std::nullopt;
+            }
+        } else if (arg == "--trace" && i + 1 < argc) {
+            options.trace_file = argv[++i];
+        } else if (arg == "--metrics-port" && i + 1 < argc) {
+            try {
+                auto port = std::stoul(argv[++i]);
+                if (port > 65535) throw std::out_of_range("port");
+                options.metrics_port = static_cast<uint16_t>(port);
+            } catch (const std::exception&) {
+                std::cerr << "Error: Invalid metrics port\n";
+                return std::nullopt;
+            }
+        } else if (arg == "--metrics-textfile" && i + 1 < argc) {
+            options.metrics_textfile = argv[++i];
+        } else if (arg == "--metrics-interval-ms" && i + 1 < argc) {
+            try {
+                options.metrics_interval = std::chrono::milliseconds(std::stoul(argv[++i]));
+                if (options.metrics_interval.count() == 0) throw std::out_of_range("interval");
+            } catch (const std::exception&) {
+                std::cerr << "Error: Invalid metrics interval\n";
+                return std::nullopt;
+            }
+        } else if (arg == "--gateway" && i + 1 < argc) {
+            auto endpoints = executor::parse_endpoints(argv[++i]);
+            if (std::holds_alternative<executor::Error>(endpoints)) {
+                const auto& error = std::get<executor::Error>(endpoints);
+                std::cerr << "Error: " << error.message;
+                if (error.context) std::cerr << " (" << *error.context << ")";
+                std::cerr << '\n';
+                return std::nullopt;
+            }
+            options.gateways = std::get<std::vector<executor::Endpoint>>(endpoints);
+        } else if (arg == "--space" && i + 1 < argc) {
+            options.executor_options.space = argv[++i];
+        } else if (arg == "--retry-timeouts") {
+            options.executor_options.retry_timeouts = true;
+        } else if (arg == "--concurrency" && i + 1 < argc) {
+            try {
+                options.executor_options.concurrency = std::stoul(argv[++i]);
+            } catch (const std::exception&) {
+                std::cerr << "Error: Invalid concurrency\n";
+                return std::nullopt;
+            }
+        } else if (arg == "--timeout-ms" && i + 1 < argc) {
+            try {
+                options.executor_options.request_timeout =
+                    std::chrono::milliseconds(std::stoul(argv[++i]));
+            } catch (const std::exception&) {
+                std::cerr << "Error: Invalid timeout\n";
+                return std::nullopt;
+            }
         } else {
             std::cerr << "Error: Unknown option: " << arg << '\n';
             print_usage(argv[0]);
@@ -70,9 +297,49 @@ std::optional<ProgramOptions> parse_arguments(int argc, char* argv[]) {
         }
     }
 
+    if (options.input_file.empty() && !options.explain && !options.codegen) {
+        print_usage(argv[0]);
+        return std::nullopt;
+    }
+
     return options;
 }
 
+void print_endpoint_report(const std::vector<executor::EndpointSnapshot>& endpoints) {
+    static const char* HEALTH_NAMES[] = {"healthy", "ejected", "probing"};
+
+    std::cerr << "Endpoint report:\n";
+    for (const auto& ep : endpoints) {
+        std::cerr << "  " << ep.endpoint.to_string()
+                  << " [" << HEALTH_NAMES[static_cast<int>(ep.health)] << "]"
+                  << " requests=" << ep.requests
+                  << " statements=" << ep.statements
+                  << " failures=" << ep.failures
+                  << " timeouts=" << ep.timeouts
+                  << " ejections=" << ep.ejections
+                  << " avg_latency_ms=" << ep.avg_latency_ms
+                  << " max_latency_ms=" << ep.max_latency_ms
+                  << " statements_per_sec=" << ep.statements_per_sec << '\n';
+    }
+}
+
+// Send statements to the gateways; returns false if any statement failed
+bool execute_statements(executor::StatementExecutor& executor,
+                        const std::vector<std::string>& statements,
+                        bool ordered) {
+    auto summary = executor.execute(statements, ordered);
+    for (const auto& error : summary.errors) {
+        std::cerr << "Execution Error: " << error << '\n';
+    }
+    return summary.failed == 0;
+}
+
+// Drops statements; --explain-analyze only wants their cost
+class DiscardSink : public graph::StatementSink {
+public:
+    void consume(std::vector<std::string>&&) override {}
+};
+
 template<typename T>
 void print_error(const T& error) {
     if constexpr (std::is_same_v<T, parser::json::Error>) {
@@ -104,84 +371,390 @@ void print_error(const T& error) {
         std::cerr << '\n';
     }
     else {
-        std::cerr << "Error: " << error.message << '\n';
+        std::cerr << "Error: " << error.message;
+        if (error.context) {
+            std::cerr << " (" << *error.context << ")";
+        }
+        std::cerr << '\n';
     }
 }
 
-int main(int argc, char* argv[]) {
-    try {
-        // Parse command line arguments
-        auto options = parse_arguments(argc, argv);
-        if (!options) {
-            return 1;
+// Map the whole input serially with step profiling on and print the cost
+// of every plan step
+int explain_analyze(const ProgramOptions& options,
+                    const parser::mapping::GraphMapping& mapping,
+                    parser::json::RecordReader& reader) {
+    if (options.threads > 1) {
+        std::cerr << "Warning: --explain-analyze maps on one thread, --threads ignored\n";
+    }
+    graph::PipelineOptions pipeline_options;
+    pipeline_options.batch_size = options.batch_size;
+
+    // Transform time is read from the stats accumulators
+    telemetry::enable_stats();
+    telemetry::enable_profile();
+    DiscardSink sink;
+    auto started = std::chrono::steady_clock::now();
+    auto result = graph::run_pipeline(mapping, reader, sink, pipeline_options);
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started);
+    telemetry::enable_profile(false);
+
+    if (std::holds_alternative<graph::StatementError>(result)) {
+        print_error(std::get<graph::StatementError>(result));
+        return 1;
+    }
+    const auto& summary = std::get<graph::PipelineSummary>(result);
+    std::cout << '\n' << graph::format_analysis(mapping, telemetry::collect_profile(),
+                                                summary.records, elapsed.count());
+    return 0;
+}
+
+// Check the mapping on a sample of the input. --validate prints the report;
+// --preflight only prints it when there are errors, which stop the run.
+int preflight(const ProgramOptions& options, const parser::mapping::GraphMapping& mapping) {
+    auto reader = parser::json::open_records(options.input_file.string(), options.input_format);
+    if (std::holds_alternative<parser::json::Error>(reader)) {
+        print_error(std::get<parser::json::Error>(reader));
+        return 1;
+    }
+
+    graph::SampleOptions sample;
+    sample.head = options.sample;
+    sample.reservoir = options.sample;
+    auto result = graph::validate_mapping(
+        mapping, *std::get<std::unique_ptr<parser::json::RecordReader>>(reader), sample);
+    if (std::holds_alternative<graph::StatementError>(result)) {
+        print_error(std::get<graph::StatementError>(result));
+        return 1;
+    }
+
+    const auto& report = std::get<graph::ValidationReport>(result);
+    if (options.validate) {
+        std::cout << graph::format_validation(report);
+    } else if (!report.ok()) {
+        std::cerr << graph::format_validation(report);
+    } else {
+        for (const auto& warning : report.warnings) {
+            std::cerr << "Warning: " << warning << '\n';
         }
+    }
+    return report.ok() ? 0 : 1;
+}
 
-        // Read input files
-        auto yaml_content = read_file(options->mapping_file);
-        auto json_content = read_file(options->input_file);
-        if (!yaml_content || !json_content) {
+// Write the extractor source for the mapping to stdout or --codegen-out
+int codegen(const ProgramOptions& options,
+            const parser::mapping::GraphMapping& mapping,
+            const std::string& yaml) {
+    auto source = graph::generate_extractor_source(
+        mapping, graph::mapping_hash(yaml), options.mapping_file.filename().string());
+    if (std::holds_alternative<graph::StatementError>(source)) {
+        print_error(std::get<graph::StatementError>(source));
+        return 1;
+    }
+
+    if (options.codegen_out.empty()) {
+        std::cout << std::get<std::string>(source);
+        return 0;
+    }
+    std::ofstream out(options.codegen_out, std::ios::binary);
+    if (!(out << std::get<std::string>(source))) {
+        std::cerr << "Error: Cannot write extractor source: " << options.codegen_out << '\n';
+        return 1;
+    }
+    return 0;
+}
+
+int run(const ProgramOptions& options) {
+    // Read and parse the mapping
+    parser::mapping::Result<parser::mapping::GraphMapping> mapping_result =
+        parser::mapping::GraphMapping{};
+    std::optional<std::string> yaml_content;
+    {
+        NEBULA_MAPPER_TRACE_SPAN("yaml_load");
+        telemetry::StageTimer timer(telemetry::Stage::YAML_LOAD);
+        yaml_content = read_file(options.mapping_file);
+        if (!yaml_content) {
             return 1;
         }
 
-        // Parse YAML mapping
         auto yaml_result = parser::yaml::parse(*yaml_content);
         if (std::holds_alternative<parser::yaml::Error>(yaml_result)) {
             print_error(std::get<parser::yaml::Error>(yaml_result));
             return 1;
         }
 
-        // Parse JSON input
-        auto json_result = parser::json::parse(*json_content);
-        if (std::holds_alternative<parser::json::Error>(json_result)) {
-            print_error(std::get<parser::json::Error>(json_result));
-            return 1;
-        }
-
-        // Create mapping
-        auto mapping_result = parser::mapping::create_mapping(yaml_result);
+        mapping_result = parser::mapping::create_mapping(yaml_result);
         if (std::holds_alternative<parser::mapping::Error>(mapping_result)) {
             print_error(std::get<parser::mapping::Error>(mapping_result));
             return 1;
         }
+    }
+    const auto& mapping = std::get<parser::mapping::GraphMapping>(mapping_result);
+
+    if (options.codegen) {
+        return codegen(options, mapping, *yaml_content);
+    }
 
-        // Generate schema statements
-        graph::SchemaManager schema_manager;
-        auto schema_result = schema_manager.generate_schema_statements(
-            std::get<parser::mapping::GraphMapping>(mapping_result));
+    if (options.explain || options.explain_analyze) {
+        std::cout << graph::format_plan(mapping, options.batch_size);
+        if (!options.explain_analyze) {
+            return 0;
+        }
+    }
 
-        if (std::holds_alternative<graph::SchemaError>(schema_result)) {
-            print_error(std::get<graph::SchemaError>(schema_result));
+    std::unique_ptr<graph::CompiledMapping> extractor;
+    if (!options.extractor.empty()) {
+        auto loaded = graph::CompiledMapping::load(options.extractor.string(), *yaml_content);
+        if (std::holds_alternative<graph::StatementError>(loaded)) {
+            print_error(std::get<graph::StatementError>(loaded));
             return 1;
         }
+        extractor = std::move(std::get<std::unique_ptr<graph::CompiledMapping>>(loaded));
+    }
+
+    if (options.validate || options.preflight) {
+        int checked = preflight(options, mapping);
+        if (options.validate || checked != 0) {
+            return checked;
+        }
+    }
+
+    // Open the input; records are parsed as the pipeline reaches them
+    auto reader_result = parser::json::open_records(options.input_file.string(),
+                                                    options.input_format);
+    if (std::holds_alternative<parser::json::Error>(reader_result)) {
+        print_error(std::get<parser::json::Error>(reader_result));
+        return 1;
+    }
+    auto& reader = *std::get<std::unique_ptr<parser::json::RecordReader>>(reader_result);
+
+    if (options.explain_analyze) {
+        return explain_analyze(options, mapping, reader);
+    }
 
-        // Print schema statements
-        for (const auto& stmt : std::get<std::vector<std::string>>(schema_result)) {
+    // Generate schema statements
+    graph::SchemaManager schema_manager;
+    auto schema_result = schema_manager.generate_schema_statements(mapping);
+
+    if (std::holds_alternative<graph::SchemaError>(schema_result)) {
+        print_error(std::get<graph::SchemaError>(schema_result));
+        return 1;
+    }
+
+    std::unique_ptr<executor::StatementExecutor> stmt_executor;
+    if (!options.gateways.empty()) {
+        stmt_executor = std::make_unique<executor::StatementExecutor>(
+            options.gateways, options.executor_options);
+    }
+
+    // Print or execute schema statements (DDL runs in order)
+    const auto& schema_statements = std::get<std::vector<std::string>>(schema_result);
+    if (stmt_executor) {
+        telemetry::StageTimer timer(telemetry::Stage::OUTPUT);
+        if (!execute_statements(*stmt_executor, schema_statements, true)) {
+            print_endpoint_report(stmt_executor->pool().snapshot());
+            return 1;
+        }
+    } else {
+        NEBULA_MAPPER_TRACE_SPAN("write");
+        telemetry::StageTimer timer(telemetry::Stage::OUTPUT);
+        for (const auto& stmt : schema_statements) {
             std::cout << stmt << "\n";
         }
+    }
 
-        if (!options->schema_only) {
-            // Generate insert statements
-            graph::StatementGenerator stmt_generator;
-            auto stmt_result = stmt_generator.generate_batch_statements(
-                std::get<parser::mapping::GraphMapping>(mapping_result),
-                std::get<parser::json::JsonDocument>(json_result),
-                options->batch_size);
+    if (!options.schema_only) {
+        // Generate insert statements, printing them as they are produced
+        // or collecting them for the executor
+        graph::PipelineOptions pipeline_options;
+        pipeline_options.threads = options.threads;
+        pipeline_options.batch_size = options.batch_size;
+        pipeline_options.compiled = extractor.get();
+
+        std::optional<graph::MemoryBudget> memory;
+        if (options.memory_limit) {
+            memory.emplace(*options.memory_limit);
+            pipeline_options.memory = &*memory;
+        }
 
-            if (std::holds_alternative<graph::StatementError>(stmt_result)) {
-                print_error(std::get<graph::StatementError>(stmt_result));
+        std::optional<telemetry::SlowRecordLog> slow_records;
+        if (options.slow_record_ms) {
+            slow_records.emplace(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::duration<double, std::milli>(*options.slow_record_ms)),
+                options.slow_top, &std::cerr);
+            pipeline_options.slow_records = &*slow_records;
+        }
+
+        graph::OstreamSink stdout_sink(std::cout);
+        graph::SpillingSink collected(
+            pipeline_options.memory,
+            options.spill_dir.empty() ? fs::temp_directory_path() : options.spill_dir);
+        graph::StatementSink& sink = stmt_executor
+            ? static_cast<graph::StatementSink&>(collected)
+            : static_cast<graph::StatementSink&>(stdout_sink);
+        // UPDATEs of update aggregates touch vertices the INSERTs create, so
+        // the executor runs them apart, in order, once every INSERT is done
+        graph::VectorSink updates;
+        if (stmt_executor) {
+            pipeline_options.update_sink = &updates;
+        }
+
+        telemetry::ProgressCounters progress_counters;
+        std::optional<telemetry::ProgressReporter> progress;
+        if (options.progress) {
+            pipeline_options.progress = &progress_counters;
+            progress.emplace(progress_counters,
+                             parser::json::input_size(options.input_file.string()),
+                             std::cerr, *options.progress);
+            progress->start(options.progress_interval);
+        }
+
+        auto pipeline_result = graph::run_pipeline(mapping, reader, sink, pipeline_options);
+        if (progress) {
+            progress->stop();
+        }
+        if (slow_records) {
+            std::cout.flush();
+            std::cerr << telemetry::format_slow_records(*slow_records);
+        }
+        if (std::holds_alternative<graph::StatementError>(pipeline_result)) {
+            if (telemetry::metrics_enabled()) {
+                telemetry::pipeline_metrics().generate_errors.add();
+            }
+            print_error(std::get<graph::StatementError>(pipeline_result));
+            return 1;
+        }
+
+        if (stmt_executor) {
+            // Execute in slices of an eighth of the budget, or all at once
+            uint64_t chunk_bytes = options.memory_limit
+                ? std::max<uint64_t>(*options.memory_limit / 8, 1)
+                : std::numeric_limits<uint64_t>::max();
+            telemetry::StageTimer timer(telemetry::Stage::OUTPUT);
+            bool ok = true;
+            bool drained = collected.drain(chunk_bytes, [&](std::vector<std::string>&& chunk) {
+                ok = execute_statements(*stmt_executor, chunk, false) && ok;
+            });
+            if (drained && !updates.statements().empty()) {
+                ok = execute_statements(*stmt_executor, updates.statements(), true) && ok;
+            }
+            print_endpoint_report(stmt_executor->pool().snapshot());
+            if (!drained) {
+                std::cerr << "Error: Cannot read back spilled statements\n";
                 return 1;
             }
+            if (!ok) {
+                return 1;
+            }
+        }
+        if (memory && options.stats) {
+            std::cout.flush();
+            std::cerr << graph::format_memory(memory->snapshot());
+        }
+        if (extractor && options.stats) {
+            std::cout.flush();
+            std::cerr << "Extractor " << extractor->hash() << ": "
+                      << extractor->compiled_records() << " records compiled, "
+                      << extractor->interpreted_records() << " interpreted\n";
+        }
+    } else if (stmt_executor) {
+        print_endpoint_report(stmt_executor->pool().snapshot());
+    }
+
+    return 0;
+}
+
+// Print and/or write the collected stats
+bool report_stats(const ProgramOptions& options) {
+    std::cout.flush();
+    auto stats = telemetry::collect_stats();
+
+    if (options.stats) {
+        std::cerr << telemetry::format_stats(stats);
+    }
+
+    if (!options.stats_json_file.empty()) {
+        std::ofstream out(options.stats_json_file);
+        if (!out) {
+            std::cerr << "Error: Cannot write stats file: " << options.stats_json_file << '\n';
+            return false;
+        }
+        out << telemetry::stats_to_json(stats).dump(2) << '\n';
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        // Parse command line arguments
+        auto options = parse_arguments(argc, argv);
+        if (!options) {
+            return 1;
+        }
 
-            // Print insert statements
-            for (const auto& stmt : std::get<std::vector<std::string>>(stmt_result)) {
-                std::cout << stmt << "\n";
+        bool collect_stats = options->stats || !options->stats_json_file.empty();
+        if (collect_stats) {
+            telemetry::enable_stats();
+        }
+        // Per-record stage times and rows come from the stats accumulators
+        if (options->slow_record_ms) {
+            telemetry::enable_stats();
+        }
+
+        if (!options->trace_file.empty()) {
+#ifdef NEBULA_MAPPER_TRACING
+            telemetry::enable_tracing();
+#else
+            std::cerr << "Warning: built without tracing support, --trace ignored\n";
+#endif
+        }
+
+        telemetry::MetricsServer metrics_server;
+        telemetry::TextfileExporter textfile_exporter;
+        if (options->metrics_port || !options->metrics_textfile.empty()) {
+            telemetry::enable_metrics();
+            // Register the pipeline series up front so scrapes see zeros
+            telemetry::pipeline_metrics();
+        }
+        if (options->metrics_port) {
+            if (!metrics_server.start(*options->metrics_port)) {
+                std::cerr << "Error: Cannot listen on metrics port "
+                          << *options->metrics_port << '\n';
+                return 1;
             }
+            std::cerr << "Serving metrics on http://127.0.0.1:"
+                      << metrics_server.port() << "/metrics\n";
+        }
+        if (!options->metrics_textfile.empty() &&
+            !textfile_exporter.start(options->metrics_textfile.string(),
+                                     options->metrics_interval)) {
+            std::cerr << "Error: Cannot write metrics file: "
+                      << options->metrics_textfile << '\n';
+            return 1;
         }
 
-        return 0;
+        int status = run(*options);
+
+        // Stopping writes the final textfile snapshot
+        textfile_exporter.stop();
+        metrics_server.stop();
+
+#ifdef NEBULA_MAPPER_TRACING
+        if (!options->trace_file.empty() &&
+            !telemetry::write_chrome_trace(options->trace_file.string())) {
+            std::cerr << "Error: Cannot write trace file: " << options->trace_file << '\n';
+            status = 1;
+        }
+#endif
+
+        if (collect_stats && !report_stats(*options)) {
+            status = 1;
+        }
+        return status;
     }
     catch (const std::exception& e) {
         std::cerr << "Unexpected error: " << e.what() << '\n';
         return 1;
     }
-}
\ No newline at end of file
+}
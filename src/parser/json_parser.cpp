@@ -1,4 +1,5 @@
 #include "parser/json_parser.hpp"
+#include "telemetry/probes.hpp"
 #include <fstream>
 #include <sstream>
 
@@ -18,9 +19,20 @@ namespace {
 }
 
 Result<JsonDocument> parse(const std::string& input) {
+    bool probed = NEBULA_MAPPER_PROBE_ENABLED(document_parsed);
+    int64_t start_ns = probed ? telemetry::probe_clock_ns() : 0;
     try {
-        return JsonDocument::parse(input);
+        auto document = JsonDocument::parse(input);
+        if (probed) {
+            NEBULA_MAPPER_PROBE3(document_parsed, input.size(),
+                                 telemetry::probe_clock_ns() - start_ns, 1);
+        }
+        return document;
     } catch (const JsonDocument::exception& e) {
+        if (probed) {
+            NEBULA_MAPPER_PROBE3(document_parsed, input.size(),
+                                 telemetry::probe_clock_ns() - start_ns, 0);
+        }
         return Error{e.what()};
     }
 }
@@ -107,5 +119,32 @@ Result<JsonDocument> navigate_path(
     return *current;
 }
 
+const JsonDocument* find_path(
+    const JsonDocument& j,
+    const std::vector<std::string>& segments) {
+
+    const JsonDocument* current = &j;
+    for (const auto& segment : segments) {
+        if (!segment.empty() && segment[0] == '[' && segment.back() == ']') {
+            if (!current->is_array()) return nullptr;
+            size_t index = 0;
+            try {
+                index = std::stoul(segment.substr(1, segment.length() - 2));
+            } catch (const std::exception&) {
+                return nullptr;
+            }
+            if (index >= current->size()) return nullptr;
+            current = &(*current)[index];
+            continue;
+        }
+
+        if (!current->is_object()) return nullptr;
+        auto it = current->find(segment);
+        if (it == current->end()) return nullptr;
+        current = &(*it);
+    }
+    return current;
+}
+
 } // namespace detail
 } // namespace parser::json
\ No newline at end of file
@@ -12,7 +12,12 @@ namespace {
     const std::unordered_set<std::string> VALID_TYPES = {
         "BOOL", "INT", "INT8", "INT16", "INT32", "INT64",
         "FLOAT", "DOUBLE", "STRING", "FIXED_STRING",
-        "TIMESTAMP", "DATE", "TIME", "DATETIME"
+        "TIMESTAMP", "DATE", "TIME", "DATETIME", "GEOGRAPHY"
+    };
+
+    // GEOGRAPHY, unconstrained or limited to one shape
+    const std::unordered_set<std::string> GEOGRAPHY_TYPES = {
+        "GEOGRAPHY", "GEOGRAPHY(POINT)", "GEOGRAPHY(LINESTRING)", "GEOGRAPHY(POLYGON)"
     };
 
     // Default lengths for string types
@@ -57,6 +62,21 @@ SchemaResult<std::vector<std::string>> SchemaManager::generate_schema_statements
             element.properties.push_back(schema_prop);
         }
 
+        // Aggregate columns are NULL where there is nothing to aggregate
+        for (const auto& aggregate : vertex.aggregates) {
+            SchemaProperty schema_prop;
+            schema_prop.name = aggregate.name;
+
+            auto type_result = convert_to_nebula_type(aggregate.nebula_type);
+            if (std::holds_alternative<SchemaError>(type_result)) {
+                return std::get<SchemaError>(type_result);
+            }
+            schema_prop.type = std::get<std::string>(type_result);
+            schema_prop.nullable = true;
+
+            element.properties.push_back(schema_prop);
+        }
+
         // Validate schema element
         auto validation = validate_schema_element(element);
         if (std::holds_alternative<SchemaError>(validation)) {
@@ -373,11 +393,21 @@ SchemaResult<std::string> SchemaManager::convert_to_nebula_type(
         return result;
     }
 
+    // GEOGRAPHY without spaces: "Geography (Point)" is GEOGRAPHY(POINT)
+    if (upper_type.rfind("GEOGRAPHY", 0) == 0) {
+        upper_type.erase(std::remove_if(upper_type.begin(), upper_type.end(), ::isspace),
+                         upper_type.end());
+        if (GEOGRAPHY_TYPES.find(upper_type) != GEOGRAPHY_TYPES.end()) {
+            return upper_type;
+        }
+        return SchemaError{"Unsupported type: " + type};
+    }
+
     // Handle numeric and other types
     static const std::unordered_map<std::string, std::string> TYPE_MAP = {
         {"INT", "INT64"},
         {"INTEGER", "INT64"},
-        {"FLOAT", "DOUBLE"},
+        {"FLOAT", "FLOAT"},
         {"DOUBLE", "DOUBLE"},
         {"BOOL", "BOOL"},
         {"BOOLEAN", "BOOL"},
@@ -568,6 +598,30 @@ bool is_string_type(const std::string& type) {
 
 namespace parser::mapping {
 
+namespace {
+    // Upper-case type without whitespace
+    std::string normalized_type(const std::string& type) {
+        std::string upper;
+        for (char c : type) {
+            if (!std::isspace(static_cast<unsigned char>(c))) {
+                upper += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            }
+        }
+        return upper;
+    }
+
+    // Shape of a GEOGRAPHY type, "" when unconstrained, or nullopt for
+    // any other type
+    std::optional<std::string> geography_shape(const std::string& type) {
+        std::string upper = normalized_type(type);
+        if (upper == "GEOGRAPHY") return std::string();
+        if (upper.rfind("GEOGRAPHY(", 0) == 0 && upper.back() == ')') {
+            return upper.substr(10, upper.size() - 11);
+        }
+        return std::nullopt;
+    }
+}
+
 Result<GraphMapping> create_mapping(const parser::yaml::Result<YAML::Node>& config) {
     if (std::holds_alternative<parser::yaml::Error>(config)) {
         return Error{
@@ -632,6 +686,66 @@ Result<GraphMapping> create_mapping(const parser::yaml::Result<YAML::Node>& conf
 
 namespace detail {
 
+    Result<Aggregate> create_aggregate(const parser::yaml::AggregateMapping& aggregate_def,
+                                       const VertexMapping& vertex) {
+        static const std::map<std::string, AggregateOp> OPS = {
+            {"count", AggregateOp::COUNT},
+            {"sum", AggregateOp::SUM},
+            {"avg", AggregateOp::AVG},
+            {"min", AggregateOp::MIN},
+            {"max", AggregateOp::MAX},
+            {"distinct", AggregateOp::DISTINCT}
+        };
+
+        const auto& name = aggregate_def.name;
+        if (name.empty() || aggregate_def.op.empty() || aggregate_def.over.empty()) {
+            return Error{"Aggregate needs name, op and over", vertex.tag_name};
+        }
+        auto op = OPS.find(aggregate_def.op);
+        if (op == OPS.end()) {
+            return Error{
+                "Unknown aggregate op '" + aggregate_def.op +
+                    "' (expected count, sum, avg, min, max or distinct)",
+                name
+            };
+        }
+        if (aggregate_def.json_path.empty() && op->second != AggregateOp::COUNT) {
+            return Error{"Aggregate '" + aggregate_def.op + "' needs a json path", name};
+        }
+        if (aggregate_def.emit != "row" && aggregate_def.emit != "update") {
+            return Error{
+                "Unknown aggregate emit '" + aggregate_def.emit + "' (expected row or update)",
+                name
+            };
+        }
+        for (const auto& prop : vertex.properties) {
+            if (prop.name == name) {
+                return Error{"Aggregate has the name of a property", name};
+            }
+        }
+        for (const auto& other : vertex.aggregates) {
+            if (other.name == name) {
+                return Error{"Duplicate aggregate", name};
+            }
+        }
+
+        Aggregate aggregate;
+        aggregate.name = name;
+        aggregate.op = op->second;
+        aggregate.over = aggregate_def.over;
+        aggregate.json_path = aggregate_def.json_path;
+        aggregate.key_path = aggregate_def.key_field;
+        aggregate.update = aggregate_def.emit == "update";
+        if (aggregate_def.nebula_type) {
+            aggregate.nebula_type = *aggregate_def.nebula_type;
+        } else {
+            bool counted = aggregate.op == AggregateOp::COUNT ||
+                           aggregate.op == AggregateOp::DISTINCT;
+            aggregate.nebula_type = counted ? "INT64" : "DOUBLE";
+        }
+        return aggregate;
+    }
+
     Result<VertexMapping> create_vertex_mapping(
         const parser::yaml::TagMapping& tag_def,
         const std::string& tag_name) {
@@ -651,6 +765,14 @@ namespace detail {
             vertex.properties.push_back(std::get<Property>(prop_result));
         }
 
+        for (const auto& aggregate_def : tag_def.aggregates) {
+            auto aggregate = create_aggregate(aggregate_def, vertex);
+            if (std::holds_alternative<Error>(aggregate)) {
+                return std::get<Error>(aggregate);
+            }
+            vertex.aggregates.push_back(std::get<Aggregate>(aggregate));
+        }
+
         return vertex;
     }
 
@@ -689,6 +811,62 @@ Result<Property> create_property_mapping(
     prop.optional = prop_def.optional;
     prop.default_value = prop_def.default_value;
 
+    if (prop_def.coerce) {
+        auto mode = common::numbers::parse_coercion_mode(*prop_def.coerce);
+        if (!mode) {
+            return Error{
+                "Unknown coerce mode '" + *prop_def.coerce + "' (expected strict or lenient)",
+                prop_name
+            };
+        }
+        prop.coerce = *mode;
+    }
+
+    if (prop_def.serialize) {
+        if (*prop_def.serialize != "json") {
+            return Error{
+                "Unknown serialize format '" + *prop_def.serialize + "' (expected json)",
+                prop_name
+            };
+        }
+        // The text is a quoted JSON document, which only a STRING holds whole
+        if (normalized_type(prop.nebula_type) != "STRING") {
+            return Error{"Serialized property must be STRING, not " + prop.nebula_type,
+                         prop_name};
+        }
+        if (prop_def.transform) {
+            return Error{"Serialized property cannot also have a transform", prop_name};
+        }
+        prop.json_format = JsonFormat{prop_def.serialize_keys, prop_def.serialize_minify};
+    }
+
+    auto geography = geography_shape(prop.nebula_type);
+    if (prop_def.geo) {
+        static const std::map<std::string, Projection> PROJECTIONS = {
+            {"wgs84", Projection::WGS84},
+            {"congnamul", Projection::CONGNAMUL},
+            {"wcongnamul", Projection::WCONGNAMUL}
+        };
+        auto projection = PROJECTIONS.find(prop_def.geo->from);
+        if (projection == PROJECTIONS.end()) {
+            return Error{
+                "Unknown projection '" + prop_def.geo->from +
+                    "' (expected wgs84, congnamul or wcongnamul)",
+                prop_name
+            };
+        }
+        if (!geography || (!geography->empty() && *geography != "POINT")) {
+            return Error{
+                "Point property must be GEOGRAPHY or GEOGRAPHY(POINT), not " +
+                    prop.nebula_type,
+                prop_name
+            };
+        }
+        prop.geo = GeoPoint{prop_def.geo->x, prop_def.geo->y, projection->second};
+    } else if (geography) {
+        return Error{"GEOGRAPHY property needs geo coordinate paths", prop_name};
+    }
+
     return prop;
 }
 
@@ -0,0 +1,316 @@
+#include "parser/record_reader.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace parser::json {
+
+namespace {
+
+    constexpr size_t CHUNK_SIZE = 1 << 16;
+
+    bool is_space(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    Result<std::string> read_whole_file(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return Error{"Cannot open file: " + path};
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return buffer.str();
+    }
+
+    class DocumentReader : public RecordReader {
+    public:
+        explicit DocumentReader(std::string path) : path_(std::move(path)) {}
+
+        Result<std::optional<Record>> next() override {
+            if (done_) return std::optional<Record>{};
+            done_ = true;
+
+            auto text = read_whole_file(path_);
+            if (std::holds_alternative<Error>(text)) {
+                return std::get<Error>(text);
+            }
+            bytes_ = std::get<std::string>(text).size();
+            return std::optional<Record>{
+                Record{std::move(std::get<std::string>(text)), path_, 0}};
+        }
+
+        uint64_t bytes_read() const override { return bytes_; }
+
+    private:
+        std::string path_;
+        bool done_{false};
+        uint64_t bytes_{0};
+    };
+
+    class NdjsonReader : public RecordReader {
+    public:
+        NdjsonReader(std::string path, std::ifstream in)
+            : path_(std::move(path)), in_(std::move(in)) {}
+
+        Result<std::optional<Record>> next() override {
+            std::string line;
+            while (std::getline(in_, line)) {
+                ++line_number_;
+                uint64_t offset = bytes_;
+                bytes_ += line.size() + 1;
+                if (!line.empty() && line.back() == '\r') {
+                    line.pop_back();
+                }
+                if (std::all_of(line.begin(), line.end(), is_space)) {
+                    continue;
+                }
+                return std::optional<Record>{Record{
+                    std::move(line), path_ + ":" + std::to_string(line_number_), index_++,
+                    offset}};
+            }
+            if (in_.bad()) {
+                return Error{"Read error: " + path_, line_number_};
+            }
+            return std::optional<Record>{};
+        }
+
+        uint64_t bytes_read() const override { return bytes_; }
+
+    private:
+        std::string path_;
+        std::ifstream in_;
+        size_t line_number_{0};
+        uint64_t index_{0};
+        uint64_t bytes_{0};
+    };
+
+    // Splits a top-level JSON array into its elements by tracking nesting
+    // depth and string state; the elements themselves are validated later
+    // by the full parser.
+    class ArrayReader : public RecordReader {
+    public:
+        ArrayReader(std::string path, std::ifstream in)
+            : path_(std::move(path)), in_(std::move(in)), buffer_(CHUNK_SIZE) {}
+
+        Result<std::optional<Record>> next() override {
+            if (finished_) return std::optional<Record>{};
+
+            if (!opened_) {
+                int c = skip_space();
+                if (c != '[') {
+                    return Error{"Expected a top-level JSON array: " + path_};
+                }
+                opened_ = true;
+                c = skip_space();
+                if (c == ']') {
+                    finished_ = true;
+                    return std::optional<Record>{};
+                }
+                if (c != EOF) --pos_;
+            }
+
+            uint64_t offset = bytes_read();
+            std::string text;
+            int depth = 0;
+            bool in_string = false;
+            bool escaped = false;
+            bool last = false;
+            for (;;) {
+                if (pos_ == end_ && !fill()) {
+                    return Error{"Unterminated JSON array: " + path_};
+                }
+                size_t start = pos_;
+                bool complete = false;
+                while (pos_ < end_) {
+                    char c = buffer_[pos_];
+                    if (in_string) {
+                        if (escaped) escaped = false;
+                        else if (c == '\\') escaped = true;
+                        else if (c == '"') in_string = false;
+                    } else if (c == '"') {
+                        in_string = true;
+                    } else if (c == '{' || c == '[') {
+                        ++depth;
+                    } else if (c == '}' || c == ']') {
+                        if (depth == 0) {
+                            if (c == '}') {
+                                return Error{"Unbalanced '}' in JSON array: " + path_};
+                            }
+                            last = true;
+                            complete = true;
+                            break;
+                        }
+                        --depth;
+                    } else if (c == ',' && depth == 0) {
+                        complete = true;
+                        break;
+                    }
+                    ++pos_;
+                }
+                text.append(buffer_.data() + start, pos_ - start);
+                if (complete) {
+                    ++pos_;  // Separator or closing bracket
+                    break;
+                }
+            }
+
+            if (std::all_of(text.begin(), text.end(), is_space)) {
+                return Error{"Empty element in JSON array: " + path_};
+            }
+            finished_ = last;
+            uint64_t index = index_++;
+            return std::optional<Record>{
+                Record{std::move(text), path_ + "[" + std::to_string(index) + "]", index,
+                       offset}};
+        }
+
+        uint64_t bytes_read() const override { return bytes_ - (end_ - pos_); }
+
+    private:
+        bool fill() {
+            in_.read(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+            pos_ = 0;
+            end_ = static_cast<size_t>(in_.gcount());
+            bytes_ += end_;
+            return end_ > 0;
+        }
+
+        int skip_space() {
+            for (;;) {
+                if (pos_ == end_ && !fill()) return EOF;
+                char c = buffer_[pos_++];
+                if (!is_space(c)) return static_cast<unsigned char>(c);
+            }
+        }
+
+        std::string path_;
+        std::ifstream in_;
+        std::vector<char> buffer_;
+        size_t pos_{0};
+        size_t end_{0};
+        bool opened_{false};
+        bool finished_{false};
+        uint64_t index_{0};
+        uint64_t bytes_{0};
+    };
+
+    class DirectoryReader : public RecordReader {
+    public:
+        explicit DirectoryReader(std::vector<std::string> files)
+            : files_(std::move(files)) {}
+
+        Result<std::optional<Record>> next() override {
+            if (index_ == files_.size()) return std::optional<Record>{};
+
+            const auto& path = files_[index_];
+            auto text = read_whole_file(path);
+            if (std::holds_alternative<Error>(text)) {
+                return std::get<Error>(text);
+            }
+            bytes_ += std::get<std::string>(text).size();
+            return std::optional<Record>{
+                Record{std::move(std::get<std::string>(text)), path, index_++}};
+        }
+
+        uint64_t bytes_read() const override { return bytes_; }
+
+    private:
+        std::vector<std::string> files_;
+        uint64_t index_{0};
+        uint64_t bytes_{0};
+    };
+
+    // First non-blank character of a file, skipping a UTF-8 byte order mark
+    int first_significant_char(std::ifstream& in) {
+        int c;
+        while ((c = in.get()) != EOF) {
+            if (c == 0xEF || c == 0xBB || c == 0xBF) continue;
+            if (!is_space(static_cast<char>(c))) break;
+        }
+        in.clear();
+        in.seekg(0);
+        return c;
+    }
+
+} // namespace
+
+Result<std::unique_ptr<RecordReader>> open_records(const std::string& path,
+                                                   InputFormat format) {
+    std::error_code ec;
+    bool directory = fs::is_directory(path, ec);
+
+    if (format == InputFormat::DIRECTORY || (format == InputFormat::AUTO && directory)) {
+        if (!directory) {
+            return Error{"Not a directory: " + path};
+        }
+        std::vector<std::string> files;
+        for (fs::recursive_directory_iterator it(path, ec), end; !ec && it != end;
+             it.increment(ec)) {
+            if (it->is_regular_file(ec)) {
+                files.push_back(it->path().string());
+            }
+        }
+        if (ec) {
+            return Error{"Cannot list directory: " + path + " (" + ec.message() + ")"};
+        }
+        std::sort(files.begin(), files.end());
+        return std::unique_ptr<RecordReader>(new DirectoryReader(std::move(files)));
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    if (directory || !in) {
+        return Error{"Cannot open file: " + path};
+    }
+
+    if (format == InputFormat::AUTO) {
+        auto extension = fs::path(path).extension().string();
+        if (extension == ".ndjson" || extension == ".jsonl") {
+            format = InputFormat::NDJSON;
+        } else {
+            format = first_significant_char(in) == '[' ? InputFormat::ARRAY
+                                                       : InputFormat::DOCUMENT;
+        }
+    }
+
+    switch (format) {
+        case InputFormat::NDJSON:
+            return std::unique_ptr<RecordReader>(new NdjsonReader(path, std::move(in)));
+        case InputFormat::ARRAY:
+            return std::unique_ptr<RecordReader>(new ArrayReader(path, std::move(in)));
+        default:
+            return std::unique_ptr<RecordReader>(new DocumentReader(path));
+    }
+}
+
+uint64_t input_size(const std::string& path) {
+    std::error_code ec;
+    if (!fs::is_directory(path, ec)) {
+        auto size = fs::file_size(path, ec);
+        return ec ? 0 : size;
+    }
+
+    uint64_t total = 0;
+    for (fs::recursive_directory_iterator it(path, ec), end; !ec && it != end;
+         it.increment(ec)) {
+        if (it->is_regular_file(ec)) {
+            total += it->file_size(ec);
+        }
+    }
+    return ec ? 0 : total;
+}
+
+Result<InputFormat> parse_input_format(const std::string& name) {
+    if (name == "auto") return InputFormat::AUTO;
+    if (name == "document") return InputFormat::DOCUMENT;
+    if (name == "ndjson" || name == "jsonl") return InputFormat::NDJSON;
+    if (name == "array") return InputFormat::ARRAY;
+    if (name == "directory" || name == "files") return InputFormat::DIRECTORY;
+    return Error{"Unknown input format: " + name};
+}
+
+} // namespace parser::json
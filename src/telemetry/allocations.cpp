@@ -0,0 +1,88 @@
+#include "telemetry/allocations.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace telemetry {
+
+namespace {
+    struct SlotCounters {
+        std::atomic<uint64_t> allocations{0};
+        std::atomic<uint64_t> bytes{0};
+    };
+
+    // Constant-initialized, so usable from operator new during static
+    // initialization of other translation units
+    SlotCounters slots[ALLOCATION_SLOTS];
+
+    void record(std::size_t size) noexcept {
+        auto& slot = slots[detail::current_allocation_slot()];
+        slot.allocations.fetch_add(1, std::memory_order_relaxed);
+        slot.bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+}
+
+std::array<AllocationCounters, ALLOCATION_SLOTS> allocation_counters() {
+    std::array<AllocationCounters, ALLOCATION_SLOTS> result{};
+    for (size_t i = 0; i < ALLOCATION_SLOTS; ++i) {
+        result[i].allocations = slots[i].allocations.load(std::memory_order_relaxed);
+        result[i].bytes = slots[i].bytes.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+AllocationCounters allocation_total() {
+    AllocationCounters total;
+    for (const auto& slot : slots) {
+        total.allocations += slot.allocations.load(std::memory_order_relaxed);
+        total.bytes += slot.bytes.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void reset_allocation_counters() {
+    for (auto& slot : slots) {
+        slot.allocations.store(0, std::memory_order_relaxed);
+        slot.bytes.store(0, std::memory_order_relaxed);
+    }
+}
+
+} // namespace telemetry
+
+// Counting replacements for the global allocator. Array and nothrow forms
+// forward to these in libstdc++, so they are counted as well.
+void* operator new(std::size_t size) {
+    telemetry::record(size);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+// Over-aligned types; aligned_alloc wants a size that is a multiple of the
+// alignment
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    telemetry::record(size);
+    auto align = static_cast<std::size_t>(alignment);
+    std::size_t rounded = size == 0 ? align : (size + align - 1) & ~(align - 1);
+    if (void* ptr = std::aligned_alloc(align, rounded)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
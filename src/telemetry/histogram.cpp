@@ -0,0 +1,71 @@
+#include "telemetry/histogram.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace telemetry {
+
+uint64_t Histogram::bucket_lower_bound(size_t index) {
+    if (index < LINEAR_BUCKETS) return index;
+    size_t exponent = (index - LINEAR_BUCKETS) / SUB_BUCKETS + 4;
+    size_t sub = (index - LINEAR_BUCKETS) % SUB_BUCKETS;
+    return static_cast<uint64_t>(SUB_BUCKETS + sub) << (exponent - 3);
+}
+
+uint64_t Histogram::bucket_upper_bound(size_t index) {
+    if (index + 1 >= BUCKET_COUNT) return std::numeric_limits<uint64_t>::max();
+    return bucket_lower_bound(index + 1) - 1;
+}
+
+uint64_t Histogram::percentile(double q) const {
+    uint64_t total = count();
+    if (total == 0) return 0;
+
+    auto rank = static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) *
+                                                static_cast<double>(total)));
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += buckets_[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            // Never report more than the largest recorded value
+            return std::min(bucket_upper_bound(i), max());
+        }
+    }
+    return max();
+}
+
+std::vector<uint64_t> Histogram::buckets() const {
+    std::vector<uint64_t> result(BUCKET_COUNT);
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        result[i] = buckets_[i].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+void Histogram::merge(const Histogram& other) {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        buckets_[i].fetch_add(other.buckets_[i].load(std::memory_order_relaxed),
+                              std::memory_order_relaxed);
+    }
+    count_.fetch_add(other.count(), std::memory_order_relaxed);
+    sum_.fetch_add(other.sum(), std::memory_order_relaxed);
+
+    uint64_t value = other.max();
+    uint64_t current = max_.load(std::memory_order_relaxed);
+    while (value > current &&
+           !max_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+void Histogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+} // namespace telemetry
@@ -0,0 +1,373 @@
+#include "telemetry/metrics.hpp"
+#include <arpa/inet.h>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <netinet/in.h>
+#include <optional>
+#include <poll.h>
+#include <sstream>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace telemetry {
+
+namespace detail {
+    std::atomic<bool> metrics_enabled{false};
+}
+
+namespace {
+    constexpr const char* OPENMETRICS_CONTENT_TYPE =
+        "application/openmetrics-text; version=1.0.0; charset=utf-8";
+    constexpr const char* PROMETHEUS_CONTENT_TYPE =
+        "text/plain; version=0.0.4; charset=utf-8";
+
+    std::string escape_label_value(const std::string& value) {
+        std::string result;
+        result.reserve(value.size());
+        for (char c : value) {
+            if (c == '\\') result += "\\\\";
+            else if (c == '"') result += "\\\"";
+            else if (c == '\n') result += "\\n";
+            else result += c;
+        }
+        return result;
+    }
+
+    // Canonical `k="v",...` form, also used as the series key
+    std::string format_labels(const Labels& labels) {
+        std::string result;
+        for (const auto& [key, value] : labels) {
+            if (!result.empty()) result += ',';
+            result += key + "=\"" + escape_label_value(value) + "\"";
+        }
+        return result;
+    }
+
+    std::string with_label(const std::string& labels, const std::string& extra) {
+        return labels.empty() ? extra : labels + "," + extra;
+    }
+
+    void write_sample(std::ostream& out, const std::string& name,
+                      const std::string& labels, const std::string& value) {
+        out << name;
+        if (!labels.empty()) out << '{' << labels << '}';
+        out << ' ' << value << '\n';
+    }
+
+    std::string format_double(double value) {
+        std::ostringstream out;
+        out.precision(12);
+        out << value;
+        return out.str();
+    }
+
+    void write_histogram(std::ostream& out, const std::string& name,
+                         const std::string& labels, const Histogram& histogram,
+                         double scale) {
+        // Only non-empty buckets are emitted; cumulative counts keep it valid
+        auto buckets = histogram.buckets();
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            if (buckets[i] == 0) continue;
+            cumulative += buckets[i];
+            double le = static_cast<double>(Histogram::bucket_upper_bound(i)) / scale;
+            write_sample(out, name + "_bucket",
+                         with_label(labels, "le=\"" + format_double(le) + "\""),
+                         std::to_string(cumulative));
+        }
+        write_sample(out, name + "_bucket", with_label(labels, "le=\"+Inf\""),
+                     std::to_string(cumulative));
+        write_sample(out, name + "_count", labels, std::to_string(cumulative));
+        write_sample(out, name + "_sum", labels,
+                     format_double(static_cast<double>(histogram.sum()) / scale));
+    }
+
+    bool send_all(int fd, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    // Read until the end of the request headers (bodies are not expected)
+    std::string read_request(int fd) {
+        std::string request;
+        char buffer[1024];
+        while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+            pollfd pfd{fd, POLLIN, 0};
+            if (::poll(&pfd, 1, 1000) <= 0) break;
+            ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            request.append(buffer, static_cast<size_t>(n));
+        }
+        return request;
+    }
+
+    // Lowercased value of a request header; names match case-insensitively
+    std::optional<std::string> header_value(const std::string& request, const char* name) {
+        const size_t name_len = std::strlen(name);
+        size_t line = request.find("\r\n");
+        while (line != std::string::npos) {
+            line += 2;
+            size_t end = request.find("\r\n", line);
+            if (end == std::string::npos || end == line) break;
+            if (end - line > name_len && request[line + name_len] == ':' &&
+                ::strncasecmp(request.data() + line, name, name_len) == 0) {
+                std::string value = request.substr(line + name_len + 1,
+                                                   end - line - name_len - 1);
+                for (auto& c : value) {
+                    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+                }
+                return value;
+            }
+            line = end;
+        }
+        return std::nullopt;
+    }
+
+    std::string http_response(const std::string& status, const char* content_type,
+                              const std::string& body) {
+        std::ostringstream out;
+        out << "HTTP/1.1 " << status << "\r\n"
+            << "Content-Type: " << content_type << "\r\n"
+            << "Content-Length: " << body.size() << "\r\n"
+            << "Connection: close\r\n\r\n"
+            << body;
+        return out.str();
+    }
+}
+
+MetricsRegistry::Family& MetricsRegistry::family(const std::string& name, Type type,
+                                                 const std::string& help) {
+    auto [it, inserted] = families_.try_emplace(name);
+    if (inserted) {
+        it->second.type = type;
+        it->second.help = help;
+    }
+    return it->second;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help,
+                                  const Labels& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = family(name, Type::COUNTER, help).counters[format_labels(labels)];
+    if (!slot) slot = std::make_unique<Counter>();
+    return *slot;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help,
+                              const Labels& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = family(name, Type::GAUGE, help).gauges[format_labels(labels)];
+    if (!slot) slot = std::make_unique<Gauge>();
+    return *slot;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help,
+                                      const Labels& labels, double scale) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& fam = family(name, Type::HISTOGRAM, help);
+    fam.scale = scale;
+    auto& slot = fam.histograms[format_labels(labels)];
+    if (!slot) slot = std::make_unique<Histogram>();
+    return *slot;
+}
+
+std::string MetricsRegistry::render(ExpositionFormat format) const {
+    bool openmetrics = format == ExpositionFormat::OPENMETRICS;
+    std::ostringstream out;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [name, fam] : families_) {
+        switch (fam.type) {
+            case Type::COUNTER: {
+                // OpenMetrics names the family without the _total suffix
+                std::string family_name = openmetrics ? name : name + "_total";
+                out << "# TYPE " << family_name << " counter\n"
+                    << "# HELP " << family_name << ' ' << fam.help << '\n';
+                for (const auto& [labels, counter] : fam.counters) {
+                    write_sample(out, name + "_total", labels,
+                                 std::to_string(counter->value()));
+                }
+                break;
+            }
+            case Type::GAUGE:
+                out << "# TYPE " << name << " gauge\n"
+                    << "# HELP " << name << ' ' << fam.help << '\n';
+                for (const auto& [labels, gauge] : fam.gauges) {
+                    write_sample(out, name, labels, std::to_string(gauge->value()));
+                }
+                break;
+            case Type::HISTOGRAM:
+                out << "# TYPE " << name << " histogram\n"
+                    << "# HELP " << name << ' ' << fam.help << '\n';
+                for (const auto& [labels, histogram] : fam.histograms) {
+                    write_histogram(out, name, labels, *histogram, fam.scale);
+                }
+                break;
+        }
+    }
+
+    if (openmetrics) {
+        out << "# EOF\n";
+    }
+    return out.str();
+}
+
+void enable_metrics(bool enabled) {
+    detail::metrics_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+PipelineMetrics& pipeline_metrics() {
+    static PipelineMetrics metrics = [] {
+        auto& registry = MetricsRegistry::instance();
+        return PipelineMetrics{
+            registry.counter("nebula_mapper_rows", "Rows rendered into statements"),
+            registry.counter("nebula_mapper_statements", "Statements emitted"),
+            registry.counter("nebula_mapper_statement_bytes", "Bytes of statements emitted"),
+            registry.counter("nebula_mapper_dedup_lookups",
+                             "Vertex de-duplication lookups", {{"result", "hit"}}),
+            registry.counter("nebula_mapper_dedup_lookups",
+                             "Vertex de-duplication lookups", {{"result", "miss"}}),
+            registry.counter("nebula_mapper_errors", "Failures by stage",
+                             {{"stage", "generate"}}),
+            registry.counter("nebula_mapper_errors", "Failures by stage",
+                             {{"stage", "execute"}}),
+            registry.gauge("nebula_mapper_queue_depth",
+                           "Statements waiting to be sent to the gateway"),
+            registry.gauge("nebula_mapper_requests_in_flight",
+                           "Statements currently being sent to the gateway"),
+            registry.histogram("nebula_mapper_request_duration_seconds",
+                               "Latency of one statement (batch) round trip to the gateway",
+                               {}, 1e9)
+        };
+    }();
+    return metrics;
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+bool MetricsServer::start(uint16_t port, const std::string& address) {
+    if (running_) return false;
+
+    fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd_ < 0) return false;
+
+    int reuse = 1;
+    ::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    socklen_t len = sizeof(addr);
+    if (::inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1 ||
+        ::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(fd_, 16) != 0 ||
+        ::getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    port_ = ntohs(addr.sin_port);
+    running_ = true;
+    thread_ = std::thread([this] { serve(); });
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (!running_.exchange(false)) return;
+    ::shutdown(fd_, SHUT_RDWR);
+    if (thread_.joinable()) thread_.join();
+    ::close(fd_);
+    fd_ = -1;
+}
+
+void MetricsServer::serve() {
+    while (running_) {
+        // Poll with a timeout so stop() is noticed promptly
+        pollfd pfd{fd_, POLLIN, 0};
+        int rc = ::poll(&pfd, 1, 200);
+        if (rc <= 0) continue;
+
+        int client = ::accept(fd_, nullptr, nullptr);
+        if (client < 0) continue;
+
+        std::string request = read_request(client);
+        std::string response;
+        if (request.rfind("GET /metrics", 0) == 0) {
+            // Scrapers that do not ask for OpenMetrics get the classic format
+            auto accept = header_value(request, "Accept");
+            bool openmetrics =
+                !accept || accept->find("application/openmetrics-text") != std::string::npos;
+            auto format = openmetrics ? ExpositionFormat::OPENMETRICS
+                                      : ExpositionFormat::PROMETHEUS;
+            response = http_response(
+                "200 OK",
+                openmetrics ? OPENMETRICS_CONTENT_TYPE : PROMETHEUS_CONTENT_TYPE,
+                MetricsRegistry::instance().render(format));
+        } else {
+            response = http_response("404 Not Found", "text/plain", "Not Found\n");
+        }
+
+        send_all(client, response);
+        ::close(client);
+    }
+}
+
+TextfileExporter::~TextfileExporter() {
+    stop();
+}
+
+bool TextfileExporter::start(const std::string& path, std::chrono::milliseconds interval) {
+    if (thread_.joinable()) return false;
+    path_ = path;
+    interval_ = interval;
+    stopping_ = false;
+    if (!write_now()) return false;
+
+    thread_ = std::thread([this] {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!cv_.wait_for(lock, interval_, [this] { return stopping_; })) {
+            write_now();
+        }
+    });
+    return true;
+}
+
+void TextfileExporter::stop() {
+    if (!thread_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+    // Final snapshot so the file reflects the completed run
+    write_now();
+}
+
+bool TextfileExporter::write_now() const {
+    // Write aside and rename so node-exporter never reads a partial file
+    std::string temp = path_ + ".tmp";
+    {
+        std::ofstream out(temp);
+        if (!out) return false;
+        out << MetricsRegistry::instance().render(ExpositionFormat::PROMETHEUS);
+        if (!out) return false;
+    }
+    return std::rename(temp.c_str(), path_.c_str()) == 0;
+}
+
+} // namespace telemetry
@@ -0,0 +1,13 @@
+#include "telemetry/probes.hpp"
+
+// Probe semaphores live in the .probes section where the tracer finds them
+#define NEBULA_MAPPER_PROBE_SEMAPHORE(name) \
+    __attribute__((section(".probes"))) unsigned short nebula_mapper_##name##_semaphore = 0
+
+extern "C" {
+    NEBULA_MAPPER_PROBE_SEMAPHORE(document_parsed);
+    NEBULA_MAPPER_PROBE_SEMAPHORE(row_extracted);
+    NEBULA_MAPPER_PROBE_SEMAPHORE(transform_applied);
+    NEBULA_MAPPER_PROBE_SEMAPHORE(batch_flushed);
+    NEBULA_MAPPER_PROBE_SEMAPHORE(statement_written);
+}
@@ -0,0 +1,119 @@
+#include "telemetry/profile.hpp"
+#include "telemetry/allocations.hpp"
+#include "telemetry/stats.hpp"
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace telemetry {
+
+namespace detail {
+    std::atomic<bool> profile_enabled{false};
+}
+
+namespace {
+    // All live thread accumulators plus the totals of threads that exited
+    struct Registry {
+        std::mutex mutex;
+        std::vector<ProfileSnapshot*> live;
+        ProfileSnapshot retired;
+    };
+
+    Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    void merge_into(ProfileSnapshot& target, const ProfileSnapshot& source) {
+        for (const auto& [step, cost] : source) {
+            target[step].merge(cost);
+        }
+    }
+
+    struct LocalHolder {
+        ProfileSnapshot steps;
+
+        LocalHolder() {
+            auto& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.live.push_back(&steps);
+        }
+
+        ~LocalHolder() {
+            auto& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            merge_into(reg.retired, steps);
+            reg.live.erase(std::remove(reg.live.begin(), reg.live.end(), &steps),
+                           reg.live.end());
+        }
+    };
+
+    ProfileSnapshot& local_profile() {
+        thread_local LocalHolder holder;
+        return holder.steps;
+    }
+
+    uint64_t transform_ns() {
+        if (!stats_enabled()) return 0;
+        return detail::local_stats().stage_ns[static_cast<size_t>(Stage::TRANSFORM)];
+    }
+}
+
+void StepCost::merge(const StepCost& other) {
+    calls += other.calls;
+    ns += other.ns;
+    transform_ns += other.transform_ns;
+    output_bytes += other.output_bytes;
+    allocations += other.allocations;
+    allocation_bytes += other.allocation_bytes;
+}
+
+void enable_profile(bool enabled) {
+    detail::profile_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void StepScope::begin() {
+    transform_ns_ = transform_ns();
+#ifdef NEBULA_MAPPER_ALLOC_TRACKING
+    auto allocations = allocation_total();
+    allocations_ = allocations.allocations;
+    allocation_bytes_ = allocations.bytes;
+#endif
+    start_ = std::chrono::steady_clock::now();
+}
+
+void StepScope::end() {
+    auto elapsed = std::chrono::steady_clock::now() - start_;
+    auto& cost = local_profile()[step_];
+    ++cost.calls;
+    cost.ns += static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    cost.transform_ns += transform_ns() - transform_ns_;
+    cost.output_bytes += output_bytes_;
+#ifdef NEBULA_MAPPER_ALLOC_TRACKING
+    auto allocations = allocation_total();
+    cost.allocations += allocations.allocations - allocations_;
+    cost.allocation_bytes += allocations.bytes - allocation_bytes_;
+#endif
+}
+
+ProfileSnapshot collect_profile() {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    ProfileSnapshot result = reg.retired;
+    for (const auto* steps : reg.live) {
+        merge_into(result, *steps);
+    }
+    return result;
+}
+
+void reset_profile() {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.retired.clear();
+    for (auto* steps : reg.live) {
+        steps->clear();
+    }
+}
+
+} // namespace telemetry
@@ -0,0 +1,170 @@
+#include "telemetry/progress.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+
+namespace telemetry {
+
+namespace {
+    // Weight of the newest interval in the smoothed rates
+    constexpr double RATE_SMOOTHING = 0.3;
+
+    std::string format_duration(double seconds) {
+        auto total = static_cast<uint64_t>(std::llround(std::max(seconds, 0.0)));
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%llu:%02llu:%02llu",
+                      static_cast<unsigned long long>(total / 3600),
+                      static_cast<unsigned long long>(total / 60 % 60),
+                      static_cast<unsigned long long>(total % 60));
+        return buffer;
+    }
+
+    double mib(uint64_t bytes) {
+        return static_cast<double>(bytes) / (1 << 20);
+    }
+}
+
+std::string format_progress(const ProgressSnapshot& progress) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(1);
+    out << (progress.final ? "done: " : "progress: ");
+    if (progress.total_bytes > 0) {
+        out << 100.0 * static_cast<double>(progress.input_bytes) /
+                   static_cast<double>(progress.total_bytes)
+            << "% " << mib(progress.input_bytes) << "/" << mib(progress.total_bytes) << " MiB";
+    } else {
+        out << mib(progress.input_bytes) << " MiB";
+    }
+    out << ", " << progress.records << " records, " << progress.rows << " rows, "
+        << progress.statements << " statements, "
+        << mib(static_cast<uint64_t>(progress.bytes_per_second)) << " MiB/s, "
+        << std::setprecision(0) << progress.records_per_second << " records/s";
+    if (progress.final) {
+        out << ", in " << format_duration(progress.elapsed_seconds);
+    } else if (progress.eta_seconds) {
+        out << ", ETA " << format_duration(*progress.eta_seconds);
+    }
+    return out.str();
+}
+
+nlohmann::json progress_to_json(const ProgressSnapshot& progress) {
+    nlohmann::json result = {
+        {"event", progress.final ? "done" : "progress"},
+        {"elapsed_seconds", progress.elapsed_seconds},
+        {"records", progress.records},
+        {"input_bytes", progress.input_bytes},
+        {"rows", progress.rows},
+        {"statements", progress.statements},
+        {"statement_bytes", progress.statement_bytes},
+        {"bytes_per_second", progress.bytes_per_second},
+        {"records_per_second", progress.records_per_second},
+    };
+    if (progress.total_bytes > 0) {
+        result["total_bytes"] = progress.total_bytes;
+    }
+    if (progress.eta_seconds) {
+        result["eta_seconds"] = *progress.eta_seconds;
+    }
+    return result;
+}
+
+ProgressReporter::ProgressReporter(const ProgressCounters& counters, uint64_t total_bytes,
+                                   std::ostream& out, ProgressFormat format)
+    : counters_(counters),
+      total_bytes_(total_bytes),
+      out_(out),
+      format_(format),
+      started_(std::chrono::steady_clock::now()),
+      last_time_(started_) {}
+
+ProgressReporter::~ProgressReporter() {
+    stop();
+}
+
+void ProgressReporter::start(std::chrono::milliseconds interval) {
+    if (thread_.joinable()) return;
+    interval_ = interval;
+    stopping_ = false;
+    started_ = last_time_ = std::chrono::steady_clock::now();
+
+    thread_ = std::thread([this] {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!cv_.wait_for(lock, interval_, [this] { return stopping_; })) {
+            write(sample());
+        }
+    });
+}
+
+void ProgressReporter::stop() {
+    if (!thread_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+
+    // Whole-run averages rather than the recent rate
+    auto progress = sample();
+    progress.final = true;
+    progress.eta_seconds.reset();
+    if (progress.elapsed_seconds > 0.0) {
+        progress.bytes_per_second =
+            static_cast<double>(progress.input_bytes) / progress.elapsed_seconds;
+        progress.records_per_second =
+            static_cast<double>(progress.records) / progress.elapsed_seconds;
+    }
+    write(progress);
+}
+
+ProgressSnapshot ProgressReporter::sample() {
+    auto now = std::chrono::steady_clock::now();
+
+    ProgressSnapshot progress;
+    progress.elapsed_seconds = std::chrono::duration<double>(now - started_).count();
+    progress.records = counters_.records.load(std::memory_order_relaxed);
+    progress.input_bytes = counters_.input_bytes.load(std::memory_order_relaxed);
+    progress.rows = counters_.rows.load(std::memory_order_relaxed);
+    progress.statements = counters_.statements.load(std::memory_order_relaxed);
+    progress.statement_bytes = counters_.statement_bytes.load(std::memory_order_relaxed);
+    progress.total_bytes = total_bytes_;
+
+    double seconds = std::chrono::duration<double>(now - last_time_).count();
+    if (seconds > 0.0) {
+        double bytes_rate = static_cast<double>(progress.input_bytes - last_bytes_) / seconds;
+        double records_rate = static_cast<double>(progress.records - last_records_) / seconds;
+        if (rated_) {
+            bytes_rate_ += RATE_SMOOTHING * (bytes_rate - bytes_rate_);
+            records_rate_ += RATE_SMOOTHING * (records_rate - records_rate_);
+        } else {
+            bytes_rate_ = bytes_rate;
+            records_rate_ = records_rate;
+            rated_ = true;
+        }
+        last_time_ = now;
+        last_bytes_ = progress.input_bytes;
+        last_records_ = progress.records;
+    }
+    progress.bytes_per_second = bytes_rate_;
+    progress.records_per_second = records_rate_;
+
+    if (total_bytes_ > 0 && bytes_rate_ > 0.0) {
+        uint64_t remaining = total_bytes_ > progress.input_bytes
+            ? total_bytes_ - progress.input_bytes : 0;
+        progress.eta_seconds = static_cast<double>(remaining) / bytes_rate_;
+    }
+    return progress;
+}
+
+void ProgressReporter::write(const ProgressSnapshot& progress) {
+    if (format_ == ProgressFormat::JSON) {
+        out_ << progress_to_json(progress).dump() << '\n';
+    } else {
+        out_ << format_progress(progress) << '\n';
+    }
+    out_.flush();
+}
+
+} // namespace telemetry
@@ -0,0 +1,152 @@
+#include "telemetry/slow_records.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace telemetry {
+
+namespace {
+    bool slower(const RecordTiming& a, const RecordTiming& b) {
+        return a.total_ns > b.total_ns;
+    }
+
+    double ns_to_ms(uint64_t ns) {
+        return static_cast<double>(ns) / 1e6;
+    }
+
+    std::string format_bytes(uint64_t bytes) {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(1);
+        if (bytes >= (1u << 20)) {
+            out << static_cast<double>(bytes) / (1u << 20) << " MiB";
+        } else if (bytes >= (1u << 10)) {
+            out << static_cast<double>(bytes) / (1u << 10) << " KiB";
+        } else {
+            out << bytes << " B";
+        }
+        return out.str();
+    }
+}
+
+RecordTimer::RecordTimer() : start_(std::chrono::steady_clock::now()) {
+    if (!stats_enabled()) return;
+    const auto& stats = detail::local_stats();
+    stage_ns_ = stats.stage_ns;
+    rows_.reserve(stats.mappings.size());
+    for (const auto& [name, counters] : stats.mappings) {
+        rows_.emplace_back(name, counters.rows);
+    }
+}
+
+RecordTiming RecordTimer::finish(std::string source, uint64_t index,
+                                 uint64_t offset, uint64_t bytes) const {
+    RecordTiming timing;
+    timing.source = std::move(source);
+    timing.index = index;
+    timing.offset = offset;
+    timing.bytes = bytes;
+    timing.total_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start_).count());
+
+    if (!stats_enabled()) return timing;
+    const auto& stats = detail::local_stats();
+    for (size_t i = 0; i < STAGE_COUNT; ++i) {
+        timing.stage_ns[i] = stats.stage_ns[i] - stage_ns_[i];
+    }
+    for (const auto& [name, counters] : stats.mappings) {
+        uint64_t before = 0;
+        for (const auto& [seen, rows] : rows_) {
+            if (seen == name) {
+                before = rows;
+                break;
+            }
+        }
+        if (counters.rows > before) {
+            timing.rows[name] = counters.rows - before;
+        }
+    }
+    return timing;
+}
+
+SlowRecordLog::SlowRecordLog(std::chrono::nanoseconds threshold, size_t top_k,
+                             std::ostream* log)
+    : threshold_ns_(static_cast<uint64_t>(threshold.count())),
+      top_k_(top_k),
+      log_(log) {
+    heap_.reserve(top_k_);
+}
+
+void SlowRecordLog::observe(RecordTiming&& timing) {
+    records_.fetch_add(1, std::memory_order_relaxed);
+    bool slow = timing.total_ns >= threshold_ns_;
+    bool ranked = top_k_ > 0 && timing.total_ns > cutoff_ns_.load(std::memory_order_relaxed);
+    if (!slow && !ranked) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (slow) {
+        slow_.fetch_add(1, std::memory_order_relaxed);
+        if (log_) {
+            *log_ << "Slow record: " << format_record_timing(timing) << '\n';
+        }
+    }
+    if (!ranked) return;
+
+    if (heap_.size() < top_k_) {
+        heap_.push_back(std::move(timing));
+        std::push_heap(heap_.begin(), heap_.end(), slower);
+    } else if (timing.total_ns > heap_.front().total_ns) {
+        std::pop_heap(heap_.begin(), heap_.end(), slower);
+        heap_.back() = std::move(timing);
+        std::push_heap(heap_.begin(), heap_.end(), slower);
+    }
+    if (heap_.size() == top_k_) {
+        cutoff_ns_.store(heap_.front().total_ns, std::memory_order_relaxed);
+    }
+}
+
+std::vector<RecordTiming> SlowRecordLog::slowest() const {
+    std::vector<RecordTiming> result;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result = heap_;
+    }
+    std::sort(result.begin(), result.end(), slower);
+    return result;
+}
+
+std::string format_record_timing(const RecordTiming& timing) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << timing.source << " (offset " << timing.offset << ", "
+        << format_bytes(timing.bytes) << "): " << ns_to_ms(timing.total_ns) << " ms";
+
+    const char* separator = " [";
+    for (size_t i = 0; i < STAGE_COUNT; ++i) {
+        if (timing.stage_ns[i] == 0) continue;
+        out << separator << stage_name(static_cast<Stage>(i)) << ' '
+            << ns_to_ms(timing.stage_ns[i]) << " ms";
+        separator = ", ";
+    }
+    if (*separator == ',') out << ']';
+
+    separator = " rows: ";
+    for (const auto& [name, rows] : timing.rows) {
+        out << separator << name << '=' << rows;
+        separator = ", ";
+    }
+    return out.str();
+}
+
+std::string format_slow_records(const SlowRecordLog& log) {
+    auto slowest = log.slowest();
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "Slowest records (" << log.slow_records() << " of " << log.records()
+        << " at or above " << ns_to_ms(log.threshold_ns()) << " ms):\n";
+    for (size_t i = 0; i < slowest.size(); ++i) {
+        out << "  " << std::setw(3) << i + 1 << ". " << format_record_timing(slowest[i]) << '\n';
+    }
+    return out.str();
+}
+
+} // namespace telemetry
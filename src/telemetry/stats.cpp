@@ -0,0 +1,340 @@
+#include "telemetry/stats.hpp"
+#include "telemetry/allocations.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace telemetry {
+
+namespace detail {
+    std::atomic<bool> stats_enabled{false};
+}
+
+namespace {
+    // All live thread accumulators plus the totals of threads that exited
+    struct Registry {
+        std::mutex mutex;
+        std::vector<ThreadStats*> live;
+        ThreadStats retired;
+        std::chrono::steady_clock::time_point started{std::chrono::steady_clock::now()};
+    };
+
+    Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    struct LocalHolder {
+        ThreadStats stats;
+
+        LocalHolder() {
+            auto& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.live.push_back(&stats);
+        }
+
+        ~LocalHolder() {
+            auto& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.retired.merge(stats);
+            reg.live.erase(std::remove(reg.live.begin(), reg.live.end(), &stats),
+                           reg.live.end());
+        }
+    };
+
+    thread_local StageTimer* current_timer = nullptr;
+
+    constexpr const char* STAGE_NAMES[STAGE_COUNT] = {
+        "yaml_load", "json_parse", "extraction", "transform", "render", "output"
+    };
+
+    constexpr const char* BATCH_CLOSE_NAMES[BATCH_CLOSE_COUNT] = {
+        "full", "flush", "single_row"
+    };
+
+    nlohmann::json histogram_to_json(const Histogram& histogram) {
+        nlohmann::json result = {
+            {"count", histogram.count()},
+            {"sum", histogram.sum()},
+            {"p50", histogram.percentile(0.5)},
+            {"p99", histogram.percentile(0.99)},
+            {"max", histogram.max()}
+        };
+        // Non-empty buckets only, as [lower bound, upper bound, count]
+        auto& buckets = result["buckets"] = nlohmann::json::array();
+        auto counts = histogram.buckets();
+        for (size_t i = 0; i < counts.size(); ++i) {
+            if (counts[i] == 0) continue;
+            buckets.push_back({Histogram::bucket_lower_bound(i),
+                               Histogram::bucket_upper_bound(i), counts[i]});
+        }
+        return result;
+    }
+
+    const char* allocation_slot_name(size_t slot) {
+        return slot < STAGE_COUNT ? STAGE_NAMES[slot] : "untimed";
+    }
+
+    uint64_t total_rows(const StatsSnapshot& stats) {
+        uint64_t rows = 0;
+        for (const auto& [name, counters] : stats.mappings) {
+            rows += counters.rows;
+        }
+        return rows;
+    }
+
+    AllocationCounters total_allocations(const StatsSnapshot& stats) {
+        AllocationCounters total;
+        for (const auto& counters : stats.allocations) {
+            total.allocations += counters.allocations;
+            total.bytes += counters.bytes;
+        }
+        return total;
+    }
+
+    double per_row(uint64_t value, uint64_t rows) {
+        return rows ? static_cast<double>(value) / static_cast<double>(rows) : 0.0;
+    }
+
+    double ns_to_ms(uint64_t ns) {
+        return static_cast<double>(ns) / 1e6;
+    }
+}
+
+namespace detail {
+    ThreadStats& local_stats() {
+        thread_local LocalHolder holder;
+        return holder.stats;
+    }
+}
+
+#ifdef NEBULA_MAPPER_ALLOC_TRACKING
+size_t detail::current_allocation_slot() noexcept {
+    return current_timer ? static_cast<size_t>(current_timer->stage()) : STAGE_COUNT;
+}
+#endif
+
+const char* stage_name(Stage stage) {
+    return STAGE_NAMES[static_cast<size_t>(stage)];
+}
+
+const char* batch_close_name(BatchClose close) {
+    return BATCH_CLOSE_NAMES[static_cast<size_t>(close)];
+}
+
+void enable_stats(bool enabled) {
+    if (enabled) {
+        auto& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.started = std::chrono::steady_clock::now();
+#ifdef NEBULA_MAPPER_ALLOC_TRACKING
+        reset_allocation_counters();
+#endif
+    }
+    detail::stats_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void ThreadStats::merge(const ThreadStats& other) {
+    for (size_t i = 0; i < STAGE_COUNT; ++i) {
+        stage_ns[i] += other.stage_ns[i];
+        stage_calls[i] += other.stage_calls[i];
+    }
+    for (const auto& [name, counters] : other.mappings) {
+        auto& target = mappings[name];
+        target.rows += counters.rows;
+        target.bytes += counters.bytes;
+        target.statements += counters.statements;
+        target.statement_bytes += counters.statement_bytes;
+        target.row_sizes.merge(counters.row_sizes);
+        target.statement_sizes.merge(counters.statement_sizes);
+        target.batch_rows.merge(counters.batch_rows);
+        for (size_t i = 0; i < BATCH_CLOSE_COUNT; ++i) {
+            target.batch_closes[i] += counters.batch_closes[i];
+        }
+    }
+    for (const auto& [name, counters] : other.transforms) {
+        auto& target = transforms[name];
+        target.calls += counters.calls;
+        target.errors += counters.errors;
+    }
+}
+
+StageTimer::StageTimer(Stage stage)
+    : stage_(stage), active_(stats_enabled()) {
+    if (!active_) return;
+    parent_ = current_timer;
+    current_timer = this;
+    start_ = std::chrono::steady_clock::now();
+}
+
+StageTimer::~StageTimer() {
+    if (!active_) return;
+
+    auto elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start_).count());
+
+    auto& stats = detail::local_stats();
+    auto index = static_cast<size_t>(stage_);
+    stats.stage_ns[index] += elapsed > child_ns_ ? elapsed - child_ns_ : 0;
+    ++stats.stage_calls[index];
+
+    if (parent_) {
+        parent_->child_ns_ += elapsed;
+    }
+    current_timer = parent_;
+}
+
+StatsSnapshot collect_stats() {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    ThreadStats merged = reg.retired;
+    for (const auto* stats : reg.live) {
+        merged.merge(*stats);
+    }
+
+    StatsSnapshot snapshot;
+    snapshot.stage_ns = merged.stage_ns;
+    snapshot.stage_calls = merged.stage_calls;
+    snapshot.mappings.insert(merged.mappings.begin(), merged.mappings.end());
+    snapshot.transforms.insert(merged.transforms.begin(), merged.transforms.end());
+    snapshot.wall_seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - reg.started).count();
+#ifdef NEBULA_MAPPER_ALLOC_TRACKING
+    snapshot.allocations_tracked = true;
+    snapshot.allocations = allocation_counters();
+#endif
+    return snapshot;
+}
+
+void reset_stats() {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.retired = ThreadStats{};
+    for (auto* stats : reg.live) {
+        *stats = ThreadStats{};
+    }
+    reg.started = std::chrono::steady_clock::now();
+#ifdef NEBULA_MAPPER_ALLOC_TRACKING
+    reset_allocation_counters();
+#endif
+}
+
+std::string format_stats(const StatsSnapshot& stats) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+
+    uint64_t total_ns = 0;
+    for (auto ns : stats.stage_ns) total_ns += ns;
+
+    out << "Stage timings (wall " << stats.wall_seconds * 1e3 << " ms):\n";
+    for (size_t i = 0; i < STAGE_COUNT; ++i) {
+        double share = total_ns ? 100.0 * static_cast<double>(stats.stage_ns[i]) /
+                                      static_cast<double>(total_ns) : 0.0;
+        out << "  " << std::left << std::setw(12) << STAGE_NAMES[i] << std::right
+            << std::setw(12) << ns_to_ms(stats.stage_ns[i]) << " ms"
+            << std::setw(8) << std::setprecision(1) << share << " %"
+            << std::setprecision(3)
+            << "  (" << stats.stage_calls[i] << " calls)\n";
+    }
+
+    if (!stats.mappings.empty()) {
+        out << "Mappings:\n";
+        for (const auto& [name, counters] : stats.mappings) {
+            out << "  " << name
+                << ": rows=" << counters.rows
+                << " row_bytes=" << counters.bytes
+                << " statements=" << counters.statements
+                << " statement_bytes=" << counters.statement_bytes << '\n';
+        }
+    }
+
+    if (!stats.transforms.empty()) {
+        out << "Transforms:\n";
+        for (const auto& [name, counters] : stats.transforms) {
+            out << "  " << name
+                << ": calls=" << counters.calls
+                << " errors=" << counters.errors << '\n';
+        }
+    }
+
+    if (stats.allocations_tracked) {
+        uint64_t rows = total_rows(stats);
+        auto total = total_allocations(stats);
+        out << std::setprecision(1)
+            << "Allocations (" << total.allocations << " allocations, "
+            << total.bytes << " bytes, " << per_row(total.allocations, rows)
+            << " per row):\n";
+        for (size_t i = 0; i <= STAGE_COUNT; ++i) {
+            const auto& counters = stats.allocations[i];
+            out << "  " << std::left << std::setw(12) << allocation_slot_name(i) << std::right
+                << std::setw(12) << counters.allocations << " allocs"
+                << std::setw(14) << counters.bytes << " bytes"
+                << std::setw(10) << per_row(counters.allocations, rows) << " per row\n";
+        }
+    }
+
+    return out.str();
+}
+
+nlohmann::json stats_to_json(const StatsSnapshot& stats) {
+    nlohmann::json result;
+    result["wall_seconds"] = stats.wall_seconds;
+
+    auto& stages = result["stages"] = nlohmann::json::object();
+    for (size_t i = 0; i < STAGE_COUNT; ++i) {
+        stages[STAGE_NAMES[i]] = {
+            {"ns", stats.stage_ns[i]},
+            {"calls", stats.stage_calls[i]}
+        };
+    }
+
+    auto& mappings = result["mappings"] = nlohmann::json::object();
+    for (const auto& [name, counters] : stats.mappings) {
+        auto& mapping = mappings[name] = {
+            {"rows", counters.rows},
+            {"row_bytes", counters.bytes},
+            {"statements", counters.statements},
+            {"statement_bytes", counters.statement_bytes},
+            {"row_size", histogram_to_json(counters.row_sizes)},
+            {"statement_size", histogram_to_json(counters.statement_sizes)},
+            {"batch_rows", histogram_to_json(counters.batch_rows)}
+        };
+        auto& closes = mapping["batch_closes"] = nlohmann::json::object();
+        for (size_t i = 0; i < BATCH_CLOSE_COUNT; ++i) {
+            closes[BATCH_CLOSE_NAMES[i]] = counters.batch_closes[i];
+        }
+    }
+
+    auto& transforms = result["transforms"] = nlohmann::json::object();
+    for (const auto& [name, counters] : stats.transforms) {
+        transforms[name] = {
+            {"calls", counters.calls},
+            {"errors", counters.errors}
+        };
+    }
+
+    if (stats.allocations_tracked) {
+        uint64_t rows = total_rows(stats);
+        auto total = total_allocations(stats);
+        auto& allocations = result["allocations"];
+        allocations["count"] = total.allocations;
+        allocations["bytes"] = total.bytes;
+        allocations["per_row"] = per_row(total.allocations, rows);
+        allocations["bytes_per_row"] = per_row(total.bytes, rows);
+        auto& slots = allocations["stages"] = nlohmann::json::object();
+        for (size_t i = 0; i <= STAGE_COUNT; ++i) {
+            slots[allocation_slot_name(i)] = {
+                {"count", stats.allocations[i].allocations},
+                {"bytes", stats.allocations[i].bytes},
+                {"per_row", per_row(stats.allocations[i].allocations, rows)}
+            };
+        }
+    }
+
+    return result;
+}
+
+} // namespace telemetry
@@ -0,0 +1,136 @@
+#include "telemetry/trace.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace telemetry {
+
+namespace detail {
+    std::atomic<bool> tracing_enabled{false};
+}
+
+namespace {
+    // Fixed-size ring owned by one writer thread
+    struct ThreadBuffer {
+        std::vector<TraceEvent> events;
+        std::atomic<uint64_t> written{0};
+        uint32_t tid{0};
+    };
+
+    struct Registry {
+        std::mutex mutex;
+        // Buffers outlive their threads so the dump can still read them
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        size_t capacity{1 << 16};
+        int64_t origin_ns{0};
+    };
+
+    Registry& registry() {
+        static Registry instance;
+        return instance;
+    }
+
+    ThreadBuffer* register_thread() {
+        auto& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        auto buffer = std::make_unique<ThreadBuffer>();
+        buffer->events.resize(reg.capacity);
+        buffer->tid = static_cast<uint32_t>(reg.buffers.size() + 1);
+        reg.buffers.push_back(std::move(buffer));
+        return reg.buffers.back().get();
+    }
+
+    void write_escaped(std::ostream& out, const char* text, size_t len) {
+        for (size_t i = 0; i < len; ++i) {
+            char c = text[i];
+            if (c == '"' || c == '\\') {
+                out << '\\' << c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                out << ' ';
+            } else {
+                out << c;
+            }
+        }
+    }
+}
+
+namespace detail {
+    int64_t trace_clock_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void record_span(const char* name, const char* detail, size_t detail_len,
+                     int64_t start_ns, int64_t end_ns) {
+        thread_local ThreadBuffer* buffer = register_thread();
+
+        uint64_t index = buffer->written.load(std::memory_order_relaxed);
+        auto& event = buffer->events[index & (buffer->events.size() - 1)];
+        event.name = name;
+        size_t len = std::min(detail_len, sizeof(event.detail) - 1);
+        if (len > 0) std::memcpy(event.detail, detail, len);
+        event.detail[len] = '\0';
+        event.start_ns = start_ns;
+        event.duration_ns = end_ns - start_ns;
+        buffer->written.store(index + 1, std::memory_order_release);
+    }
+}
+
+void enable_tracing(size_t events_per_thread) {
+    auto& reg = registry();
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        // Round up to a power of two so the ring index is a mask
+        size_t capacity = 1;
+        while (capacity < events_per_thread) capacity <<= 1;
+        reg.capacity = capacity;
+        reg.origin_ns = detail::trace_clock_ns();
+    }
+    detail::tracing_enabled.store(true, std::memory_order_relaxed);
+}
+
+bool write_chrome_trace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,"
+        << "\"args\":{\"name\":\"nebula_mapper\"}}";
+
+    for (const auto& buffer : reg.buffers) {
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+            << ",\"args\":{\"name\":\"worker-" << buffer->tid << "\"}}";
+
+        uint64_t written = buffer->written.load(std::memory_order_acquire);
+        uint64_t capacity = buffer->events.size();
+        uint64_t first = written > capacity ? written - capacity : 0;
+
+        for (uint64_t i = first; i < written; ++i) {
+            const auto& event = buffer->events[i & (capacity - 1)];
+            out << ",\n{\"name\":\"";
+            write_escaped(out, event.name, std::strlen(event.name));
+            out << "\",\"cat\":\"pipeline\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+                << ",\"ts\":" << static_cast<double>(event.start_ns - reg.origin_ns) / 1e3
+                << ",\"dur\":" << static_cast<double>(event.duration_ns) / 1e3;
+            if (event.detail[0] != '\0') {
+                out << ",\"args\":{\"detail\":\"";
+                write_escaped(out, event.detail, std::strlen(event.detail));
+                out << "\"}";
+            }
+            out << '}';
+        }
+    }
+
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+} // namespace telemetry
@@ -1,4 +1,6 @@
 #include "transformer/transform_engine.hpp"
+#include "telemetry/probes.hpp"
+#include "telemetry/stats.hpp"
 #include <regex>
 #include <sstream>
 #include <iomanip>
@@ -29,15 +31,28 @@ Result<TransformValue> TransformEngine::apply_transform(
     const TransformValue& value,
     const std::map<std::string, std::string>& params) {
 
+    telemetry::StageTimer timer(telemetry::Stage::TRANSFORM);
+
     auto it = transforms_.find(name);
     if (it == transforms_.end()) {
+        telemetry::count_transform(name, true);
         return TransformError{
             "Transform not found: " + name,
             std::nullopt,
             std::nullopt
         };
     }
-    return it->second(value, params);
+
+    bool probed = NEBULA_MAPPER_PROBE_ENABLED(transform_applied);
+    int64_t start_ns = probed ? telemetry::probe_clock_ns() : 0;
+    auto result = it->second(value, params);
+    bool failed = std::holds_alternative<TransformError>(result);
+    telemetry::count_transform(name, failed);
+    if (probed) {
+        NEBULA_MAPPER_PROBE3(transform_applied, name.c_str(),
+                             telemetry::probe_clock_ns() - start_ns, failed);
+    }
+    return result;
 }
 
 bool TransformEngine::has_transform(const std::string& name) const {
@@ -73,22 +88,21 @@ namespace detail {
     }
 
     Result<int64_t> parse_price(const std::string& price_str) {
-        try {
-            // Remove currency symbols and separators
-            std::string clean_str;
-            std::copy_if(price_str.begin(), price_str.end(),
-                        std::back_inserter(clean_str),
-                        [](char c) { return std::isdigit(c); });
-
-            return std::stoll(clean_str);
-        }
-        catch (const std::exception& e) {
+        // Remove currency symbols and separators
+        std::string clean_str;
+        std::copy_if(price_str.begin(), price_str.end(),
+                    std::back_inserter(clean_str),
+                    [](char c) { return std::isdigit(static_cast<unsigned char>(c)); });
+
+        auto price = common::numbers::parse_int64(clean_str);
+        if (const auto* error = std::get_if<common::Error>(&price)) {
             return TransformError{
-                "Error parsing price: " + std::string(e.what()),
+                "Error parsing price: " + error->message,
                 price_str,
                 std::nullopt
             };
         }
+        return std::get<int64_t>(price);
     }
 
     Result<std::string> normalize_string(const std::string& input) {
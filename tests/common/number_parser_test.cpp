@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include "common/number_parser.hpp"
+#include "transformer/transform_engine.hpp"
+
+using common::numbers::CoercionMode;
+
+namespace {
+
+// The parsed integer, or the error message
+std::string int64_of(std::string_view text, CoercionMode mode = CoercionMode::STRICT) {
+    auto result = common::numbers::parse_int64(text, mode);
+    if (const auto* error = std::get_if<common::Error>(&result)) return error->message;
+    return std::to_string(std::get<int64_t>(result));
+}
+
+} // namespace
+
+TEST(NumberParserTest, ParsesEightDigitsAtATime) {
+    const char* digits = "12345678";
+    EXPECT_TRUE(common::numbers::detail::is_eight_digits(
+        common::numbers::detail::load_eight(digits)));
+    EXPECT_EQ(common::numbers::detail::parse_eight_digits(
+        common::numbers::detail::load_eight(digits)), 12345678u);
+    EXPECT_FALSE(common::numbers::detail::is_eight_digits(
+        common::numbers::detail::load_eight("1234/678")));
+    EXPECT_FALSE(common::numbers::detail::is_eight_digits(
+        common::numbers::detail::load_eight("1234:678")));
+
+    // Every length around the 8-byte chunks
+    std::string text;
+    uint64_t expected = 0;
+    for (int length = 1; length <= 18; ++length) {
+        text += static_cast<char>('0' + length % 10);
+        expected = expected * 10 + static_cast<uint64_t>(length % 10);
+        EXPECT_EQ(int64_of(text), std::to_string(expected)) << text;
+    }
+}
+
+TEST(NumberParserTest, KeepsInt64Exact) {
+    // Above 2^53, where std::stod rounds
+    EXPECT_EQ(int64_of("9007199254740993"), "9007199254740993");
+    EXPECT_EQ(int64_of("9223372036854775807"), "9223372036854775807");
+    EXPECT_EQ(int64_of("-9223372036854775808"), "-9223372036854775808");
+    EXPECT_EQ(int64_of("0000000000000000000000042", CoercionMode::LENIENT), "42");
+    EXPECT_EQ(int64_of("9223372036854775808"),
+              "'9223372036854775808' is out of range for INT64");
+    EXPECT_EQ(int64_of("-9223372036854775809"),
+              "'-9223372036854775809' is out of range for INT64");
+    EXPECT_EQ(int64_of("123456789012345678901"),
+              "'123456789012345678901' is out of range for INT64");
+}
+
+TEST(NumberParserTest, StrictTakesOnlyJsonIntegers) {
+    for (const char* bad : {"", "-", "+1", " 1", "1 ", "1,000", "12.0", "1e3", "0x1F", "12a",
+                            "007", "-00"}) {
+        EXPECT_EQ(int64_of(bad), "'" + std::string(bad) + "' is not an integer") << bad;
+    }
+    EXPECT_EQ(int64_of("0"), "0");
+    EXPECT_EQ(int64_of("-0"), "0");
+    EXPECT_EQ(int64_of("007", CoercionMode::LENIENT), "7");
+}
+
+TEST(NumberParserTest, LenientAllowsSeparatorsAndPadding) {
+    EXPECT_EQ(int64_of(" +1,234,567 ", CoercionMode::LENIENT), "1234567");
+    EXPECT_EQ(int64_of("1_000", CoercionMode::LENIENT), "1000");
+    EXPECT_EQ(int64_of("-12.000", CoercionMode::LENIENT), "-12");
+    EXPECT_EQ(int64_of("12.5", CoercionMode::LENIENT), "'12.5' is not an integer");
+    EXPECT_EQ(int64_of("1,,000", CoercionMode::LENIENT), "'1,,000' is not an integer");
+    EXPECT_EQ(int64_of(",100", CoercionMode::LENIENT), "',100' is not an integer");
+}
+
+TEST(NumberParserTest, ParsesDoubles) {
+    auto value = [](std::string_view text, CoercionMode mode = CoercionMode::STRICT) {
+        auto result = common::numbers::parse_double(text, mode);
+        if (const auto* error = std::get_if<common::Error>(&result)) return error->message;
+        return std::to_string(std::get<double>(result));
+    };
+    EXPECT_EQ(value("4.25"), "4.250000");
+    EXPECT_EQ(value("-1e3"), "-1000.000000");
+    EXPECT_EQ(value("0.5e-1"), "0.050000");
+    for (const char* bad : {".5", "5.", "-.5", "05.5", "1e", "1e+", "1.e3", "0x1p3", "1E5x"}) {
+        EXPECT_EQ(value(bad), "'" + std::string(bad) + "' is not a number") << bad;
+    }
+    EXPECT_EQ(value(".5", CoercionMode::LENIENT), "0.500000");
+    EXPECT_EQ(value("5.", CoercionMode::LENIENT), "5.000000");
+    EXPECT_EQ(value("inf"), "'inf' is not a number");
+    EXPECT_EQ(value("nan"), "'nan' is not a number");
+    EXPECT_EQ(value("1e999"), "'1e999' is out of range for DOUBLE");
+    EXPECT_EQ(value(" 1,234.5"), "' 1,234.5' is not a number");
+    EXPECT_EQ(value(" 1,234.5", CoercionMode::LENIENT), "1234.500000");
+}
+
+TEST(NumberParserTest, BacksTransformConversions) {
+    transformer::TransformValue id;
+    id.value = std::string("9007199254740993");
+    auto exact = transformer::detail::convert_value<int64_t>(id);
+    ASSERT_TRUE(std::holds_alternative<int64_t>(exact));
+    EXPECT_EQ(std::get<int64_t>(exact), 9007199254740993);
+
+    id.value = std::string("99999999999999999999");
+    auto too_big = transformer::detail::convert_value<int64_t>(id);
+    ASSERT_TRUE(std::holds_alternative<transformer::TransformError>(too_big));
+
+    // The property's coerce mode reaches the conversion
+    id.value = std::string("1,234");
+    ASSERT_TRUE(std::holds_alternative<transformer::TransformError>(
+        transformer::detail::convert_value<int64_t>(id)));
+    id.coerce = CoercionMode::LENIENT;
+    auto lenient = transformer::detail::convert_value<int64_t>(id);
+    ASSERT_TRUE(std::holds_alternative<int64_t>(lenient));
+    EXPECT_EQ(std::get<int64_t>(lenient), 1234);
+
+    auto price = transformer::detail::parse_price("\xe2\x82\xa9" "12,000");
+    EXPECT_EQ(std::get<int64_t>(price), 12000);
+    auto huge = transformer::detail::parse_price("99999999999999999999 won");
+    ASSERT_TRUE(std::holds_alternative<transformer::TransformError>(huge));
+    EXPECT_NE(std::get<transformer::TransformError>(huge).message.find("out of range"),
+              std::string::npos);
+}
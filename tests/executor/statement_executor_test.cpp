@@ -0,0 +1,241 @@
+#include <gtest/gtest.h>
+#include "executor/statement_executor.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+// Minimal statement gateway speaking the line protocol of tcp_line_transport
+class MockServer {
+public:
+    explicit MockServer(std::chrono::milliseconds delay = std::chrono::milliseconds(0))
+        : delay_(delay) {
+        fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        ::setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        ::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        ::listen(fd_, 64);
+
+        socklen_t len = sizeof(addr);
+        ::getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+
+        thread_ = std::thread([this] { serve(); });
+    }
+
+    ~MockServer() {
+        stop_ = true;
+        thread_.join();
+        for (auto& client : clients_) {
+            client.join();
+        }
+        ::close(fd_);
+    }
+
+    executor::Endpoint endpoint() const { return {"127.0.0.1", port_}; }
+    size_t handled() const { return handled_.load(); }
+    void set_delay(std::chrono::milliseconds delay) { delay_ = delay; }
+    void set_reject(bool reject) { reject_ = reject; }
+    std::string last_request() const {
+        std::lock_guard<std::mutex> lock(request_mutex_);
+        return last_request_;
+    }
+
+private:
+    void serve() {
+        while (!stop_) {
+            pollfd pfd{fd_, POLLIN, 0};
+            if (::poll(&pfd, 1, 20) <= 0) continue;
+
+            int client = ::accept(fd_, nullptr, nullptr);
+            if (client < 0) continue;
+
+            clients_.emplace_back([this, client] {
+                std::string request;
+                char buffer[4096];
+                while (request.find('\n') == std::string::npos) {
+                    ssize_t n = ::recv(client, buffer, sizeof(buffer), 0);
+                    if (n <= 0) break;
+                    request.append(buffer, static_cast<size_t>(n));
+                }
+                std::this_thread::sleep_for(delay_.load());
+                ++handled_;
+                {
+                    std::lock_guard<std::mutex> lock(request_mutex_);
+                    last_request_ = request.substr(0, request.find('\n'));
+                }
+                if (reject_) {
+                    ::send(client, "ERR SemanticError\n", 18, MSG_NOSIGNAL);
+                } else {
+                    ::send(client, "OK\n", 3, MSG_NOSIGNAL);
+                }
+                ::close(client);
+            });
+        }
+    }
+
+    int fd_{-1};
+    uint16_t port_{0};
+    std::atomic<std::chrono::milliseconds> delay_;
+    std::atomic<bool> reject_{false};
+    std::atomic<bool> stop_{false};
+    std::atomic<size_t> handled_{0};
+    std::thread thread_;
+    std::vector<std::thread> clients_;  // Only touched by the accept thread
+    mutable std::mutex request_mutex_;
+    std::string last_request_;
+};
+
+std::vector<std::string> make_statements(size_t count) {
+    std::vector<std::string> statements;
+    for (size_t i = 0; i < count; ++i) {
+        statements.push_back("INSERT VERTEX Place (cid) VALUES \"" +
+                             std::to_string(i) + "\":(" + std::to_string(i) + ");");
+    }
+    return statements;
+}
+
+TEST(EndpointParsingTest, ParsesEndpointList) {
+    auto result = executor::parse_endpoints("gw1:8000,gw2:8001");
+    ASSERT_TRUE(std::holds_alternative<std::vector<executor::Endpoint>>(result));
+    const auto& endpoints = std::get<std::vector<executor::Endpoint>>(result);
+    ASSERT_EQ(endpoints.size(), 2u);
+    EXPECT_EQ(endpoints[0].host, "gw1");
+    EXPECT_EQ(endpoints[1].port, 8001);
+
+    EXPECT_TRUE(std::holds_alternative<executor::Error>(
+        executor::parse_endpoints("gw1:notaport")));
+    EXPECT_TRUE(std::holds_alternative<executor::Error>(executor::parse_endpoints("gw1")));
+}
+
+TEST(StatementExecutorTest, SpreadsBatchesAcrossEndpoints) {
+    MockServer a, b, c;
+    executor::ExecutorOptions options;
+    options.concurrency = 6;
+    options.request_timeout = std::chrono::milliseconds(2000);
+
+    executor::StatementExecutor exec({a.endpoint(), b.endpoint(), c.endpoint()}, options);
+    auto summary = exec.execute(make_statements(90));
+
+    EXPECT_EQ(summary.executed, 90u);
+    EXPECT_EQ(summary.failed, 0u);
+    EXPECT_EQ(a.handled() + b.handled() + c.handled(), 90u);
+    EXPECT_GT(a.handled(), 0u);
+    EXPECT_GT(b.handled(), 0u);
+    EXPECT_GT(c.handled(), 0u);
+
+    ASSERT_EQ(summary.endpoints.size(), 3u);
+    for (const auto& ep : summary.endpoints) {
+        EXPECT_EQ(ep.health, executor::Health::HEALTHY);
+        EXPECT_EQ(ep.outstanding, 0u);
+        EXPECT_GT(ep.avg_latency_ms, 0.0);
+    }
+}
+
+TEST(StatementExecutorTest, PrefersLessLoadedEndpoint) {
+    MockServer fast;
+    MockServer slow(std::chrono::milliseconds(100));
+    executor::ExecutorOptions options;
+    options.concurrency = 4;
+    options.request_timeout = std::chrono::milliseconds(2000);
+
+    executor::StatementExecutor exec({slow.endpoint(), fast.endpoint()}, options);
+    auto summary = exec.execute(make_statements(40));
+
+    EXPECT_EQ(summary.executed, 40u);
+    EXPECT_GT(fast.handled(), slow.handled());
+}
+
+TEST(StatementExecutorTest, EjectsTimedOutEndpointAndReprobes) {
+    MockServer healthy;
+    MockServer stalled(std::chrono::milliseconds(1000));
+    executor::ExecutorOptions options;
+    options.concurrency = 2;
+    options.request_timeout = std::chrono::milliseconds(100);
+    options.health.eject_duration = std::chrono::milliseconds(300);
+    options.retry_timeouts = true;
+
+    executor::StatementExecutor exec({stalled.endpoint(), healthy.endpoint()}, options);
+    auto summary = exec.execute(make_statements(20));
+
+    // With retry_timeouts, timed out statements are retried on the healthy endpoint
+    EXPECT_EQ(summary.executed, 20u);
+    EXPECT_EQ(summary.endpoints[0].health, executor::Health::EJECTED);
+    EXPECT_GE(summary.endpoints[0].ejections, 1u);
+    EXPECT_GE(summary.endpoints[0].timeouts, 1u);
+
+    // Once the endpoint recovers, it is re-admitted after the ejection window
+    stalled.set_delay(std::chrono::milliseconds(0));
+    std::this_thread::sleep_for(std::chrono::milliseconds(700));
+    summary = exec.execute(make_statements(20));
+    EXPECT_EQ(summary.executed, 20u);
+    EXPECT_EQ(summary.endpoints[0].health, executor::Health::HEALTHY);
+    EXPECT_GT(summary.endpoints[0].statements, 0u);
+}
+
+TEST(StatementExecutorTest, RetriesOnlyUnsentStatements) {
+    MockServer rejecting, stalled(std::chrono::milliseconds(300)), healthy;
+    rejecting.set_reject(true);
+    executor::ExecutorOptions options;
+    options.concurrency = 1;
+    options.request_timeout = std::chrono::milliseconds(100);
+    options.space = "places";
+
+    // A rejection is final
+    executor::StatementExecutor rejected({rejecting.endpoint(), healthy.endpoint()}, options);
+    auto summary = rejected.execute(make_statements(1));
+    EXPECT_EQ(summary.failed, 1u);
+    EXPECT_NE(summary.errors[0].find("SemanticError"), std::string::npos);
+    EXPECT_EQ(rejecting.handled() + healthy.handled(), 1u);
+
+    // So is a timeout once the statement was sent, as it may have run
+    executor::StatementExecutor timed_out({stalled.endpoint()}, options);
+    summary = timed_out.execute(make_statements(1));
+    EXPECT_EQ(summary.failed, 1u);
+    std::this_thread::sleep_for(std::chrono::milliseconds(400));
+    EXPECT_EQ(stalled.handled(), 1u);
+
+    // A statement that never left goes to the next endpoint
+    uint16_t closed;
+    {
+        MockServer temp;
+        closed = temp.endpoint().port;
+    }
+    executor::StatementExecutor unsent({{"127.0.0.1", closed}, healthy.endpoint()}, options);
+    summary = unsent.execute(make_statements(4));
+    EXPECT_EQ(summary.executed, 4u);
+    EXPECT_EQ(healthy.last_request(),
+              "USE `places`; INSERT VERTEX Place (cid) VALUES \"3\":(3);");
+}
+
+TEST(StatementExecutorTest, FailsWhenNoEndpointReachable) {
+    // Grab a free port, then close it so nothing listens there
+    uint16_t port;
+    {
+        MockServer temp;
+        port = temp.endpoint().port;
+    }
+
+    executor::ExecutorOptions options;
+    options.request_timeout = std::chrono::milliseconds(100);
+    options.unavailable_timeout = std::chrono::milliseconds(300);
+    options.max_retries = 1;
+
+    executor::StatementExecutor exec({{"127.0.0.1", port}}, options);
+    auto summary = exec.execute(make_statements(2));
+    EXPECT_EQ(summary.executed, 0u);
+    EXPECT_EQ(summary.failed, 2u);
+}
+
+} // namespace
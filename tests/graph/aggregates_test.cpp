@@ -0,0 +1,328 @@
+#include <gtest/gtest.h>
+#include "graph/aggregates.hpp"
+#include "graph/codegen.hpp"
+#include "graph/pipeline.hpp"
+#include "graph/schema_manager.hpp"
+#include "parser/yaml_parser.hpp"
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using parser::json::JsonDocument;
+
+namespace {
+
+parser::mapping::Result<parser::mapping::GraphMapping> mapping_with(
+    const std::string& aggregates) {
+    return parser::mapping::create_mapping(parser::yaml::parse(R"(
+tags:
+  Place:
+    from: basicInfo
+    key: cid
+    properties:
+      - json: cid
+        type: INT64
+    aggregates:
+)" + aggregates));
+}
+
+// Place with comment_count, avg_point and last_comment_date, and User with
+// its out-degree over the comments it wrote
+const char* const KAKAO_AGGREGATES = R"(
+tags:
+  Place:
+    from: basicInfo
+    key: cid
+    properties:
+      - json: cid
+        type: INT64
+    aggregates:
+      - name: comment_count
+        op: count
+        over: comment/list
+      - name: avg_point
+        op: avg
+        over: comment/list
+        json: point
+      - name: last_comment_date
+        op: max
+        over: comment/list
+        json: date
+        type: STRING
+  User:
+    from: comment/list
+    key: kakaoMapUserId
+    properties:
+      - json: username
+        type: STRING
+    aggregates:
+      - name: out_degree
+        op: count
+        over: comment/list
+        key: kakaoMapUserId
+        emit: %EMIT%
+)";
+
+parser::mapping::GraphMapping kakao_mapping(const std::string& emit) {
+    std::string yaml = KAKAO_AGGREGATES;
+    yaml.replace(yaml.find("%EMIT%"), 6, emit);
+    return std::get<parser::mapping::GraphMapping>(
+        parser::mapping::create_mapping(parser::yaml::parse(yaml)));
+}
+
+JsonDocument comment(const std::string& user, int point, const std::string& date) {
+    return {{"kakaoMapUserId", user}, {"username", "user " + user},
+            {"point", point}, {"date", date}};
+}
+
+JsonDocument place(int cid, std::vector<JsonDocument> comments) {
+    return {{"basicInfo", {{"cid", cid}}}, {"comment", {{"list", comments}}}};
+}
+
+std::vector<std::string> statements_of(const parser::mapping::GraphMapping& mapping,
+                                       const JsonDocument& data) {
+    graph::StatementGenerator generator;
+    auto statements = generator.generate_batch_statements(mapping, data);
+    if (std::holds_alternative<graph::StatementError>(statements)) {
+        ADD_FAILURE() << std::get<graph::StatementError>(statements).message;
+        return {};
+    }
+    return std::get<std::vector<std::string>>(statements);
+}
+
+class CollectingSink : public graph::StatementSink {
+public:
+    void consume(std::vector<std::string>&& statements) override {
+        for (auto& stmt : statements) {
+            statements_.push_back(std::move(stmt));
+        }
+    }
+
+    std::vector<std::string> statements_;
+};
+
+} // namespace
+
+TEST(AggregatesTest, HyperLogLogIsExactWhileSparse) {
+    graph::HyperLogLog small;
+    for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < 500; ++i) {
+            small.add(graph::hash_value(JsonDocument(i)));
+        }
+    }
+    EXPECT_EQ(small.estimate(), 500u);
+
+    // 1 and 1.0 are one value, "1" another
+    graph::HyperLogLog mixed;
+    mixed.add(graph::hash_value(JsonDocument(1)));
+    mixed.add(graph::hash_value(JsonDocument(1.0)));
+    mixed.add(graph::hash_value(JsonDocument("1")));
+    EXPECT_EQ(mixed.estimate(), 2u);
+
+    graph::HyperLogLog low, high, all;
+    for (int i = 0; i < 100000; ++i) {
+        auto hash = graph::hash_value(JsonDocument("user" + std::to_string(i)));
+        (i < 60000 ? low : high).add(hash);
+        all.add(hash);
+    }
+    EXPECT_NEAR(static_cast<double>(all.estimate()), 100000.0, 100000 * 0.05);
+    low.merge(high);
+    EXPECT_EQ(low.estimate(), all.estimate());
+    small.merge(all);
+    EXPECT_NEAR(static_cast<double>(small.estimate()), 100500.0, 100500 * 0.05);
+}
+
+TEST(AggregatesTest, RowsCarryAggregatesOverTheDocument) {
+    auto mapping = kakao_mapping("row");
+    auto data = place(7, {comment("a", 5, "2024.08.27."), comment("b", 2, "2024.10.19."),
+                          comment("a", 4, "2024.09.25.")});
+
+    auto statements = statements_of(mapping, data);
+    ASSERT_EQ(statements.size(), 2u);
+    EXPECT_EQ(statements[0], "INSERT VERTEX Place (cid, comment_count, avg_point, "
+                             "last_comment_date) VALUES \"7\":(7, 3, 3.6666666666666665, "
+                             "\"2024.10.19.\");");
+    EXPECT_EQ(statements[1], "INSERT VERTEX User (username, out_degree) VALUES "
+                             "\"a\":(\"user a\", 2), \"b\":(\"user b\", 1), "
+                             "\"a\":(\"user a\", 2);");
+
+    // No comments: a count of 0, NULL for the rest
+    statements = statements_of(mapping, place(8, {}));
+    ASSERT_EQ(statements.size(), 1u);
+    EXPECT_EQ(statements[0], "INSERT VERTEX Place (cid, comment_count, avg_point, "
+                             "last_comment_date) VALUES \"8\":(8, 0, NULL, NULL);");
+
+    data["comment"]["list"][1]["point"] = "many";
+    graph::StatementGenerator generator;
+    auto bad = generator.generate_batch_statements(mapping, data);
+    ASSERT_TRUE(std::holds_alternative<graph::StatementError>(bad));
+    EXPECT_NE(std::get<graph::StatementError>(bad).message.find("many"), std::string::npos);
+
+    // A generator that outlives a change to the mapping reads the new paths
+    data["comment"]["list"][1]["point"] = 2;
+    ASSERT_TRUE(std::holds_alternative<std::vector<std::string>>(
+        generator.generate_batch_statements(mapping, data)));
+    auto& avg_point = mapping.vertices[0].aggregates[1];
+    ASSERT_EQ(avg_point.name, "avg_point");
+    avg_point.json_path = "rating";
+    auto changed = generator.generate_batch_statements(mapping, data);
+    ASSERT_TRUE(std::holds_alternative<std::vector<std::string>>(changed));
+    EXPECT_EQ(std::get<std::vector<std::string>>(changed).at(0),
+              "INSERT VERTEX Place (cid, comment_count, avg_point, "
+              "last_comment_date) VALUES \"7\":(7, 3, NULL, \"2024.10.19.\");");
+}
+
+TEST(AggregatesTest, UpdatesFoldEveryRecord) {
+    auto mapping = kakao_mapping("update");
+    auto input = place(1, {comment("a", 5, "2024.01.01."), comment("b", 3, "2024.01.02.")})
+                     .dump() + "\n" +
+                 place(2, {comment("a", 4, "2024.02.01."), comment("a", 1, "2024.02.02.")})
+                     .dump() + "\n";
+    auto path = fs::temp_directory_path() /
+                ("nebula_mapper_aggregates_" + std::to_string(::getpid()) + ".ndjson");
+    std::ofstream(path, std::ios::binary) << input;
+
+    for (size_t threads : {1, 3}) {
+        auto reader = parser::json::open_records(path.string());
+        ASSERT_TRUE(std::holds_alternative<std::unique_ptr<parser::json::RecordReader>>(reader));
+        CollectingSink sink;
+        graph::PipelineOptions options;
+        options.threads = threads;
+        auto summary = graph::run_pipeline(
+            mapping, *std::get<std::unique_ptr<parser::json::RecordReader>>(reader), sink,
+            options);
+        ASSERT_TRUE(std::holds_alternative<graph::PipelineSummary>(summary));
+        EXPECT_EQ(std::get<graph::PipelineSummary>(summary).records, 2u);
+        ASSERT_EQ(sink.statements_.size(), 6u) << threads;
+        EXPECT_EQ(sink.statements_[1],
+                  "INSERT VERTEX User (username) VALUES \"a\":(\"user a\"), "
+                  "\"b\":(\"user b\");");
+        EXPECT_EQ(sink.statements_[4], "UPDATE VERTEX ON User \"a\" SET out_degree = 3;");
+        EXPECT_EQ(sink.statements_[5], "UPDATE VERTEX ON User \"b\" SET out_degree = 1;");
+
+        // Or apart from the INSERTs, for the executor to run after them
+        reader = parser::json::open_records(path.string());
+        CollectingSink inserts, updates;
+        options.update_sink = &updates;
+        summary = graph::run_pipeline(
+            mapping, *std::get<std::unique_ptr<parser::json::RecordReader>>(reader), inserts,
+            options);
+        ASSERT_TRUE(std::holds_alternative<graph::PipelineSummary>(summary));
+        EXPECT_EQ(std::get<graph::PipelineSummary>(summary).statements, 6u);
+        EXPECT_EQ(inserts.statements_.size(), 4u);
+        EXPECT_EQ(updates.statements_,
+                  std::vector<std::string>(sink.statements_.begin() + 4, sink.statements_.end()));
+    }
+    fs::remove(path);
+}
+
+TEST(AggregatesTest, UpdateStateIsChargedToTheBudget) {
+    auto mapping = kakao_mapping("update");
+    const auto& user = mapping.vertices[1];
+    ASSERT_EQ(user.tag_name, "User");
+    const JsonDocument value = 1;
+    graph::Accumulator one(user.aggregates[0].op);
+    ASSERT_TRUE(std::holds_alternative<bool>(one.add(&value, "kakaoMapUserId")));
+
+    graph::MemoryBudget budget(1 << 20);
+    auto charged = [&] {
+        return budget.snapshot().consumers[static_cast<size_t>(
+            graph::MemoryConsumer::AGGREGATES)].current;
+    };
+    {
+        graph::AggregateTable table;
+        table.merge(user, "\"a\"", {&one});
+        const auto bytes = table.bytes();
+        EXPECT_GT(bytes, 0u);
+        table.set_budget(&budget);
+        EXPECT_EQ(charged(), bytes);
+
+        // Folding into a known VID adds nothing, a new VID its state
+        table.merge(user, "\"a\"", {&one});
+        EXPECT_EQ(table.bytes(), bytes);
+        graph::AggregateTable other;
+        other.set_budget(&budget);
+        other.merge(user, "\"b\"", {&one});
+        table.merge(std::move(other));
+        EXPECT_EQ(other.bytes(), 0u);
+        EXPECT_GT(table.bytes(), bytes);
+        EXPECT_EQ(charged(), table.bytes());
+
+        auto updates = table.update_statements(mapping);
+        ASSERT_TRUE(std::holds_alternative<std::vector<std::string>>(updates));
+        EXPECT_EQ(std::get<std::vector<std::string>>(updates).size(), 2u);
+        EXPECT_EQ(charged(), 0u);
+        table.merge(user, "\"c\"", {&one});
+    }
+    EXPECT_EQ(budget.used(), 0u);
+
+    // A run reports the state to the budget until the updates are made
+    auto path = fs::temp_directory_path() /
+                ("nebula_mapper_aggregates_budget_" + std::to_string(::getpid()) + ".ndjson");
+    std::ofstream(path, std::ios::binary)
+        << place(1, {comment("a", 5, "2024.01.01."), comment("b", 3, "2024.01.02.")}).dump()
+        << "\n";
+    for (size_t threads : {1, 2}) {
+        auto reader = parser::json::open_records(path.string());
+        CollectingSink sink;
+        graph::PipelineOptions options;
+        options.threads = threads;
+        options.memory = &budget;
+        auto summary = graph::run_pipeline(
+            mapping, *std::get<std::unique_ptr<parser::json::RecordReader>>(reader), sink,
+            options);
+        ASSERT_TRUE(std::holds_alternative<graph::PipelineSummary>(summary));
+        EXPECT_GT(budget.snapshot().consumers[static_cast<size_t>(
+            graph::MemoryConsumer::AGGREGATES)].peak, 0u);
+        EXPECT_EQ(budget.used(), 0u);
+    }
+    fs::remove(path);
+}
+
+TEST(AggregatesTest, RefusesResultsPastDouble) {
+    auto mapping = std::get<parser::mapping::GraphMapping>(mapping_with(
+        "      - {name: total, op: sum, over: list, json: x, type: DOUBLE}\n"));
+    JsonDocument data = {{"basicInfo", {{"cid", 1}}},
+                         {"list", {{{"x", 1e308}}, {{"x", 1.5e308}}}}};
+
+    graph::StatementGenerator generator;
+    auto statements = generator.generate_batch_statements(mapping, data);
+    ASSERT_TRUE(std::holds_alternative<graph::StatementError>(statements));
+    const auto& error = std::get<graph::StatementError>(statements);
+    EXPECT_EQ(error.message, "Aggregate result overflows DOUBLE");
+    EXPECT_EQ(error.json_path, "list/x");
+
+    data["list"][1]["x"] = -1e308;
+    EXPECT_NE(statements_of(mapping, data).at(0).find("(1, 0)"), std::string::npos);
+}
+
+TEST(AggregatesTest, ChecksDeclarations) {
+    auto message = [](const std::string& aggregates) {
+        auto mapping = mapping_with(aggregates);
+        if (!std::holds_alternative<parser::mapping::Error>(mapping)) return std::string();
+        return std::get<parser::mapping::Error>(mapping).message;
+    };
+    EXPECT_EQ(message("      - {name: n, op: distinct, over: list, json: user}\n"), "");
+    EXPECT_NE(message("      - {name: n, op: median, over: list, json: x}\n")
+                  .find("Unknown aggregate op 'median'"), std::string::npos);
+    EXPECT_NE(message("      - {name: n, op: sum, over: list}\n")
+                  .find("needs a json path"), std::string::npos);
+    EXPECT_NE(message("      - {name: n, op: count, over: list, emit: later}\n")
+                  .find("expected row or update"), std::string::npos);
+    EXPECT_NE(message("      - {name: cid, op: count, over: list}\n")
+                  .find("name of a property"), std::string::npos);
+    EXPECT_NE(message("      - {name: n, op: count}\n").find("needs name, op and over"),
+              std::string::npos);
+
+    auto mapping = kakao_mapping("update");
+    graph::SchemaManager schema;
+    auto statements = schema.generate_schema_statements(mapping);
+    ASSERT_TRUE(std::holds_alternative<std::vector<std::string>>(statements));
+    const auto& place_tag = std::get<std::vector<std::string>>(statements).at(0);
+    EXPECT_NE(place_tag.find("comment_count INT64,"), std::string::npos);
+    EXPECT_NE(place_tag.find("avg_point DOUBLE,"), std::string::npos);
+
+    EXPECT_TRUE(std::holds_alternative<graph::StatementError>(
+        graph::generate_extractor_source(mapping, "0")));
+}
@@ -0,0 +1,289 @@
+#include <gtest/gtest.h>
+#include "graph/codegen.hpp"
+#include "graph/compiled_mapping.hpp"
+#include "graph/pipeline.hpp"
+#include "parser/yaml_parser.hpp"
+#include "telemetry/stats.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using parser::json::JsonDocument;
+
+namespace {
+
+const char* MAPPING_YAML = R"(
+tags:
+  Place:
+    from: basicInfo
+    key: cid
+    properties:
+      - json: cid
+        type: INT64
+      - json: placenamefull
+        type: STRING
+      - json: rating
+        type: DOUBLE
+      - json: open
+        type: BOOL
+  User:
+    from: comment/list
+    key: userId
+    properties:
+      - json: username
+        type: STRING
+edges:
+  Wrote:
+    from: comment/list
+    source_tag: User
+    target_tag: Place
+    source_key: userId
+    target_key: commentid
+    properties:
+      - json: point
+        type: INT64
+)";
+
+parser::mapping::GraphMapping load_mapping(const std::string& yaml) {
+    return std::get<parser::mapping::GraphMapping>(
+        parser::mapping::create_mapping(parser::yaml::parse(yaml)));
+}
+
+JsonDocument place(int cid, int comments) {
+    JsonDocument list = JsonDocument::array();
+    for (int i = 0; i < comments; ++i) {
+        list.push_back({{"userId", "u" + std::to_string(i % 3)},
+                        {"commentid", 100 * cid + i},
+                        {"username", "name \"" + std::to_string(i) + "\"\n"},
+                        {"point", i % 5}});
+    }
+    return {{"basicInfo", {{"cid", cid},
+                           {"placenamefull", "Caf\xc3\xa9 " + std::to_string(cid)},
+                           {"rating", cid / 3.0},
+                           {"open", cid % 2 == 0}}},
+            {"comment", {{"list", list}}}};
+}
+
+class CodegenTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = fs::temp_directory_path() /
+               ("nebula_mapper_codegen_" + std::to_string(::getpid()));
+        fs::create_directories(dir_);
+    }
+
+    void TearDown() override {
+        fs::remove_all(dir_);
+    }
+
+    // Generate and build an extractor for `yaml`; empty on failure
+    std::string build(const std::string& yaml) {
+        auto source = graph::generate_extractor_source(load_mapping(yaml),
+                                                       graph::mapping_hash(yaml), "test.yaml");
+        if (!std::holds_alternative<std::string>(source)) return "";
+        auto cpp = dir_ / "extractor.cpp";
+        auto library = dir_ / "extractor.so";
+        std::ofstream(cpp, std::ios::binary) << std::get<std::string>(source);
+
+        std::string command = std::string(NEBULA_MAPPER_CXX_COMPILER) +
+            " -std=c++17 -shared -fPIC -Wall -Wextra -Werror -I" + NEBULA_MAPPER_JSON_INCLUDE +
+            " " + cpp.string() + " -o " + library.string();
+        return std::system(command.c_str()) == 0 ? library.string() : "";
+    }
+
+    fs::path dir_;
+};
+
+std::string join_lines(const std::vector<std::string>& statements) {
+    std::string joined;
+    for (const auto& statement : statements) {
+        joined += statement + "\n";
+    }
+    return joined;
+}
+
+} // namespace
+
+TEST(CodegenSourceTest, HashesTheExactText) {
+    EXPECT_EQ(graph::mapping_hash(""), "cbf29ce484222325");
+    EXPECT_EQ(graph::mapping_hash(MAPPING_YAML), graph::mapping_hash(MAPPING_YAML));
+    EXPECT_NE(graph::mapping_hash(MAPPING_YAML),
+              graph::mapping_hash(std::string(MAPPING_YAML) + "\n"));
+}
+
+TEST(CodegenSourceTest, EmitsPathsAndPrefixesAsConstants) {
+    auto source = graph::generate_extractor_source(load_mapping(MAPPING_YAML), "0123abcd");
+    ASSERT_TRUE(std::holds_alternative<std::string>(source));
+    const auto& text = std::get<std::string>(source);
+    EXPECT_NE(text.find(R"("INSERT VERTEX Place (cid, open, placenamefull, rating) VALUES ")"),
+              std::string::npos) << text;
+    EXPECT_NE(text.find(R"("INSERT EDGE Wrote (point) VALUES ")"), std::string::npos);
+    EXPECT_NE(text.find(R"(key(key(doc, "comment"), "list"))"), std::string::npos);
+    EXPECT_NE(text.find("append_double(values, key(item, \"rating\"))"), std::string::npos);
+    EXPECT_NE(text.find("return \"0123abcd\";"), std::string::npos);
+}
+
+TEST(CodegenSourceTest, RefusesTransforms) {
+    auto mapping = load_mapping(MAPPING_YAML);
+    mapping.vertices[0].properties[0].transform = parser::mapping::Transform{"to_boolean", {}};
+    auto source = graph::generate_extractor_source(mapping, "0");
+    ASSERT_TRUE(std::holds_alternative<graph::StatementError>(source));
+    EXPECT_NE(std::get<graph::StatementError>(source).message.find("to_boolean"),
+              std::string::npos);
+
+    mapping = load_mapping(MAPPING_YAML);
+    mapping.vertices[0].properties[0].nebula_type = "INT16";
+    source = graph::generate_extractor_source(mapping, "0");
+    ASSERT_TRUE(std::holds_alternative<graph::StatementError>(source));
+    EXPECT_NE(std::get<graph::StatementError>(source).message.find("Type 'INT16'"),
+              std::string::npos);
+
+    // Types the build cannot parse are not read as strings
+    mapping = load_mapping(MAPPING_YAML);
+    mapping.vertices[0].properties[0].nebula_type = "BLOB";
+    source = graph::generate_extractor_source(mapping, "0");
+    ASSERT_TRUE(std::holds_alternative<graph::StatementError>(source));
+    EXPECT_NE(std::get<graph::StatementError>(source).message.find("Type 'BLOB'"),
+              std::string::npos);
+
+    // Points are projected from two paths, which the helpers cannot do
+    mapping = load_mapping(MAPPING_YAML);
+    auto& point = mapping.vertices[0].properties[0];
+    point.nebula_type = "GEOGRAPHY(POINT)";
+    point.geo = parser::mapping::GeoPoint{"wpointx", "wpointy",
+                                          parser::mapping::Projection::WCONGNAMUL};
+    source = graph::generate_extractor_source(mapping, "0");
+    ASSERT_TRUE(std::holds_alternative<graph::StatementError>(source));
+    EXPECT_NE(std::get<graph::StatementError>(source).message.find("Point property"),
+              std::string::npos);
+}
+
+TEST_F(CodegenTest, MatchesTheInterpreterAndHandsBackErrors) {
+    auto library = build(MAPPING_YAML);
+    ASSERT_FALSE(library.empty());
+    auto loaded = graph::CompiledMapping::load(library, MAPPING_YAML);
+    ASSERT_TRUE(std::holds_alternative<std::unique_ptr<graph::CompiledMapping>>(loaded))
+        << std::get<graph::StatementError>(loaded).message;
+    const auto& extractor = *std::get<std::unique_ptr<graph::CompiledMapping>>(loaded);
+
+    auto mapping = load_mapping(MAPPING_YAML);
+    graph::StatementGenerator generator;
+    for (int cid = 0; cid < 20; ++cid) {
+        for (size_t batch_size : {0, 1, 4, 500}) {
+            auto document = place(cid, cid % 7);
+            uint64_t rows = 0;
+            auto compiled = extractor.generate(document, batch_size, rows);
+            ASSERT_TRUE(compiled);
+            uint64_t rows_before = generator.rows_generated();
+            auto expected = generator.generate_batch_statements(mapping, document, batch_size);
+            EXPECT_EQ(*compiled, std::get<std::vector<std::string>>(expected));
+            EXPECT_EQ(rows, generator.rows_generated() - rows_before);
+        }
+    }
+
+    // Control bytes escape alike
+    auto document = place(1, 2);
+    document["basicInfo"]["placenamefull"] = "q\" b\\ \n\b\f\x01\x7f";
+    uint64_t rows = 0;
+    auto compiled = extractor.generate(document, 500, rows);
+    ASSERT_TRUE(compiled);
+    EXPECT_EQ(*compiled, std::get<std::vector<std::string>>(
+                             generator.generate_batch_statements(mapping, document, 500)));
+
+    // Nulls render; wrong types, null ids and missing paths go back
+    document["basicInfo"]["placenamefull"] = nullptr;
+    EXPECT_TRUE(extractor.generate(document, 500, rows));
+    for (auto broken : {JsonDocument{{"cid", "1"}}, JsonDocument{{"cid", nullptr}},
+                        JsonDocument{{"rating", "high"}}, JsonDocument{{"open", 1}}}) {
+        document = place(1, 2);
+        document["basicInfo"].update(broken);
+        EXPECT_FALSE(extractor.generate(document, 500, rows)) << broken.dump();
+    }
+    document = place(1, 2);
+    document["comment"]["list"][1].erase("point");
+    EXPECT_FALSE(extractor.generate(document, 500, rows));
+    EXPECT_EQ(extractor.interpreted_records(), 5u);
+}
+
+TEST_F(CodegenTest, RefusesAnotherMapping) {
+    auto library = build(MAPPING_YAML);
+    ASSERT_FALSE(library.empty());
+    auto loaded = graph::CompiledMapping::load(library, std::string(MAPPING_YAML) + "# edited\n");
+    ASSERT_TRUE(std::holds_alternative<graph::StatementError>(loaded));
+    EXPECT_NE(std::get<graph::StatementError>(loaded).message.find("different mapping"),
+              std::string::npos);
+
+    loaded = graph::CompiledMapping::load((dir_ / "missing.so").string(), MAPPING_YAML);
+    EXPECT_TRUE(std::holds_alternative<graph::StatementError>(loaded));
+}
+
+TEST_F(CodegenTest, PipelineMatchesTheInterpreter) {
+    auto library = build(MAPPING_YAML);
+    ASSERT_FALSE(library.empty());
+    auto extractor = std::move(std::get<std::unique_ptr<graph::CompiledMapping>>(
+        graph::CompiledMapping::load(library, MAPPING_YAML)));
+    auto mapping = load_mapping(MAPPING_YAML);
+
+    auto run = [&](const std::string& input, const graph::CompiledMapping* compiled,
+                   size_t threads, telemetry::ProgressCounters& progress) {
+        auto path = dir_ / "input.ndjson";
+        std::ofstream(path, std::ios::binary) << input;
+        graph::PipelineOptions options;
+        options.threads = threads;
+        options.batch_size = 2;
+        options.compiled = compiled;
+        options.progress = &progress;
+        auto reader = std::get<std::unique_ptr<parser::json::RecordReader>>(
+            parser::json::open_records(path.string()));
+        graph::VectorSink sink;
+        auto result = graph::run_pipeline(mapping, *reader, sink, options);
+        if (std::holds_alternative<graph::StatementError>(result)) {
+            return std::get<graph::StatementError>(result).message;
+        }
+        return join_lines(sink.statements());
+    };
+
+    std::string input;
+    for (int cid = 0; cid < 6; ++cid) {
+        input += place(cid, 3).dump() + "\n";
+    }
+    // Per-mapping counters come out the same on both paths
+    telemetry::reset_stats();
+    telemetry::enable_stats();
+    telemetry::ProgressCounters interpreted;
+    auto expected = run(input, nullptr, 1, interpreted);
+    auto expected_stats = telemetry::collect_stats().mappings;
+    for (size_t threads : {1, 3}) {
+        telemetry::reset_stats();
+        telemetry::ProgressCounters progress;
+        EXPECT_EQ(run(input, extractor.get(), threads, progress), expected);
+        EXPECT_EQ(progress.rows, interpreted.rows);
+
+        auto stats = telemetry::collect_stats().mappings;
+        ASSERT_EQ(stats.size(), 3u);
+        for (const auto& [name, counters] : expected_stats) {
+            const auto& compiled = stats[name];
+            EXPECT_EQ(compiled.rows, counters.rows) << name;
+            EXPECT_EQ(compiled.bytes, counters.bytes) << name;
+            EXPECT_EQ(compiled.statements, counters.statements) << name;
+            EXPECT_EQ(compiled.statement_bytes, counters.statement_bytes) << name;
+            EXPECT_EQ(compiled.row_sizes.buckets(), counters.row_sizes.buckets()) << name;
+            EXPECT_EQ(compiled.batch_rows.buckets(), counters.batch_rows.buckets()) << name;
+            EXPECT_EQ(compiled.batch_closes, counters.batch_closes) << name;
+        }
+    }
+    telemetry::enable_stats(false);
+    EXPECT_EQ(extractor->compiled_records(), 12u);
+
+    // A bad record reaches the interpreter, which reports it
+    auto broken = place(6, 1);
+    broken["basicInfo"]["rating"] = "high";
+    input += broken.dump() + "\n";
+    telemetry::ProgressCounters progress;
+    auto error = run(input, extractor.get(), 1, progress);
+    EXPECT_EQ(error, run(input, nullptr, 1, progress));
+    EXPECT_NE(error.find("conversion"), std::string::npos) << error;
+    EXPECT_EQ(extractor->interpreted_records(), 1u);
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include "graph/column_dictionary.hpp"
+#include "graph/statement_generator.hpp"
+
+using parser::json::JsonDocument;
+
+namespace {
+
+// What the general extract/format path renders for the same value
+std::string reference(const JsonDocument& item, const std::string& path) {
+    graph::StatementGenerator generator;
+    auto value = generator.extract_value(item, path, "STRING");
+    return std::get<std::string>(generator.format_value(std::get<graph::Value>(value)));
+}
+
+} // namespace
+
+TEST(ColumnDictionaryTest, InternsLowCardinalityValues) {
+    const char* badges[] = {"gold", "silver", "bronze", "new", "say \"hi\"\n"};
+    graph::ColumnDictionary dictionary("user/badge");
+
+    for (int i = 0; i < 1000; ++i) {
+        JsonDocument item = {{"user", {{"badge", badges[i % 5]}}}};
+        const auto* literal = dictionary.render(item);
+        ASSERT_NE(literal, nullptr);
+        EXPECT_EQ(*literal, reference(item, "user/badge"));
+    }
+
+    EXPECT_TRUE(dictionary.interning());
+    EXPECT_EQ(dictionary.distinct(), 5u);
+    EXPECT_EQ(dictionary.lookups(), 1000u);
+    EXPECT_EQ(dictionary.hits(), 995u);
+
+    auto id = dictionary.find("silver");
+    ASSERT_TRUE(id);
+    EXPECT_EQ(dictionary.value(*id), "silver");
+    EXPECT_EQ(dictionary.literal(*id), "\"silver\"");
+    EXPECT_FALSE(dictionary.find("platinum"));
+}
+
+TEST(ColumnDictionaryTest, DropsHighCardinalityColumns) {
+    graph::ColumnDictionary::Limits limits;
+    limits.sample = 64;
+    graph::ColumnDictionary dictionary("contents", limits);
+
+    for (int i = 0; i < 500; ++i) {
+        JsonDocument item = {{"contents", "review number " + std::to_string(i)}};
+        const auto* literal = dictionary.render(item);
+        ASSERT_NE(literal, nullptr);
+        EXPECT_EQ(*literal, "\"review number " + std::to_string(i) + "\"");
+    }
+    EXPECT_FALSE(dictionary.interning());
+    EXPECT_EQ(dictionary.distinct(), 0u);
+
+    // Long values are rendered but never interned
+    graph::ColumnDictionary names("name");
+    JsonDocument long_item = {{"name", std::string(200, 'x')}};
+    ASSERT_NE(names.render(long_item), nullptr);
+    EXPECT_EQ(names.distinct(), 0u);
+    EXPECT_TRUE(names.interning());
+}
+
+TEST(ColumnDictionaryTest, LeavesOtherValuesToTheGeneralPath) {
+    graph::ColumnDictionary dictionary("a/b");
+    EXPECT_EQ(dictionary.render(JsonDocument{{"a", {{"c", "x"}}}}), nullptr);
+    EXPECT_EQ(dictionary.render(JsonDocument{{"a", {{"b", nullptr}}}}), nullptr);
+    EXPECT_EQ(dictionary.render(JsonDocument{{"a", {{"b", 42}}}}), nullptr);
+    EXPECT_EQ(dictionary.render(JsonDocument{{"a", "b"}}), nullptr);
+
+    JsonDocument item = {{"a", {{"b", "tab\there \\ and 한글"}}}};
+    ASSERT_NE(dictionary.render(item), nullptr);
+    EXPECT_EQ(*dictionary.render(item), reference(item, "a/b"));
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include "graph/explain.hpp"
+#include "graph/pipeline.hpp"
+#include "parser/yaml_parser.hpp"
+#include "telemetry/stats.hpp"
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+parser::mapping::GraphMapping review_mapping() {
+    auto yaml = parser::yaml::parse(R"(
+tags:
+  Place:
+    from: basicInfo
+    key: cid
+    properties:
+      - json: cid
+        type: INT64
+      - json: address/region
+        type: STRING
+  Review:
+    from: comment/list
+    key: commentid
+    properties:
+      - json: contents
+        type: STRING
+edges:
+  Wrote:
+    from: comment/list
+    source_tag: User
+    target_tag: Review
+    source_key: username
+    target_key: commentid
+    properties:
+      - json: point
+        type: INT64
+)");
+    return std::get<parser::mapping::GraphMapping>(parser::mapping::create_mapping(yaml));
+}
+
+std::string place(int cid, int reviews) {
+    std::string list;
+    for (int i = 0; i < reviews; ++i) {
+        list += std::string(i ? "," : "") + R"({"commentid": ")" + std::to_string(cid) + "-" +
+                std::to_string(i) + R"(", "username": "u)" + std::to_string(i) +
+                R"(", "contents": "good", "point": 5})";
+    }
+    return R"({"basicInfo": {"cid": )" + std::to_string(cid) +
+           R"(, "address": {"region": "Seoul"}}, "comment": {"list": [)" + list + "]}}";
+}
+
+} // namespace
+
+TEST(ExplainTest, PlanGroupsMappingsBySourceWithTheirPathTrie) {
+    auto mapping = review_mapping();
+    mapping.vertices[1].dynamic_fields.enabled = true;
+    mapping.edges[0].properties[0].transform =
+        parser::mapping::Transform{"price_normalize", {{"unit", "KRW"}}};
+    mapping.vertices[1].properties[0].transform = parser::mapping::Transform{"no_such", {}};
+
+    auto plan = graph::format_plan(mapping, 50);
+    EXPECT_NE(plan.find("2 tags, 1 edges, 2 source paths, batch size 50"), std::string::npos) << plan;
+    EXPECT_NE(plan.find("source comment/list (navigated 2x per record: Review Wrote)"),
+              std::string::npos) << plan;
+
+    // address/region is a nested node of the basicInfo trie
+    auto address = plan.find("\n    address\n");
+    ASSERT_NE(address, std::string::npos) << plan;
+    EXPECT_NE(plan.find("\n      region", address), std::string::npos) << plan;
+    EXPECT_NE(plan.find("Place.address/region STRING"), std::string::npos) << plan;
+    // Both mappings over comment/list read commentid
+    EXPECT_NE(plan.find("Review key, Wrote target key"), std::string::npos) << plan;
+
+    EXPECT_NE(plan.find("write: INSERT VERTEX, up to 50 rows per statement"), std::string::npos);
+    EXPECT_NE(plan.find("write: UPSERT VERTEX, one row per statement\n"), std::string::npos);
+    EXPECT_NE(plan.find("dedup: by vertex id within a record"), std::string::npos);
+    EXPECT_NE(plan.find("transform point: price_normalize(unit=KRW) resolved"), std::string::npos)
+        << plan;
+    EXPECT_NE(plan.find("transform contents: no_such() UNRESOLVED"), std::string::npos) << plan;
+}
+
+TEST(ExplainTest, AnalysisChargesEveryStep) {
+    auto mapping = review_mapping();
+    std::string lines;
+    for (int i = 0; i < 20; ++i) {
+        lines += place(i, 3) + "\n";
+    }
+
+    auto path = fs::temp_directory_path() /
+                ("nebula_mapper_explain_" + std::to_string(::getpid()) + ".ndjson");
+    std::ofstream(path, std::ios::binary) << lines;
+
+    telemetry::reset_profile();
+    telemetry::enable_profile();
+    auto reader = std::get<std::unique_ptr<parser::json::RecordReader>>(
+        parser::json::open_records(path.string()));
+    graph::VectorSink sink;
+    auto result = graph::run_pipeline(mapping, *reader, sink);
+    telemetry::enable_profile(false);
+    fs::remove(path);
+    ASSERT_TRUE(std::holds_alternative<graph::PipelineSummary>(result));
+
+    auto profile = telemetry::collect_profile();
+    const auto& place_tag = mapping.vertices[0];
+    const auto& wrote = mapping.edges[0];
+    EXPECT_EQ(profile.at(&place_tag.source_path).calls, 20u);
+    EXPECT_EQ(profile.at(&place_tag.key_path).calls, 20u);
+    for (const auto& prop : place_tag.properties) {
+        EXPECT_EQ(profile.at(&prop).calls, 20u);
+        if (prop.json_path == "address/region") {
+            // "Seoul" rendered with quotes, 20 times
+            EXPECT_EQ(profile.at(&prop).output_bytes, 20u * 7);
+        }
+    }
+    EXPECT_EQ(profile.at(&wrote.from.key_path).calls, 60u);
+    EXPECT_EQ(profile.at(&wrote.properties[0]).calls, 60u);
+    EXPECT_GT(profile.at(&wrote.properties[0]).ns, 0u);
+
+    auto analysis = graph::format_analysis(mapping, profile, 20, 0.5);
+    EXPECT_EQ(analysis.rfind("Analysis: 20 records in 0.500 s", 0), 0u) << analysis;
+    for (const char* label : {"tag Place:", "tag Review:", "edge Wrote:", "source basicInfo",
+                              "from key username", "prop address/region"}) {
+        EXPECT_NE(analysis.find(label), std::string::npos) << label << "\n" << analysis;
+    }
+    telemetry::reset_profile();
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include "graph/geo.hpp"
+#include "graph/schema_manager.hpp"
+#include "graph/statement_generator.hpp"
+#include "parser/yaml_parser.hpp"
+
+using parser::json::JsonDocument;
+using parser::mapping::Projection;
+
+namespace {
+
+parser::mapping::Result<parser::mapping::GraphMapping> place_mapping(
+    const std::string& location) {
+    return parser::mapping::create_mapping(parser::yaml::parse(R"(
+tags:
+  Place:
+    from: places
+    key: cid
+    properties:
+      - name: location
+)" + location));
+}
+
+std::string point(double x, double y, Projection from = Projection::WCONGNAMUL) {
+    graph::to_wgs84(from, &x, &y, 1);
+    std::string out;
+    graph::append_point(out, x, y);
+    return out;
+}
+
+} // namespace
+
+TEST(GeoTest, MatchesProjForKakaoCoordinates) {
+    // WCONGNAMUL / 2.5 through PROJ's EPSG:5181 -> EPSG:4326
+    struct Case { double x, y, lon, lat; };
+    const Case cases[] = {
+        {487529, 1124303, 126.943550980941, 37.546992498722},   // Daeheung station
+        {500000, 1250000, 127.0, 38.0},                         // Projection origin
+        {1240000, 465000, 130.246908217308, 35.126879695266},
+        {370000, -250000, 126.446118394185, 32.590756793473},
+        {850000, 1800000, 128.638708700674, 39.970123631616},
+    };
+    std::vector<double> x, y;
+    for (const auto& c : cases) {
+        x.push_back(c.x);
+        y.push_back(c.y);
+    }
+    graph::to_wgs84(Projection::WCONGNAMUL, x.data(), y.data(), x.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+        EXPECT_NEAR(x[i], cases[i].lon, 1e-9) << i;
+        EXPECT_NEAR(y[i], cases[i].lat, 1e-9) << i;
+    }
+
+    double cx = 487529 / 2.5, cy = 1124303 / 2.5;
+    graph::to_wgs84(Projection::CONGNAMUL, &cx, &cy, 1);
+    EXPECT_NEAR(cx, cases[0].lon, 1e-9);
+    EXPECT_NEAR(cy, cases[0].lat, 1e-9);
+    EXPECT_EQ(point(126.5, 37.25, Projection::WGS84), "ST_Point(126.5, 37.25)");
+}
+
+TEST(GeoTest, GeneratorRendersPointsFromTwoPaths) {
+    auto mapping = std::get<parser::mapping::GraphMapping>(place_mapping(R"(
+        type: GEOGRAPHY(POINT)
+        optional: true
+        geo:
+          x: basicInfo/wpointx
+          y: basicInfo/wpointy
+)"));
+    const JsonDocument places = {{"places", {
+        {{"cid", 1}, {"basicInfo", {{"wpointx", 487529}, {"wpointy", 1124303}}}},
+        {{"cid", 2}, {"basicInfo", {{"wpointx", nullptr}, {"wpointy", 1124303}}}},
+        {{"cid", 3}, {"basicInfo", {{"wpointx", 500000.0}, {"wpointy", 1250000}}}}}}};
+
+    // Batched projection and the one-point-at-a-time reference agree
+    for (bool fast_paths : {true, false}) {
+        graph::GeneratorOptions options;
+        options.fast_paths = fast_paths;
+        graph::StatementGenerator generator(options);
+        auto data = places;
+        auto statements = generator.generate_batch_statements(mapping, data);
+        ASSERT_TRUE(std::holds_alternative<std::vector<std::string>>(statements));
+        EXPECT_EQ(std::get<std::vector<std::string>>(statements).at(0),
+                  "INSERT VERTEX Place (location) VALUES \"1\":(" + point(487529, 1124303) +
+                  "), \"2\":(NULL), \"3\":(ST_Point(127, 38));");
+
+        data["places"][1]["basicInfo"].erase("wpointy");
+        auto missing = generator.generate_batch_statements(mapping, data);
+        ASSERT_TRUE(std::holds_alternative<graph::StatementError>(missing));
+        EXPECT_EQ(std::get<graph::StatementError>(missing).json_path, "basicInfo/wpointy");
+
+        data["places"][1]["basicInfo"]["wpointy"] = "north";
+        data["places"][1]["basicInfo"]["wpointx"] = 487529;
+        auto bad = generator.generate_batch_statements(mapping, data);
+        ASSERT_TRUE(std::holds_alternative<graph::StatementError>(bad));
+        EXPECT_NE(std::get<graph::StatementError>(bad).message.find("north"),
+                  std::string::npos);
+    }
+}
+
+TEST(GeoTest, ChecksPointDeclarations) {
+    auto message = [](const std::string& location) {
+        auto mapping = place_mapping(location);
+        if (!std::holds_alternative<parser::mapping::Error>(mapping)) return std::string();
+        return std::get<parser::mapping::Error>(mapping).message;
+    };
+    EXPECT_EQ(message("        type: GEOGRAPHY\n        geo: {x: x, y: y, from: wgs84}\n"), "");
+    EXPECT_NE(message("        type: GEOGRAPHY(POINT)\n        geo: {x: x, y: y, from: tm}\n")
+                  .find("Unknown projection 'tm'"), std::string::npos);
+    EXPECT_NE(message("        type: STRING\n        geo: {x: x, y: y}\n")
+                  .find("GEOGRAPHY(POINT)"), std::string::npos);
+    EXPECT_NE(message("        type: GEOGRAPHY(POLYGON)\n        geo: {x: x, y: y}\n")
+                  .find("GEOGRAPHY(POINT)"), std::string::npos);
+    EXPECT_NE(message("        json: shape\n        type: GEOGRAPHY\n")
+                  .find("needs geo"), std::string::npos);
+}
+
+TEST(GeoTest, SchemaDeclaresGeographyColumns) {
+    auto mapping = std::get<parser::mapping::GraphMapping>(place_mapping(R"(
+        type: geography(point)
+        geo: {x: wpointx, y: wpointy}
+)"));
+    graph::SchemaManager schema;
+    auto statements = schema.generate_schema_statements(mapping);
+    ASSERT_TRUE(std::holds_alternative<std::vector<std::string>>(statements));
+    EXPECT_NE(std::get<std::vector<std::string>>(statements).at(0)
+                  .find("location GEOGRAPHY(POINT) NOT NULL"), std::string::npos);
+
+    mapping.vertices[0].properties[0].nebula_type = "GEOGRAPHY(CIRCLE)";
+    auto bad = schema.generate_schema_statements(mapping);
+    ASSERT_TRUE(std::holds_alternative<graph::SchemaError>(bad));
+    EXPECT_EQ(std::get<graph::SchemaError>(bad).message, "Unsupported type: GEOGRAPHY(CIRCLE)");
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "graph/json_literal.hpp"
+#include "graph/statement_generator.hpp"
+#include "parser/yaml_parser.hpp"
+
+using parser::json::JsonDocument;
+
+namespace {
+
+std::string literal(const JsonDocument& value, parser::mapping::JsonFormat format = {}) {
+    std::string out;
+    graph::append_json_literal(out, value, format);
+    return out;
+}
+
+// The dump-then-escape route the fused writer replaces
+std::string reference(const JsonDocument& value, int indent = -1) {
+    return "\"" + graph::StatementGenerator::escape_string(value.dump(indent)) + "\"";
+}
+
+JsonDocument facility_info() {
+    return JsonDocument::parse(R"({
+        "wifi": "Y",
+        "pet": "N",
+        "parking": {"spaces": 12, "valet": false, "fee": null},
+        "hours": [9, 21.5, -3, 18446744073709551615, 1e300, 0.1],
+        "note": "say \"hi\"\\ \n\t\r\b\f \u0001 café 😀",
+        "empty": {},
+        "none": []
+    })");
+}
+
+} // namespace
+
+TEST(JsonLiteralTest, MatchesDumpThenEscape) {
+    auto info = facility_info();
+    EXPECT_EQ(literal(info), reference(info));
+    EXPECT_EQ(literal(info, {{}, false}), reference(info, 2));
+    for (const auto& [key, value] : info.items()) {
+        EXPECT_EQ(literal(value), reference(value)) << key;
+        EXPECT_EQ(literal(value, {{}, false}), reference(value, 2)) << key;
+    }
+    EXPECT_EQ(literal(JsonDocument("plain")), "\"\\\"plain\\\"\"");
+}
+
+TEST(JsonLiteralTest, KeepsOnlyListedTopLevelKeys) {
+    auto info = facility_info();
+    JsonDocument kept = {{"parking", info["parking"]}, {"wifi", "Y"}};
+    EXPECT_EQ(literal(info, {{"wifi", "parking", "missing"}, true}), reference(kept));
+    EXPECT_EQ(literal(info, {{"missing"}, false}), reference(JsonDocument::object(), 2));
+    // Nested objects and arrays are not filtered
+    EXPECT_EQ(literal(info["hours"], {{"wifi"}, true}), reference(info["hours"]));
+}
+
+TEST(JsonLiteralTest, GeneratorSerializesMarkedProperties) {
+    auto mapping = std::get<parser::mapping::GraphMapping>(
+        parser::mapping::create_mapping(parser::yaml::parse(R"(
+tags:
+  Place:
+    from: places
+    key: id
+    properties:
+      - json: facilityInfo
+        type: STRING
+        serialize:
+          keys: [wifi, parking]
+      - json: strengths
+        type: STRING
+        serialize: json
+)")));
+    JsonDocument data = {{"places", {{{"id", "p1"},
+                                      {"facilityInfo", facility_info()},
+                                      {"strengths", {{"taste", 3}}}},
+                                     {{"id", "p2"},
+                                      {"facilityInfo", nullptr},
+                                      {"strengths", "n/a"}}}}};
+
+    graph::StatementGenerator generator;
+    auto statements = generator.generate_batch_statements(mapping, data);
+    ASSERT_TRUE(std::holds_alternative<std::vector<std::string>>(statements));
+    JsonDocument kept = {{"parking", facility_info()["parking"]}, {"wifi", "Y"}};
+    EXPECT_EQ(std::get<std::vector<std::string>>(statements).at(0),
+              "INSERT VERTEX Place (facilityInfo, strengths) VALUES \"p1\":(" +
+              reference(kept) + ", " + reference(data["places"][0]["strengths"]) +
+              "), \"p2\":(NULL, \"\\\"n/a\\\"\");");
+
+    auto bad = parser::mapping::create_mapping(parser::yaml::parse(R"(
+tags:
+  Place:
+    from: places
+    key: id
+    properties:
+      - json: strengths
+        type: STRING
+        serialize: xml
+)"));
+    ASSERT_TRUE(std::holds_alternative<parser::mapping::Error>(bad));
+    EXPECT_NE(std::get<parser::mapping::Error>(bad).message.find("xml"), std::string::npos);
+
+    // Only a plain STRING property can hold the serialized text
+    for (const char* property : {"type: INT64\n        serialize: json",
+                                 "type: FIXED_STRING(16)\n        serialize: json",
+                                 "type: STRING\n        serialize: json\n"
+                                 "        transform:\n          delimiter: \";\""}) {
+        auto rejected = parser::mapping::create_mapping(parser::yaml::parse(std::string(R"(
+tags:
+  Place:
+    from: places
+    key: id
+    properties:
+      - json: strengths
+        )") + property + "\n"));
+        ASSERT_TRUE(std::holds_alternative<parser::mapping::Error>(rejected)) << property;
+        EXPECT_EQ(std::get<parser::mapping::Error>(rejected).context, "strengths") << property;
+    }
+}
@@ -0,0 +1,248 @@
+#include <gtest/gtest.h>
+#include "graph/mapping_dsl.hpp"
+#include "graph/pipeline.hpp"
+#include "parser/yaml_parser.hpp"
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using parser::json::JsonDocument;
+
+namespace {
+
+constexpr char Place[] = "Place", User[] = "User", Wrote[] = "Wrote";
+constexpr char basicInfo[] = "basicInfo", comment_list[] = "comment/list";
+constexpr char cid[] = "cid", name[] = "name", rating[] = "rating", open[] = "open";
+constexpr char first_tag[] = "tags/[0]", user_id[] = "userId", comment_id[] = "commentid";
+constexpr char point[] = "point", username[] = "username", user_name[] = "user name";
+
+namespace dsl = graph::dsl;
+
+constexpr auto places = dsl::mapping(
+    dsl::tag<Place, basicInfo>(dsl::key<cid>,
+                               dsl::prop<cid, int64_t>,
+                               dsl::prop<name>,
+                               dsl::prop<open, bool>,
+                               dsl::prop<rating, double>,
+                               dsl::prop<first_tag>),
+    dsl::tag<User, comment_list>(dsl::key<user_id>, dsl::prop<username>),
+    dsl::edge<Wrote, comment_list>(dsl::from_key<user_id>, dsl::to_key<comment_id>,
+                                   dsl::prop<point, int64_t>));
+
+// The same mapping for the interpreter
+const char* MAPPING_YAML = R"(
+tags:
+  Place:
+    from: basicInfo
+    key: cid
+    properties:
+      - json: cid
+        type: INT64
+      - json: name
+        type: STRING
+      - json: open
+        type: BOOL
+      - json: rating
+        type: DOUBLE
+      - json: tags/[0]
+        type: STRING
+  User:
+    from: comment/list
+    key: userId
+    properties:
+      - json: username
+        type: STRING
+edges:
+  Wrote:
+    from: comment/list
+    source_tag: User
+    target_tag: Place
+    source_key: userId
+    target_key: commentid
+    properties:
+      - json: point
+        type: INT64
+)";
+
+parser::mapping::GraphMapping interpreted() {
+    return std::get<parser::mapping::GraphMapping>(
+        parser::mapping::create_mapping(parser::yaml::parse(MAPPING_YAML)));
+}
+
+JsonDocument place(int id, int comments) {
+    JsonDocument list = JsonDocument::array();
+    for (int i = 0; i < comments; ++i) {
+        list.push_back({{"userId", "u" + std::to_string(i % 3)},
+                        {"commentid", 100 * id + i},
+                        {"username", "say \"" + std::to_string(i) + "\"\n"},
+                        {"point", i % 5}});
+    }
+    return {{"basicInfo", {{"cid", id},
+                           {"name", "Caf\xc3\xa9 " + std::to_string(id)},
+                           {"open", id % 2 == 0},
+                           {"rating", id / 3.0},
+                           {"tags", {"coffee", "tea"}}}},
+            {"comment", {{"list", list}}}};
+}
+
+} // namespace
+
+TEST(MappingDslTest, BuildsPrefixesAtCompileTime) {
+    using PlaceTag = decltype(dsl::tag<Place, basicInfo>(dsl::key<cid>, dsl::prop<cid, int64_t>,
+                                                         dsl::prop<name>));
+    static_assert(PlaceTag::prefix == "INSERT VERTEX Place (cid, name) VALUES ");
+    using UserTag = decltype(dsl::tag<User, comment_list>(
+        dsl::key<user_id>, dsl::prop<username, std::string, user_name>));
+    static_assert(UserTag::prefix == "INSERT VERTEX User (`user name`) VALUES ");
+    static_assert(dsl::detail::segments<first_tag>.size() == 2);
+    static_assert(dsl::detail::segments<first_tag>[1].index == 0);
+}
+
+TEST(MappingDslTest, MatchesTheInterpreter) {
+    auto mapping = interpreted();
+    graph::StatementGenerator generator;
+    for (int id = 0; id < 12; ++id) {
+        for (size_t batch_size : {0, 1, 2, 500}) {
+            auto document = place(id, id % 5);
+            if (id == 3) document["basicInfo"]["name"] = nullptr;
+            auto expected = generator.generate_batch_statements(mapping, document, batch_size);
+            auto actual = places.generate(document, batch_size);
+            ASSERT_TRUE(std::holds_alternative<std::vector<std::string>>(actual));
+            EXPECT_EQ(std::get<std::vector<std::string>>(actual),
+                      std::get<std::vector<std::string>>(expected));
+        }
+    }
+}
+
+TEST(MappingDslTest, ReportsErrorsLikeTheInterpreter) {
+    auto mapping = interpreted();
+    graph::StatementGenerator generator;
+    for (auto broken : {JsonDocument{{"cid", nullptr}}, JsonDocument{{"cid", true}},
+                        JsonDocument{{"rating", "high"}}, JsonDocument{{"name", 3}},
+                        JsonDocument{{"tags", "coffee"}}, JsonDocument{{"tags", JsonDocument::array()}}}) {
+        auto document = place(1, 2);
+        document["basicInfo"].update(broken);
+        auto expected = generator.generate_batch_statements(mapping, document);
+        auto actual = places.generate(document);
+        ASSERT_TRUE(std::holds_alternative<graph::StatementError>(expected)) << broken.dump();
+        ASSERT_TRUE(std::holds_alternative<graph::StatementError>(actual)) << broken.dump();
+        const auto& want = std::get<graph::StatementError>(expected);
+        const auto& got = std::get<graph::StatementError>(actual);
+        EXPECT_EQ(got.message, want.message);
+        EXPECT_EQ(got.context, want.context);
+        EXPECT_EQ(got.json_path, want.json_path);
+    }
+
+    auto document = place(1, 2);
+    document.erase("comment");
+    auto actual = places.generate(document);
+    ASSERT_TRUE(std::holds_alternative<graph::StatementError>(actual));
+    EXPECT_EQ(std::get<graph::StatementError>(actual).message,
+              "Failed to extract data: Property not found: comment");
+}
+
+TEST(MappingDslTest, RunsRecordsIntoASink) {
+    std::string input;
+    for (int id = 0; id < 20; ++id) {
+        input += place(id, 3).dump() + "\n";
+    }
+    auto path = fs::temp_directory_path() /
+                ("nebula_mapper_dsl_" + std::to_string(::getpid()) + ".ndjson");
+    std::ofstream(path, std::ios::binary) << input;
+
+    auto reader = std::get<std::unique_ptr<parser::json::RecordReader>>(
+        parser::json::open_records(path.string()));
+    graph::VectorSink sink;
+    auto summary = places.run(*reader, sink, 4);
+    ASSERT_TRUE(std::holds_alternative<graph::PipelineSummary>(summary));
+
+    graph::PipelineOptions options;
+    options.batch_size = 4;
+    reader = std::get<std::unique_ptr<parser::json::RecordReader>>(
+        parser::json::open_records(path.string()));
+    graph::VectorSink expected;
+    auto expected_summary = graph::run_pipeline(interpreted(), *reader, expected, options);
+    ASSERT_TRUE(std::holds_alternative<graph::PipelineSummary>(expected_summary));
+    fs::remove(path);
+
+    EXPECT_EQ(sink.statements(), expected.statements());
+    EXPECT_EQ(std::get<graph::PipelineSummary>(summary).records, 20u);
+    EXPECT_EQ(std::get<graph::PipelineSummary>(summary).statement_bytes,
+              std::get<graph::PipelineSummary>(expected_summary).statement_bytes);
+}
+
+TEST(MappingDslTest, DescribesItselfAsAGraphMapping) {
+    auto mapping = places.describe();
+    ASSERT_EQ(mapping.vertices.size(), 2u);
+    ASSERT_EQ(mapping.edges.size(), 1u);
+    EXPECT_EQ(mapping.vertices[0].tag_name, "Place");
+    EXPECT_EQ(mapping.vertices[0].properties[3].nebula_type, "DOUBLE");
+    EXPECT_EQ(mapping.vertices[1].properties[0].name, "username");
+    EXPECT_EQ(mapping.vertices[1].source_path, "comment/list");
+    EXPECT_EQ(mapping.edges[0].to.key_path, "commentid");
+}
+
+namespace {
+
+constexpr char Sensor[] = "Sensor", readings[] = "readings", id[] = "id";
+constexpr char tiny[] = "tiny", small[] = "small", medium[] = "medium", ratio[] = "ratio";
+
+constexpr auto sensors = dsl::mapping(
+    dsl::tag<Sensor, readings>(dsl::key<id>,
+                               dsl::prop<medium, int32_t>,
+                               dsl::prop<ratio, float>,
+                               dsl::prop<small, int16_t>,
+                               dsl::prop<tiny, int8_t>));
+
+const char* SENSOR_YAML = R"(
+tags:
+  Sensor:
+    from: readings
+    key: id
+    properties:
+      - json: medium
+        type: INT32
+      - json: ratio
+        type: FLOAT
+      - json: small
+        type: INT16
+      - json: tiny
+        type: INT8
+)";
+
+} // namespace
+
+TEST(MappingDslTest, NarrowTypesMatchTheirYamlTypes) {
+    auto described = sensors.describe();
+    const auto& properties = described.vertices[0].properties;
+    EXPECT_EQ(properties[0].nebula_type, "INT32");
+    EXPECT_EQ(properties[1].nebula_type, "FLOAT");
+    EXPECT_EQ(properties[2].nebula_type, "INT16");
+    EXPECT_EQ(properties[3].nebula_type, "INT8");
+
+    auto mapping = std::get<parser::mapping::GraphMapping>(
+        parser::mapping::create_mapping(parser::yaml::parse(SENSOR_YAML)));
+    graph::StatementGenerator generator;
+    JsonDocument fits = {{"id", "s1"}, {"tiny", -128}, {"small", "32767"},
+                         {"medium", 2147483647}, {"ratio", 127.0276543}};
+    for (auto reading : {fits,
+                         JsonDocument{{"tiny", 128}}, JsonDocument{{"small", -32769}},
+                         JsonDocument{{"medium", "2147483648"}}, JsonDocument{{"ratio", 1e39}}}) {
+        JsonDocument record = fits;
+        record.update(reading);
+        JsonDocument document = {{"readings", {record}}};
+        auto expected = generator.generate_batch_statements(mapping, document);
+        auto actual = sensors.generate(document);
+        EXPECT_EQ(std::holds_alternative<graph::StatementError>(expected), reading != fits);
+        if (std::holds_alternative<graph::StatementError>(expected)) {
+            ASSERT_TRUE(std::holds_alternative<graph::StatementError>(actual)) << reading.dump();
+            EXPECT_EQ(std::get<graph::StatementError>(actual).message,
+                      std::get<graph::StatementError>(expected).message);
+        } else {
+            ASSERT_TRUE(std::holds_alternative<std::vector<std::string>>(actual));
+            EXPECT_EQ(std::get<std::vector<std::string>>(actual),
+                      std::get<std::vector<std::string>>(expected));
+        }
+    }
+}
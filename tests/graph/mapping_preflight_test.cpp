@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include "graph/mapping_preflight.hpp"
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using parser::json::JsonDocument;
+using graph::ValidationReport;
+
+namespace {
+
+parser::mapping::GraphMapping place_mapping(const std::string& source = "comment/list") {
+    return std::get<parser::mapping::GraphMapping>(
+        parser::mapping::create_mapping(parser::yaml::parse(R"(
+tags:
+  Place:
+    from: basicInfo
+    key: cid
+    properties:
+      - json: cid
+        type: INT64
+      - json: homepage
+        type: STRING
+        optional: true
+  Review:
+    from: )" + source + R"(
+    key: commentid
+    properties:
+      - json: point
+        type: INT8
+    aggregates:
+      - {name: likes, op: sum, over: comment/list, json: likeCnt, type: INT64}
+)")));
+}
+
+JsonDocument place(int cid, JsonDocument point = 5) {
+    return {{"basicInfo", {{"cid", cid}, {"homepage", nullptr}}},
+            {"comment", {{"list", {{{"commentid", cid * 10}, {"point", point},
+                                    {"likeCnt", 1}}}}}}};
+}
+
+const graph::PathReport& path(const ValidationReport& report,
+                              const std::string& owner, const std::string& name) {
+    for (const auto& path : report.paths) {
+        if (path.owner == owner && path.name == name) return path;
+    }
+    ADD_FAILURE() << "No path " << owner << "." << name;
+    return report.paths.front();
+}
+
+bool mentions(const std::vector<std::string>& lines, const std::string& text) {
+    for (const auto& line : lines) {
+        if (line.find(text) != std::string::npos) return true;
+    }
+    return false;
+}
+
+std::unique_ptr<parser::json::RecordReader> ndjson(const fs::path& path,
+                                                   const std::vector<JsonDocument>& records,
+                                                   const std::string& tail = "") {
+    std::ofstream out(path, std::ios::binary);
+    for (const auto& record : records) out << record.dump() << '\n';
+    out << tail;
+    out.close();
+    return std::move(std::get<std::unique_ptr<parser::json::RecordReader>>(
+        parser::json::open_records(path.string())));
+}
+
+} // namespace
+
+TEST(MappingPreflightTest, ReportsResolutionRates) {
+    auto mapping = place_mapping();
+    auto result = graph::validate_mapping(mapping, place(1));
+    ASSERT_TRUE(std::holds_alternative<ValidationReport>(result));
+    const auto& report = std::get<ValidationReport>(result);
+
+    EXPECT_TRUE(report.ok());
+    EXPECT_EQ(report.records, 1u);
+    EXPECT_EQ(path(report, "Place", "key").resolved, 1u);
+    EXPECT_EQ(path(report, "Review", "point").resolution_rate(), 1.0);
+    EXPECT_EQ(path(report, "Review", "likes").resolved, 1u);
+    // All-null optional columns are only a warning
+    EXPECT_EQ(path(report, "Place", "homepage").nulls, 1u);
+    EXPECT_TRUE(mentions(report.warnings, "Place.homepage: 'homepage' never has a value"));
+
+    auto text = graph::format_validation(report);
+    EXPECT_NE(text.find("Review: source comment/list in 1/1 records, 1 items"),
+              std::string::npos);
+    EXPECT_NE(text.find("point INT8"), std::string::npos);
+}
+
+TEST(MappingPreflightTest, FindsWhatWouldStopARun) {
+    auto document = place(1, 300);
+    document["comment"]["list"].push_back({{"point", 4}, {"likeCnt", "lots"}});
+    document["basicInfo"]["cid"] = JsonDocument::array();
+
+    auto result = graph::validate_mapping(place_mapping(), document);
+    ASSERT_TRUE(std::holds_alternative<ValidationReport>(result));
+    const auto& report = std::get<ValidationReport>(result);
+    EXPECT_FALSE(report.ok());
+
+    const auto& key = path(report, "Review", "key");
+    EXPECT_EQ(key.items, 2u);
+    EXPECT_EQ(key.missing, 1u);
+    EXPECT_TRUE(mentions(report.errors, "Review.key: 'commentid' missing in 1 of 2 items"));
+    EXPECT_EQ(path(report, "Review", "point").conflicts, 1u);
+    EXPECT_TRUE(mentions(report.errors, "300 is out of range for INT8"));
+    EXPECT_TRUE(mentions(report.errors, "Review.likes: 1 of 2 items do not convert"));
+    EXPECT_TRUE(mentions(report.errors, "Place.key: 1 of 1 items do not convert"));
+
+    // The dotted [*] source of older mappings never resolves
+    auto legacy = graph::validate_mapping(place_mapping("comment.list[*]"), place(1));
+    const auto& errors = std::get<ValidationReport>(legacy).errors;
+    EXPECT_TRUE(mentions(errors, "Review: source 'comment.list[*]' missing in 1 of 1 records"));
+    EXPECT_TRUE(mentions(errors, "'/' separators"));
+}
+
+TEST(MappingPreflightTest, ReportsTheErrorGenerationStopsOn) {
+    auto mapping = place_mapping();
+    auto document = place(1, "high");
+
+    graph::StatementGenerator generator;
+    auto generated = generator.generate_batch_statements(mapping, document);
+    ASSERT_TRUE(std::holds_alternative<graph::StatementError>(generated));
+
+    auto result = graph::validate_mapping(mapping, document);
+    const auto& point = path(std::get<ValidationReport>(result), "Review", "point");
+    EXPECT_EQ(point.first_conflict,
+              "document: " + std::get<graph::StatementError>(generated).message);
+}
+
+TEST(MappingPreflightTest, SamplesHeadAndReservoir) {
+    std::vector<JsonDocument> records;
+    for (int i = 0; i < 1000; ++i) {
+        records.push_back(place(i, i == 700 ? JsonDocument("bad") : JsonDocument(5)));
+    }
+    auto file = fs::temp_directory_path() /
+                ("nebula_mapper_preflight_" + std::to_string(::getpid()) + ".ndjson");
+
+    graph::SampleOptions options;
+    options.head = 10;
+    options.reservoir = 20;
+    auto reader = ndjson(file, records);
+    auto result = graph::validate_mapping(place_mapping(), *reader, options);
+    ASSERT_TRUE(std::holds_alternative<ValidationReport>(result));
+    const auto& sampled = std::get<ValidationReport>(result);
+    EXPECT_EQ(sampled.records_read, 1000u);
+    EXPECT_EQ(sampled.records, 30u);
+    EXPECT_EQ(path(sampled, "Place", "cid").items, 30u);
+
+    // A reservoir as large as the rest sees every record
+    options.reservoir = 1000;
+    reader = ndjson(file, records);
+    result = graph::validate_mapping(place_mapping(), *reader, options);
+    const auto& full = std::get<ValidationReport>(result);
+    EXPECT_EQ(full.records, 1000u);
+    EXPECT_TRUE(mentions(full.errors, "Review.point: 1 of 1000 items do not convert (first "));
+
+    // Reading stops at max_records; broken JSON is a finding
+    options.max_records = 5;
+    reader = ndjson(file, records);
+    result = graph::validate_mapping(place_mapping(), *reader, options);
+    EXPECT_EQ(std::get<ValidationReport>(result).records_read, 5u);
+
+    reader = ndjson(file, {place(1)}, "{\"basicInfo\": [}\n");
+    options.max_records = 0;
+    result = graph::validate_mapping(place_mapping(), *reader, options);
+    const auto& broken = std::get<ValidationReport>(result);
+    EXPECT_EQ(broken.records, 1u);
+    EXPECT_TRUE(mentions(broken.errors, "JSON error"));
+    fs::remove(file);
+}
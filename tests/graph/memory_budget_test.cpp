@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include "graph/memory_budget.hpp"
+#include "graph/pipeline.hpp"
+#include "parser/yaml_parser.hpp"
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+using graph::MemoryConsumer;
+
+TEST(MemoryBudgetTest, TracksUsagePeaksAndPressure) {
+    graph::MemoryBudget budget(1000);
+    budget.charge(MemoryConsumer::READ_AHEAD, 500);
+    EXPECT_FALSE(budget.under_pressure());
+    budget.charge(MemoryConsumer::REORDER, 300);
+    EXPECT_TRUE(budget.under_pressure());
+    EXPECT_FALSE(budget.exhausted());
+    budget.charge(MemoryConsumer::REORDER, 200);
+    EXPECT_TRUE(budget.exhausted());
+
+    budget.release(MemoryConsumer::REORDER, 500);
+    budget.release(MemoryConsumer::READ_AHEAD, 500);
+    EXPECT_EQ(budget.used(), 0u);
+
+    auto memory = budget.snapshot();
+    EXPECT_EQ(memory.peak, 1000u);
+    EXPECT_EQ(memory.consumers[static_cast<size_t>(MemoryConsumer::REORDER)].peak, 500u);
+    EXPECT_EQ(memory.consumers[static_cast<size_t>(MemoryConsumer::REORDER)].current, 0u);
+
+    EXPECT_EQ(graph::parse_memory_size("512M"), 512u << 20);
+    EXPECT_EQ(graph::parse_memory_size("2gb"), 2ull << 30);
+    EXPECT_EQ(graph::parse_memory_size("4096"), 4096u);
+    EXPECT_FALSE(graph::parse_memory_size("lots"));
+    EXPECT_FALSE(graph::parse_memory_size("5X"));
+    EXPECT_FALSE(graph::parse_memory_size("-1"));
+    EXPECT_FALSE(graph::parse_memory_size("20000000000G"));
+    EXPECT_FALSE(graph::parse_memory_size("99999999999999999999"));
+    EXPECT_EQ(graph::parse_memory_size("17179869183G"), 17179869183ull << 30);
+}
+
+TEST(MemoryBudgetTest, SpillingSinkReplaysInArrivalOrder) {
+    graph::MemoryBudget budget(1000);
+    std::vector<std::string> expected;
+    fs::path spill_file;
+    {
+        graph::SpillingSink sink(&budget, fs::temp_directory_path());
+        for (int record = 0; record < 20; ++record) {
+            std::vector<std::string> statements;
+            for (int i = 0; i < 3; ++i) {
+                statements.push_back("INSERT " + std::to_string(record) + "/" +
+                                     std::to_string(i) + std::string(30, 'x'));
+            }
+            // Anything may be in a statement, newlines included
+            statements.push_back("multi\nline " + std::to_string(record));
+            expected.insert(expected.end(), statements.begin(), statements.end());
+            sink.consume(std::move(statements));
+            EXPECT_LT(budget.used(), 1000u);
+        }
+        EXPECT_GT(sink.spilled_statements(), 0u);
+        EXPECT_GT(budget.snapshot().spills, 0u);
+
+        for (const auto& entry : fs::directory_iterator(fs::temp_directory_path())) {
+            auto name = entry.path().filename().string();
+            if (name.rfind("nebula_mapper_spill_" + std::to_string(::getpid()) + "_", 0) == 0) {
+                spill_file = entry.path();
+            }
+        }
+        ASSERT_FALSE(spill_file.empty());
+
+        std::vector<std::string> replayed;
+        size_t chunks = 0;
+        ASSERT_TRUE(sink.drain(200, [&](std::vector<std::string>&& chunk) {
+            ++chunks;
+            replayed.insert(replayed.end(), chunk.begin(), chunk.end());
+        }));
+        EXPECT_EQ(replayed, expected);
+        EXPECT_GT(chunks, 1u);
+        EXPECT_EQ(budget.used(), 0u);
+    }
+    EXPECT_FALSE(fs::exists(spill_file));
+}
+
+TEST(MemoryBudgetTest, PipelineOutputIsUnchangedUnderATightBudget) {
+    auto yaml = parser::yaml::parse(R"(
+tags:
+  Place:
+    from: basicInfo
+    key: cid
+    properties:
+      - json: cid
+        type: INT64
+  Review:
+    from: comment/list
+    key: commentid
+    properties: []
+)");
+    auto mapping = std::get<parser::mapping::GraphMapping>(parser::mapping::create_mapping(yaml));
+
+    std::string input;
+    for (int i = 0; i < 200; ++i) {
+        std::string list;
+        for (int j = 0; j < i % 7; ++j) {
+            list += std::string(j ? "," : "") + R"({"commentid": ")" + std::to_string(i) + "-" +
+                    std::to_string(j) + R"("})";
+        }
+        input += R"({"basicInfo": {"cid": )" + std::to_string(i) +
+                 R"(}, "comment": {"list": [)" + list + "]}}\n";
+    }
+    auto path = fs::temp_directory_path() /
+                ("nebula_mapper_memory_" + std::to_string(::getpid()) + ".ndjson");
+    std::ofstream(path, std::ios::binary) << input;
+
+    auto run = [&](graph::MemoryBudget* budget) {
+        graph::PipelineOptions options;
+        options.threads = 3;
+        options.memory = budget;
+        auto reader = std::get<std::unique_ptr<parser::json::RecordReader>>(
+            parser::json::open_records(path.string()));
+        graph::VectorSink sink;
+        EXPECT_TRUE(std::holds_alternative<graph::PipelineSummary>(
+            graph::run_pipeline(mapping, *reader, sink, options)));
+        return sink.statements();
+    };
+
+    auto unlimited = run(nullptr);
+    // Smaller than a single parsed record, so the reader throttles
+    graph::MemoryBudget budget(256);
+    EXPECT_EQ(run(&budget), unlimited);
+    EXPECT_GT(budget.snapshot().throttles, 0u);
+    EXPECT_EQ(budget.used(), 0u);
+    fs::remove(path);
+}
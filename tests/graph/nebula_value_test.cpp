@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+#include "graph/nebula_value.hpp"
+#include "graph/statement_generator.hpp"
+#include "parser/yaml_parser.hpp"
+#include <type_traits>
+
+using graph::NebulaType;
+using graph::NebulaValue;
+using parser::json::JsonDocument;
+
+namespace {
+
+// Literal for `json` converted to `type`, or the error message
+std::string render(const JsonDocument& json, const std::string& type) {
+    auto spec = graph::parse_type(type);
+    if (!spec) return "unknown type " + type;
+    auto value = graph::to_nebula_value(json, *spec, "path");
+    if (std::holds_alternative<graph::StatementError>(value)) {
+        return std::get<graph::StatementError>(value).message;
+    }
+    std::string out;
+    graph::append_literal(out, std::get<NebulaValue>(value));
+    return out;
+}
+
+// What the generator renders for {"v": json} with a property of `type`
+std::string generated(const JsonDocument& json, const std::string& type) {
+    parser::mapping::GraphMapping mapping;
+    parser::mapping::VertexMapping vertex;
+    vertex.tag_name = "T";
+    vertex.source_path = "items";
+    vertex.key_path = "id";
+    parser::mapping::Property prop;
+    prop.name = "v";
+    prop.json_path = "v";
+    prop.nebula_type = type;
+    vertex.properties.push_back(prop);
+    mapping.vertices.push_back(vertex);
+
+    graph::StatementGenerator generator;
+    auto result = generator.generate_batch_statements(
+        mapping, JsonDocument{{"items", {{{"id", "a"}, {"v", json}}}}});
+    if (std::holds_alternative<graph::StatementError>(result)) {
+        return std::get<graph::StatementError>(result).message;
+    }
+    return std::get<std::vector<std::string>>(result).at(0);
+}
+
+} // namespace
+
+TEST(NebulaValueTest, IsCompact) {
+    EXPECT_EQ(sizeof(NebulaValue), 16u);
+    EXPECT_TRUE(std::is_trivially_copyable_v<NebulaValue>);
+}
+
+TEST(NebulaValueTest, ParsesDeclaredTypes) {
+    EXPECT_EQ(graph::parse_type("int")->type, NebulaType::INT64);
+    EXPECT_EQ(graph::parse_type("Int32")->type, NebulaType::INT32);
+    EXPECT_EQ(graph::parse_type("varchar")->type, NebulaType::STRING);
+    EXPECT_EQ(graph::parse_type("STRING(256)")->type, NebulaType::STRING);
+    EXPECT_EQ(graph::parse_type("FIXED_STRING")->length, 32u);
+    EXPECT_EQ(graph::parse_type("fixed_string(8)")->length, 8u);
+    EXPECT_FALSE(graph::parse_type("INT8(4)"));
+    EXPECT_FALSE(graph::parse_type("FIXED_STRING(0)"));
+    EXPECT_FALSE(graph::parse_type("GEOGRAPHY"));
+}
+
+TEST(NebulaValueTest, NarrowsIntegersWithRangeChecks) {
+    EXPECT_EQ(render(127, "INT8"), "127");
+    EXPECT_EQ(render(-128, "INT8"), "-128");
+    EXPECT_EQ(render(300, "INT8"), "Value conversion error: 300 is out of range for INT8");
+    EXPECT_EQ(render(-32769, "INT16"),
+              "Value conversion error: -32769 is out of range for INT16");
+    EXPECT_EQ(render(2147483647, "INT32"), "2147483647");
+    EXPECT_EQ(render(int64_t{1} << 40, "INT64"), "1099511627776");
+    EXPECT_NE(render(JsonDocument::array(), "INT32").find("type must be number"),
+              std::string::npos);
+    EXPECT_EQ(render(nullptr, "INT16"), "NULL");
+}
+
+TEST(NebulaValueTest, CoercesNumericStrings) {
+    EXPECT_EQ(render("9007199254740993", "INT64"), "9007199254740993");
+    EXPECT_EQ(render("-12", "INT8"), "-12");
+    EXPECT_EQ(render("300", "INT8"), "Value conversion error: 300 is out of range for INT8");
+    EXPECT_EQ(render("4.5", "DOUBLE"), "4.5");
+    EXPECT_EQ(render("1700000000", "TIMESTAMP"), "1700000000");
+    EXPECT_EQ(render("1,234", "INT32"), "Value conversion error: '1,234' is not an integer");
+
+    auto lenient = graph::to_nebula_value(JsonDocument(" 1,234 "), {NebulaType::INT32, 0},
+                                          "p", common::numbers::CoercionMode::LENIENT);
+    EXPECT_EQ(std::get<NebulaValue>(lenient).as_int(), 1234);
+
+    // The mapping chooses the mode per property
+    auto mapping = parser::mapping::create_mapping(parser::yaml::parse(R"(
+tags:
+  Place:
+    from: items
+    key: id
+    properties:
+      - json: price
+        type: INT64
+        coerce: lenient
+)"));
+    const auto& prop = std::get<parser::mapping::GraphMapping>(mapping).vertices[0].properties[0];
+    EXPECT_EQ(prop.coerce, common::numbers::CoercionMode::LENIENT);
+    graph::StatementGenerator generator;
+    auto statements = generator.generate_batch_statements(
+        std::get<parser::mapping::GraphMapping>(mapping),
+        JsonDocument{{"items", {{{"id", "a"}, {"price", "12,000"}}}}});
+    EXPECT_EQ(std::get<std::vector<std::string>>(statements).at(0),
+              "INSERT VERTEX Place (price) VALUES \"a\":(12000);");
+}
+
+TEST(NebulaValueTest, HoldsFloatsInFourBytes) {
+    auto value = std::get<NebulaValue>(
+        graph::to_nebula_value(JsonDocument(0.1), {NebulaType::FLOAT, 0}, "p"));
+    EXPECT_EQ(value.as_double(), static_cast<double>(0.1f));
+    EXPECT_EQ(render(0.1, "FLOAT"), "0.1");
+    EXPECT_EQ(render(4.5, "DOUBLE"), "4.5");
+    EXPECT_EQ(render(1e39, "FLOAT"), "Value conversion error: 1e+39 is out of range for FLOAT");
+    EXPECT_EQ(render(1e39, "DOUBLE"), "1e+39");
+}
+
+TEST(NebulaValueTest, RendersDigitsThatReadBack) {
+    EXPECT_EQ(render(127.0276543, "DOUBLE"), "127.0276543");
+    EXPECT_EQ(render(12345678.9, "DOUBLE"), "12345678.9");
+    EXPECT_EQ(render("37.546992499", "DOUBLE"), "37.546992499");
+    EXPECT_EQ(render(127.0276543, "FLOAT"), "127.02766");
+}
+
+TEST(NebulaValueTest, TruncatesFixedStringsOnCharacterBoundaries) {
+    EXPECT_EQ(render("abcdef", "FIXED_STRING(4)"), "\"abcd\"");
+    // "é" takes two bytes; it is dropped rather than split
+    EXPECT_EQ(render("caf\xc3\xa9", "FIXED_STRING(4)"), "\"caf\"");
+    EXPECT_EQ(render("caf\xc3\xa9", "FIXED_STRING(5)"), "\"caf\xc3\xa9\"");
+    EXPECT_EQ(render("say \"hi\"", "STRING"), "\"say \\\"hi\\\"\"");
+
+    // Short strings are held inline, longer ones point into the document
+    JsonDocument long_text = std::string(40, 'x');
+    auto value = std::get<NebulaValue>(
+        graph::to_nebula_value(long_text, {NebulaType::STRING, 0}, "p"));
+    EXPECT_EQ(value.as_string().data(), long_text.get_ref<const std::string&>().data());
+    auto short_value = std::get<NebulaValue>(
+        graph::to_nebula_value(JsonDocument("tiny"), {NebulaType::STRING, 0}, "p"));
+    EXPECT_EQ(short_value.as_string(), "tiny");
+}
+
+TEST(NebulaValueTest, PacksTemporalValues) {
+    auto date = graph::parse_date("2024-02-29");
+    ASSERT_TRUE(date);
+    EXPECT_EQ(NebulaValue::date(*date).packed(), 2024 * 512 + 2 * 32 + 29);
+    EXPECT_FALSE(graph::parse_date("2023-02-29"));
+    EXPECT_FALSE(graph::parse_date("2024-13-01"));
+    EXPECT_FALSE(graph::parse_time("24:00:00"));
+
+    EXPECT_EQ(render("2024-02-29", "DATE"), "date(\"2024-02-29\")");
+    EXPECT_EQ(render("08:05:09.5", "TIME"), "time(\"08:05:09.500000\")");
+    EXPECT_EQ(render("2024-01-31 12:30:45Z", "DATETIME"),
+              "datetime(\"2024-01-31T12:30:45\")");
+    EXPECT_EQ(render("31/01/2024", "DATE"),
+              "Value conversion error: '31/01/2024' is not a DATE (expected YYYY-MM-DD)");
+
+    auto datetime = NebulaValue::datetime({2024, 1, 31}, {23, 59, 58, 7});
+    EXPECT_EQ(datetime.as_date().day, 31);
+    EXPECT_EQ(datetime.as_time().second, 58);
+    EXPECT_EQ(datetime.as_time().microsecond, 7u);
+    EXPECT_LT(NebulaValue::date({2023, 12, 31}).packed(),
+              NebulaValue::date({2024, 1, 1}).packed());
+}
+
+TEST(NebulaValueTest, ReadsTimestampsFromSecondsOrText) {
+    EXPECT_EQ(render(1700000000, "TIMESTAMP"), "1700000000");
+    EXPECT_EQ(render("2024-01-01T00:00:00", "TIMESTAMP"), "1704067200");
+    EXPECT_EQ(render("1970-01-02 00:00:01", "TIMESTAMP"), "86401");
+    EXPECT_EQ(render(-1, "TIMESTAMP"), "Value conversion error: -1 is out of range for TIMESTAMP");
+}
+
+TEST(NebulaValueTest, InfersNarrowTypes) {
+    auto infer = [](std::initializer_list<JsonDocument> values) {
+        graph::TypeInference inference;
+        for (const auto& value : values) inference.observe(value);
+        auto type = inference.type();
+        return type ? graph::nebula_type_name(type->type) : "none";
+    };
+    EXPECT_STREQ(infer({1, -100, 127}), "INT8");
+    EXPECT_STREQ(infer({1, 40000}), "INT32");
+    EXPECT_STREQ(infer({int64_t{1} << 40}), "INT64");
+    EXPECT_STREQ(infer({0.5, 2, nullptr}), "FLOAT");
+    EXPECT_STREQ(infer({0.1}), "DOUBLE");
+    EXPECT_STREQ(infer({"2024-01-01", "1999-12-31"}), "DATE");
+    EXPECT_STREQ(infer({"2024-01-01T10:00:00"}), "DATETIME");
+    EXPECT_STREQ(infer({"2024-01-01", "soon"}), "STRING");
+    EXPECT_STREQ(infer({true, 1}), "STRING");
+    EXPECT_STREQ(infer({nullptr}), "none");
+}
+
+TEST(NebulaValueTest, GeneratorMatchesTheValueApi) {
+    EXPECT_EQ(generated(12, "INT16"), "INSERT VERTEX T (v) VALUES \"a\":(12);");
+    EXPECT_EQ(generated("2024-01-31", "DATE"),
+              "INSERT VERTEX T (v) VALUES \"a\":(date(\"2024-01-31\"));");
+    EXPECT_EQ(generated(1000, "INT8"), "Value conversion error: 1000 is out of range for INT8");
+    // Every control byte is escaped, with octal where nGQL has no name for it
+    EXPECT_EQ(generated("q\" b\\ \n\t\b\f\x01\x1f\x7f", "STRING"),
+              "INSERT VERTEX T (v) VALUES \"a\":(\"q\\\" b\\\\ \\n\\t\\b\\f\\001\\037\\177\");");
+
+    // extract_value and format_value agree with the fast path
+    graph::StatementGenerator generator;
+    for (auto [json, type] : {std::pair<JsonDocument, std::string>{"2024-01-31", "DATE"},
+                              {"abcdef", "FIXED_STRING(3)"},
+                              {"bell\a tab\t", "STRING"},
+                              {3.25, "FLOAT"},
+                              {127.0276543, "FLOAT"},
+                              {12345678.9, "DOUBLE"},
+                              {-5, "INT8"},
+                              {"12:00:00", "TIME"}}) {
+        auto value = generator.extract_value(JsonDocument{{"v", json}}, "v", type);
+        ASSERT_TRUE(std::holds_alternative<graph::Value>(value)) << type;
+        auto formatted = generator.format_value(std::get<graph::Value>(value));
+        EXPECT_EQ(std::get<std::string>(formatted), render(json, type)) << type;
+    }
+    auto error = generator.extract_value(JsonDocument{{"v", 200}}, "v", "INT8");
+    ASSERT_TRUE(std::holds_alternative<graph::StatementError>(error));
+    EXPECT_EQ(std::get<graph::StatementError>(error).context, "v");
+}
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include "graph/pipeline.hpp"
+#include "parser/yaml_parser.hpp"
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using parser::json::InputFormat;
+using parser::json::Record;
+using parser::json::RecordReader;
+
+fs::path temp_path(const std::string& name) {
+    return fs::temp_directory_path() /
+           ("nebula_mapper_pipeline_" + std::to_string(::getpid()) + "_" + name);
+}
+
+fs::path write_file(const fs::path& path, const std::string& content) {
+    fs::create_directories(path.parent_path());
+    std::ofstream(path, std::ios::binary) << content;
+    return path;
+}
+
+std::unique_ptr<RecordReader> open(const fs::path& path,
+                                   InputFormat format = InputFormat::AUTO) {
+    auto reader = parser::json::open_records(path.string(), format);
+    if (std::holds_alternative<parser::json::Error>(reader)) {
+        ADD_FAILURE() << std::get<parser::json::Error>(reader).message;
+        return nullptr;
+    }
+    return std::move(std::get<std::unique_ptr<RecordReader>>(reader));
+}
+
+std::vector<std::string> read_all(RecordReader& reader) {
+    std::vector<std::string> texts;
+    for (;;) {
+        auto next = reader.next();
+        if (std::holds_alternative<parser::json::Error>(next)) {
+            ADD_FAILURE() << std::get<parser::json::Error>(next).message;
+            break;
+        }
+        auto& record = std::get<std::optional<Record>>(next);
+        if (!record) break;
+        texts.push_back(record->text);
+    }
+    return texts;
+}
+
+const parser::mapping::GraphMapping& place_mapping() {
+    static const auto mapping = [] {
+        auto yaml = parser::yaml::parse(R"(
+tags:
+  Place:
+    from: basicInfo
+    key: cid
+    properties:
+      - json: cid
+        type: INT64
+      - json: name
+        type: STRING
+)");
+        return std::get<parser::mapping::GraphMapping>(parser::mapping::create_mapping(yaml));
+    }();
+    return mapping;
+}
+
+std::string place(int cid) {
+    return R"({"basicInfo": {"cid": )" + std::to_string(cid) +
+           R"(, "name": "place )" + std::to_string(cid) + R"("}})";
+}
+
+class CollectingSink : public graph::StatementSink {
+public:
+    void consume(std::vector<std::string>&& statements) override {
+        for (auto& stmt : statements) {
+            statements_.push_back(std::move(stmt));
+        }
+    }
+
+    std::vector<std::string> statements_;
+};
+
+} // namespace
+
+TEST(RecordReaderTest, DetectsFormats) {
+    auto ndjson = write_file(temp_path("records.ndjson"), "{\"a\": 1}\n\n{\"a\": 2}\r\n");
+    auto array = write_file(temp_path("records.json"),
+                            " [ {\"a\": \"x,]\\\"\"}, [1, {\"b\": [2]}], 3 ]");
+    auto document = write_file(temp_path("document.json"), "{\"a\": [1, 2]}");
+    auto directory = temp_path("records");
+    write_file(directory / "b" / "2.json", "{\"n\": 2}");
+    write_file(directory / "a.json", "{\"n\": 1}");
+
+    auto reader = open(ndjson);
+    EXPECT_EQ(read_all(*reader), (std::vector<std::string>{"{\"a\": 1}", "{\"a\": 2}"}));
+
+    reader = open(array);
+    EXPECT_EQ(read_all(*reader), (std::vector<std::string>{
+        "{\"a\": \"x,]\\\"\"}", " [1, {\"b\": [2]}]", " 3 "}));
+
+    reader = open(document);
+    EXPECT_EQ(read_all(*reader), (std::vector<std::string>{"{\"a\": [1, 2]}"}));
+
+    reader = open(directory);
+    EXPECT_EQ(read_all(*reader), (std::vector<std::string>{"{\"n\": 1}", "{\"n\": 2}"}));
+
+    // An explicit format wins over detection
+    reader = open(array, InputFormat::DOCUMENT);
+    EXPECT_EQ(read_all(*reader).size(), 1u);
+
+    fs::remove(ndjson);
+    fs::remove(array);
+    fs::remove(document);
+    fs::remove_all(directory);
+}
+
+TEST(RecordReaderTest, RejectsBrokenArrays) {
+    auto path = write_file(temp_path("broken.json"), "[{\"a\": 1}, {\"a\": 2}");
+    auto reader = open(path);
+    ASSERT_TRUE(std::holds_alternative<std::optional<Record>>(reader->next()));
+    EXPECT_TRUE(std::holds_alternative<parser::json::Error>(reader->next()));
+
+    write_file(path, "[1,,2]");
+    reader = open(path);
+    reader->next();
+    EXPECT_TRUE(std::holds_alternative<parser::json::Error>(reader->next()));
+
+    EXPECT_TRUE(std::holds_alternative<parser::json::Error>(
+        parser::json::open_records(temp_path("missing.json").string())));
+    fs::remove(path);
+}
+
+TEST(PipelineTest, ThreadsKeepInputOrder) {
+    std::string input;
+    for (int i = 0; i < 200; ++i) {
+        input += place(i) + "\n";
+    }
+    auto path = write_file(temp_path("places.ndjson"), input);
+
+    std::vector<std::string> expected;
+    for (size_t threads : {1, 2, 8}) {
+        auto reader = open(path);
+        CollectingSink sink;
+        graph::PipelineOptions options;
+        options.threads = threads;
+        options.queue_capacity = 3;
+
+        auto result = graph::run_pipeline(place_mapping(), *reader, sink, options);
+        ASSERT_TRUE(std::holds_alternative<graph::PipelineSummary>(result));
+        const auto& summary = std::get<graph::PipelineSummary>(result);
+        EXPECT_EQ(summary.records, 200u);
+        EXPECT_EQ(summary.input_bytes, input.size());
+        EXPECT_EQ(summary.statements, sink.statements_.size());
+
+        if (expected.empty()) {
+            expected = sink.statements_;
+            ASSERT_EQ(expected.size(), 200u);
+            EXPECT_NE(expected.front().find("\"place 0\""), std::string::npos);
+        } else {
+            EXPECT_EQ(sink.statements_, expected) << threads << " threads";
+        }
+    }
+    fs::remove(path);
+}
+
+TEST(PipelineTest, ReportsTheFirstBadRecord) {
+    auto path = write_file(temp_path("bad.ndjson"),
+                           place(1) + "\n" + place(2) + "\n{\"basicInfo\": \n" +
+                           "{\"other\": {}}\n" + place(5) + "\n");
+
+    for (size_t threads : {1, 4}) {
+        auto reader = open(path);
+        CollectingSink sink;
+        graph::PipelineOptions options;
+        options.threads = threads;
+
+        auto result = graph::run_pipeline(place_mapping(), *reader, sink, options);
+        ASSERT_TRUE(std::holds_alternative<graph::StatementError>(result));
+        const auto& error = std::get<graph::StatementError>(result);
+        EXPECT_EQ(error.message.rfind("JSON error", 0), 0u) << error.message;
+        ASSERT_TRUE(error.context.has_value());
+        EXPECT_EQ(*error.context, path.string() + ":3");
+    }
+    fs::remove(path);
+}
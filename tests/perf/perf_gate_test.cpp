@@ -0,0 +1,251 @@
+#include <gtest/gtest.h>
+#include "corpus/corpus_generator.hpp"
+#include "graph/pipeline.hpp"
+#include "parser/yaml_parser.hpp"
+#include "telemetry/allocations.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <sys/resource.h>
+#include <unistd.h>
+
+// Performance regression gate (ctest label "perf"). A fixed workload runs
+// through the serial pipeline. Its throughput is divided by the speed of a
+// calibration loop, so baselines carry over between machines of different
+// speed. The results are compared with perf/perf_baseline.json, keyed by
+// build type.
+//
+//   NEBULA_MAPPER_PERF_TOLERANCE=0.25  allowed regression (default 0.25)
+//   NEBULA_MAPPER_PERF_UPDATE=1        record the measured figures instead
+
+namespace fs = std::filesystem;
+using Json = parser::json::JsonDocument;
+
+namespace {
+
+constexpr const char* BASELINE_FILE = "perf/perf_baseline.json";
+constexpr uint64_t WORKLOAD_PLACES = 300;
+constexpr int REPETITIONS = 3;
+
+std::string build_key() {
+    std::string key = NEBULA_MAPPER_BUILD_TYPE;
+    if (key.empty()) key = "default";
+#ifdef NEBULA_MAPPER_ALLOC_TRACKING
+    key += "+alloc-tracking";
+#endif
+    return key;
+}
+
+double tolerance() {
+    const char* value = std::getenv("NEBULA_MAPPER_PERF_TOLERANCE");
+    return value ? std::stod(value) : 0.25;
+}
+
+bool updating() {
+    const char* value = std::getenv("NEBULA_MAPPER_PERF_UPDATE");
+    return value && std::string(value) == "1";
+}
+
+double since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Seconds for a fixed mix of the work the mapper does per value: format
+// numbers, build strings, scan and hash them. Best of two.
+double calibrate() {
+    double best = 1e9;
+    for (int round = 0; round < 2; ++round) {
+        auto start = std::chrono::steady_clock::now();
+        uint64_t hash = 1469598103934665603ULL;
+        std::string text;
+        for (uint32_t i = 0; i < 400000; ++i) {
+            text.clear();
+            text += "\"value ";
+            text += std::to_string(i * 2654435761u);
+            text += "\":(";
+            text += std::to_string(static_cast<double>(i) / 7.0);
+            text += ')';
+            for (char c : text) {
+                hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+            }
+        }
+        double seconds = since(start);
+        // Keeps the loop from being optimized away
+        EXPECT_NE(hash, 0u);
+        best = std::min(best, seconds);
+    }
+    return best;
+}
+
+class DiscardingSink : public graph::StatementSink {
+public:
+    void consume(std::vector<std::string>&& statements) override {
+        count_ += statements.size();
+    }
+
+    uint64_t count_{0};
+};
+
+struct Measurement {
+    double records_per_second{0.0};
+    double normalized_throughput{0.0};   // Records per calibration loop
+    double allocations_per_record{0.0};
+    long peak_rss_kb{0};
+};
+
+class PerfGateTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        corpus::CorpusOptions options;
+        options.seed = 86;
+        options.places = WORKLOAD_PLACES;
+        options.missing_field_rate = 0.0;
+        options.null_field_rate = 0.0;
+        input_ = fs::temp_directory_path() /
+                 ("nebula_mapper_perf_" + std::to_string(::getpid()) + ".ndjson");
+        auto written = corpus::write_corpus(options, corpus::OutputFormat::NDJSON,
+                                            input_.string());
+        ASSERT_TRUE(std::holds_alternative<corpus::WriteSummary>(written));
+
+        // The YAML layer logs while decoding
+        std::stringstream log;
+        auto* saved = std::cerr.rdbuf(log.rdbuf());
+        auto yaml = parser::yaml::parse_file(corpus::kakao_mapping_path());
+        auto mapping = parser::mapping::create_mapping(yaml);
+        std::cerr.rdbuf(saved);
+        ASSERT_TRUE(std::holds_alternative<parser::mapping::GraphMapping>(mapping));
+        mapping_ = std::get<parser::mapping::GraphMapping>(mapping);
+    }
+
+    static void TearDownTestSuite() {
+        std::error_code ignored;
+        fs::remove(input_, ignored);
+    }
+
+    // Best of REPETITIONS, each normalized by a calibration taken right
+    // before it, so a slow moment on a shared machine only costs one round
+    Measurement measure() {
+        Measurement best;
+        for (int round = 0; round < REPETITIONS; ++round) {
+            double calibration = calibrate();
+
+            auto reader = parser::json::open_records(input_.string());
+            EXPECT_TRUE(std::holds_alternative<std::unique_ptr<parser::json::RecordReader>>(reader));
+            if (!std::holds_alternative<std::unique_ptr<parser::json::RecordReader>>(reader)) {
+                return best;
+            }
+            DiscardingSink sink;
+#ifdef NEBULA_MAPPER_ALLOC_TRACKING
+            telemetry::reset_allocation_counters();
+#endif
+            auto start = std::chrono::steady_clock::now();
+            auto result = graph::run_pipeline(
+                mapping_, *std::get<std::unique_ptr<parser::json::RecordReader>>(reader), sink);
+            double seconds = since(start);
+            EXPECT_TRUE(std::holds_alternative<graph::PipelineSummary>(result));
+            if (!std::holds_alternative<graph::PipelineSummary>(result)) {
+                return best;
+            }
+            const auto& summary = std::get<graph::PipelineSummary>(result);
+
+            auto records = static_cast<double>(summary.records);
+            double throughput = records / seconds;
+            if (throughput * calibration > best.normalized_throughput) {
+                best.records_per_second = throughput;
+                best.normalized_throughput = throughput * calibration;
+            }
+#ifdef NEBULA_MAPPER_ALLOC_TRACKING
+            // Per input record: the workload is fixed, so this moves with
+            // allocations per mapped row
+            best.allocations_per_record =
+                static_cast<double>(telemetry::allocation_total().allocations) / records;
+#endif
+        }
+
+        rusage usage{};
+        ::getrusage(RUSAGE_SELF, &usage);
+        best.peak_rss_kb = usage.ru_maxrss;
+        return best;
+    }
+
+    static fs::path input_;
+    static parser::mapping::GraphMapping mapping_;
+};
+
+fs::path PerfGateTest::input_;
+parser::mapping::GraphMapping PerfGateTest::mapping_;
+
+Json load_baseline() {
+    std::ifstream in(BASELINE_FILE);
+    if (!in) return Json::object();
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    auto parsed = parser::json::parse(buffer.str());
+    return std::holds_alternative<Json>(parsed) ? std::get<Json>(parsed) : Json::object();
+}
+
+void save_baseline(const Json& baseline) {
+    std::ofstream out(BASELINE_FILE);
+    out << baseline.dump(2) << '\n';
+}
+
+} // namespace
+
+TEST_F(PerfGateTest, PipelineWithinBaseline) {
+    Measurement measured = measure();
+    ASSERT_GT(measured.normalized_throughput, 0.0);
+
+    std::cout << "perf gate [" << build_key() << "]: "
+              << measured.records_per_second << " records/s, "
+              << measured.normalized_throughput << " records per calibration, "
+              << measured.peak_rss_kb << " KiB peak RSS";
+#ifdef NEBULA_MAPPER_ALLOC_TRACKING
+    std::cout << ", " << measured.allocations_per_record << " allocations per record";
+#endif
+    std::cout << '\n';
+
+    Json baseline = load_baseline();
+    if (updating()) {
+        Json entry = {
+            {"normalized_throughput", measured.normalized_throughput},
+            {"peak_rss_kb", measured.peak_rss_kb},
+        };
+#ifdef NEBULA_MAPPER_ALLOC_TRACKING
+        entry["allocations_per_record"] = measured.allocations_per_record;
+#endif
+        baseline["workload_places"] = WORKLOAD_PLACES;
+        baseline["builds"][build_key()] = entry;
+        save_baseline(baseline);
+        GTEST_SKIP() << "Recorded baseline for " << build_key() << " in " << BASELINE_FILE;
+    }
+
+    if (!baseline.contains("builds") || !baseline["builds"].contains(build_key())) {
+        GTEST_SKIP() << "No baseline for build " << build_key()
+                     << "; record one with NEBULA_MAPPER_PERF_UPDATE=1";
+    }
+    ASSERT_EQ(baseline.value("workload_places", uint64_t{0}), WORKLOAD_PLACES)
+        << "Workload changed; record a new baseline";
+
+    const Json& expected = baseline["builds"][build_key()];
+    double allowed = tolerance();
+
+    double min_throughput = expected.value("normalized_throughput", 0.0) * (1.0 - allowed);
+    EXPECT_GE(measured.normalized_throughput, min_throughput)
+        << "Throughput regressed more than " << allowed * 100 << "%";
+
+    double max_rss = static_cast<double>(expected.value("peak_rss_kb", 0L)) * (1.0 + allowed);
+    EXPECT_LE(static_cast<double>(measured.peak_rss_kb), max_rss)
+        << "Peak RSS grew more than " << allowed * 100 << "%";
+
+#ifdef NEBULA_MAPPER_ALLOC_TRACKING
+    if (expected.contains("allocations_per_record")) {
+        double max_allocations =
+            expected["allocations_per_record"].get<double>() * (1.0 + allowed);
+        EXPECT_LE(measured.allocations_per_record, max_allocations)
+            << "Allocations per record grew more than " << allowed * 100 << "%";
+    }
+#endif
+}
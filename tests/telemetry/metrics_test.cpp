@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "telemetry/metrics.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+// Issue one HTTP request against the local server and return the raw response
+std::string http_get(uint16_t port, const std::string& path, const std::string& headers = "") {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return {};
+    }
+
+    std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n" + headers + "\r\n";
+    ::send(fd, request.data(), request.size(), MSG_NOSIGNAL);
+
+    std::string response;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = ::recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, static_cast<size_t>(n));
+    }
+    ::close(fd);
+    return response;
+}
+
+std::string read_all(const std::filesystem::path& path) {
+    std::ifstream in(path);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+} // namespace
+
+TEST(HistogramTest, BucketsBoundRelativeError) {
+    telemetry::Histogram histogram;
+    for (uint64_t v = 1; v <= 1000; ++v) {
+        histogram.record(v);
+    }
+
+    EXPECT_EQ(histogram.count(), 1000u);
+    EXPECT_EQ(histogram.sum(), 500500u);
+    EXPECT_EQ(histogram.max(), 1000u);
+
+    auto p50 = histogram.percentile(0.5);
+    EXPECT_GE(p50, 500u);
+    EXPECT_LE(p50, 500u + 500u / 8);
+    EXPECT_EQ(histogram.percentile(1.0), 1000u);
+
+    for (size_t i = 1; i < telemetry::Histogram::BUCKET_COUNT; ++i) {
+        ASSERT_EQ(telemetry::Histogram::bucket_lower_bound(i),
+                  telemetry::Histogram::bucket_upper_bound(i - 1) + 1);
+    }
+    EXPECT_EQ(telemetry::Histogram::bucket_index(UINT64_MAX),
+              telemetry::Histogram::BUCKET_COUNT - 1);
+}
+
+TEST(MetricsTest, RendersOpenMetricsText) {
+    auto& registry = telemetry::MetricsRegistry::instance();
+    registry.counter("test_render_rows", "Rows seen", {{"mapping", "Place"}}).add(3);
+    registry.gauge("test_render_depth", "Queue depth").set(7);
+    auto& latency = registry.histogram("test_render_latency_seconds", "Latency", {}, 1e9);
+    latency.record(1000000);
+    latency.record(3000000);
+
+    auto text = registry.render();
+    EXPECT_NE(text.find("# TYPE test_render_rows counter"), std::string::npos);
+    EXPECT_NE(text.find("test_render_rows_total{mapping=\"Place\"} 3"), std::string::npos);
+    EXPECT_NE(text.find("test_render_depth 7"), std::string::npos);
+    EXPECT_NE(text.find("test_render_latency_seconds_bucket{le=\"+Inf\"} 2"), std::string::npos);
+    EXPECT_NE(text.find("test_render_latency_seconds_count 2"), std::string::npos);
+    EXPECT_NE(text.find("test_render_latency_seconds_sum 0.004"), std::string::npos);
+    EXPECT_EQ(text.substr(text.size() - 6), "# EOF\n");
+
+    auto classic = registry.render(telemetry::ExpositionFormat::PROMETHEUS);
+    EXPECT_NE(classic.find("# TYPE test_render_rows_total counter"), std::string::npos);
+    EXPECT_EQ(classic.find("# EOF"), std::string::npos);
+}
+
+TEST(MetricsTest, ServesScrapesOverHttp) {
+    auto& registry = telemetry::MetricsRegistry::instance();
+    auto& scraped = registry.counter("test_scrape_requests", "Requests served");
+    scraped.add(42);
+
+    telemetry::MetricsServer server;
+    ASSERT_TRUE(server.start(0));
+    ASSERT_NE(server.port(), 0);
+
+    auto response = http_get(server.port(), "/metrics",
+                             "Accept: application/openmetrics-text; version=1.0.0\r\n");
+    EXPECT_EQ(response.rfind("HTTP/1.1 200 OK", 0), 0u);
+    EXPECT_NE(response.find("Content-Type: application/openmetrics-text"), std::string::npos);
+    EXPECT_NE(response.find("test_scrape_requests_total 42"), std::string::npos);
+    EXPECT_NE(response.find("# EOF"), std::string::npos);
+
+    // Later updates are visible in the next scrape
+    scraped.add();
+    response = http_get(server.port(), "/metrics", "Accept: text/plain\r\n");
+    EXPECT_NE(response.find("Content-Type: text/plain"), std::string::npos);
+    EXPECT_NE(response.find("test_scrape_requests_total 43"), std::string::npos);
+
+    // Header names and media types are case-insensitive
+    response = http_get(server.port(), "/metrics", "accept: text/plain\r\n");
+    EXPECT_NE(response.find("Content-Type: text/plain"), std::string::npos);
+    response = http_get(server.port(), "/metrics", "ACCEPT: Application/OpenMetrics-Text\r\n");
+    EXPECT_NE(response.find("Content-Type: application/openmetrics-text"), std::string::npos);
+
+    EXPECT_EQ(http_get(server.port(), "/other").rfind("HTTP/1.1 404", 0), 0u);
+    server.stop();
+}
+
+TEST(MetricsTest, WritesTextfileAtomically) {
+    auto path = std::filesystem::temp_directory_path() /
+                ("nebula_mapper_metrics_" + std::to_string(::getpid()) + ".prom");
+    auto& registry = telemetry::MetricsRegistry::instance();
+    auto& gauge = registry.gauge("test_textfile_value", "Value written to the textfile");
+    gauge.set(1);
+
+    telemetry::TextfileExporter exporter;
+    ASSERT_TRUE(exporter.start(path.string(), std::chrono::milliseconds(20)));
+    EXPECT_NE(read_all(path).find("test_textfile_value 1"), std::string::npos);
+
+    gauge.set(2);
+    exporter.stop();
+    auto text = read_all(path);
+    EXPECT_NE(text.find("test_textfile_value 2"), std::string::npos);
+    EXPECT_FALSE(std::filesystem::exists(path.string() + ".tmp"));
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include "graph/pipeline.hpp"
+#include "parser/yaml_parser.hpp"
+#include "telemetry/progress.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+TEST(ProgressTest, SamplesRatesAndEta) {
+    telemetry::ProgressCounters counters;
+    std::ostringstream out;
+    telemetry::ProgressReporter reporter(counters, 1000, out);
+
+    counters.input_bytes = 250;
+    counters.records = 5;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    auto progress = reporter.sample();
+    EXPECT_EQ(progress.input_bytes, 250u);
+    EXPECT_EQ(progress.records, 5u);
+    EXPECT_GT(progress.bytes_per_second, 0.0);
+    ASSERT_TRUE(progress.eta_seconds);
+    // 750 bytes left at the measured rate
+    EXPECT_NEAR(*progress.eta_seconds, 750.0 / progress.bytes_per_second, 1e-9);
+
+    auto line = telemetry::format_progress(progress);
+    EXPECT_EQ(line.rfind("progress: 25.0%", 0), 0u) << line;
+    EXPECT_NE(line.find("ETA"), std::string::npos);
+
+    counters.input_bytes = 1000;
+    progress = reporter.sample();
+    EXPECT_DOUBLE_EQ(*progress.eta_seconds, 0.0);
+}
+
+TEST(ProgressTest, ReporterWritesJsonLinesAndAFinalLine) {
+    telemetry::ProgressCounters counters;
+    std::ostringstream out;
+    {
+        telemetry::ProgressReporter reporter(counters, 0, out, telemetry::ProgressFormat::JSON);
+        reporter.start(std::chrono::milliseconds(5));
+        counters.records = 3;
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        reporter.stop();
+    }
+
+    std::istringstream lines(out.str());
+    std::string line;
+    std::vector<nlohmann::json> events;
+    while (std::getline(lines, line)) {
+        events.push_back(nlohmann::json::parse(line));
+    }
+    ASSERT_GE(events.size(), 2u);
+    EXPECT_EQ(events.front()["event"], "progress");
+    EXPECT_EQ(events.back()["event"], "done");
+    EXPECT_EQ(events.back()["records"], 3);
+    // No total, so no ETA
+    EXPECT_FALSE(events.front().contains("eta_seconds"));
+}
+
+TEST(ProgressTest, PipelineKeepsCountersCurrent) {
+    auto yaml = parser::yaml::parse(R"(
+tags:
+  Place:
+    from: basicInfo
+    key: cid
+    properties:
+      - json: cid
+        type: INT64
+  Review:
+    from: comment/list
+    key: commentid
+    properties: []
+)");
+    auto mapping = std::get<parser::mapping::GraphMapping>(parser::mapping::create_mapping(yaml));
+
+    std::string input;
+    for (int i = 0; i < 50; ++i) {
+        input += R"({"basicInfo": {"cid": )" + std::to_string(i) +
+                 R"(}, "comment": {"list": [{"commentid": "a"}, {"commentid": "b"}]}})" "\n";
+    }
+    auto path = fs::temp_directory_path() /
+                ("nebula_mapper_progress_" + std::to_string(::getpid()) + ".ndjson");
+    std::ofstream(path, std::ios::binary) << input;
+    EXPECT_EQ(parser::json::input_size(path.string()), input.size());
+
+    for (size_t threads : {1, 4}) {
+        telemetry::ProgressCounters counters;
+        graph::PipelineOptions options;
+        options.threads = threads;
+        options.progress = &counters;
+
+        auto reader = std::get<std::unique_ptr<parser::json::RecordReader>>(
+            parser::json::open_records(path.string()));
+        graph::VectorSink sink;
+        auto result = graph::run_pipeline(mapping, *reader, sink, options);
+        ASSERT_TRUE(std::holds_alternative<graph::PipelineSummary>(result));
+        const auto& summary = std::get<graph::PipelineSummary>(result);
+
+        EXPECT_EQ(counters.records, 50u);
+        EXPECT_EQ(counters.input_bytes, input.size());
+        EXPECT_EQ(counters.rows, 150u);
+        EXPECT_EQ(counters.statements, summary.statements);
+        EXPECT_EQ(counters.statement_bytes, summary.statement_bytes);
+    }
+    fs::remove(path);
+}
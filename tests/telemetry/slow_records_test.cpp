@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include "graph/pipeline.hpp"
+#include "parser/yaml_parser.hpp"
+#include "telemetry/slow_records.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+using namespace std::chrono_literals;
+
+telemetry::RecordTiming timing(const std::string& source, uint64_t ms) {
+    telemetry::RecordTiming result;
+    result.source = source;
+    result.total_ns = ms * 1000000;
+    return result;
+}
+
+std::string place(int cid, int reviews) {
+    std::string list;
+    for (int i = 0; i < reviews; ++i) {
+        list += std::string(i ? "," : "") + R"({"commentid": ")" + std::to_string(cid) + "-" +
+                std::to_string(i) + R"("})";
+    }
+    return R"({"basicInfo": {"cid": )" + std::to_string(cid) +
+           R"(}, "comment": {"list": [)" + list + "]}}";
+}
+
+} // namespace
+
+TEST(SlowRecordLogTest, KeepsTheSlowestAndLogsOverThreshold) {
+    std::ostringstream log;
+    telemetry::SlowRecordLog slow(50ms, 3, &log);
+    for (uint64_t ms : {10, 70, 30, 5, 90, 50, 20}) {
+        slow.observe(timing("r" + std::to_string(ms), ms));
+    }
+
+    auto slowest = slow.slowest();
+    ASSERT_EQ(slowest.size(), 3u);
+    EXPECT_EQ(slowest[0].source, "r90");
+    EXPECT_EQ(slowest[1].source, "r70");
+    EXPECT_EQ(slowest[2].source, "r50");
+
+    EXPECT_EQ(slow.records(), 7u);
+    EXPECT_EQ(slow.slow_records(), 3u);
+    std::string logged = log.str();
+    EXPECT_NE(logged.find("r70"), std::string::npos);
+    EXPECT_NE(logged.find("r50 "), std::string::npos);
+    EXPECT_EQ(logged.find("r30"), std::string::npos);
+
+    auto summary = telemetry::format_slow_records(slow);
+    EXPECT_LT(summary.find("r90"), summary.find("r70"));
+}
+
+TEST(SlowRecordLogTest, PipelineReportsOffsetsStagesAndRows) {
+    auto yaml = parser::yaml::parse(R"(
+tags:
+  Place:
+    from: basicInfo
+    key: cid
+    properties:
+      - json: cid
+        type: INT64
+  Review:
+    from: comment/list
+    key: commentid
+    properties: []
+)");
+    auto mapping = std::get<parser::mapping::GraphMapping>(parser::mapping::create_mapping(yaml));
+
+    std::string lines = place(1, 2) + "\n" + place(2, 40) + "\n" + place(3, 1) + "\n";
+    auto path = fs::temp_directory_path() /
+                ("nebula_mapper_slow_" + std::to_string(::getpid()) + ".ndjson");
+    std::ofstream(path, std::ios::binary) << lines;
+
+    for (size_t threads : {1, 3}) {
+        telemetry::enable_stats();
+        telemetry::SlowRecordLog slow(0ns, 3);
+        graph::PipelineOptions options;
+        options.threads = threads;
+        options.slow_records = &slow;
+
+        auto reader = std::get<std::unique_ptr<parser::json::RecordReader>>(
+            parser::json::open_records(path.string()));
+        graph::VectorSink sink;
+        ASSERT_TRUE(std::holds_alternative<graph::PipelineSummary>(
+            graph::run_pipeline(mapping, *reader, sink, options)));
+        telemetry::enable_stats(false);
+
+        EXPECT_EQ(slow.records(), 3u);
+        EXPECT_EQ(slow.slow_records(), 3u);
+        auto slowest = slow.slowest();
+        ASSERT_EQ(slowest.size(), 3u);
+
+        const telemetry::RecordTiming* second = nullptr;
+        for (const auto& record : slowest) {
+            if (record.index == 1) second = &record;
+        }
+        ASSERT_NE(second, nullptr);
+        EXPECT_EQ(second->source, path.string() + ":2");
+        EXPECT_EQ(second->offset, place(1, 2).size() + 1);
+        EXPECT_EQ(second->bytes, place(2, 40).size());
+        EXPECT_EQ(second->rows.at("Place"), 1u);
+        EXPECT_EQ(second->rows.at("Review"), 40u);
+        EXPECT_GT(second->stage_ns[static_cast<size_t>(telemetry::Stage::JSON_PARSE)], 0u);
+        EXPECT_GT(second->stage_ns[static_cast<size_t>(telemetry::Stage::EXTRACTION)], 0u);
+    }
+    fs::remove(path);
+}
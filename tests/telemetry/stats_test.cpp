@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include "graph/statement_generator.hpp"
+#include "parser/yaml_parser.hpp"
+#include "telemetry/stats.hpp"
+
+TEST(StatsTest, RecordsRowAndBatchShapesPerMapping) {
+    auto yaml = parser::yaml::parse(R"(
+tags:
+  Place:
+    from: basicInfo
+    key: cid
+    properties:
+      - json: cid
+        type: INT64
+  Review:
+    from: comment/list
+    key: commentid
+    properties:
+      - json: contents
+        type: STRING
+)");
+    auto mapping = std::get<parser::mapping::GraphMapping>(parser::mapping::create_mapping(yaml));
+    auto document = std::get<parser::json::JsonDocument>(parser::json::parse(R"({
+        "basicInfo": {"cid": 7},
+        "comment": {"list": [
+            {"commentid": "a", "contents": "x"},
+            {"commentid": "b", "contents": "xxxxxxxxxx"},
+            {"commentid": "c", "contents": "x"},
+            {"commentid": "d", "contents": "x"},
+            {"commentid": "e", "contents": "x"}
+        ]}
+    })"));
+
+    telemetry::reset_stats();
+    telemetry::enable_stats();
+    graph::StatementGenerator generator;
+    auto statements = generator.generate_batch_statements(mapping, document, 2);
+    telemetry::enable_stats(false);
+    ASSERT_TRUE(std::holds_alternative<std::vector<std::string>>(statements));
+
+    auto stats = telemetry::collect_stats();
+    const auto& review = stats.mappings.at("Review");
+    EXPECT_EQ(review.row_sizes.count(), 5u);
+    EXPECT_EQ(review.row_sizes.sum(), review.bytes);
+    // "b" carries the longest contents
+    EXPECT_EQ(review.row_sizes.max(), std::string(R"("b":("xxxxxxxxxx"))").size());
+    EXPECT_EQ(review.batch_rows.count(), 3u);
+    EXPECT_EQ(review.batch_rows.max(), 2u);
+    EXPECT_EQ(review.batch_closes[static_cast<size_t>(telemetry::BatchClose::FULL)], 2u);
+    EXPECT_EQ(review.batch_closes[static_cast<size_t>(telemetry::BatchClose::FLUSH)], 1u);
+
+    auto json = telemetry::stats_to_json(stats);
+    const auto& review_json = json["mappings"]["Review"];
+    EXPECT_EQ(review_json["batch_rows"]["p50"], 2);
+    EXPECT_EQ(review_json["batch_rows"]["max"], 2);
+    EXPECT_EQ(review_json["batch_closes"]["full"], 2);
+    EXPECT_EQ(review_json["batch_closes"]["flush"], 1);
+    EXPECT_EQ(review_json["batch_closes"]["single_row"], 0);
+    EXPECT_EQ(review_json["statement_size"]["count"], 3);
+    EXPECT_EQ(review_json["statement_size"]["sum"], review.statement_bytes);
+    EXPECT_EQ(review_json["row_size"]["p99"], review.row_sizes.percentile(0.99));
+
+    // Buckets are [lower, upper, count] and add up to the sample count
+    uint64_t bucketed = 0;
+    for (const auto& bucket : review_json["row_size"]["buckets"]) {
+        EXPECT_LE(bucket[0].get<uint64_t>(), bucket[1].get<uint64_t>());
+        bucketed += bucket[2].get<uint64_t>();
+    }
+    EXPECT_EQ(bucketed, 5u);
+
+    EXPECT_EQ(json["mappings"]["Place"]["batch_closes"]["flush"], 1);
+    telemetry::reset_stats();
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include "parser/json_parser.hpp"
+#include "telemetry/trace.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using parser::json::JsonDocument;
+
+TEST(TraceTest, WritesNewestSpansAsTraceEvents) {
+    telemetry::enable_tracing(4);
+
+    // A fresh thread, so its ring is sized for 4 events
+    const std::string long_detail = "quote \" backslash \\ newline \n and then some more text";
+    std::thread worker([&] {
+        for (int i = 0; i < 10; ++i) {
+            std::string detail = "span " + std::to_string(i);
+            telemetry::TraceSpan span("map", detail);
+        }
+        telemetry::TraceSpan span("write", long_detail);
+    });
+    worker.join();
+
+    auto path = fs::temp_directory_path() /
+                ("nebula_mapper_trace_" + std::to_string(::getpid()) + ".json");
+    ASSERT_TRUE(telemetry::write_chrome_trace(path.string()));
+    std::ifstream in(path);
+    std::stringstream text;
+    text << in.rdbuf();
+    in.close();
+    fs::remove(path);
+
+    auto trace = JsonDocument::parse(text.str(), nullptr, false);
+    ASSERT_FALSE(trace.is_discarded()) << text.str();
+    ASSERT_TRUE(trace["traceEvents"].is_array());
+
+    // Only the newest four spans survive the wrap, oldest first
+    std::vector<JsonDocument> spans;
+    for (const auto& event : trace["traceEvents"]) {
+        if (event["ph"] == "M") continue;
+        EXPECT_EQ(event["ph"], "X");
+        EXPECT_EQ(event["pid"], 1);
+        EXPECT_TRUE(event["ts"].is_number());
+        EXPECT_GE(event["dur"].get<double>(), 0.0);
+        spans.push_back(event);
+    }
+    ASSERT_EQ(spans.size(), 4u);
+    EXPECT_EQ(spans[0]["args"]["detail"], "span 7");
+    EXPECT_EQ(spans[2]["args"]["detail"], "span 9");
+    EXPECT_EQ(spans[3]["name"], "write");
+
+    // Details are cut to the event's 39 bytes; control bytes become spaces
+    auto detail = spans[3]["args"]["detail"].get<std::string>();
+    EXPECT_EQ(detail, std::string("quote \" backslash \\ newline   and then some more text")
+                          .substr(0, sizeof(telemetry::TraceEvent::detail) - 1));
+}
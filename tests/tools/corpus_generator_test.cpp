@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include "corpus/corpus_generator.hpp"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+fs::path temp_path(const std::string& name) {
+    return fs::temp_directory_path() /
+           ("nebula_mapper_corpus_" + std::to_string(::getpid()) + "_" + name);
+}
+
+std::string read_all(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+} // namespace
+
+TEST(CorpusGeneratorTest, SameSeedSameDocuments) {
+    corpus::CorpusOptions options;
+    options.seed = 7;
+    corpus::CorpusGenerator a(options);
+    corpus::CorpusGenerator b(options);
+
+    for (uint64_t i = 0; i < 20; ++i) {
+        EXPECT_EQ(a.place(i).dump(), b.place(i).dump());
+    }
+    // Documents are independent of generation order
+    EXPECT_EQ(a.place(15).dump(), corpus::CorpusGenerator(options).place(15).dump());
+
+    options.seed = 8;
+    EXPECT_NE(a.place(0).dump(), corpus::CorpusGenerator(options).place(0).dump());
+}
+
+TEST(CorpusGeneratorTest, DocumentsLookLikeKakaoPlaces) {
+    corpus::CorpusOptions options;
+    options.comments = {3, 3};
+    options.missing_field_rate = 0.0;
+    options.null_field_rate = 0.0;
+    options.extra_fields = 2;
+
+    auto doc = corpus::CorpusGenerator(options).place(4);
+    EXPECT_EQ(doc["basicInfo"]["cid"].get<int64_t>(), 1000000004);
+    EXPECT_TRUE(doc["basicInfo"]["placenamefull"].is_string());
+    EXPECT_TRUE(doc["basicInfo"]["phonenum"].is_string());
+    EXPECT_TRUE(doc["basicInfo"]["wpointx"].is_number_integer());
+
+    const auto& comments = doc["comment"]["list"];
+    ASSERT_EQ(comments.size(), 3u);
+    for (const auto& comment : comments) {
+        EXPECT_TRUE(comment["kakaoMapUserId"].is_string());
+        EXPECT_TRUE(comment["level"]["nowLevel"].is_number_integer());
+        EXPECT_TRUE(comment.contains("extra_0"));
+        EXPECT_TRUE(comment.contains("extra_1"));
+    }
+}
+
+TEST(CorpusGeneratorTest, RatesShapeTheOutput) {
+    corpus::CorpusOptions options;
+    options.comments = {5, 5};
+    options.missing_field_rate = 1.0;
+    options.duplicate_user_rate = 1.0;
+    options.user_pool = 1;
+    options.unicode_ratio = 0.0;
+
+    corpus::CorpusGenerator generator(options);
+    auto first = generator.place(0);
+    auto second = generator.place(1);
+
+    EXPECT_FALSE(first["basicInfo"].contains("phonenum"));
+    EXPECT_FALSE(first["comment"]["list"][0].contains("level"));
+
+    // A single recurring user writes every comment, always with the same name
+    const auto& expected = first["comment"]["list"][0];
+    for (const auto* doc : {&first, &second}) {
+        for (const auto& comment : (*doc)["comment"]["list"]) {
+            EXPECT_EQ(comment["kakaoMapUserId"], expected["kakaoMapUserId"]);
+            EXPECT_EQ(comment["username"], expected["username"]);
+        }
+    }
+
+    // Generated text has no Hangul when the Unicode ratio is zero
+    auto text = first["basicInfo"]["placenamefull"].get<std::string>() +
+                expected["username"].get<std::string>();
+    for (unsigned char c : text) {
+        ASSERT_LT(c, 0x80);
+    }
+}
+
+TEST(CorpusGeneratorTest, WritesAllFormats) {
+    corpus::CorpusOptions options;
+    options.places = 25;
+
+    auto ndjson = temp_path("corpus.ndjson");
+    auto result = corpus::write_corpus(options, corpus::OutputFormat::NDJSON, ndjson.string());
+    ASSERT_TRUE(std::holds_alternative<corpus::WriteSummary>(result));
+    EXPECT_EQ(std::get<corpus::WriteSummary>(result).documents, 25u);
+    std::istringstream lines(read_all(ndjson));
+    std::string line;
+    size_t count = 0;
+    while (std::getline(lines, line)) {
+        auto doc = parser::json::parse(line);
+        ASSERT_TRUE(std::holds_alternative<parser::json::JsonDocument>(doc));
+        ++count;
+    }
+    EXPECT_EQ(count, 25u);
+    EXPECT_EQ(fs::file_size(ndjson), std::get<corpus::WriteSummary>(result).bytes);
+
+    auto array = temp_path("corpus.json");
+    result = corpus::write_corpus(options, corpus::OutputFormat::ARRAY, array.string());
+    ASSERT_TRUE(std::holds_alternative<corpus::WriteSummary>(result));
+    auto doc = parser::json::parse(read_all(array));
+    ASSERT_TRUE(std::holds_alternative<parser::json::JsonDocument>(doc));
+    EXPECT_EQ(std::get<parser::json::JsonDocument>(doc).size(), 25u);
+
+    auto directory = temp_path("corpus_files");
+    options.places = 1005;
+    options.comments = {0, 1};
+    result = corpus::write_corpus(options, corpus::OutputFormat::FILES, directory.string());
+    ASSERT_TRUE(std::holds_alternative<corpus::WriteSummary>(result));
+    EXPECT_EQ(std::get<corpus::WriteSummary>(result).files, 1005u);
+    EXPECT_TRUE(fs::exists(directory / "000001" / "place-000001004.json"));
+
+    fs::remove(ndjson);
+    fs::remove(array);
+    fs::remove_all(directory);
+}
+
+TEST(CorpusGeneratorTest, ThreadsDoNotChangeOutput) {
+    corpus::CorpusOptions options;
+    options.places = 300;
+
+    auto serial = temp_path("serial.ndjson");
+    auto parallel = temp_path("parallel.ndjson");
+    corpus::write_corpus(options, corpus::OutputFormat::NDJSON, serial.string());
+    options.threads = 4;
+    corpus::write_corpus(options, corpus::OutputFormat::NDJSON, parallel.string());
+
+    EXPECT_EQ(read_all(serial), read_all(parallel));
+    fs::remove(serial);
+    fs::remove(parallel);
+}
+
+TEST(CorpusGeneratorTest, StopsAtTargetSize) {
+    corpus::CorpusOptions options;
+    options.places = UINT64_MAX;
+    options.target_bytes = 64 * 1024;
+
+    auto path = temp_path("sized.ndjson");
+    auto result = corpus::write_corpus(options, corpus::OutputFormat::NDJSON, path.string());
+    ASSERT_TRUE(std::holds_alternative<corpus::WriteSummary>(result));
+    const auto& summary = std::get<corpus::WriteSummary>(result);
+    EXPECT_GE(summary.bytes, options.target_bytes);
+    EXPECT_LT(summary.bytes, options.target_bytes + 64 * 1024);
+    fs::remove(path);
+}
+
+TEST(CorpusGeneratorTest, ParsesSizes) {
+    EXPECT_EQ(std::get<uint64_t>(corpus::parse_size("512")), 512u);
+    EXPECT_EQ(std::get<uint64_t>(corpus::parse_size("4k")), 4096u);
+    EXPECT_EQ(std::get<uint64_t>(corpus::parse_size("1G")), 1ULL << 30);
+    EXPECT_EQ(std::get<uint64_t>(corpus::parse_size("100GB")), 100ULL << 30);
+    EXPECT_TRUE(std::holds_alternative<corpus::Error>(corpus::parse_size("12X")));
+    EXPECT_TRUE(std::holds_alternative<corpus::Error>(corpus::parse_size("big")));
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "equivalence/equivalence.hpp"
+#include "parser/yaml_parser.hpp"
+#include <algorithm>
+
+namespace {
+
+const parser::mapping::GraphMapping& kakao_mapping() {
+    static const auto mapping = [] {
+        auto yaml = parser::yaml::parse_file(corpus::kakao_mapping_path());
+        return std::get<parser::mapping::GraphMapping>(parser::mapping::create_mapping(yaml));
+    }();
+    return mapping;
+}
+
+std::vector<std::string> rows(const std::vector<std::string>& statements) {
+    auto result = equivalence::canonical_rows(statements);
+    if (std::holds_alternative<equivalence::Error>(result)) {
+        ADD_FAILURE() << std::get<equivalence::Error>(result).message;
+        return {};
+    }
+    return std::get<std::vector<std::string>>(result);
+}
+
+// Reference output with backslash escapes dropped, as a renderer that
+// forgot to escape would produce
+equivalence::Outcome unescaped(const parser::mapping::GraphMapping& mapping,
+                               const std::vector<std::string>& records) {
+    auto outcome = equivalence::run_reference(mapping, records);
+    for (auto& stmt : outcome.statements) {
+        stmt.erase(std::remove(stmt.begin(), stmt.end(), '\\'), stmt.end());
+    }
+    return outcome;
+}
+
+} // namespace
+
+TEST(EquivalenceTest, CanonicalRowsIgnoreBatchingAndPropertyOrder) {
+    auto batched = rows({
+        R"(INSERT VERTEX Place (`name`, cid) VALUES "1":("a, \"b\"):(", 1), "2":("c", 2);)",
+        R"(INSERT EDGE E (w) VALUES "1" -> "2":(0.5);)",
+    });
+    auto split = rows({
+        R"(INSERT EDGE E (w) VALUES "1" -> "2":(0.5);)",
+        R"(INSERT VERTEX Place (cid, `name`) VALUES "2":(2, "c");)",
+        R"(INSERT VERTEX Place (cid, `name`) VALUES "1":(1, "a, \"b\"):(");)",
+    });
+    ASSERT_EQ(batched.size(), 3u);
+    EXPECT_EQ(batched, split);
+
+    auto changed = rows({
+        R"(INSERT VERTEX Place (`name`, cid) VALUES "1":("a, \"b\"):(", 1), "2":("c", 3);)",
+        R"(INSERT EDGE E (w) VALUES "1" -> "2":(0.5);)",
+    });
+    EXPECT_NE(batched, changed);
+
+    EXPECT_TRUE(std::holds_alternative<equivalence::Error>(
+        equivalence::canonical_rows({R"(INSERT VERTEX Place (a) VALUES "1":(x, y);)"})));
+}
+
+TEST(EquivalenceTest, DefaultCorpusMapsThroughItsMapping) {
+    auto records = equivalence::generated_records(corpus::CorpusOptions{}, 50);
+    auto outcome = equivalence::run_reference(kakao_mapping(), records);
+    EXPECT_FALSE(outcome.error) << *outcome.error;
+    EXPECT_FALSE(outcome.statements.empty());
+}
+
+TEST(EquivalenceTest, OptimizedPathsMatchTheReference) {
+    corpus::CorpusOptions options;
+    options.seed = 11;
+    options.missing_field_rate = 0.0;
+    options.null_field_rate = 0.0;
+    auto generated = equivalence::generated_records(options, 24);
+    auto fuzzed = equivalence::fuzzed_records(11, 120);
+
+    // The fuzzer has to reach both rejected records and escaped values
+    size_t failing = 0;
+    size_t escaped = 0;
+    for (const auto& record : fuzzed) {
+        auto outcome = equivalence::run_reference(kakao_mapping(), {record});
+        if (outcome.error) ++failing;
+        for (const auto& stmt : outcome.statements) {
+            if (stmt.find('\\') != std::string::npos) {
+                ++escaped;
+                break;
+            }
+        }
+    }
+    EXPECT_GT(failing, 0u);
+    EXPECT_LT(failing, fuzzed.size() / 2);
+    EXPECT_GT(escaped, 0u);
+
+    for (const auto& configuration : equivalence::default_configurations()) {
+        // The extractor and DSL configurations cover the shipped mapping
+        ASSERT_TRUE(!configuration.applies || configuration.applies(kakao_mapping()))
+            << configuration.name;
+        for (size_t start = 0; start < fuzzed.size(); start += 12) {
+            std::vector<std::string> slice(fuzzed.begin() + static_cast<std::ptrdiff_t>(start),
+                                           fuzzed.begin() + static_cast<std::ptrdiff_t>(start + 12));
+            auto mismatch = equivalence::check(kakao_mapping(), configuration, slice);
+            EXPECT_FALSE(mismatch) << configuration.name << ": " << mismatch->description;
+        }
+        auto mismatch = equivalence::check(kakao_mapping(), configuration, generated);
+        EXPECT_FALSE(mismatch) << configuration.name << ": " << mismatch->description;
+    }
+}
+
+TEST(EquivalenceTest, ReportsAMinimizedInput) {
+    std::vector<std::string> records;
+    for (int i = 0; i < 6; ++i) {
+        records.push_back(R"({"basicInfo": {"cid": )" + std::to_string(i) +
+                          R"(, "placenamefull": "plain", "wpointx": 1, "wpointy": 2,
+                              "phonenum": "02", "mainphotourl": "u"},
+                              "comment": {"list": []}})");
+    }
+    records[4] = R"({"basicInfo": {"cid": 4, "placenamefull": "say \"hi\"", "wpointx": 1,
+                    "wpointy": 2, "phonenum": "02", "mainphotourl": "u"},
+                    "comment": {"list": []}, "unrelated": [1, 2, 3]})";
+
+    equivalence::Configuration broken{"unescaped", unescaped, false, {}};
+    auto mismatch = equivalence::check(kakao_mapping(), broken, records);
+    ASSERT_TRUE(mismatch);
+    EXPECT_EQ(mismatch->configuration, "unescaped");
+    EXPECT_FALSE(mismatch->description.empty());
+
+    ASSERT_EQ(mismatch->records.size(), 1u);
+    const auto& minimized = mismatch->records.front();
+    EXPECT_LT(minimized.size(), records[4].size());
+    EXPECT_NE(minimized.find("\\\""), std::string::npos) << minimized;
+    EXPECT_EQ(minimized.find("unrelated"), std::string::npos) << minimized;
+
+    // The minimized input still fails on its own
+    EXPECT_TRUE(equivalence::compare(equivalence::run_reference(kakao_mapping(), {minimized}),
+                                     unescaped(kakao_mapping(), {minimized}), false));
+}
@@ -0,0 +1,448 @@
+#include "corpus/corpus_generator.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+namespace corpus {
+
+namespace fs = std::filesystem;
+using parser::json::JsonDocument;
+
+namespace {
+    // Stream identifiers keep places, users and comments independent
+    constexpr uint64_t PLACE_STREAM = 1;
+    constexpr uint64_t USER_STREAM = 2;
+    constexpr uint64_t COMMENT_STREAM = 3;
+
+    constexpr uint64_t FILES_PER_DIRECTORY = 1000;
+    constexpr uint64_t RENDER_BATCH = 64;  // Documents per worker per round
+
+    const char* const CATEGORIES[][2] = {
+        {"음식점", "한식"}, {"음식점", "디저트카페"}, {"음식점", "일식"},
+        {"음식점", "중식"}, {"카페", "커피전문점"}, {"음식점", "분식"},
+    };
+    const char* const DISTRICTS[] = {
+        "마포구", "종로구", "강남구", "서초구", "용산구", "성동구", "송파구", "중구"
+    };
+    const char* const STRENGTHS[][2] = {
+        {"5", "맛"}, {"1", "가성비"}, {"2", "친절"}, {"3", "분위기"}, {"4", "주차"}
+    };
+
+    void append_utf8(std::string& out, uint32_t code_point) {
+        if (code_point < 0x80) {
+            out += static_cast<char>(code_point);
+        } else if (code_point < 0x800) {
+            out += static_cast<char>(0xC0 | (code_point >> 6));
+            out += static_cast<char>(0x80 | (code_point & 0x3F));
+        } else {
+            out += static_cast<char>(0xE0 | (code_point >> 12));
+            out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code_point & 0x3F));
+        }
+    }
+
+    // Words of Hangul syllables or ASCII letters; length counts characters
+    std::string text(detail::Rng& rng, const Range& length, double unicode_ratio) {
+        uint32_t target = rng.in(length);
+        std::string out;
+        out.reserve(target * 2);
+
+        uint32_t written = 0;
+        while (written < target) {
+            auto word = static_cast<uint32_t>(rng.between(1, 8));
+            word = std::min(word, target - written);
+            bool hangul = rng.chance(unicode_ratio);
+            for (uint32_t i = 0; i < word; ++i) {
+                if (hangul) {
+                    append_utf8(out, 0xAC00 + static_cast<uint32_t>(rng.between(0, 11171)));
+                } else {
+                    out += static_cast<char>('a' + rng.between(0, 25));
+                }
+            }
+            written += word;
+            if (written < target) {
+                out += ' ';
+                ++written;
+            }
+        }
+        return out;
+    }
+
+    std::string digits(detail::Rng& rng, size_t count) {
+        std::string out;
+        for (size_t i = 0; i < count; ++i) {
+            out += static_cast<char>('0' + rng.between(0, 9));
+        }
+        return out;
+    }
+
+    std::string date(detail::Rng& rng) {
+        // Separate statements: argument evaluation order is unspecified
+        auto year = static_cast<unsigned>(rng.between(2015, 2024));
+        auto month = static_cast<unsigned>(rng.between(1, 12));
+        auto day = static_cast<unsigned>(rng.between(1, 28));
+        char buffer[16];
+        std::snprintf(buffer, sizeof(buffer), "%04u.%02u.%02u.", year, month, day);
+        return buffer;
+    }
+
+    std::string yes_no(detail::Rng& rng) {
+        return rng.chance(0.5) ? "Y" : "N";
+    }
+
+    // Sets an optional field, honouring the missing and null rates
+    template<typename Make>
+    void optional_field(JsonDocument& object, const char* key, detail::Rng& rng,
+                        const CorpusOptions& options, Make make) {
+        double roll = rng.unit();
+        if (roll < options.missing_field_rate) {
+            return;
+        }
+        if (roll < options.missing_field_rate + options.null_field_rate) {
+            object[key] = nullptr;
+            return;
+        }
+        object[key] = make();
+    }
+
+    // Serialize documents [first, first + count) on up to `threads` workers
+    std::vector<std::string> render_batch(const CorpusGenerator& generator,
+                                          uint64_t first, uint64_t count,
+                                          unsigned threads) {
+        std::vector<std::string> rendered(count);
+        auto work = [&](unsigned worker, unsigned workers) {
+            for (uint64_t i = worker; i < count; i += workers) {
+                rendered[i] = generator.place(first + i).dump();
+            }
+        };
+
+        if (threads <= 1 || count < 2) {
+            work(0, 1);
+            return rendered;
+        }
+
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < threads; ++t) {
+            pool.emplace_back(work, t, threads);
+        }
+        for (auto& thread : pool) {
+            thread.join();
+        }
+        return rendered;
+    }
+
+    bool write_text(std::ofstream& out, const std::string& text, WriteSummary& summary) {
+        out.write(text.data(), static_cast<std::streamsize>(text.size()));
+        summary.bytes += text.size();
+        return static_cast<bool>(out);
+    }
+}
+
+namespace detail {
+    uint64_t derive_seed(uint64_t seed, uint64_t stream, uint64_t index) {
+        Rng rng(seed ^ (stream * 0xd1b54a32d192ed03ULL));
+        rng.next();
+        return rng.next() ^ (index * 0x9e3779b97f4a7c15ULL);
+    }
+}
+
+CorpusGenerator::CorpusGenerator(CorpusOptions options)
+    : options_(std::move(options)) {
+    if (options_.user_pool == 0) {
+        options_.user_pool = 1;
+    }
+}
+
+JsonDocument CorpusGenerator::comment(uint64_t place_index, uint32_t ordinal,
+                                      uint64_t seed) const {
+    detail::Rng rng(seed);
+    uint64_t per_place = static_cast<uint64_t>(options_.comments.max) + 1;
+    uint64_t serial = place_index * per_place + ordinal;
+
+    // Recurring users come from a fixed pool; everyone else is new
+    uint64_t user_number = rng.chance(options_.duplicate_user_rate)
+        ? 1000000000ULL + rng.between(0, options_.user_pool - 1)
+        : 5000000000ULL + serial;
+
+    // User attributes only depend on the user, so duplicates agree
+    detail::Rng user(detail::derive_seed(options_.seed, USER_STREAM, user_number));
+    JsonDocument c = JsonDocument::object();
+    c["kakaoMapUserId"] = std::to_string(user_number);
+    c["username"] = text(user, options_.name_length, options_.unicode_ratio);
+    c["profileStatus"] = user.chance(0.8) ? "S" : "N";
+    c["userCommentCount"] = user.between(1, 500);
+    optional_field(c, "profile", user, options_, [&] {
+        return "http://t1.daumcdn.net/local/kakaomapPhoto/profile/" + digits(user, 40);
+    });
+    optional_field(c, "level", user, options_, [&] {
+        return JsonDocument{{"badge", "0" + std::to_string(user.between(1, 9))},
+                            {"nowLevel", user.between(1, 20)}};
+    });
+    optional_field(c, "userCommentAverageScore", user, options_, [&] {
+        return static_cast<double>(user.between(10, 50)) / 10.0;
+    });
+
+    c["commentid"] = std::to_string(10000000ULL + serial);
+    c["point"] = rng.between(1, 5);
+    c["date"] = date(rng);
+    c["likeCnt"] = rng.between(0, 30);
+    c["isMy"] = false;
+    c["isBlock"] = false;
+    c["isEditable"] = false;
+    c["isMyLike"] = false;
+    c["myStorePick"] = false;
+    optional_field(c, "contents", rng, options_, [&] {
+        return text(rng, options_.text_length, options_.unicode_ratio);
+    });
+
+    uint32_t photos = static_cast<uint32_t>(rng.between(0, 2));
+    c["photoCnt"] = photos;
+    JsonDocument photo_list = JsonDocument::array();
+    for (uint32_t i = 0; i < photos; ++i) {
+        photo_list.push_back({{"orgurl", "http://t1.kakaocdn.net/mystore/" + digits(rng, 32)}});
+    }
+    c["photoList"] = std::move(photo_list);
+
+    JsonDocument strengths = JsonDocument::array();
+    for (const auto& strength : STRENGTHS) {
+        if (rng.chance(0.3)) {
+            strengths.push_back({{"id", std::stoi(strength[0])}, {"name", strength[1]}});
+        }
+    }
+    c["strengths"] = std::move(strengths);
+
+    // Fields no mapping declares, like input_dynamic.json
+    for (uint32_t i = 0; i < options_.extra_fields; ++i) {
+        auto key = "extra_" + std::to_string(i);
+        if (i % 2 == 0) {
+            c[key] = text(rng, options_.name_length, options_.unicode_ratio);
+        } else {
+            c[key] = rng.between(0, 1000000);
+        }
+    }
+    return c;
+}
+
+JsonDocument CorpusGenerator::place(uint64_t index) const {
+    detail::Rng rng(detail::derive_seed(options_.seed, PLACE_STREAM, index));
+    const auto& o = options_;
+
+    int64_t cid = 1000000000LL + static_cast<int64_t>(index);
+    std::string name = text(rng, o.name_length, o.unicode_ratio);
+    const auto& category = CATEGORIES[rng.between(0, std::size(CATEGORIES) - 1)];
+    const char* district = DISTRICTS[rng.between(0, std::size(DISTRICTS) - 1)];
+
+    // WCONGNAMUL coordinates around Seoul, as in input.json
+    auto x = static_cast<int64_t>(rng.between(440000, 540000));
+    auto y = static_cast<int64_t>(rng.between(1090000, 1150000));
+
+    JsonDocument basic = JsonDocument::object();
+    basic["cid"] = cid;
+    basic["placenamefull"] = name;
+    basic["wpointx"] = x;
+    basic["wpointy"] = y;
+    basic["isStation"] = false;
+    basic["address"] = {
+        {"region", {{"fullname", std::string("서울 ") + district},
+                    {"newaddrfullname", std::string("서울 ") + district}}},
+        {"newaddr", {{"bsizonno", digits(rng, 5)},
+                     {"newaddrfull", text(rng, o.name_length, o.unicode_ratio)}}},
+    };
+    optional_field(basic, "phonenum", rng, o, [&] {
+        std::string exchange = digits(rng, 4);
+        return "02-" + exchange + "-" + digits(rng, 4);
+    });
+    optional_field(basic, "homepage", rng, o, [&] {
+        return "https://www.instagram.com/" + digits(rng, 12);
+    });
+    optional_field(basic, "mainphotourl", rng, o, [&] {
+        return "http://t1.kakaocdn.net/mystore/" + digits(rng, 32);
+    });
+    optional_field(basic, "category", rng, o, [&] {
+        return JsonDocument{{"cateid", digits(rng, 5)},
+                            {"cate1name", category[0]},
+                            {"catename", category[1]}};
+    });
+    optional_field(basic, "facilityInfo", rng, o, [&] {
+        return JsonDocument{{"pet", yes_no(rng)}, {"wifi", yes_no(rng)},
+                            {"parking", yes_no(rng)}};
+    });
+
+    uint32_t comment_count = rng.in(o.comments);
+    JsonDocument comments = JsonDocument::array();
+    int64_t score_sum = 0;
+    for (uint32_t i = 0; i < comment_count; ++i) {
+        comments.push_back(comment(index, i,
+            detail::derive_seed(o.seed, COMMENT_STREAM, index * (o.comments.max + 1ULL) + i)));
+        score_sum += comments.back()["point"].get<int64_t>();
+    }
+    basic["feedback"] = {{"comntcnt", comment_count}, {"scorecnt", comment_count},
+                         {"scoresum", score_sum}};
+
+    JsonDocument menus = JsonDocument::array();
+    uint32_t menu_count = rng.in(o.menus);
+    for (uint32_t i = 0; i < menu_count; ++i) {
+        std::string menu_name = text(rng, o.name_length, o.unicode_ratio);
+        std::string thousands = std::to_string(rng.between(1, 60));
+        std::string price = thousands + "," + std::to_string(rng.between(0, 9)) + "00";
+        JsonDocument menu = {
+            {"menu", menu_name},
+            {"price", price},
+            {"recommend", rng.chance(0.2)},
+        };
+        optional_field(menu, "desc", rng, o, [&] {
+            return text(rng, o.text_length, o.unicode_ratio);
+        });
+        menus.push_back(std::move(menu));
+    }
+
+    JsonDocument photos = JsonDocument::array();
+    uint32_t photo_count = rng.in(o.photos);
+    for (uint32_t i = 0; i < photo_count; ++i) {
+        photos.push_back({{"orgurl", "http://t1.kakaocdn.net/mystore/" + digits(rng, 32)},
+                          {"photoid", digits(rng, 8)}});
+    }
+
+    JsonDocument doc = JsonDocument::object();
+    doc["isExist"] = true;
+    doc["basicInfo"] = std::move(basic);
+    doc["comment"] = {
+        {"list", std::move(comments)},
+        {"hasNext", false},
+        {"kamapComntcnt", comment_count},
+        {"placenamefull", name},
+        {"scorecnt", comment_count},
+        {"scoresum", score_sum},
+    };
+    doc["findway"] = {{"x", x}, {"y", y}};
+    doc["menuInfo"] = {{"menucount", menu_count}, {"menuList", std::move(menus)}};
+    doc["photo"] = {{"photoList", JsonDocument::array({
+        {{"categoryName", "all"}, {"photoCount", photo_count}, {"list", std::move(photos)}}
+    })}};
+    return doc;
+}
+
+Result<WriteSummary> write_corpus(
+    const CorpusOptions& options,
+    OutputFormat format,
+    const std::string& path,
+    const std::function<void(const WriteSummary&)>& progress) {
+
+    CorpusGenerator generator(options);
+    WriteSummary summary;
+    uint64_t next = 0;
+    std::vector<std::string> rendered;
+    size_t cursor = 0;
+
+    auto done = [&]() {
+        if (next >= options.places) return true;
+        return options.target_bytes > 0 && summary.bytes >= options.target_bytes;
+    };
+
+    // Documents are rendered in parallel batches but written in order
+    auto next_document = [&]() -> const std::string& {
+        if (cursor == rendered.size()) {
+            uint64_t count = std::min<uint64_t>(options.places - next,
+                                                RENDER_BATCH * std::max(options.threads, 1u));
+            rendered = render_batch(generator, next, count, options.threads);
+            cursor = 0;
+        }
+        ++next;
+        return rendered[cursor++];
+    };
+
+    try {
+        if (format == OutputFormat::FILES) {
+            fs::create_directories(path);
+            while (!done()) {
+                uint64_t index = next;
+                char name[64];
+                std::snprintf(name, sizeof(name), "%06llu/place-%09llu.json",
+                              static_cast<unsigned long long>(index / FILES_PER_DIRECTORY),
+                              static_cast<unsigned long long>(index));
+                fs::path file = fs::path(path) / name;
+                if (index % FILES_PER_DIRECTORY == 0) {
+                    fs::create_directories(file.parent_path());
+                }
+
+                std::ofstream out(file, std::ios::binary);
+                if (!out || !write_text(out, next_document(), summary) ||
+                    !write_text(out, "\n", summary)) {
+                    return Error{"Cannot write corpus file", file.string()};
+                }
+                ++summary.documents;
+                ++summary.files;
+                if (progress) progress(summary);
+            }
+            return summary;
+        }
+
+        std::ofstream out(path, std::ios::binary);
+        if (!out) {
+            return Error{"Cannot open corpus output", path};
+        }
+        summary.files = 1;
+
+        bool array = format == OutputFormat::ARRAY;
+        if (array && !write_text(out, "[\n", summary)) {
+            return Error{"Cannot write corpus output", path};
+        }
+        while (!done()) {
+            bool first = next == 0;
+            bool ok = (!array || first || write_text(out, ",\n", summary)) &&
+                      write_text(out, next_document(), summary) &&
+                      (array || write_text(out, "\n", summary));
+            if (!ok) {
+                return Error{"Cannot write corpus output", path};
+            }
+            ++summary.documents;
+            if (progress) progress(summary);
+        }
+        if (array && !write_text(out, "\n]\n", summary)) {
+            return Error{"Cannot write corpus output", path};
+        }
+        return summary;
+    } catch (const std::exception& e) {
+        return Error{std::string("Corpus generation failed: ") + e.what(), path};
+    }
+}
+
+Result<OutputFormat> parse_format(const std::string& name) {
+    if (name == "ndjson") return OutputFormat::NDJSON;
+    if (name == "array") return OutputFormat::ARRAY;
+    if (name == "files") return OutputFormat::FILES;
+    return Error{"Unknown corpus format (expected ndjson, array or files)", name};
+}
+
+Result<uint64_t> parse_size(const std::string& text) {
+    size_t consumed = 0;
+    uint64_t value = 0;
+    try {
+        value = std::stoull(text, &consumed);
+    } catch (const std::exception&) {
+        return Error{"Invalid size", text};
+    }
+
+    std::string suffix;
+    for (size_t i = consumed; i < text.size(); ++i) {
+        suffix += static_cast<char>(std::toupper(static_cast<unsigned char>(text[i])));
+    }
+    if (suffix.size() == 2 && suffix[1] == 'B') suffix.pop_back();
+
+    if (suffix.empty() || suffix == "B") return value;
+    if (suffix == "K") return value << 10;
+    if (suffix == "M") return value << 20;
+    if (suffix == "G") return value << 30;
+    if (suffix == "T") return value << 40;
+    return Error{"Invalid size suffix", text};
+}
+
+std::string kakao_mapping_path() {
+    return NEBULA_MAPPER_CORPUS_DIR "/kakao_mapping.yaml";
+}
+
+} // namespace corpus
@@ -0,0 +1,136 @@
+#ifndef NEBULA_MAPPER_CORPUS_GENERATOR_HPP
+#define NEBULA_MAPPER_CORPUS_GENERATOR_HPP
+
+#include "common/result.hpp"
+#include "parser/json_parser.hpp"
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace corpus {
+
+struct Error : common::Error {
+    Error(const std::string& msg,
+          const std::optional<std::string>& ctx = std::nullopt)
+        : common::Error(msg, ctx) {}
+};
+
+template<typename T>
+using Result = common::Result<T, Error>;
+
+// Inclusive [min, max] range
+struct Range {
+    uint32_t min{0};
+    uint32_t max{0};
+};
+
+// Knobs for the synthetic Kakao place corpus. The same options and seed
+// always produce byte-identical output, and document i only depends on
+// (seed, i), so any slice of a corpus can be regenerated on its own.
+struct CorpusOptions {
+    uint64_t seed{42};
+    uint64_t places{1000};            // Upper bound on documents
+    uint64_t target_bytes{0};         // Stop once this much was written (0 = off)
+    Range comments{0, 12};            // Comments per place
+    Range menus{0, 20};               // Menu entries per place
+    Range photos{0, 8};               // Photos per place
+    Range name_length{4, 24};         // Place and user names, in characters
+    Range text_length{10, 200};       // Comment and menu text, in characters
+    double unicode_ratio{0.7};        // Share of words written in Hangul
+    double duplicate_user_rate{0.3};  // Comments by an already-seen user
+    uint64_t user_pool{10000};        // Size of the recurring user population
+    double missing_field_rate{0.0};   // Optional fields left out entirely
+    double null_field_rate{0.0};      // Optional fields present as null
+    uint32_t extra_fields{0};         // Unmapped comment fields, as in input_dynamic.json
+    unsigned threads{1};              // Render workers; never changes the output
+};
+
+enum class OutputFormat {
+    NDJSON,   // One document per line
+    ARRAY,    // One JSON array holding every document
+    FILES     // One file per document, 1000 per sub-directory
+};
+
+struct WriteSummary {
+    uint64_t documents{0};
+    uint64_t bytes{0};
+    uint64_t files{0};
+};
+
+class CorpusGenerator {
+public:
+    explicit CorpusGenerator(CorpusOptions options);
+
+    // Document number `index` of the corpus
+    parser::json::JsonDocument place(uint64_t index) const;
+
+    const CorpusOptions& options() const { return options_; }
+
+private:
+    parser::json::JsonDocument comment(uint64_t place_index, uint32_t ordinal,
+                                       uint64_t seed) const;
+
+    CorpusOptions options_;
+};
+
+// Write the corpus to `path` (a file, or a directory for FILES).
+// `progress` is called after each document with the running summary.
+Result<WriteSummary> write_corpus(
+    const CorpusOptions& options,
+    OutputFormat format,
+    const std::string& path,
+    const std::function<void(const WriteSummary&)>& progress = {});
+
+Result<OutputFormat> parse_format(const std::string& name);
+
+// Parse sizes such as "512M", "1G" or "100GB"
+Result<uint64_t> parse_size(const std::string& text);
+
+// Mapping YAML that covers the corpus documents (tools/corpus/kakao_mapping.yaml).
+// Absent or null parents fail extraction, so corpora with a missing or null
+// field rate above 0 do not map through it.
+std::string kakao_mapping_path();
+
+namespace detail {
+    // SplitMix64: tiny, fast and identical on every platform, unlike the
+    // standard distributions
+    class Rng {
+    public:
+        explicit Rng(uint64_t seed) : state_(seed) {}
+
+        uint64_t next() {
+            uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+
+        // Uniform in [min, max]
+        uint64_t between(uint64_t min, uint64_t max) {
+            return max <= min ? min : min + next() % (max - min + 1);
+        }
+
+        uint32_t in(const Range& range) {
+            return static_cast<uint32_t>(between(range.min, range.max));
+        }
+
+        // Uniform in [0, 1)
+        double unit() {
+            return static_cast<double>(next() >> 11) * 0x1.0p-53;
+        }
+
+        bool chance(double probability) {
+            return unit() < probability;
+        }
+
+    private:
+        uint64_t state_;
+    };
+
+    // Independent stream for (seed, stream, index)
+    uint64_t derive_seed(uint64_t seed, uint64_t stream, uint64_t index);
+}
+
+} // namespace corpus
+
+#endif // NEBULA_MAPPER_CORPUS_GENERATOR_HPP
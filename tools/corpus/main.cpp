@@ -0,0 +1,164 @@
+#include "corpus/corpus_generator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+void print_usage(const char* program_name) {
+    std::cerr << "Usage: " << program_name << " --output PATH [options]\n"
+              << "Options:\n"
+              << "  --format F              ndjson, array or files (default: ndjson)\n"
+              << "  --seed N                Random seed (default: 42)\n"
+              << "  --places N              Maximum number of documents (default: 1000)\n"
+              << "  --size S                Stop after S bytes, e.g. 1G (lifts the --places\n"
+              << "                          default)\n"
+              << "  --comments MIN:MAX      Comments per place (default: 0:12)\n"
+              << "  --menus MIN:MAX         Menu entries per place (default: 0:20)\n"
+              << "  --photos MIN:MAX        Photos per place (default: 0:8)\n"
+              << "  --name-length MIN:MAX   Name length in characters (default: 4:24)\n"
+              << "  --text-length MIN:MAX   Comment/menu text length (default: 10:200)\n"
+              << "  --unicode-ratio R       Share of Hangul words (default: 0.7)\n"
+              << "  --duplicate-user-rate R Comments by recurring users (default: 0.3)\n"
+              << "  --user-pool N           Recurring user population (default: 10000)\n"
+              << "  --missing-field-rate R  Optional fields left out (default: 0)\n"
+              << "  --null-field-rate R     Optional fields set to null (default: 0)\n"
+              << "  --extra-fields N        Unmapped fields per comment (default: 0)\n"
+              << "  --threads N             Render workers (default: hardware threads)\n";
+}
+
+std::optional<corpus::Range> parse_range(const std::string& text) {
+    auto colon = text.find(':');
+    try {
+        if (colon == std::string::npos) {
+            auto value = static_cast<uint32_t>(std::stoul(text));
+            return corpus::Range{value, value};
+        }
+        corpus::Range range{static_cast<uint32_t>(std::stoul(text.substr(0, colon))),
+                            static_cast<uint32_t>(std::stoul(text.substr(colon + 1)))};
+        if (range.max < range.min) return std::nullopt;
+        return range;
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+std::optional<double> parse_rate(const std::string& text) {
+    try {
+        double rate = std::stod(text);
+        if (rate < 0.0 || rate > 1.0) return std::nullopt;
+        return rate;
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    corpus::CorpusOptions options;
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+    corpus::OutputFormat format = corpus::OutputFormat::NDJSON;
+    std::string output;
+    bool places_set = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        std::string value = argv[++i];
+
+        bool ok = true;
+        try {
+            if (arg == "--output") {
+                output = value;
+            } else if (arg == "--format") {
+                auto parsed = corpus::parse_format(value);
+                ok = std::holds_alternative<corpus::OutputFormat>(parsed);
+                if (ok) format = std::get<corpus::OutputFormat>(parsed);
+            } else if (arg == "--seed") {
+                options.seed = std::stoull(value);
+            } else if (arg == "--places") {
+                options.places = std::stoull(value);
+                places_set = true;
+            } else if (arg == "--size") {
+                auto parsed = corpus::parse_size(value);
+                ok = std::holds_alternative<uint64_t>(parsed);
+                if (ok) options.target_bytes = std::get<uint64_t>(parsed);
+            } else if (arg == "--user-pool") {
+                options.user_pool = std::stoull(value);
+            } else if (arg == "--threads") {
+                options.threads = static_cast<unsigned>(std::stoul(value));
+            } else if (arg == "--extra-fields") {
+                options.extra_fields = static_cast<uint32_t>(std::stoul(value));
+            } else if (arg == "--comments" || arg == "--menus" || arg == "--photos" ||
+                       arg == "--name-length" || arg == "--text-length") {
+                auto range = parse_range(value);
+                if (!range) ok = false;
+                else if (arg == "--comments") options.comments = *range;
+                else if (arg == "--menus") options.menus = *range;
+                else if (arg == "--photos") options.photos = *range;
+                else if (arg == "--name-length") options.name_length = *range;
+                else options.text_length = *range;
+            } else if (arg == "--unicode-ratio" || arg == "--duplicate-user-rate" ||
+                       arg == "--missing-field-rate" || arg == "--null-field-rate") {
+                auto rate = parse_rate(value);
+                if (!rate) ok = false;
+                else if (arg == "--unicode-ratio") options.unicode_ratio = *rate;
+                else if (arg == "--duplicate-user-rate") options.duplicate_user_rate = *rate;
+                else if (arg == "--missing-field-rate") options.missing_field_rate = *rate;
+                else options.null_field_rate = *rate;
+            } else {
+                std::cerr << "Error: Unknown option: " << arg << '\n';
+                print_usage(argv[0]);
+                return 1;
+            }
+        } catch (const std::exception&) {
+            ok = false;
+        }
+
+        if (!ok) {
+            std::cerr << "Error: Invalid value for " << arg << ": " << value << '\n';
+            return 1;
+        }
+    }
+
+    if (output.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (options.target_bytes > 0 && !places_set) {
+        options.places = UINT64_MAX;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    uint64_t next_report = 1ULL << 30;
+    auto result = corpus::write_corpus(options, format, output,
+        [&](const corpus::WriteSummary& summary) {
+            if (summary.bytes >= next_report) {
+                std::cerr << "  " << (summary.bytes >> 20) << " MiB, "
+                          << summary.documents << " documents\n";
+                next_report += 1ULL << 30;
+            }
+        });
+
+    if (std::holds_alternative<corpus::Error>(result)) {
+        const auto& error = std::get<corpus::Error>(result);
+        std::cerr << "Error: " << error.message;
+        if (error.context) std::cerr << " (" << *error.context << ")";
+        std::cerr << '\n';
+        return 1;
+    }
+
+    const auto& summary = std::get<corpus::WriteSummary>(result);
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cerr << "Wrote " << summary.documents << " documents, " << summary.bytes
+              << " bytes in " << summary.files << " file(s) ("
+              << static_cast<double>(summary.bytes) / (1 << 20) / std::max(seconds, 1e-9)
+              << " MiB/s)\n";
+    return 0;
+}
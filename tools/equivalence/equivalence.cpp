@@ -0,0 +1,819 @@
+#include "equivalence/equivalence.hpp"
+#include "graph/codegen.hpp"
+#include "graph/compiled_mapping.hpp"
+#include "graph/mapping_dsl.hpp"
+#include "graph/pipeline.hpp"
+#include "telemetry/metrics.hpp"
+#include "telemetry/stats.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <unistd.h>
+
+namespace equivalence {
+
+namespace fs = std::filesystem;
+using parser::json::JsonDocument;
+using parser::json::Record;
+using parser::json::RecordReader;
+
+namespace {
+    // Serves records straight from memory, so the pipeline can be driven
+    // without touching the filesystem
+    class MemoryReader : public RecordReader {
+    public:
+        explicit MemoryReader(const std::vector<std::string>& records)
+            : records_(records) {}
+
+        parser::json::Result<std::optional<Record>> next() override {
+            if (position_ >= records_.size()) {
+                return std::optional<Record>{};
+            }
+            Record record{records_[position_], "memory[" + std::to_string(position_) + "]",
+                          position_};
+            bytes_ += record.text.size();
+            ++position_;
+            return std::optional<Record>{std::move(record)};
+        }
+
+        uint64_t bytes_read() const override { return bytes_; }
+
+    private:
+        const std::vector<std::string>& records_;
+        uint64_t position_{0};
+        uint64_t bytes_{0};
+    };
+
+    class CollectingSink : public graph::StatementSink {
+    public:
+        void consume(std::vector<std::string>&& statements) override {
+            for (auto& stmt : statements) {
+                statements_.push_back(std::move(stmt));
+            }
+        }
+
+        std::vector<std::string> statements_;
+    };
+
+    Outcome run_pipeline(const parser::mapping::GraphMapping& mapping,
+                         RecordReader& reader,
+                         const graph::PipelineOptions& options) {
+        CollectingSink sink;
+        auto result = graph::run_pipeline(mapping, reader, sink, options);
+        Outcome outcome;
+        outcome.statements = std::move(sink.statements_);
+        if (std::holds_alternative<graph::StatementError>(result)) {
+            outcome.error = std::get<graph::StatementError>(result).message;
+        }
+        return outcome;
+    }
+
+    Runner in_memory(graph::PipelineOptions options) {
+        return [options](const parser::mapping::GraphMapping& mapping,
+                         const std::vector<std::string>& records) {
+            MemoryReader reader(records);
+            return run_pipeline(mapping, reader, options);
+        };
+    }
+
+    // Writes the records to a temporary file and reads them back through
+    // open_records(), covering the streaming readers
+    Runner from_file(const std::string& extension, parser::json::InputFormat format) {
+        return [extension, format](const parser::mapping::GraphMapping& mapping,
+                                   const std::vector<std::string>& records) {
+            static uint64_t counter = 0;
+            fs::path path = fs::temp_directory_path() /
+                ("nebula_mapper_equivalence_" + std::to_string(::getpid()) + "_" +
+                 std::to_string(counter++) + extension);
+            {
+                std::ofstream out(path, std::ios::binary);
+                if (format == parser::json::InputFormat::ARRAY) {
+                    out << '[';
+                    for (size_t i = 0; i < records.size(); ++i) {
+                        out << (i ? ",\n" : "") << records[i];
+                    }
+                    out << ']';
+                } else {
+                    for (const auto& record : records) {
+                        out << record << '\n';
+                    }
+                }
+            }
+
+            Outcome outcome;
+            auto reader = parser::json::open_records(path.string(), format);
+            if (std::holds_alternative<parser::json::Error>(reader)) {
+                outcome.error = "Input error: " + std::get<parser::json::Error>(reader).message;
+            } else {
+                outcome = run_pipeline(
+                    mapping, *std::get<std::unique_ptr<RecordReader>>(reader), {});
+            }
+            std::error_code ignored;
+            fs::remove(path, ignored);
+            return outcome;
+        };
+    }
+
+    // Serial pipeline with every telemetry hook switched on
+    Outcome run_instrumented(const parser::mapping::GraphMapping& mapping,
+                             const std::vector<std::string>& records) {
+        bool stats = telemetry::stats_enabled();
+        bool metrics = telemetry::metrics_enabled();
+        telemetry::enable_stats();
+        telemetry::enable_metrics();
+        MemoryReader reader(records);
+        auto outcome = run_pipeline(mapping, reader, {});
+        telemetry::enable_stats(stats);
+        telemetry::enable_metrics(metrics);
+        return outcome;
+    }
+
+    // An extractor built for one generated source, or why it was not
+    struct ExtractorBuild {
+        std::string source;
+        std::unique_ptr<graph::CompiledMapping> extractor;
+        std::optional<std::string> error;
+    };
+
+    // Any text will do as the "YAML": the extractor is loaded for the same
+    // text it is generated with
+    const char EXTRACTOR_LABEL[] = "equivalence harness";
+
+    std::optional<std::string> extractor_source(const parser::mapping::GraphMapping& mapping) {
+        auto source = graph::generate_extractor_source(
+            mapping, graph::mapping_hash(EXTRACTOR_LABEL), "equivalence");
+        if (!std::holds_alternative<std::string>(source)) return std::nullopt;
+        return std::get<std::string>(source);
+    }
+
+    // Compile with the compiler and nlohmann/json the library was built with
+    void build_extractor(ExtractorBuild& build) {
+        static uint64_t counter = 0;
+        fs::path dir = fs::temp_directory_path() /
+            ("nebula_mapper_equivalence_" + std::to_string(::getpid()) + "_extractor_" +
+             std::to_string(counter++));
+        fs::create_directories(dir);
+        auto cpp = dir / "extractor.cpp";
+        auto library = dir / "extractor.so";
+        std::ofstream(cpp, std::ios::binary) << build.source;
+
+        std::string command = std::string(NEBULA_MAPPER_CXX_COMPILER) +
+            " -std=c++17 -shared -fPIC -I" + NEBULA_MAPPER_JSON_INCLUDE + " " + cpp.string() +
+            " -o " + library.string();
+        if (std::system(command.c_str()) != 0) {
+            build.error = "cannot compile " + cpp.string();
+        } else {
+            auto loaded = graph::CompiledMapping::load(library.string(), EXTRACTOR_LABEL);
+            if (std::holds_alternative<graph::StatementError>(loaded)) {
+                build.error = std::get<graph::StatementError>(loaded).message;
+            } else {
+                build.extractor =
+                    std::move(std::get<std::unique_ptr<graph::CompiledMapping>>(loaded));
+            }
+        }
+        std::error_code ignored;
+        fs::remove_all(dir, ignored);
+    }
+
+    // Pipeline with an extractor generated and built for the mapping, as
+    // --extractor runs it. The build is kept until the mapping changes.
+    Runner compiled(graph::PipelineOptions options) {
+        auto build = std::make_shared<ExtractorBuild>();
+        return [options, build](const parser::mapping::GraphMapping& mapping,
+                                const std::vector<std::string>& records) {
+            auto source = extractor_source(mapping);
+            if (!source) return Outcome{{}, "Extractor refuses the mapping"};
+            if (*source != build->source) {
+                *build = ExtractorBuild{};
+                build->source = std::move(*source);
+                build_extractor(*build);
+            }
+            if (build->error) return Outcome{{}, "Extractor build failed: " + *build->error};
+
+            auto with_extractor = options;
+            with_extractor.compiled = build->extractor.get();
+            MemoryReader reader(records);
+            return run_pipeline(mapping, reader, with_extractor);
+        };
+    }
+
+    bool compilable(const parser::mapping::GraphMapping& mapping) {
+        return extractor_source(mapping).has_value();
+    }
+
+    // tools/corpus/kakao_mapping.yaml as a constexpr DSL mapping: tags in
+    // file order, properties in the interpreter's (alphabetical) order
+    namespace kakao {
+        constexpr char Place[] = "Place", User[] = "User", Review[] = "Review",
+                       Wrote[] = "Wrote";
+        constexpr char basicInfo[] = "basicInfo", comment_list[] = "comment/list";
+        constexpr char cid[] = "cid", placenamefull[] = "placenamefull",
+                       wpointx[] = "wpointx", wpointy[] = "wpointy",
+                       phonenum[] = "phonenum", mainphotourl[] = "mainphotourl";
+        constexpr char kakaoMapUserId[] = "kakaoMapUserId", username[] = "username",
+                       profileStatus[] = "profileStatus", nowLevel[] = "level/nowLevel",
+                       level_now[] = "level_now", userCommentCount[] = "userCommentCount",
+                       userCommentAverageScore[] = "userCommentAverageScore";
+        constexpr char commentid[] = "commentid", contents[] = "contents",
+                       point[] = "point", date[] = "date";
+        constexpr char likeCnt[] = "likeCnt", photoCnt[] = "photoCnt";
+
+        namespace dsl = graph::dsl;
+        constexpr auto mapping = dsl::mapping(
+            dsl::tag<Place, basicInfo>(dsl::key<cid>,
+                                       dsl::prop<cid, int64_t>,
+                                       dsl::prop<mainphotourl>,
+                                       dsl::prop<phonenum>,
+                                       dsl::prop<placenamefull>,
+                                       dsl::prop<wpointx, int64_t>,
+                                       dsl::prop<wpointy, int64_t>),
+            dsl::tag<User, comment_list>(dsl::key<kakaoMapUserId>,
+                                         dsl::prop<nowLevel, int64_t, level_now>,
+                                         dsl::prop<profileStatus>,
+                                         dsl::prop<userCommentAverageScore, double>,
+                                         dsl::prop<userCommentCount, int64_t>,
+                                         dsl::prop<username>),
+            dsl::tag<Review, comment_list>(dsl::key<commentid>,
+                                           dsl::prop<contents>,
+                                           dsl::prop<date>,
+                                           dsl::prop<point, int64_t>),
+            dsl::edge<Wrote, comment_list>(dsl::from_key<kakaoMapUserId>,
+                                           dsl::to_key<commentid>,
+                                           dsl::prop<likeCnt, int64_t>,
+                                           dsl::prop<photoCnt, int64_t>));
+    }
+
+    bool same_properties(const std::vector<parser::mapping::Property>& dsl,
+                         const std::vector<parser::mapping::Property>& yaml) {
+        return std::equal(dsl.begin(), dsl.end(), yaml.begin(), yaml.end(),
+                          [](const auto& a, const auto& b) {
+            return a.name == b.name && a.json_path == b.json_path &&
+                   a.nebula_type == b.nebula_type && !b.transform && !b.json_format &&
+                   !b.geo && b.coerce == common::numbers::CoercionMode::STRICT;
+        });
+    }
+
+    // True if `mapping` is the one the DSL mapping spells out
+    bool described_by_dsl(const parser::mapping::GraphMapping& mapping) {
+        auto dsl = kakao::mapping.describe();
+        return std::equal(dsl.vertices.begin(), dsl.vertices.end(),
+                          mapping.vertices.begin(), mapping.vertices.end(),
+                          [](const auto& a, const auto& b) {
+                   return a.tag_name == b.tag_name && a.source_path == b.source_path &&
+                          a.key_path == b.key_path && !b.dynamic_fields.enabled &&
+                          b.aggregates.empty() && same_properties(a.properties, b.properties);
+               }) &&
+               std::equal(dsl.edges.begin(), dsl.edges.end(),
+                          mapping.edges.begin(), mapping.edges.end(),
+                          [](const auto& a, const auto& b) {
+                   return a.edge_name == b.edge_name && a.source_path == b.source_path &&
+                          a.from.key_path == b.from.key_path &&
+                          a.to.key_path == b.to.key_path &&
+                          same_properties(a.properties, b.properties);
+               });
+    }
+
+    Outcome run_dsl(const parser::mapping::GraphMapping&,
+                    const std::vector<std::string>& records) {
+        MemoryReader reader(records);
+        CollectingSink sink;
+        auto result = kakao::mapping.run(reader, sink);
+        Outcome outcome;
+        outcome.statements = std::move(sink.statements_);
+        if (std::holds_alternative<graph::StatementError>(result)) {
+            outcome.error = std::get<graph::StatementError>(result).message;
+        }
+        return outcome;
+    }
+
+    // Tokens of a rendered statement: quoted strings and back-quoted
+    // identifiers are kept whole, escapes included
+    class Scanner {
+    public:
+        explicit Scanner(const std::string& text) : text_(text) {}
+
+        void skip_space() {
+            while (pos_ < text_.size() &&
+                   std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+                ++pos_;
+            }
+        }
+
+        bool at_end() {
+            skip_space();
+            return pos_ >= text_.size();
+        }
+
+        bool accept(const std::string& literal) {
+            skip_space();
+            if (text_.compare(pos_, literal.size(), literal) == 0) {
+                pos_ += literal.size();
+                return true;
+            }
+            return false;
+        }
+
+        bool token(std::string& out) {
+            skip_space();
+            if (pos_ >= text_.size()) return false;
+
+            size_t start = pos_;
+            char open = text_[pos_];
+            if (open == '"' || open == '`') {
+                for (++pos_; pos_ < text_.size() && text_[pos_] != open; ++pos_) {
+                    if (text_[pos_] == '\\') ++pos_;
+                }
+                if (pos_ >= text_.size()) return false;
+                ++pos_;
+            } else {
+                while (pos_ < text_.size() &&
+                       !std::isspace(static_cast<unsigned char>(text_[pos_])) &&
+                       std::string_view(",():;").find(text_[pos_]) == std::string_view::npos) {
+                    ++pos_;
+                }
+            }
+            out = text_.substr(start, pos_ - start);
+            return pos_ > start;
+        }
+
+        // "(a, b, c)", possibly empty
+        bool list(std::vector<std::string>& out) {
+            out.clear();
+            if (!accept("(")) return false;
+            if (accept(")")) return true;
+            do {
+                std::string item;
+                if (!token(item)) return false;
+                out.push_back(std::move(item));
+            } while (accept(","));
+            return accept(")");
+        }
+
+        size_t position() const { return pos_; }
+
+    private:
+        const std::string& text_;
+        size_t pos_{0};
+    };
+
+    std::string row(const std::string& kind, const std::string& name,
+                    const std::string& key,
+                    const std::vector<std::string>& names,
+                    const std::vector<std::string>& values) {
+        std::vector<std::string> props;
+        for (size_t i = 0; i < names.size(); ++i) {
+            props.push_back(names[i] + "=" + values[i]);
+        }
+        std::sort(props.begin(), props.end());
+
+        std::string out = kind + " " + name + " " + key + " {";
+        for (size_t i = 0; i < props.size(); ++i) {
+            out += (i ? "," : "") + props[i];
+        }
+        return out + "}";
+    }
+
+    std::optional<Error> parse_statement(const std::string& stmt, std::vector<std::string>& rows) {
+        Scanner scan(stmt);
+        auto fail = [&](const std::string& what) {
+            return Error{"Cannot parse statement: " + what + " at offset " +
+                         std::to_string(scan.position()), stmt};
+        };
+
+        std::string name;
+        std::vector<std::string> names;
+        std::vector<std::string> values;
+
+        if (scan.accept("UPSERT VERTEX ")) {
+            std::string id;
+            if (!scan.token(name) || !scan.token(id) || !scan.list(names) ||
+                !scan.accept("VALUES") || !scan.list(values)) {
+                return fail("malformed UPSERT");
+            }
+            if (names.size() != values.size()) return fail("property count");
+            rows.push_back(row("UPSERT", name, id, names, values));
+        } else {
+            bool edge = false;
+            if (scan.accept("INSERT EDGE ")) {
+                edge = true;
+            } else if (!scan.accept("INSERT VERTEX ")) {
+                return fail("unknown statement");
+            }
+            if (!scan.token(name) || !scan.list(names) || !scan.accept("VALUES")) {
+                return fail("malformed header");
+            }
+            do {
+                std::string key;
+                if (!scan.token(key)) return fail("missing key");
+                if (edge) {
+                    std::string target;
+                    if (!scan.accept("->") || !scan.token(target)) return fail("missing target");
+                    key += " -> " + target;
+                }
+                if (!scan.accept(":") || !scan.list(values)) return fail("missing values");
+                if (names.size() != values.size()) return fail("property count");
+                rows.push_back(row(edge ? "EDGE" : "VERTEX", name, key, names, values));
+            } while (scan.accept(","));
+        }
+
+        if (!scan.accept(";") || !scan.at_end()) {
+            return fail("trailing input");
+        }
+        return std::nullopt;
+    }
+
+    std::string excerpt(const std::string& text) {
+        constexpr size_t LIMIT = 160;
+        return text.size() <= LIMIT ? text : text.substr(0, LIMIT) + "...";
+    }
+
+    // First element of `a` missing from `b`, both sorted
+    std::optional<std::string> first_missing(const std::vector<std::string>& a,
+                                             const std::vector<std::string>& b) {
+        std::vector<std::string> missing;
+        std::set_difference(a.begin(), a.end(), b.begin(), b.end(),
+                            std::back_inserter(missing));
+        if (missing.empty()) return std::nullopt;
+        return missing.front();
+    }
+
+    // All nodes below the root, parents before children
+    void collect_pointers(const JsonDocument& node, const JsonDocument::json_pointer& at,
+                          std::vector<JsonDocument::json_pointer>& out) {
+        if (node.is_object()) {
+            for (const auto& [key, child] : node.items()) {
+                auto pointer = at / key;
+                out.push_back(pointer);
+                collect_pointers(child, pointer, out);
+            }
+        } else if (node.is_array()) {
+            for (size_t i = 0; i < node.size(); ++i) {
+                auto pointer = at / i;
+                out.push_back(pointer);
+                collect_pointers(node[i], pointer, out);
+            }
+        }
+    }
+
+    // Smaller variants of one node, most aggressive first
+    std::vector<JsonDocument> reductions(const JsonDocument& node) {
+        std::vector<JsonDocument> out;
+        if (node.is_string()) {
+            const auto& text = node.get_ref<const std::string&>();
+            if (!text.empty()) out.emplace_back("");
+            if (text.size() > 1) out.emplace_back(text.substr(0, text.size() / 2));
+        } else if (node.is_number() && node != 0) {
+            out.emplace_back(0);
+        } else if ((node.is_object() || node.is_array()) && !node.empty()) {
+            out.push_back(node.is_object() ? JsonDocument::object() : JsonDocument::array());
+        }
+        return out;
+    }
+
+    // Tricky values for string properties: statement syntax, escapes and
+    // characters a naive renderer gets wrong
+    const char* const HOSTILE_STRINGS[] = {
+        "", "\"", "\\", "\\\"", "a\"b", "line\nbreak", "tab\there", "cr\rlf",
+        "\"):(\"x", "a, b", "\" -> \"", ");", "`back`", "NULL", "한글 \"인용\"",
+        "🙂", "é́", "semi;colon",
+    };
+}
+
+Outcome run_reference(const parser::mapping::GraphMapping& mapping,
+                      const std::vector<std::string>& records) {
+    // Without the fast paths the reference does not run the code it checks
+    graph::GeneratorOptions options;
+    options.fast_paths = false;
+    graph::StatementGenerator generator(options);
+    Outcome outcome;
+    for (const auto& text : records) {
+        auto document = parser::json::parse(text);
+        if (std::holds_alternative<parser::json::Error>(document)) {
+            outcome.error = "JSON error: " + std::get<parser::json::Error>(document).message;
+            break;
+        }
+        auto statements = generator.generate_batch_statements(
+            mapping, std::get<JsonDocument>(document), 500);
+        if (std::holds_alternative<graph::StatementError>(statements)) {
+            outcome.error = std::get<graph::StatementError>(statements).message;
+            break;
+        }
+        for (auto& stmt : std::get<std::vector<std::string>>(statements)) {
+            outcome.statements.push_back(std::move(stmt));
+        }
+    }
+    return outcome;
+}
+
+std::vector<Configuration> default_configurations() {
+    graph::PipelineOptions threaded;
+    threaded.threads = 4;
+    threaded.queue_capacity = 2;
+
+    graph::PipelineOptions unordered = threaded;
+    unordered.ordered = false;
+
+    graph::PipelineOptions single_row;
+    single_row.batch_size = 1;
+
+    graph::PipelineOptions small_batches;
+    small_batches.batch_size = 7;
+    small_batches.threads = 2;
+
+    return {
+        {"pipeline", in_memory({}), true, {}},
+        {"threads", in_memory(threaded), true, {}},
+        {"threads-unordered", in_memory(unordered), false, {}},
+        {"batch-1", in_memory(single_row), false, {}},
+        {"batch-7-threads", in_memory(small_batches), false, {}},
+        {"ndjson-file", from_file(".ndjson", parser::json::InputFormat::NDJSON), true, {}},
+        {"array-file", from_file(".json", parser::json::InputFormat::ARRAY), true, {}},
+        {"telemetry", run_instrumented, true, {}},
+        {"extractor", compiled({}), true, compilable},
+        {"extractor-threads", compiled(threaded), true, compilable},
+        {"dsl", run_dsl, true, described_by_dsl},
+    };
+}
+
+Result<std::vector<std::string>> canonical_rows(const std::vector<std::string>& statements) {
+    std::vector<std::string> rows;
+    for (const auto& stmt : statements) {
+        if (auto error = parse_statement(stmt, rows)) {
+            return *error;
+        }
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
+std::optional<std::string> compare(const Outcome& reference,
+                                   const Outcome& candidate,
+                                   bool exact) {
+    auto describe_error = [](const std::optional<std::string>& error) {
+        return error ? "error \"" + *error + "\"" : std::string("success");
+    };
+    if (reference.error != candidate.error) {
+        return "reference ended with " + describe_error(reference.error) +
+               ", candidate with " + describe_error(candidate.error);
+    }
+
+    if (exact) {
+        size_t common = std::min(reference.statements.size(), candidate.statements.size());
+        for (size_t i = 0; i < common; ++i) {
+            if (reference.statements[i] != candidate.statements[i]) {
+                return "statement " + std::to_string(i) + " differs: reference \"" +
+                       excerpt(reference.statements[i]) + "\", candidate \"" +
+                       excerpt(candidate.statements[i]) + "\"";
+            }
+        }
+        if (reference.statements.size() != candidate.statements.size()) {
+            return "reference produced " + std::to_string(reference.statements.size()) +
+                   " statements, candidate " + std::to_string(candidate.statements.size());
+        }
+        return std::nullopt;
+    }
+
+    // Unordered output only agrees on what precedes a failing record
+    if (reference.error) {
+        return std::nullopt;
+    }
+
+    auto expected = canonical_rows(reference.statements);
+    if (std::holds_alternative<Error>(expected)) {
+        const auto& error = std::get<Error>(expected);
+        return "reference: " + error.message + " in \"" + excerpt(*error.context) + "\"";
+    }
+    auto actual = canonical_rows(candidate.statements);
+    if (std::holds_alternative<Error>(actual)) {
+        const auto& error = std::get<Error>(actual);
+        return "candidate: " + error.message + " in \"" + excerpt(*error.context) + "\"";
+    }
+
+    const auto& want = std::get<std::vector<std::string>>(expected);
+    const auto& got = std::get<std::vector<std::string>>(actual);
+    if (auto missing = first_missing(want, got)) {
+        return "candidate lacks row " + excerpt(*missing);
+    }
+    if (auto extra = first_missing(got, want)) {
+        return "candidate has extra row " + excerpt(*extra);
+    }
+    return std::nullopt;
+}
+
+std::optional<Mismatch> check(const parser::mapping::GraphMapping& mapping,
+                              const Configuration& configuration,
+                              const std::vector<std::string>& records) {
+    auto differs = [&](const std::vector<std::string>& input) {
+        return compare(run_reference(mapping, input),
+                       configuration.run(mapping, input),
+                       configuration.exact);
+    };
+
+    if (!differs(records)) {
+        return std::nullopt;
+    }
+
+    Mismatch mismatch;
+    mismatch.configuration = configuration.name;
+    mismatch.records = minimize(records, [&](const std::vector<std::string>& input) {
+        return differs(input).has_value();
+    });
+    mismatch.description = differs(mismatch.records).value_or("mismatch is not reproducible");
+    return mismatch;
+}
+
+std::vector<std::string> minimize(std::vector<std::string> records, const Predicate& fails) {
+    // ddmin: drop ever smaller chunks of records while the failure persists
+    size_t granularity = 2;
+    while (records.size() >= 2) {
+        size_t chunk = (records.size() + granularity - 1) / granularity;
+        bool reduced = false;
+
+        for (size_t start = 0; start < records.size(); start += chunk) {
+            size_t end = std::min(start + chunk, records.size());
+            std::vector<std::string> subset(records.begin() + static_cast<std::ptrdiff_t>(start),
+                                            records.begin() + static_cast<std::ptrdiff_t>(end));
+            std::vector<std::string> complement(records.begin(),
+                                                records.begin() + static_cast<std::ptrdiff_t>(start));
+            complement.insert(complement.end(),
+                              records.begin() + static_cast<std::ptrdiff_t>(end), records.end());
+
+            if (fails(subset)) {
+                records = std::move(subset);
+                granularity = 2;
+                reduced = true;
+                break;
+            }
+            if (granularity > 2 && fails(complement)) {
+                records = std::move(complement);
+                granularity = std::max<size_t>(granularity - 1, 2);
+                reduced = true;
+                break;
+            }
+        }
+
+        if (!reduced) {
+            if (granularity >= records.size()) break;
+            granularity = std::min(granularity * 2, records.size());
+        }
+    }
+
+    for (size_t i = 0; i < records.size(); ++i) {
+        records[i] = minimize_document(records[i], [&](const std::string& candidate) {
+            auto trial = records;
+            trial[i] = candidate;
+            return fails(trial);
+        });
+    }
+    return records;
+}
+
+std::string minimize_document(const std::string& record,
+                              const std::function<bool(const std::string&)>& fails) {
+    auto parsed = parser::json::parse(record);
+    if (std::holds_alternative<parser::json::Error>(parsed)) {
+        return record;
+    }
+    JsonDocument document = std::move(std::get<JsonDocument>(parsed));
+    std::string best = record;
+
+    auto attempt = [&](JsonDocument candidate) {
+        std::string text = candidate.dump();
+        if (text.size() < best.size() && fails(text)) {
+            document = std::move(candidate);
+            best = std::move(text);
+            return true;
+        }
+        return false;
+    };
+
+    // Children come after their parents, so walking the list backwards
+    // never invalidates a pointer still to be visited
+    for (bool changed = true; changed;) {
+        changed = false;
+        std::vector<JsonDocument::json_pointer> pointers;
+        collect_pointers(document, JsonDocument::json_pointer(), pointers);
+
+        for (auto it = pointers.rbegin(); it != pointers.rend(); ++it) {
+            const auto& pointer = *it;
+            JsonDocument candidate = document;
+            auto& parent = candidate[pointer.parent_pointer()];
+            if (parent.is_object()) {
+                parent.erase(pointer.back());
+            } else {
+                parent.erase(std::stoul(pointer.back()));
+            }
+            if (attempt(std::move(candidate))) {
+                changed = true;
+                continue;
+            }
+
+            for (auto& smaller : reductions(document[pointer])) {
+                candidate = document;
+                candidate[pointer] = std::move(smaller);
+                if (attempt(std::move(candidate))) {
+                    changed = true;
+                    break;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+std::vector<std::string> generated_records(const corpus::CorpusOptions& options,
+                                           uint64_t count) {
+    corpus::CorpusGenerator generator(options);
+    std::vector<std::string> records;
+    records.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        records.push_back(generator.place(i).dump());
+    }
+    return records;
+}
+
+std::vector<std::string> fuzzed_records(uint64_t seed, uint64_t count) {
+    // Mappable base documents: absent or null parents only produce errors
+    corpus::CorpusOptions options;
+    options.seed = seed;
+    options.comments = {1, 6};
+    options.text_length = {0, 40};
+    options.missing_field_rate = 0.0;
+    options.null_field_rate = 0.0;
+    corpus::CorpusGenerator generator(options);
+
+    const char* const STRING_FIELDS[] = {"username", "contents", "date", "profileStatus"};
+    const char* const INT_FIELDS[] = {"point", "likeCnt", "userCommentCount", "photoCnt"};
+    const JsonDocument EXTREME_INTS[] = {
+        std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min(),
+        0, -1, 4294967296LL,
+    };
+    const JsonDocument EXTREME_DOUBLES[] = {
+        0.0, -0.0, 1e308, -1e-308, 0.1, 5e-324, 123456789.125,
+    };
+    constexpr size_t HOSTILE_COUNT = sizeof(HOSTILE_STRINGS) / sizeof(HOSTILE_STRINGS[0]);
+
+    std::vector<std::string> records;
+    records.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        corpus::detail::Rng rng(corpus::detail::derive_seed(seed, 0xF022, i));
+        JsonDocument document = generator.place(i);
+        auto& info = document["basicInfo"];
+        auto& comments = document["comment"]["list"];
+
+        auto hostile = [&]() {
+            return JsonDocument(HOSTILE_STRINGS[rng.between(0, HOSTILE_COUNT - 1)]);
+        };
+
+        if (rng.chance(0.5)) {
+            info[rng.chance(0.5) ? "placenamefull" : "phonenum"] = hostile();
+        }
+        if (rng.chance(0.2)) {
+            info["wpointx"] = EXTREME_INTS[rng.between(0, 4)];
+        }
+
+        for (auto& comment : comments) {
+            if (rng.chance(0.4)) {
+                comment[STRING_FIELDS[rng.between(0, 3)]] = hostile();
+            }
+            if (rng.chance(0.2)) {
+                comment[INT_FIELDS[rng.between(0, 3)]] = EXTREME_INTS[rng.between(0, 4)];
+            }
+            if (rng.chance(0.2)) {
+                comment["userCommentAverageScore"] = EXTREME_DOUBLES[rng.between(0, 6)];
+            }
+            if (rng.chance(0.1)) {
+                comment["kakaoMapUserId"] = hostile();
+            }
+            if (rng.chance(0.05)) {
+                // Mapped leaf as null, or a number where a string belongs
+                if (rng.chance(0.5)) {
+                    comment["contents"] = nullptr;
+                } else {
+                    comment["username"] = static_cast<int64_t>(rng.between(0, 1000));
+                }
+            }
+        }
+
+        // Repeated and reordered vertices
+        if (!comments.empty() && rng.chance(0.3)) {
+            auto copy = comments[rng.between(0, comments.size() - 1)];
+            comments.push_back(std::move(copy));
+        }
+        if (comments.size() > 1 && rng.chance(0.3)) {
+            for (size_t j = comments.size() - 1; j > 0; --j) {
+                size_t k = rng.between(0, j);
+                std::swap(comments[j], comments[k]);
+            }
+        }
+
+        records.push_back(document.dump());
+    }
+    return records;
+}
+
+} // namespace equivalence
@@ -0,0 +1,97 @@
+#ifndef NEBULA_MAPPER_EQUIVALENCE_HPP
+#define NEBULA_MAPPER_EQUIVALENCE_HPP
+
+#include "common/result.hpp"
+#include "corpus/corpus_generator.hpp"
+#include "parser/mapping_parser.hpp"
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Differential harness: runs the straightforward per-document
+// generate_batch_statements() and each optimized configuration over the same
+// records and checks that they produce the same statements.
+
+namespace equivalence {
+
+struct Error : common::Error {
+    Error(const std::string& msg,
+          const std::optional<std::string>& ctx = std::nullopt)
+        : common::Error(msg, ctx) {}
+};
+
+template<typename T>
+using Result = common::Result<T, Error>;
+
+// Statements produced for a list of records, or the error that stopped them
+struct Outcome {
+    std::vector<std::string> statements;
+    std::optional<std::string> error;
+};
+
+using Runner = std::function<Outcome(const parser::mapping::GraphMapping& mapping,
+                                     const std::vector<std::string>& records)>;
+
+struct Configuration {
+    std::string name;
+    Runner run;
+    // Byte-identical statements expected; otherwise only the same rows, in
+    // any order and any batching
+    bool exact{true};
+    // Mappings the configuration can run, all of them when empty
+    std::function<bool(const parser::mapping::GraphMapping&)> applies;
+};
+
+// Parse each record and call generate_batch_statements() on it, with the
+// generator's fast paths off
+Outcome run_reference(const parser::mapping::GraphMapping& mapping,
+                      const std::vector<std::string>& records);
+
+// Every optimized path currently in the tree
+std::vector<Configuration> default_configurations();
+
+// Order- and batching-independent form of a statement list: one entry per
+// inserted row, properties sorted by name, the entries sorted
+Result<std::vector<std::string>> canonical_rows(const std::vector<std::string>& statements);
+
+// Description of the first difference, or std::nullopt if equivalent
+std::optional<std::string> compare(const Outcome& reference,
+                                   const Outcome& candidate,
+                                   bool exact);
+
+struct Mismatch {
+    std::string configuration;
+    std::string description;
+    std::vector<std::string> records;   // Minimized input
+};
+
+// Compare one configuration against the reference; on mismatch the records
+// are minimized first
+std::optional<Mismatch> check(const parser::mapping::GraphMapping& mapping,
+                              const Configuration& configuration,
+                              const std::vector<std::string>& records);
+
+using Predicate = std::function<bool(const std::vector<std::string>&)>;
+
+// Smallest subset of `records` (ddmin) for which `fails` still holds, with
+// each remaining record shrunk by minimize_document()
+std::vector<std::string> minimize(std::vector<std::string> records, const Predicate& fails);
+
+// Greedily drop members and elements and shorten scalars of a JSON record
+// while `fails` holds for it
+std::string minimize_document(const std::string& record,
+                              const std::function<bool(const std::string&)>& fails);
+
+// Documents of the synthetic corpus, serialized one per record
+std::vector<std::string> generated_records(const corpus::CorpusOptions& options,
+                                           uint64_t count);
+
+// Corpus documents with hostile values spliced in: quotes, escapes,
+// separators used by the statement syntax, extreme numbers, type swaps,
+// nulls and repeated vertices
+std::vector<std::string> fuzzed_records(uint64_t seed, uint64_t count);
+
+} // namespace equivalence
+
+#endif // NEBULA_MAPPER_EQUIVALENCE_HPP
@@ -0,0 +1,150 @@
+#include "equivalence/equivalence.hpp"
+#include "parser/yaml_parser.hpp"
+#include <iostream>
+#include <sstream>
+
+namespace {
+
+void print_usage(const char* program_name) {
+    std::cerr << "Usage: " << program_name << " [options]\n"
+              << "Options:\n"
+              << "  --mapping FILE     Mapping YAML (default: tools/corpus/kakao_mapping.yaml)\n"
+              << "  --generated N      Synthetic corpus documents (default: 200)\n"
+              << "  --fuzzed N         Fuzzed documents (default: 200)\n"
+              << "  --seed N           Corpus and fuzzer seed (default: 42)\n"
+              << "  --chunk N          Records per comparison (default: 32)\n"
+              << "  --config NAME      Only check this configuration\n"
+              << "  --list             Print the configurations and exit\n";
+}
+
+void print_mismatch(const equivalence::Mismatch& mismatch, const std::string& corpus) {
+    std::cout << "MISMATCH " << mismatch.configuration << " on " << corpus << ": "
+              << mismatch.description << '\n'
+              << "  minimized input (" << mismatch.records.size() << " record(s)):\n";
+    for (const auto& record : mismatch.records) {
+        std::cout << "    " << record << '\n';
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string mapping_file = corpus::kakao_mapping_path();
+    uint64_t generated = 200;
+    uint64_t fuzzed = 200;
+    uint64_t seed = 42;
+    size_t chunk = 32;
+    std::string only;
+    bool list = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--list") {
+            list = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        std::string value = argv[++i];
+
+        try {
+            if (arg == "--mapping") {
+                mapping_file = value;
+            } else if (arg == "--generated") {
+                generated = std::stoull(value);
+            } else if (arg == "--fuzzed") {
+                fuzzed = std::stoull(value);
+            } else if (arg == "--seed") {
+                seed = std::stoull(value);
+            } else if (arg == "--chunk") {
+                chunk = std::max<size_t>(1, std::stoul(value));
+            } else if (arg == "--config") {
+                only = value;
+            } else {
+                std::cerr << "Error: Unknown option: " << arg << '\n';
+                print_usage(argv[0]);
+                return 1;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Error: Invalid value for " << arg << ": " << value << '\n';
+            return 1;
+        }
+    }
+
+    auto configurations = equivalence::default_configurations();
+    if (list) {
+        for (const auto& configuration : configurations) {
+            std::cout << configuration.name
+                      << (configuration.exact ? " (exact)" : " (rows, any order)") << '\n';
+        }
+        return 0;
+    }
+
+    // The YAML layer logs while decoding; only show that if compiling fails
+    std::stringstream compile_log;
+    auto* saved = std::cerr.rdbuf(compile_log.rdbuf());
+    auto yaml = parser::yaml::parse_file(mapping_file);
+    auto mapping = parser::mapping::create_mapping(yaml);
+    std::cerr.rdbuf(saved);
+    if (std::holds_alternative<parser::yaml::Error>(yaml)) {
+        std::cerr << "YAML Error: " << std::get<parser::yaml::Error>(yaml).message << '\n';
+        return 1;
+    }
+    if (std::holds_alternative<parser::mapping::Error>(mapping)) {
+        std::cerr << compile_log.str() << "Mapping Error: "
+                  << std::get<parser::mapping::Error>(mapping).message << '\n';
+        return 1;
+    }
+    const auto& graph_mapping = std::get<parser::mapping::GraphMapping>(mapping);
+
+    corpus::CorpusOptions options;
+    options.seed = seed;
+    options.missing_field_rate = 0.0;
+    options.null_field_rate = 0.0;
+
+    const std::pair<std::string, std::vector<std::string>> corpora[] = {
+        {"generated", equivalence::generated_records(options, generated)},
+        {"fuzzed", equivalence::fuzzed_records(seed, fuzzed)},
+    };
+
+    int mismatches = 0;
+    size_t checked = 0;
+    for (const auto& configuration : configurations) {
+        if (!only.empty() && configuration.name != only) continue;
+        ++checked;
+        if (configuration.applies && !configuration.applies(graph_mapping)) {
+            std::cout << "skipped  " << configuration.name << " (does not apply to "
+                      << mapping_file << ")\n";
+            continue;
+        }
+
+        bool equivalent = true;
+        for (const auto& [name, records] : corpora) {
+            // Chunks keep one failing record from hiding everything after it
+            for (size_t start = 0; start < records.size() && equivalent; start += chunk) {
+                std::vector<std::string> slice(
+                    records.begin() + static_cast<std::ptrdiff_t>(start),
+                    records.begin() + static_cast<std::ptrdiff_t>(
+                        std::min(start + chunk, records.size())));
+                if (auto mismatch = equivalence::check(graph_mapping, configuration, slice)) {
+                    print_mismatch(*mismatch, name);
+                    equivalent = false;
+                }
+            }
+        }
+
+        if (equivalent) {
+            std::cout << "ok       " << configuration.name << '\n';
+        } else {
+            ++mismatches;
+        }
+    }
+
+    if (checked == 0) {
+        std::cerr << "Error: Unknown configuration: " << only << '\n';
+        return 1;
+    }
+    return mismatches == 0 ? 0 : 1;
+}